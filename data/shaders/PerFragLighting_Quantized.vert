@@ -0,0 +1,42 @@
+#version 400
+
+// PerFragLighting.vert for vertex data laid out as VertexLayoutType::Quantized.
+
+layout (location = 0) in vec3 vertexPosition;   // Unsigned normalized, within [0, 1].
+layout (location = 1) in vec2 vertexNormal;     // Octahedral, within [-1, 1].
+
+out vec3 position;
+out vec3 normal;
+
+uniform mat4 ModelViewMatrix;
+uniform mat3 NormalMatrix;
+uniform mat4 ProjectionMatrix;
+
+// From VertexLayout::getQuantization().
+uniform vec3 PositionOffset;
+uniform vec3 PositionScale;
+
+vec2 signNotZero(vec2 v) {
+    return vec2((v.x >= 0.0) ? 1.0 : -1.0, (v.y >= 0.0) ? 1.0 : -1.0);
+}
+
+// Inverse of VertexLayout::packOctahedralNormal().
+vec3 decodeOctahedralNormal(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * signNotZero(n.xy);
+    }
+    return normalize(n);
+}
+
+void main()
+{
+    vec3 objectPosition = PositionOffset + PositionScale * vertexPosition;
+
+    // Transform vertex position and normal to eye coordinate space.
+    normal = normalize(NormalMatrix * decodeOctahedralNormal(vertexNormal));
+    position = vec3( ModelViewMatrix * vec4(objectPosition, 1.0) );
+
+    // Transform position to normalized device coordinate space.
+    gl_Position = ProjectionMatrix * vec4(position, 1.0);
+}
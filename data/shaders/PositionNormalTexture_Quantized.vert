@@ -0,0 +1,43 @@
+// PositionNormalTexture_Quantized.vert
+// PositionNormalTexture.vert for vertex data laid out as VertexLayoutType::Quantized.
+#version 400
+
+layout (location = 0) in vec3 v_Position;       // Unsigned normalized, within [0, 1].
+layout (location = 1) in vec2 v_Normal;         // Octahedral, within [-1, 1].
+layout (location = 2) in vec2 v_TextureCoord;   // Unsigned normalized, within [0, 1].
+
+out vec3 position;
+out vec3 normal;
+out vec2 textureCoord;
+
+uniform mat4 ModelViewMatrix;
+uniform mat3 NormalMatrix;
+uniform mat4 MVP;
+
+// From VertexLayout::getQuantization().
+uniform vec3 PositionOffset;
+uniform vec3 PositionScale;
+uniform vec2 UvCoordOffset;
+uniform vec2 UvCoordScale;
+
+vec2 signNotZero(vec2 v) {
+    return vec2((v.x >= 0.0) ? 1.0 : -1.0, (v.y >= 0.0) ? 1.0 : -1.0);
+}
+
+// Inverse of VertexLayout::packOctahedralNormal().
+vec3 decodeOctahedralNormal(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * signNotZero(n.xy);
+    }
+    return normalize(n);
+}
+
+void main() {
+    vec3 objectPosition = PositionOffset + PositionScale * v_Position;
+
+    textureCoord = UvCoordOffset + UvCoordScale * v_TextureCoord;
+    normal = normalize(NormalMatrix * decodeOctahedralNormal(v_Normal));
+    position = vec3( ModelViewMatrix * vec4(objectPosition, 1.0) );
+    gl_Position = MVP * vec4(objectPosition, 1.0);
+}
@@ -0,0 +1,7 @@
+// ShadowDepth.frag
+#version 400
+
+// Only depth is written.
+void main() {
+
+}
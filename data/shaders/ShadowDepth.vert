@@ -0,0 +1,11 @@
+// ShadowDepth.vert
+#version 400
+
+layout (location = 0) in vec3 vertexPosition;
+
+uniform mat4 ModelViewProjectionMatrix;
+
+void main()
+{
+    gl_Position = ModelViewProjectionMatrix * vec4(vertexPosition, 1.0);
+}
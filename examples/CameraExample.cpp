@@ -23,7 +23,7 @@ shared_ptr<GlfwOpenGlWindow> CameraExample::getInstance() {
 
 //---------------------------------------------------------------------------------------
 CameraExample::CameraExample()
-        : vao(0), vbo_vertices(0), vbo_normals(0) {
+        : vao(0), vbo_vertices(0), vbo_normals(0), vbo_indices(0) {
 }
 
 //---------------------------------------------------------------------------------------
@@ -33,12 +33,20 @@ CameraExample::CameraExample()
  */
 void CameraExample::init()
 {
+    // Indexed meshes share vertices between triangles, and are drawn by the
+    // Renderables with glDrawElements.
+    Mesh gridMesh("data/meshes/grid.obj", MeshIndexing::Indexed);
+    Mesh bunnyMesh("data/meshes/bunny_smooth.obj", MeshIndexing::Indexed);
+    Mesh tyrannosaurusMesh("data/meshes/tyrannosaurus_smooth.obj", MeshIndexing::Indexed);
+    Mesh sphereMesh("data/meshes/sphere_smooth.obj", MeshIndexing::Indexed);
+    Mesh cubeMesh("data/meshes/cube.obj", MeshIndexing::Indexed);
+
     meshConsolidator =  {
-            {"grid", "data/meshes/grid.obj"},
-            {"bunny", "data/meshes/bunny_smooth.obj"},
-            {"tyrannosaurus", "data/meshes/tyrannosaurus_smooth.obj"},
-            {"sphere", "data/meshes/sphere_smooth.obj"},
-            {"cube", "data/meshes/cube.obj"}
+            {"grid", &gridMesh},
+            {"bunny", &bunnyMesh},
+            {"tyrannosaurus", &tyrannosaurusMesh},
+            {"sphere", &sphereMesh},
+            {"cube", &cubeMesh}
     };
 
     meshConsolidator.getBatchInfo(batchInfoMap);
@@ -144,6 +152,12 @@ void CameraExample::setupGLBuffers()
     glBufferData(GL_ARRAY_BUFFER, meshConsolidator.getNumVertexNormalBytes(), meshConsolidator.getVertexNormalDataPtr(), GL_STATIC_DRAW);
     glVertexAttribPointer(shaderProgram.getAttribLocation("vertexNormal"), 3, GL_FLOAT, GL_FALSE, 0, 0);
 
+    // Copy index data to OpenGL buffer, which stays bound to the VAO.
+    const IndexBuffer & indices = meshConsolidator.getIndexBuffer();
+    glGenBuffers(1, &vbo_indices);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo_indices);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.getNumBytes(), indices.getDataPtr(), GL_STATIC_DRAW);
+
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
     Rigid3D::checkGLErrors(__FILE__, __LINE__);
@@ -174,6 +188,7 @@ void CameraExample::logic() {
 void CameraExample::cleanup() {
     glBindVertexArray(0);
     glDeleteBuffers(1, &vbo_normals);
+    glDeleteBuffers(1, &vbo_indices);
     glDeleteBuffers(1, &vbo_vertices);
     glDeleteVertexArrays(1, &vao);
     Rigid3D::checkGLErrors(__FILE__, __LINE__);
@@ -52,6 +52,7 @@ private:
     GLuint vao;
     GLuint vbo_vertices;
     GLuint vbo_normals;
+    GLuint vbo_indices;
 
     virtual void init();
     virtual void logic();
@@ -78,4 +78,58 @@ vec3 AABB::getCenter() const {
     return (minBounds + maxBounds) * 0.5f;
 }
 
+//----------------------------------------------------------------------------------------
+vec3 AABB::getHalfExtents() const {
+    return (maxBounds - minBounds) * 0.5f;
+}
+
+//----------------------------------------------------------------------------------------
+float AABB::getSurfaceArea() const {
+    vec3 d = maxBounds - minBounds;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if this AABB and 'other' intersect, including touching faces.
+ */
+bool AABB::overlaps(const AABB & other) const {
+    return (minBounds.x <= other.maxBounds.x) && (other.minBounds.x <= maxBounds.x) &&
+           (minBounds.y <= other.maxBounds.y) && (other.minBounds.y <= maxBounds.y) &&
+           (minBounds.z <= other.maxBounds.z) && (other.minBounds.z <= maxBounds.z);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if 'other' lies entirely within this AABB.
+ */
+bool AABB::contains(const AABB & other) const {
+    return (minBounds.x <= other.minBounds.x) && (other.maxBounds.x <= maxBounds.x) &&
+           (minBounds.y <= other.minBounds.y) && (other.maxBounds.y <= maxBounds.y) &&
+           (minBounds.z <= other.minBounds.z) && (other.maxBounds.z <= maxBounds.z);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the smallest AABB enclosing both 'a' and 'b'.
+ */
+AABB AABB::combine(const AABB & a, const AABB & b) {
+    AABB result;
+    result.minBounds = glm::min(a.minBounds, b.minBounds);
+    result.maxBounds = glm::max(a.maxBounds, b.maxBounds);
+    return result;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the AABB centered at 'center' that extends 'halfExtents' to either
+ * side of it along each axis.
+ */
+AABB AABB::fromCenter(const vec3 & center, const vec3 & halfExtents) {
+    AABB result;
+    result.minBounds = center - halfExtents;
+    result.maxBounds = center + halfExtents;
+    return result;
+}
+
 } // end namespace Rigid3D
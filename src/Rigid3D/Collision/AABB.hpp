@@ -21,6 +21,18 @@ namespace Rigid3D {
         bool rayCast(const RayCastInput & input, RayCastOutput * output) const;
 
         vec3 getCenter() const;
+
+        vec3 getHalfExtents() const;
+
+        float getSurfaceArea() const;
+
+        bool overlaps(const AABB & other) const;
+
+        bool contains(const AABB & other) const;
+
+        static AABB combine(const AABB & a, const AABB & b);
+
+        static AABB fromCenter(const vec3 & center, const vec3 & halfExtents);
     };
 
 }
@@ -0,0 +1,247 @@
+#include "BatchOverlapQuery.hpp"
+
+#include <Rigid3D/Collision/DynamicAABBTree.hpp>
+#include <Rigid3D/Common/ParallelFor.hpp>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Rigid3D {
+
+using std::fabs;
+
+namespace {
+
+    struct AABBTest {
+        AABB aabb;
+
+        explicit AABBTest(const AABB & query)
+            : aabb(query) { }
+
+        bool operator () (const AABB & nodeAABB) const {
+            return nodeAABB.overlaps(aabb);
+        }
+    };
+
+    struct SphereTest {
+        vec3 center;
+        float radiusSquared;
+
+        explicit SphereTest(const SphereQuery & query)
+            : center(query.center),
+              radiusSquared(query.radius * query.radius) { }
+
+        // Squared distance from the sphere's center to the closest point in the AABB.
+        bool operator () (const AABB & nodeAABB) const {
+            float distanceSquared = 0.0f;
+            for(int i = 0; i < 3; ++i) {
+                float c = center[i];
+                if (c < nodeAABB.minBounds[i]) {
+                    float d = nodeAABB.minBounds[i] - c;
+                    distanceSquared += d * d;
+                } else if (c > nodeAABB.maxBounds[i]) {
+                    float d = c - nodeAABB.maxBounds[i];
+                    distanceSquared += d * d;
+                }
+            }
+            return distanceSquared <= radiusSquared;
+        }
+    };
+
+    /**
+     * Separating axis test between an AABB (A) and an oriented box (B), testing
+     * the 3 face axes of each box and the 9 edge-edge cross products.
+     */
+    struct BoxTest {
+        vec3 center;
+        vec3 e;            // Half extents of the oriented box.
+        float R[3][3];     // R[i][j] = dot(world axis i, box axis j)
+        float absR[3][3];  // Padded by an epsilon to handle near-parallel edges.
+
+        explicit BoxTest(const BoxQuery & query)
+            : center(query.center),
+              e(query.halfExtents) {
+            mat3 M = glm::mat3_cast(query.orientation);
+            for(int i = 0; i < 3; ++i) {
+                for(int j = 0; j < 3; ++j) {
+                    R[i][j] = M[j][i];
+                    absR[i][j] = fabs(R[i][j]) + 1.0e-6f;
+                }
+            }
+        }
+
+        bool operator () (const AABB & nodeAABB) const {
+            const vec3 a = nodeAABB.getHalfExtents();
+            const vec3 t = center - nodeAABB.getCenter();
+            float ra, rb;
+
+            // World axes, which also rejects by the box's enclosing AABB.
+            for(int i = 0; i < 3; ++i) {
+                ra = a[i];
+                rb = e[0] * absR[i][0] + e[1] * absR[i][1] + e[2] * absR[i][2];
+                if (fabs(t[i]) > ra + rb) { return false; }
+            }
+
+            // Box axes.
+            for(int j = 0; j < 3; ++j) {
+                ra = a[0] * absR[0][j] + a[1] * absR[1][j] + a[2] * absR[2][j];
+                rb = e[j];
+                if (fabs(t[0] * R[0][j] + t[1] * R[1][j] + t[2] * R[2][j]) > ra + rb) {
+                    return false;
+                }
+            }
+
+            // Cross products of world axis i with box axis j.
+            for(int j = 0; j < 3; ++j) {
+                const int j1 = (j + 1) % 3;
+                const int j2 = (j + 2) % 3;
+
+                // x cross box axis j
+                ra = a[1] * absR[2][j] + a[2] * absR[1][j];
+                rb = e[j1] * absR[0][j2] + e[j2] * absR[0][j1];
+                if (fabs(t[2] * R[1][j] - t[1] * R[2][j]) > ra + rb) { return false; }
+
+                // y cross box axis j
+                ra = a[0] * absR[2][j] + a[2] * absR[0][j];
+                rb = e[j1] * absR[1][j2] + e[j2] * absR[1][j1];
+                if (fabs(t[0] * R[2][j] - t[2] * R[0][j]) > ra + rb) { return false; }
+
+                // z cross box axis j
+                ra = a[0] * absR[1][j] + a[1] * absR[0][j];
+                rb = e[j1] * absR[2][j2] + e[j2] * absR[2][j1];
+                if (fabs(t[1] * R[0][j] - t[0] * R[1][j]) > ra + rb) { return false; }
+            }
+
+            return true;
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+BatchOverlapQuery::BatchOverlapQuery(uint32 numThreads)
+    : numThreads(resolveThreadCount(numThreads)),
+      minQueriesPerThread(64),
+      threadResults(this->numThreads) {
+
+}
+
+//----------------------------------------------------------------------------------------
+BatchOverlapQuery::~BatchOverlapQuery() {
+
+}
+
+//----------------------------------------------------------------------------------------
+template <class Query, class MakeTest>
+void BatchOverlapQuery::run(const DynamicAABBTree & tree, const Query * queries,
+        size_t numQueries, const MakeTest & makeTest) {
+    ranges.resize(numQueries);
+
+    uint32 threadsToUse = numThreads;
+    if (numQueries < minQueriesPerThread * threadsToUse) {
+        threadsToUse = std::max(uint32(1), uint32(numQueries / minQueriesPerThread));
+    }
+
+    // Each thread appends its chunk's results to its own buffer, recording
+    // offsets relative to that buffer.
+    parallelFor(numQueries, threadsToUse,
+        [&](size_t begin, size_t end, uint32 threadIndex) {
+            std::vector<int32> & out = threadResults[threadIndex];
+            out.clear();
+
+            for(size_t i = begin; i < end; ++i) {
+                QueryResultRange & range = ranges[i];
+                range.offset = static_cast<uint32>(out.size());
+
+                tree.query(makeTest(queries[i]), [&out](int32 proxyId) {
+                    out.push_back(proxyId);
+                    return true;
+                });
+
+                range.count = static_cast<uint32>(out.size()) - range.offset;
+            }
+        });
+
+    // Stitch the per-thread buffers together in chunk order.
+    size_t numResults = 0;
+    for(uint32 t = 0; t < threadsToUse; ++t) {
+        numResults += threadResults[t].size();
+    }
+    results.resize(numResults);
+
+    uint32 base = 0;
+    for(uint32 t = 0; t < threadsToUse; ++t) {
+        const std::vector<int32> & chunkResults = threadResults[t];
+        if (!chunkResults.empty()) {
+            std::memcpy(&results[base], chunkResults.data(),
+                    chunkResults.size() * sizeof(int32));
+        }
+
+        size_t begin = chunkBegin(numQueries, threadsToUse, t);
+        size_t end = chunkBegin(numQueries, threadsToUse, t + 1);
+        for(size_t i = begin; i < end; ++i) {
+            ranges[i].offset += base;
+        }
+
+        base += static_cast<uint32>(chunkResults.size());
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void BatchOverlapQuery::queryAABBs(const DynamicAABBTree & tree, const AABB * queries,
+        size_t numQueries) {
+    run(tree, queries, numQueries,
+        [](const AABB & query) { return AABBTest(query); });
+}
+
+//----------------------------------------------------------------------------------------
+void BatchOverlapQuery::querySpheres(const DynamicAABBTree & tree,
+        const SphereQuery * queries, size_t numQueries) {
+    run(tree, queries, numQueries,
+        [](const SphereQuery & query) { return SphereTest(query); });
+}
+
+//----------------------------------------------------------------------------------------
+void BatchOverlapQuery::queryBoxes(const DynamicAABBTree & tree,
+        const BoxQuery * queries, size_t numQueries) {
+    run(tree, queries, numQueries,
+        [](const BoxQuery & query) { return BoxTest(query); });
+}
+
+//----------------------------------------------------------------------------------------
+size_t BatchOverlapQuery::getNumQueries() const {
+    return ranges.size();
+}
+
+//----------------------------------------------------------------------------------------
+const QueryResultRange & BatchOverlapQuery::getRange(size_t queryIndex) const {
+    return ranges[queryIndex];
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return proxy ids overlapping each query, grouped by query in query order.
+ */
+const int32 * BatchOverlapQuery::getResults() const {
+    return results.data();
+}
+
+//----------------------------------------------------------------------------------------
+size_t BatchOverlapQuery::getNumResults() const {
+    return results.size();
+}
+
+//----------------------------------------------------------------------------------------
+uint32 BatchOverlapQuery::getNumThreads() const {
+    return numThreads;
+}
+
+//----------------------------------------------------------------------------------------
+void BatchOverlapQuery::setMinQueriesPerThread(size_t minQueries) {
+    minQueriesPerThread = std::max(size_t(1), minQueries);
+}
+
+}
@@ -0,0 +1,111 @@
+/**
+ * @brief BatchOverlapQuery
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_BATCHOVERLAPQUERY_HPP_
+#define RIGID3D_BATCHOVERLAPQUERY_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Collision/AABB.hpp>
+
+#include <vector>
+
+// Forward Declarations
+namespace Rigid3D {
+    class DynamicAABBTree;
+}
+
+namespace Rigid3D {
+
+    struct SphereQuery {
+        vec3 center;
+        float radius;
+    };
+
+    /**
+     * Oriented box, with 'halfExtents' given along the axes of 'orientation'.
+     */
+    struct BoxQuery {
+        vec3 center;
+        vec3 halfExtents;
+        quat orientation;
+    };
+
+    /**
+     * Location of one query's results within BatchOverlapQuery::getResults().
+     */
+    struct QueryResultRange {
+        uint32 offset;
+        uint32 count;
+    };
+
+    /**
+     * @brief Runs many overlap queries against a DynamicAABBTree at once.
+     *
+     * Queries are split into contiguous chunks, one per thread, and each query
+     * traverses the tree once.  Results are the proxy ids whose fat AABBs
+     * overlap the query volume, and are written into a single pooled buffer,
+     * with getRange(i) giving the offset and count of query i's results.
+     *
+     * Result storage is kept between calls, so once it has grown to fit a
+     * typical frame's queries, running a batch performs no allocation.
+     *
+     * \code{.cpp}
+     *  BatchOverlapQuery overlaps;
+     *  overlaps.querySpheres(tree, spheres, numSpheres);
+     *
+     *  for(size_t i = 0; i < numSpheres; ++i) {
+     *      const QueryResultRange & range = overlaps.getRange(i);
+     *      for(uint32 j = 0; j < range.count; ++j) {
+     *          int32 proxyId = overlaps.getResults()[range.offset + j];
+     *      }
+     *  }
+     * \endcode
+     */
+    class BatchOverlapQuery {
+    public:
+        // Zero uses one thread per hardware thread.
+        explicit BatchOverlapQuery(uint32 numThreads = 0);
+
+        ~BatchOverlapQuery();
+
+        void queryAABBs(const DynamicAABBTree & tree, const AABB * queries,
+                size_t numQueries);
+
+        void querySpheres(const DynamicAABBTree & tree, const SphereQuery * queries,
+                size_t numQueries);
+
+        void queryBoxes(const DynamicAABBTree & tree, const BoxQuery * queries,
+                size_t numQueries);
+
+        size_t getNumQueries() const;
+
+        const QueryResultRange & getRange(size_t queryIndex) const;
+
+        const int32 * getResults() const;
+
+        size_t getNumResults() const;
+
+        uint32 getNumThreads() const;
+
+        // Queries per thread below which a batch runs on the calling thread only.
+        void setMinQueriesPerThread(size_t minQueries);
+
+    private:
+        template <class Query, class MakeTest>
+        void run(const DynamicAABBTree & tree, const Query * queries,
+                size_t numQueries, const MakeTest & makeTest);
+
+        uint32 numThreads;
+        size_t minQueriesPerThread;
+
+        std::vector<std::vector<int32>> threadResults;
+        std::vector<QueryResultRange> ranges;
+        std::vector<int32> results;
+    };
+
+}
+
+#endif /* RIGID3D_BATCHOVERLAPQUERY_HPP_ */
@@ -0,0 +1,35 @@
+/**
+ * @brief ContactEvent
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_CONTACTEVENT_HPP_
+#define RIGID3D_CONTACTEVENT_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+namespace Rigid3D {
+
+    enum class ContactEventType : uint8 {
+        Begin,   // Pair started touching this step.
+        Persist, // Pair was touching last step and is still touching.
+        End      // Pair was touching last step and has now separated.
+    };
+
+    /**
+     * Change in the touching state of a pair of shapes over one step.
+     *
+     * For contact events shapeA < shapeB.  For trigger events shapeA is the
+     * trigger shape and shapeB the shape overlapping it.
+     */
+    struct ContactEvent {
+        uint32 shapeA;
+        uint32 shapeB;
+        ContactEventType type;
+        bool isTrigger;
+    };
+
+}
+
+#endif /* RIGID3D_CONTACTEVENT_HPP_ */
@@ -0,0 +1,263 @@
+#include "ContactEventStream.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+
+#include <algorithm>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+bool ContactEventStream::TouchingPair::operator < (const TouchingPair & other) const {
+    if (isTrigger != other.isTrigger) {
+        return isTrigger < other.isTrigger;
+    }
+    if (shapeA != other.shapeA) {
+        return shapeA < other.shapeA;
+    }
+    return shapeB < other.shapeB;
+}
+
+//----------------------------------------------------------------------------------------
+bool ContactEventStream::TouchingPair::operator == (const TouchingPair & other) const {
+    return (shapeA == other.shapeA) && (shapeB == other.shapeB) &&
+           (isTrigger == other.isTrigger);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param numThreads - number of worker threads that will report pairs.
+ * @param maxPairsPerThread - capacity of each thread's ring buffer.
+ * @param maxTouchingPairs - capacity of the merged pair array.  Zero uses
+ * numThreads * maxPairsPerThread.  Choose a larger value when drain() is called
+ * during the step to keep ring buffers small.
+ */
+ContactEventStream::ContactEventStream(uint32 numThreads, size_t maxPairsPerThread,
+        size_t maxTouchingPairs)
+    : numCurrentPairs(0),
+      numPreviousPairs(0),
+      numEvents(0),
+      numDroppedPairs(0) {
+
+    if (numThreads == 0) {
+        throw Rigid3DException("ContactEventStream requires at least one thread.");
+    }
+    if (maxPairsPerThread == 0) {
+        throw Rigid3DException("ContactEventStream requires maxPairsPerThread > 0.");
+    }
+
+    for(uint32 i = 0; i < numThreads; ++i) {
+        rings.emplace_back(new SpscRingBuffer<TouchingPair>(maxPairsPerThread));
+    }
+    ringDropCounts.reset(new std::atomic<size_t>[numThreads]);
+    for(uint32 i = 0; i < numThreads; ++i) {
+        ringDropCounts[i].store(0, std::memory_order_relaxed);
+    }
+
+    const size_t maxPairs = (maxTouchingPairs > 0) ? maxTouchingPairs :
+            numThreads * maxPairsPerThread;
+    currentPairs.resize(maxPairs);
+    previousPairs.resize(maxPairs);
+
+    // Every current pair emits Begin or Persist, and every previous pair not
+    // touching anymore emits End.
+    events.resize(2 * maxPairs);
+}
+
+//----------------------------------------------------------------------------------------
+ContactEventStream::~ContactEventStream() {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Discards anything reported since the last call to endStep().  Must not be
+ * called while worker threads are reporting.
+ */
+void ContactEventStream::beginStep() {
+    TouchingPair discarded;
+    for(auto & ring : rings) {
+        while (ring->pop(discarded)) { }
+    }
+    for(uint32 i = 0; i < getNumThreads(); ++i) {
+        ringDropCounts[i].store(0, std::memory_order_relaxed);
+    }
+
+    numCurrentPairs = 0;
+    numDroppedPairs = 0;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Reports that shapes \a shapeA and \a shapeB are touching during this step.
+ *
+ * @return false if the pair was dropped because the thread's ring buffer is full.
+ */
+bool ContactEventStream::reportContact(uint32 threadIndex, uint32 shapeA,
+        uint32 shapeB) {
+    TouchingPair pair;
+    pair.shapeA = std::min(shapeA, shapeB);
+    pair.shapeB = std::max(shapeA, shapeB);
+    pair.isTrigger = 0;
+
+    return report(threadIndex, pair);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Reports that \a otherShape overlaps trigger shape \a triggerShape during this
+ * step.
+ *
+ * @return false if the pair was dropped because the thread's ring buffer is full.
+ */
+bool ContactEventStream::reportTriggerOverlap(uint32 threadIndex, uint32 triggerShape,
+        uint32 otherShape) {
+    TouchingPair pair;
+    pair.shapeA = triggerShape;
+    pair.shapeB = otherShape;
+    pair.isTrigger = 1;
+
+    return report(threadIndex, pair);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @throws Rigid3DException if 'threadIndex' is not less than getNumThreads().
+ */
+bool ContactEventStream::report(uint32 threadIndex, const TouchingPair & pair) {
+    if (threadIndex >= getNumThreads()) {
+        throw Rigid3DException("Invalid thread index passed to "
+                "ContactEventStream::report.");
+    }
+    if (rings[threadIndex]->push(pair)) {
+        return true;
+    }
+
+    ringDropCounts[threadIndex].fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+//----------------------------------------------------------------------------------------
+void ContactEventStream::drain() {
+    const size_t maxPairs = currentPairs.size();
+    TouchingPair discarded;
+
+    for(auto & ring : rings) {
+        numCurrentPairs += ring->popMany(currentPairs.data() + numCurrentPairs,
+                maxPairs - numCurrentPairs);
+
+        // The merged array can only fill up when pairs are reported more than
+        // once before being de-duplicated by endStep().
+        if (numCurrentPairs == maxPairs) {
+            while (ring->pop(discarded)) {
+                ++numDroppedPairs;
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Merges the pairs reported during this step and generates events.  Must not be
+ * called while worker threads are reporting.
+ */
+void ContactEventStream::endStep() {
+    drain();
+
+    for(uint32 i = 0; i < getNumThreads(); ++i) {
+        numDroppedPairs += ringDropCounts[i].exchange(0, std::memory_order_relaxed);
+    }
+
+    // Sort, and remove pairs reported more than once.
+    TouchingPair * first = currentPairs.data();
+    std::sort(first, first + numCurrentPairs);
+    numCurrentPairs = std::unique(first, first + numCurrentPairs) - first;
+
+    // Both pair arrays are sorted, so a single merge pass classifies every pair.
+    numEvents = 0;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < numCurrentPairs && j < numPreviousPairs) {
+        const TouchingPair & current = currentPairs[i];
+        const TouchingPair & previous = previousPairs[j];
+        if (current < previous) {
+            emit(current, ContactEventType::Begin);
+            ++i;
+        } else if (previous < current) {
+            emit(previous, ContactEventType::End);
+            ++j;
+        } else {
+            emit(current, ContactEventType::Persist);
+            ++i;
+            ++j;
+        }
+    }
+    for(; i < numCurrentPairs; ++i) {
+        emit(currentPairs[i], ContactEventType::Begin);
+    }
+    for(; j < numPreviousPairs; ++j) {
+        emit(previousPairs[j], ContactEventType::End);
+    }
+
+    // Swapping vectors exchanges their buffers without allocating.
+    currentPairs.swap(previousPairs);
+    numPreviousPairs = numCurrentPairs;
+    numCurrentPairs = 0;
+}
+
+//----------------------------------------------------------------------------------------
+void ContactEventStream::emit(const TouchingPair & pair, ContactEventType type) {
+    ContactEvent & event = events[numEvents++];
+    event.shapeA = pair.shapeA;
+    event.shapeB = pair.shapeB;
+    event.type = type;
+    event.isTrigger = (pair.isTrigger != 0);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return events generated by the last call to endStep(), sorted with contact
+ * events first, then by shapeA, then by shapeB.
+ */
+const ContactEvent * ContactEventStream::getEvents() const {
+    return events.data();
+}
+
+//----------------------------------------------------------------------------------------
+size_t ContactEventStream::getNumEvents() const {
+    return numEvents;
+}
+
+//----------------------------------------------------------------------------------------
+const ContactEvent * ContactEventStream::begin() const {
+    return events.data();
+}
+
+//----------------------------------------------------------------------------------------
+const ContactEvent * ContactEventStream::end() const {
+    return events.data() + numEvents;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of distinct pairs touching as of the last call to endStep().
+ */
+size_t ContactEventStream::getNumTouchingPairs() const {
+    return numPreviousPairs;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of pairs dropped during the last step because a ring buffer or
+ * the merged pair array was full.  A dropped pair that was touching during the
+ * previous step is reported as an End event.
+ */
+size_t ContactEventStream::getNumDroppedPairs() const {
+    return numDroppedPairs;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 ContactEventStream::getNumThreads() const {
+    return static_cast<uint32>(rings.size());
+}
+
+}
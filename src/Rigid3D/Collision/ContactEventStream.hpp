@@ -0,0 +1,119 @@
+/**
+ * @brief ContactEventStream
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_CONTACTEVENTSTREAM_HPP_
+#define RIGID3D_CONTACTEVENTSTREAM_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Common/SpscRingBuffer.hpp>
+#include <Rigid3D/Collision/ContactEvent.hpp>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Collects touching pairs from narrow-phase worker threads and turns
+     * them into begin/persist/end contact and trigger events once per step.
+     *
+     * Each worker thread reports the pairs it finds touching into its own
+     * lock-free ring buffer, identified by 'threadIndex'.  ContactEventStream::endStep()
+     * drains every ring, sorts and de-duplicates the pairs, and compares them
+     * against the pairs touching during the previous step, producing a flat
+     * array of events sorted by pair.  The order of events is therefore
+     * independent of how pairs were distributed across threads.
+     *
+     * All storage is allocated by the constructor.  Nothing is allocated and no
+     * callbacks are made during a step.  Pairs that do not fit in a full ring or
+     * in the merged pair array are dropped and counted by getNumDroppedPairs().
+     *
+     * \code{.cpp}
+     *  ContactEventStream events(numThreads, maxPairsPerThread);
+     *
+     *  events.beginStep();
+     *  // On worker thread 't':
+     *  events.reportContact(t, shapeA, shapeB);
+     *  // After all workers are done:
+     *  events.endStep();
+     *
+     *  for(const ContactEvent & event : events) { ... }
+     * \endcode
+     */
+    class ContactEventStream {
+    public:
+        ContactEventStream(uint32 numThreads, size_t maxPairsPerThread,
+                size_t maxTouchingPairs = 0);
+
+        ~ContactEventStream();
+
+        void beginStep();
+
+        // Thread safe, provided each thread uses its own 'threadIndex'.
+        bool reportContact(uint32 threadIndex, uint32 shapeA, uint32 shapeB);
+
+        // Thread safe, provided each thread uses its own 'threadIndex'.
+        bool reportTriggerOverlap(uint32 threadIndex, uint32 triggerShape,
+                uint32 otherShape);
+
+        // Moves pairs out of the ring buffers.  May be called by the thread that
+        // owns this stream while workers are still reporting, to keep rings from
+        // filling up.
+        void drain();
+
+        void endStep();
+
+        const ContactEvent * getEvents() const;
+
+        size_t getNumEvents() const;
+
+        const ContactEvent * begin() const;
+
+        const ContactEvent * end() const;
+
+        size_t getNumTouchingPairs() const;
+
+        size_t getNumDroppedPairs() const;
+
+        uint32 getNumThreads() const;
+
+    private:
+        ContactEventStream(const ContactEventStream &);
+        ContactEventStream & operator = (const ContactEventStream &);
+
+        // Contact pairs sort before trigger pairs, then by shapeA, then by shapeB.
+        struct TouchingPair {
+            uint32 shapeA;
+            uint32 shapeB;
+            uint32 isTrigger;
+
+            bool operator < (const TouchingPair & other) const;
+            bool operator == (const TouchingPair & other) const;
+        };
+
+        bool report(uint32 threadIndex, const TouchingPair & pair);
+
+        void emit(const TouchingPair & pair, ContactEventType type);
+
+        std::vector<std::unique_ptr<SpscRingBuffer<TouchingPair>>> rings;
+        std::unique_ptr<std::atomic<size_t>[]> ringDropCounts;
+
+        std::vector<TouchingPair> currentPairs;
+        size_t numCurrentPairs;
+
+        std::vector<TouchingPair> previousPairs;
+        size_t numPreviousPairs;
+
+        std::vector<ContactEvent> events;
+        size_t numEvents;
+
+        size_t numDroppedPairs;
+    };
+
+}
+
+#endif /* RIGID3D_CONTACTEVENTSTREAM_HPP_ */
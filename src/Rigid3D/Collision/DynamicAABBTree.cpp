@@ -0,0 +1,409 @@
+#include "DynamicAABBTree.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+
+#include <algorithm>
+
+namespace Rigid3D {
+
+using std::max;
+
+// Fat AABBs are extended along the direction of motion by this multiple of a
+// proxy's displacement.
+static const float displacementMultiplier = 2.0f;
+
+//----------------------------------------------------------------------------------------
+DynamicAABBTree::DynamicAABBTree(float aabbMargin)
+    : root(nullNode),
+      freeList(nullNode),
+      proxyCount(0),
+      aabbMargin(aabbMargin) {
+
+}
+
+//----------------------------------------------------------------------------------------
+DynamicAABBTree::~DynamicAABBTree() {
+
+}
+
+//----------------------------------------------------------------------------------------
+int32 DynamicAABBTree::allocateNode() {
+    if (freeList == nullNode) {
+        DynamicTreeNode node;
+        node.parent = nullNode;
+        node.height = -1;
+        nodes.push_back(node);
+        freeList = static_cast<int32>(nodes.size()) - 1;
+    }
+
+    int32 nodeId = freeList;
+    DynamicTreeNode & node = nodes[nodeId];
+    freeList = node.parent;
+    node.parent = nullNode;
+    node.child1 = nullNode;
+    node.child2 = nullNode;
+    node.height = 0;
+    node.userData = 0;
+
+    return nodeId;
+}
+
+//----------------------------------------------------------------------------------------
+void DynamicAABBTree::freeNode(int32 nodeId) {
+    nodes[nodeId].parent = freeList;
+    nodes[nodeId].height = -1;
+    freeList = nodeId;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Creates a proxy whose fat AABB encloses 'aabb' plus the tree's margin.
+ *
+ * @return proxy id, used to move or destroy the proxy.
+ */
+int32 DynamicAABBTree::createProxy(const AABB & aabb, uint32 userData) {
+    int32 proxyId = allocateNode();
+
+    vec3 margin(aabbMargin, aabbMargin, aabbMargin);
+    DynamicTreeNode & node = nodes[proxyId];
+    node.aabb.minBounds = aabb.minBounds - margin;
+    node.aabb.maxBounds = aabb.maxBounds + margin;
+    node.userData = userData;
+
+    insertLeaf(proxyId);
+    ++proxyCount;
+
+    return proxyId;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if 'nodeId' is a live leaf, as returned by createProxy() and not
+ * since destroyed.
+ */
+bool DynamicAABBTree::isProxy(int32 nodeId) const {
+    return nodeId >= 0 && nodeId < int32(nodes.size()) && nodes[nodeId].isLeaf() &&
+           nodes[nodeId].height == 0;
+}
+
+//----------------------------------------------------------------------------------------
+void DynamicAABBTree::destroyProxy(int32 proxyId) {
+    if (!isProxy(proxyId)) {
+        throw Rigid3DException("Invalid proxy id passed to DynamicAABBTree::destroyProxy.");
+    }
+
+    removeLeaf(proxyId);
+    freeNode(proxyId);
+    --proxyCount;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Updates a proxy with its new tight 'aabb', and the 'displacement' of its shape
+ * since the last update.
+ *
+ * @return true if the proxy's fat AABB was recomputed and the proxy reinserted,
+ * or false if 'aabb' still fits within its fat AABB.
+ *
+ * @throws Rigid3DException if 'proxyId' is not a live proxy.
+ */
+bool DynamicAABBTree::moveProxy(int32 proxyId, const AABB & aabb,
+        const vec3 & displacement) {
+    if (!isProxy(proxyId)) {
+        throw Rigid3DException("Invalid proxy id passed to DynamicAABBTree::moveProxy.");
+    }
+
+    if (nodes[proxyId].aabb.contains(aabb)) {
+        return false;
+    }
+
+    removeLeaf(proxyId);
+
+    vec3 margin(aabbMargin, aabbMargin, aabbMargin);
+    AABB fatAABB;
+    fatAABB.minBounds = aabb.minBounds - margin;
+    fatAABB.maxBounds = aabb.maxBounds + margin;
+
+    // Predict the motion over the next step.
+    vec3 d = displacement * displacementMultiplier;
+    for(int i = 0; i < 3; ++i) {
+        if (d[i] < 0.0f) {
+            fatAABB.minBounds[i] += d[i];
+        } else {
+            fatAABB.maxBounds[i] += d[i];
+        }
+    }
+
+    nodes[proxyId].aabb = fatAABB;
+    insertLeaf(proxyId);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+const AABB & DynamicAABBTree::getFatAABB(int32 proxyId) const {
+    return nodes[proxyId].aabb;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 DynamicAABBTree::getUserData(int32 proxyId) const {
+    return nodes[proxyId].userData;
+}
+
+//----------------------------------------------------------------------------------------
+int32 DynamicAABBTree::getProxyCount() const {
+    return proxyCount;
+}
+
+//----------------------------------------------------------------------------------------
+int32 DynamicAABBTree::getRoot() const {
+    return root;
+}
+
+//----------------------------------------------------------------------------------------
+const DynamicTreeNode & DynamicAABBTree::getNode(int32 nodeId) const {
+    return nodes[nodeId];
+}
+
+//----------------------------------------------------------------------------------------
+int32 DynamicAABBTree::getHeight() const {
+    return (root == nullNode) ? 0 : nodes[root].height;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Inserts 'leaf' next to the sibling that minimizes the increase in total
+ * surface area of the tree.
+ */
+void DynamicAABBTree::insertLeaf(int32 leaf) {
+    if (root == nullNode) {
+        root = leaf;
+        nodes[root].parent = nullNode;
+        return;
+    }
+
+    const AABB leafAABB = nodes[leaf].aabb;
+
+    // Find the best sibling.
+    int32 index = root;
+    while (!nodes[index].isLeaf()) {
+        int32 child1 = nodes[index].child1;
+        int32 child2 = nodes[index].child2;
+
+        float area = nodes[index].aabb.getSurfaceArea();
+        float combinedArea = AABB::combine(nodes[index].aabb, leafAABB).getSurfaceArea();
+
+        // Cost of creating a new parent for this node and the new leaf.
+        float cost = 2.0f * combinedArea;
+
+        // Minimum cost of pushing the leaf further down the tree.
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float cost1 = AABB::combine(leafAABB, nodes[child1].aabb).getSurfaceArea() +
+                inheritanceCost;
+        if (!nodes[child1].isLeaf()) {
+            cost1 -= nodes[child1].aabb.getSurfaceArea();
+        }
+
+        float cost2 = AABB::combine(leafAABB, nodes[child2].aabb).getSurfaceArea() +
+                inheritanceCost;
+        if (!nodes[child2].isLeaf()) {
+            cost2 -= nodes[child2].aabb.getSurfaceArea();
+        }
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+
+        index = (cost1 < cost2) ? child1 : child2;
+    }
+
+    int32 sibling = index;
+
+    // Create a new parent.  allocateNode() may grow 'nodes', so no references
+    // into it are held across the call.
+    int32 oldParent = nodes[sibling].parent;
+    int32 newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].aabb = AABB::combine(leafAABB, nodes[sibling].aabb);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent != nullNode) {
+        if (nodes[oldParent].child1 == sibling) {
+            nodes[oldParent].child1 = newParent;
+        } else {
+            nodes[oldParent].child2 = newParent;
+        }
+    } else {
+        root = newParent;
+    }
+
+    refit(nodes[leaf].parent);
+}
+
+//----------------------------------------------------------------------------------------
+void DynamicAABBTree::removeLeaf(int32 leaf) {
+    if (leaf == root) {
+        root = nullNode;
+        return;
+    }
+
+    int32 parent = nodes[leaf].parent;
+    int32 grandParent = nodes[parent].parent;
+    int32 sibling = (nodes[parent].child1 == leaf) ? nodes[parent].child2 :
+            nodes[parent].child1;
+
+    if (grandParent != nullNode) {
+        // Replace the parent with the sibling.
+        if (nodes[grandParent].child1 == parent) {
+            nodes[grandParent].child1 = sibling;
+        } else {
+            nodes[grandParent].child2 = sibling;
+        }
+        nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        refit(grandParent);
+    } else {
+        root = sibling;
+        nodes[sibling].parent = nullNode;
+        freeNode(parent);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Walks from 'nodeId' up to the root, rebalancing and recomputing AABBs and
+ * heights.
+ */
+void DynamicAABBTree::refit(int32 nodeId) {
+    int32 index = nodeId;
+    while (index != nullNode) {
+        index = balance(index);
+
+        int32 child1 = nodes[index].child1;
+        int32 child2 = nodes[index].child2;
+        nodes[index].height = 1 + max(nodes[child1].height, nodes[child2].height);
+        nodes[index].aabb = AABB::combine(nodes[child1].aabb, nodes[child2].aabb);
+
+        index = nodes[index].parent;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Performs a left or right rotation if node A is imbalanced.
+ *
+ * @return the index of the node now at A's position in the tree.
+ */
+int32 DynamicAABBTree::balance(int32 iA) {
+    DynamicTreeNode * A = &nodes[iA];
+    if (A->isLeaf() || A->height < 2) {
+        return iA;
+    }
+
+    int32 iB = A->child1;
+    int32 iC = A->child2;
+    DynamicTreeNode * B = &nodes[iB];
+    DynamicTreeNode * C = &nodes[iC];
+
+    int32 balance = C->height - B->height;
+
+    // Rotate C up.
+    if (balance > 1) {
+        int32 iF = C->child1;
+        int32 iG = C->child2;
+        DynamicTreeNode * F = &nodes[iF];
+        DynamicTreeNode * G = &nodes[iG];
+
+        // Swap A and C.
+        C->child1 = iA;
+        C->parent = A->parent;
+        A->parent = iC;
+
+        // A's old parent should point to C.
+        if (C->parent != nullNode) {
+            if (nodes[C->parent].child1 == iA) {
+                nodes[C->parent].child1 = iC;
+            } else {
+                nodes[C->parent].child2 = iC;
+            }
+        } else {
+            root = iC;
+        }
+
+        // Rotate.
+        if (F->height > G->height) {
+            C->child2 = iF;
+            A->child2 = iG;
+            G->parent = iA;
+            A->aabb = AABB::combine(B->aabb, G->aabb);
+            C->aabb = AABB::combine(A->aabb, F->aabb);
+            A->height = 1 + max(B->height, G->height);
+            C->height = 1 + max(A->height, F->height);
+        } else {
+            C->child2 = iG;
+            A->child2 = iF;
+            F->parent = iA;
+            A->aabb = AABB::combine(B->aabb, F->aabb);
+            C->aabb = AABB::combine(A->aabb, G->aabb);
+            A->height = 1 + max(B->height, F->height);
+            C->height = 1 + max(A->height, G->height);
+        }
+
+        return iC;
+    }
+
+    // Rotate B up.
+    if (balance < -1) {
+        int32 iD = B->child1;
+        int32 iE = B->child2;
+        DynamicTreeNode * D = &nodes[iD];
+        DynamicTreeNode * E = &nodes[iE];
+
+        // Swap A and B.
+        B->child1 = iA;
+        B->parent = A->parent;
+        A->parent = iB;
+
+        // A's old parent should point to B.
+        if (B->parent != nullNode) {
+            if (nodes[B->parent].child1 == iA) {
+                nodes[B->parent].child1 = iB;
+            } else {
+                nodes[B->parent].child2 = iB;
+            }
+        } else {
+            root = iB;
+        }
+
+        // Rotate.
+        if (D->height > E->height) {
+            B->child2 = iD;
+            A->child1 = iE;
+            E->parent = iA;
+            A->aabb = AABB::combine(C->aabb, E->aabb);
+            B->aabb = AABB::combine(A->aabb, D->aabb);
+            A->height = 1 + max(C->height, E->height);
+            B->height = 1 + max(A->height, D->height);
+        } else {
+            B->child2 = iE;
+            A->child1 = iD;
+            D->parent = iA;
+            A->aabb = AABB::combine(C->aabb, D->aabb);
+            B->aabb = AABB::combine(A->aabb, E->aabb);
+            A->height = 1 + max(C->height, D->height);
+            B->height = 1 + max(A->height, E->height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
+
+}
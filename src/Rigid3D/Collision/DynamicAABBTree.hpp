@@ -0,0 +1,247 @@
+/**
+ * @brief DynamicAABBTree
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_DYNAMICAABBTREE_HPP_
+#define RIGID3D_DYNAMICAABBTREE_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Collision/AABB.hpp>
+
+#include <vector>
+
+namespace Rigid3D {
+
+    const int32 nullNode = -1;
+
+    struct DynamicTreeNode {
+        AABB aabb;         // Fat AABB for leaves, union of children otherwise.
+        uint32 userData;   // Only meaningful for leaves.
+        int32 parent;      // Next free node, when on the free list.
+        int32 child1;
+        int32 child2;
+        int32 height;      // Zero for leaves, -1 for free nodes.
+
+        bool isLeaf() const { return child1 == nullNode; }
+    };
+
+    /**
+     * How much of an AABB lies within a query volume.
+     */
+    enum class Containment {
+        Outside,
+        Partial,
+        Inside
+    };
+
+    /**
+     * @brief Bounding volume hierarchy of AABBs, used as the broad-phase.
+     *
+     * Each proxy is stored in a leaf, with an AABB enlarged by a margin so that
+     * small motions do not require updating the tree.  Leaves are inserted by
+     * the surface area heuristic, and the tree is kept balanced by rotations.
+     *
+     * Proxy ids are node indices, so they stay valid until the proxy is
+     * destroyed.
+     */
+    class DynamicAABBTree {
+    public:
+        explicit DynamicAABBTree(float aabbMargin = 0.1f);
+
+        ~DynamicAABBTree();
+
+        int32 createProxy(const AABB & aabb, uint32 userData);
+
+        void destroyProxy(int32 proxyId);
+
+        bool moveProxy(int32 proxyId, const AABB & aabb, const vec3 & displacement);
+
+        const AABB & getFatAABB(int32 proxyId) const;
+
+        uint32 getUserData(int32 proxyId) const;
+
+        int32 getProxyCount() const;
+
+        int32 getRoot() const;
+
+        const DynamicTreeNode & getNode(int32 nodeId) const;
+
+        int32 getHeight() const;
+
+        // Calls 'callback(proxyId)' for every proxy whose fat AABB overlaps 'aabb'.
+        // Traversal stops early if 'callback' returns false.
+        template <class Callback>
+        void query(const AABB & aabb, Callback && callback) const;
+
+        // Calls 'callback(proxyId)' for every proxy for which 'overlapTest(nodeAABB)'
+        // returns true for its leaf and all of its ancestors.  Traversal stops
+        // early if 'callback' returns false.
+        template <class OverlapTest, class Callback>
+        void query(const OverlapTest & overlapTest, Callback && callback) const;
+
+        // Calls 'callback(proxyId)' for every proxy whose fat AABB is at least
+        // partly within the volume classified by 'containmentTest(nodeAABB)',
+        // which returns a Containment.  Subtrees found Inside are reported
+        // without testing their descendants, and leaves found Partial are
+        // reported.  Traversal stops early if 'callback' returns false.
+        template <class ContainmentTest, class Callback>
+        void queryContainment(const ContainmentTest & containmentTest,
+                Callback && callback) const;
+
+    private:
+        bool isProxy(int32 nodeId) const;
+
+        int32 allocateNode();
+
+        void freeNode(int32 nodeId);
+
+        void insertLeaf(int32 leaf);
+
+        void removeLeaf(int32 leaf);
+
+        int32 balance(int32 nodeId);
+
+        void refit(int32 nodeId);
+
+        template <class Callback>
+        bool reportSubtree(int32 nodeId, Callback && callback) const;
+
+        std::vector<DynamicTreeNode> nodes;
+        int32 root;
+        int32 freeList;
+        int32 proxyCount;
+        float aabbMargin;
+    };
+
+    /**
+     * Traversal stack that lives on the call stack for typical tree depths, and
+     * only falls back to the heap for unusually deep trees.
+     */
+    class NodeStack {
+    public:
+        NodeStack() : count(0) { }
+
+        void push(int32 nodeId) {
+            if (count < fixedCapacity) {
+                fixed[count] = nodeId;
+            } else {
+                overflow.push_back(nodeId);
+            }
+            ++count;
+        }
+
+        int32 pop() {
+            --count;
+            if (count < fixedCapacity) {
+                return fixed[count];
+            }
+            int32 nodeId = overflow.back();
+            overflow.pop_back();
+            return nodeId;
+        }
+
+        bool empty() const { return count == 0; }
+
+    private:
+        static const size_t fixedCapacity = 128;
+        int32 fixed[fixedCapacity];
+        std::vector<int32> overflow;
+        size_t count;
+    };
+
+    //------------------------------------------------------------------------------------
+    template <class Callback>
+    inline void DynamicAABBTree::query(const AABB & aabb, Callback && callback) const {
+        query([&aabb](const AABB & nodeAABB) { return nodeAABB.overlaps(aabb); },
+              callback);
+    }
+
+    //------------------------------------------------------------------------------------
+    template <class OverlapTest, class Callback>
+    inline void DynamicAABBTree::query(const OverlapTest & overlapTest,
+            Callback && callback) const {
+        if (root == nullNode) {
+            return;
+        }
+
+        NodeStack stack;
+        stack.push(root);
+
+        while (!stack.empty()) {
+            const DynamicTreeNode & node = nodes[stack.pop()];
+            if (!overlapTest(node.aabb)) {
+                continue;
+            }
+
+            if (node.isLeaf()) {
+                int32 proxyId = static_cast<int32>(&node - nodes.data());
+                if (!callback(proxyId)) {
+                    return;
+                }
+            } else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    template <class ContainmentTest, class Callback>
+    inline void DynamicAABBTree::queryContainment(const ContainmentTest & containmentTest,
+            Callback && callback) const {
+        if (root == nullNode) {
+            return;
+        }
+
+        NodeStack stack;
+        stack.push(root);
+
+        while (!stack.empty()) {
+            const int32 nodeId = stack.pop();
+            const DynamicTreeNode & node = nodes[nodeId];
+
+            Containment containment = containmentTest(node.aabb);
+            if (containment == Containment::Outside) {
+                continue;
+            }
+
+            if (containment == Containment::Inside || node.isLeaf()) {
+                if (!reportSubtree(nodeId, callback)) {
+                    return;
+                }
+            } else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Calls 'callback(proxyId)' for every leaf under 'nodeId'.  Returns false if
+    // 'callback' stopped the traversal.
+    template <class Callback>
+    inline bool DynamicAABBTree::reportSubtree(int32 nodeId, Callback && callback) const {
+        NodeStack stack;
+        stack.push(nodeId);
+
+        while (!stack.empty()) {
+            const int32 id = stack.pop();
+            const DynamicTreeNode & node = nodes[id];
+
+            if (node.isLeaf()) {
+                if (!callback(id)) {
+                    return false;
+                }
+            } else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+        return true;
+    }
+
+}
+
+#endif /* RIGID3D_DYNAMICAABBTREE_HPP_ */
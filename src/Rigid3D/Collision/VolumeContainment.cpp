@@ -0,0 +1,122 @@
+#include "VolumeContainment.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Rigid3D {
+
+using glm::dot;
+using std::fabs;
+
+//----------------------------------------------------------------------------------------
+FrustumContainment::FrustumContainment(const vec4 * planes) {
+    for(int i = 0; i < 6; ++i) {
+        this->planes[i] = planes[i];
+        absNormals[i] = glm::abs(vec3(planes[i]));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Compares the distance of the AABB's center from each plane to the AABB's
+ * extent along the plane normal.
+ */
+Containment FrustumContainment::operator () (const AABB & aabb) const {
+    const vec3 center = aabb.getCenter();
+    const vec3 halfExtents = aabb.getHalfExtents();
+
+    Containment result = Containment::Inside;
+    for(int i = 0; i < 6; ++i) {
+        const float distance = dot(vec3(planes[i]), center) + planes[i].w;
+        const float radius = dot(absNormals[i], halfExtents);
+        if (distance + radius < 0.0f) {
+            return Containment::Outside;
+        }
+        if (distance - radius < 0.0f) {
+            result = Containment::Partial;
+        }
+    }
+    return result;
+}
+
+//----------------------------------------------------------------------------------------
+SphereContainment::SphereContainment(const vec3 & center, float radius)
+    : center(center),
+      radiusSquared(radius * radius) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Compares the squared distances from the sphere's center to the closest and
+ * furthest points of the AABB to the squared radius.
+ */
+Containment SphereContainment::operator () (const AABB & aabb) const {
+    float nearSquared = 0.0f;
+    float farSquared = 0.0f;
+    for(int i = 0; i < 3; ++i) {
+        const float toMin = center[i] - aabb.minBounds[i];
+        const float toMax = aabb.maxBounds[i] - center[i];
+        if (toMin < 0.0f) {
+            nearSquared += toMin * toMin;
+        } else if (toMax < 0.0f) {
+            nearSquared += toMax * toMax;
+        }
+        const float far = fabs(toMin) > fabs(toMax) ? toMin : toMax;
+        farSquared += far * far;
+    }
+
+    if (nearSquared > radiusSquared) {
+        return Containment::Outside;
+    }
+    return (farSquared <= radiusSquared) ? Containment::Inside : Containment::Partial;
+}
+
+//----------------------------------------------------------------------------------------
+ConeContainment::ConeContainment(const vec3 & apex, const vec3 & axis, float halfAngle,
+        float range)
+    : apex(apex),
+      axis(axis),
+      range(range),
+      cosHalfAngle(std::cos(halfAngle)),
+      sinHalfAngle(std::sin(halfAngle)) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Rejects the AABB by its bounding sphere, against the cone's sides, cap and
+ * the plane through its apex.  The capped cone is convex, so the AABB is
+ * inside when all eight of its corners are.
+ */
+Containment ConeContainment::operator () (const AABB & aabb) const {
+    const vec3 v = aabb.getCenter() - apex;
+    const float radius = glm::length(aabb.getHalfExtents());
+
+    const float alongAxis = dot(v, axis);
+    const float fromAxis = std::sqrt(std::max(0.0f, dot(v, v) - alongAxis * alongAxis));
+    const float fromSide = fromAxis * cosHalfAngle - alongAxis * sinHalfAngle;
+    if (fromSide > radius || alongAxis > range + radius || alongAxis < -radius) {
+        return Containment::Outside;
+    }
+
+    for(int corner = 0; corner < 8; ++corner) {
+        const vec3 point((corner & 1) ? aabb.maxBounds.x : aabb.minBounds.x,
+                         (corner & 2) ? aabb.maxBounds.y : aabb.minBounds.y,
+                         (corner & 4) ? aabb.maxBounds.z : aabb.minBounds.z);
+        if (!contains(point)) {
+            return Containment::Partial;
+        }
+    }
+    return Containment::Inside;
+}
+
+//----------------------------------------------------------------------------------------
+bool ConeContainment::contains(const vec3 & point) const {
+    const vec3 v = point - apex;
+    const float alongAxis = dot(v, axis);
+    return alongAxis >= 0.0f && alongAxis <= range &&
+            alongAxis >= glm::length(v) * cosHalfAngle;
+}
+
+}
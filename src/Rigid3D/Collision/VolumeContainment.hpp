@@ -0,0 +1,75 @@
+/**
+ * @brief VolumeContainment
+ *
+ * Classifiers of AABBs against convex query volumes, for use with
+ * DynamicAABBTree::queryContainment():
+ * \code{.cpp}
+ *  vec4 planes[numFrustumPlanes];
+ *  camera.getPlanes(planes);
+ *
+ *  tree.queryContainment(FrustumContainment(planes), [&](int32 proxyId) {
+ *      queue.submit(renderables[tree.getUserData(proxyId)]);
+ *      return true;
+ *  });
+ * \endcode
+ *
+ * Every classifier is conservative: an AABB reported Outside never overlaps
+ * the volume, and one reported Inside always lies entirely within it, while
+ * Partial may be returned for AABBs that do either.
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_VOLUMECONTAINMENT_HPP_
+#define RIGID3D_VOLUMECONTAINMENT_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Collision/DynamicAABBTree.hpp>
+
+namespace Rigid3D {
+
+    /**
+     * Intersection of six planes {normal, distance} with normals pointing
+     * inwards, such as those from Frustum::extractPlanes().
+     */
+    struct FrustumContainment {
+        vec4 planes[6];
+        vec3 absNormals[6];
+
+        explicit FrustumContainment(const vec4 * planes);
+
+        Containment operator () (const AABB & aabb) const;
+    };
+
+    struct SphereContainment {
+        vec3 center;
+        float radiusSquared;
+
+        SphereContainment(const vec3 & center, float radius);
+
+        Containment operator () (const AABB & aabb) const;
+    };
+
+    /**
+     * Cone with its tip at 'apex', opening along the unit vector 'axis' by
+     * 'halfAngle' radians, and capped 'range' units along the axis, such as the
+     * volume lit by a spot light.  'halfAngle' must be less than pi / 2.
+     */
+    struct ConeContainment {
+        vec3 apex;
+        vec3 axis;
+        float range;
+        float cosHalfAngle;
+        float sinHalfAngle;
+
+        ConeContainment(const vec3 & apex, const vec3 & axis, float halfAngle,
+                float range);
+
+        Containment operator () (const AABB & aabb) const;
+
+        bool contains(const vec3 & point) const;
+    };
+
+}
+
+#endif /* RIGID3D_VOLUMECONTAINMENT_HPP_ */
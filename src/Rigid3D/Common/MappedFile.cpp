@@ -0,0 +1,145 @@
+#include "MappedFile.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <sstream>
+
+namespace Rigid3D {
+
+using std::stringstream;
+
+//----------------------------------------------------------------------------------------
+static void throwMappingError(const char * filePath, const char * reason) {
+    stringstream errorMessage;
+    errorMessage << "Unable to " << reason << " file " << filePath
+                 << " within MappedFile constructor.";
+    throw Rigid3DException(errorMessage.str());
+}
+
+#if defined(_WIN32)
+
+//----------------------------------------------------------------------------------------
+MappedFile::MappedFile(const char * filePath)
+    : data(nullptr),
+      size(0),
+      fileHandle(INVALID_HANDLE_VALUE),
+      mappingHandle(nullptr) {
+
+    fileHandle = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        throwMappingError(filePath, "open");
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        CloseHandle(fileHandle);
+        throwMappingError(filePath, "stat");
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+
+    // Empty files cannot be mapped, and have no data to point to.
+    if (size == 0) {
+        return;
+    }
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        CloseHandle(fileHandle);
+        throwMappingError(filePath, "map");
+    }
+
+    data = static_cast<const char *>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr) {
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        throwMappingError(filePath, "map");
+    }
+}
+
+//----------------------------------------------------------------------------------------
+MappedFile::~MappedFile() {
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+    }
+}
+
+#else
+
+//----------------------------------------------------------------------------------------
+MappedFile::MappedFile(const char * filePath)
+    : data(nullptr),
+      size(0) {
+
+    int fd = open(filePath, O_RDONLY);
+    if (fd < 0) {
+        throwMappingError(filePath, "open");
+    }
+
+    struct stat fileStatus;
+    if (fstat(fd, &fileStatus) != 0) {
+        close(fd);
+        throwMappingError(filePath, "stat");
+    }
+    size = static_cast<size_t>(fileStatus.st_size);
+
+    // Empty files cannot be mapped, and have no data to point to.
+    if (size == 0) {
+        close(fd);
+        return;
+    }
+
+    void * mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping keeps its own reference to the file.
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        throwMappingError(filePath, "map");
+    }
+
+    // Files are parsed front to back.
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    data = static_cast<const char *>(mapping);
+}
+
+//----------------------------------------------------------------------------------------
+MappedFile::~MappedFile() {
+    if (data) {
+        munmap(const_cast<char *>(data), size);
+    }
+}
+
+#endif
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return pointer to the first byte of the file, or nullptr for an empty file.
+ */
+const char * MappedFile::getData() const {
+    return data;
+}
+
+//----------------------------------------------------------------------------------------
+size_t MappedFile::getSize() const {
+    return size;
+}
+
+}
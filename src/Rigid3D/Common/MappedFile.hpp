@@ -0,0 +1,47 @@
+/**
+ * @brief MappedFile
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_MAPPEDFILE_HPP_
+#define RIGID3D_MAPPEDFILE_HPP_
+
+#include <cstddef>
+
+namespace Rigid3D {
+
+    /**
+     * Read-only memory mapping of an entire file.
+     *
+     * The mapping is released when the MappedFile is destroyed, so pointers
+     * returned by getData() must not outlive it.
+     *
+     * @throws Rigid3DException if the file cannot be opened or mapped.
+     */
+    class MappedFile {
+    public:
+        explicit MappedFile(const char * filePath);
+
+        ~MappedFile();
+
+        const char * getData() const;
+
+        size_t getSize() const;
+
+    private:
+        MappedFile(const MappedFile &);
+        MappedFile & operator = (const MappedFile &);
+
+        const char * data;
+        size_t size;
+
+#if defined(_WIN32)
+        void * fileHandle;
+        void * mappingHandle;
+#endif
+    };
+
+}
+
+#endif /* RIGID3D_MAPPEDFILE_HPP_ */
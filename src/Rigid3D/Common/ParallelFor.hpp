@@ -0,0 +1,75 @@
+/**
+ * @brief ParallelFor
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_PARALLELFOR_HPP_
+#define RIGID3D_PARALLELFOR_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+
+#include <cstddef>
+#include <thread>
+
+namespace Rigid3D {
+
+    /**
+     * @return 'requestedThreads', or the number of hardware threads if
+     * 'requestedThreads' is zero.  Always at least one.
+     */
+    inline uint32 resolveThreadCount(uint32 requestedThreads) {
+        uint32 numThreads = requestedThreads;
+        if (numThreads == 0) {
+            numThreads = std::thread::hardware_concurrency();
+        }
+        return (numThreads == 0) ? 1 : numThreads;
+    }
+
+    /**
+     * @return first index of chunk 'chunkIndex', when splitting 'count' items
+     * into 'numChunks' contiguous chunks.
+     */
+    inline size_t chunkBegin(size_t count, uint32 numChunks, uint32 chunkIndex) {
+        return (count * chunkIndex) / numChunks;
+    }
+
+    /**
+     * Splits [0, count) into 'numThreads' contiguous chunks, and calls
+     * 'function(begin, end, threadIndex)' once per chunk, with the chunk's index
+     * as 'threadIndex'.  Chunk 0 runs on the calling thread, the others on the
+     * workers of ThreadPool::getShared(), which are started once and reused by
+     * every call, and the call returns once every chunk is done.  If chunks
+     * throw, one of the exceptions is rethrown once every chunk is done.
+     *
+     * Chunks are assigned in index order, so chunk 't' always precedes chunk
+     * 't + 1', which lets callers stitch per-thread output back together in
+     * order.
+     */
+    template <class Function>
+    void parallelFor(size_t count, uint32 numThreads, const Function & function) {
+        if (numThreads <= 1 || count <= 1) {
+            function(size_t(0), count, uint32(0));
+            return;
+        }
+
+        struct Chunks {
+            size_t count;
+            uint32 numChunks;
+            const Function * function;
+
+            static void run(void * context, uint32 chunk) {
+                const Chunks & chunks = *static_cast<const Chunks *>(context);
+                (*chunks.function)(chunkBegin(chunks.count, chunks.numChunks, chunk),
+                        chunkBegin(chunks.count, chunks.numChunks, chunk + 1), chunk);
+            }
+        };
+
+        Chunks chunks = {count, numThreads, &function};
+        ThreadPool::getShared().run(numThreads, &Chunks::run, &chunks);
+    }
+
+}
+
+#endif /* RIGID3D_PARALLELFOR_HPP_ */
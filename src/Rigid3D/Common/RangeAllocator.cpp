@@ -0,0 +1,363 @@
+#include "RangeAllocator.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Rigid3D {
+
+namespace {
+
+    // Index of the lowest set bit of 'x', which must not be zero.
+    inline uint32 findLowestBit(uint32 x) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, x);
+        return uint32(index);
+#else
+        return uint32(__builtin_ctz(x));
+#endif
+    }
+
+    // Index of the highest set bit of 'x', which must not be zero.
+    inline uint32 findHighestBit(uint32 x) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse(&index, x);
+        return uint32(index);
+#else
+        return uint32(31 - __builtin_clz(x));
+#endif
+    }
+
+}
+
+const uint32 RangeAllocator::invalidOffset;
+const uint32 RangeAllocator::noBlock;
+
+//----------------------------------------------------------------------------------------
+/**
+ * Constructs a RangeAllocator with all of 'capacity' units free.
+ */
+RangeAllocator::RangeAllocator(uint32 capacity) {
+    reset(capacity);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Frees every range, and sets the capacity to 'capacity' units.
+ */
+void RangeAllocator::reset(uint32 capacity) {
+    this->capacity = 0;
+    numFreeUnits = 0;
+    blocks.clear();
+    unusedBlocks.clear();
+    allocations.clear();
+    lastPhysical = noBlock;
+
+    firstLevelBitmap = 0;
+    for(uint32 f = 0; f < numFirstLevels; ++f) {
+        secondLevelBitmaps[f] = 0;
+        for(uint32 s = 0; s < numSecondLevels; ++s) {
+            freeHeads[f][s] = noBlock;
+        }
+    }
+
+    grow(capacity);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Extends the block to 'capacity' units, adding the new units to the end as
+ * free space.  Existing ranges keep their offsets.
+ *
+ * @throws Rigid3DException if 'capacity' is less than the current capacity.
+ */
+void RangeAllocator::grow(uint32 capacity) {
+    if (capacity < this->capacity) {
+        throw Rigid3DException("Capacity cannot shrink within method "
+                "RangeAllocator::grow");
+    }
+    const uint32 numAdded = capacity - this->capacity;
+    if (numAdded == 0) {
+        return;
+    }
+
+    if (lastPhysical != noBlock && blocks[lastPhysical].isFree) {
+        removeFree(lastPhysical);
+        blocks[lastPhysical].size += numAdded;
+        insertFree(lastPhysical);
+    } else {
+        const uint32 block = createBlock(this->capacity, numAdded);
+        blocks[block].prevPhysical = lastPhysical;
+        if (lastPhysical != noBlock) {
+            blocks[lastPhysical].nextPhysical = block;
+        }
+        lastPhysical = block;
+        insertFree(block);
+    }
+
+    this->capacity = capacity;
+    numFreeUnits += numAdded;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Reserves 'size' consecutive units.
+ *
+ * @return offset of the first unit, or invalidOffset if no free range is large
+ * enough, in which case the caller may grow() and try again.
+ *
+ * @throws Rigid3DException if 'size' is zero.
+ */
+uint32 RangeAllocator::allocate(uint32 size) {
+    if (size == 0) {
+        throw Rigid3DException("Cannot allocate an empty range within method "
+                "RangeAllocator::allocate");
+    }
+    if (size > numFreeUnits) {
+        return invalidOffset;
+    }
+
+    const uint32 block = findFree(size);
+    if (block == noBlock) {
+        return invalidOffset;
+    }
+    removeFree(block);
+
+    // Return what is left over to the free lists.
+    if (blocks[block].size > size) {
+        const uint32 rest = createBlock(blocks[block].offset + size, blocks[block].size - size);
+        blocks[block].size = size;
+
+        const uint32 next = blocks[block].nextPhysical;
+        blocks[rest].prevPhysical = block;
+        blocks[rest].nextPhysical = next;
+        blocks[block].nextPhysical = rest;
+        if (next != noBlock) {
+            blocks[next].prevPhysical = rest;
+        } else {
+            lastPhysical = rest;
+        }
+        insertFree(rest);
+    }
+
+    blocks[block].isFree = false;
+    numFreeUnits -= size;
+    allocations[blocks[block].offset] = block;
+    return blocks[block].offset;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Releases the range starting at 'offset', merging it with free neighbours.
+ *
+ * @throws Rigid3DException if no range starts at 'offset'.
+ */
+void RangeAllocator::free(uint32 offset) {
+    const auto allocation = allocations.find(offset);
+    if (allocation == allocations.end()) {
+        throw Rigid3DException("No range is allocated at the given offset within method "
+                "RangeAllocator::free");
+    }
+    uint32 block = allocation->second;
+    allocations.erase(allocation);
+
+    blocks[block].isFree = true;
+    numFreeUnits += blocks[block].size;
+
+    const uint32 prev = blocks[block].prevPhysical;
+    if (prev != noBlock && blocks[prev].isFree) {
+        removeFree(prev);
+        blocks[prev].size += blocks[block].size;
+        blocks[prev].nextPhysical = blocks[block].nextPhysical;
+        if (blocks[block].nextPhysical != noBlock) {
+            blocks[blocks[block].nextPhysical].prevPhysical = prev;
+        } else {
+            lastPhysical = prev;
+        }
+        destroyBlock(block);
+        block = prev;
+    }
+
+    const uint32 next = blocks[block].nextPhysical;
+    if (next != noBlock && blocks[next].isFree) {
+        removeFree(next);
+        blocks[block].size += blocks[next].size;
+        blocks[block].nextPhysical = blocks[next].nextPhysical;
+        if (blocks[next].nextPhysical != noBlock) {
+            blocks[blocks[next].nextPhysical].prevPhysical = block;
+        } else {
+            lastPhysical = block;
+        }
+        destroyBlock(next);
+    }
+
+    insertFree(block);
+}
+
+//----------------------------------------------------------------------------------------
+uint32 RangeAllocator::getCapacity() const {
+    return capacity;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return total size of all free ranges, which may be split across many
+ * ranges.
+ */
+uint32 RangeAllocator::getNumFreeUnits() const {
+    return numFreeUnits;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return size of the largest range allocate() could currently return.
+ */
+uint32 RangeAllocator::getLargestFreeRange() const {
+    if (firstLevelBitmap == 0) {
+        return 0;
+    }
+    const uint32 f = findHighestBit(firstLevelBitmap);
+    const uint32 s = findHighestBit(secondLevelBitmaps[f]);
+
+    uint32 largest = 0;
+    for(uint32 block = freeHeads[f][s]; block != noBlock; block = blocks[block].nextFree) {
+        largest = std::max(largest, blocks[block].size);
+    }
+    return largest;
+}
+
+//----------------------------------------------------------------------------------------
+size_t RangeAllocator::getNumAllocations() const {
+    return allocations.size();
+}
+
+//----------------------------------------------------------------------------------------
+uint32 RangeAllocator::createBlock(uint32 offset, uint32 size) {
+    uint32 block;
+    if (unusedBlocks.empty()) {
+        block = uint32(blocks.size());
+        blocks.push_back(Block());
+    } else {
+        block = unusedBlocks.back();
+        unusedBlocks.pop_back();
+    }
+
+    Block & b = blocks[block];
+    b.offset = offset;
+    b.size = size;
+    b.prevPhysical = b.nextPhysical = noBlock;
+    b.prevFree = b.nextFree = noBlock;
+    b.isFree = true;
+    return block;
+}
+
+//----------------------------------------------------------------------------------------
+void RangeAllocator::destroyBlock(uint32 block) {
+    unusedBlocks.push_back(block);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sizes below 16 each have their own class.  Larger sizes are split by their
+ * highest bit, then into 16 classes by the next four bits.
+ */
+void RangeAllocator::getClass(uint32 size, uint32 & firstLevel, uint32 & secondLevel) {
+    if (size < numSecondLevels) {
+        firstLevel = 0;
+        secondLevel = size;
+    } else {
+        const uint32 highestBit = findHighestBit(size);
+        firstLevel = highestBit - (numSecondLevelBits - 1);
+        secondLevel = (size >> (highestBit - numSecondLevelBits)) - numSecondLevels;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void RangeAllocator::insertFree(uint32 block) {
+    uint32 f, s;
+    getClass(blocks[block].size, f, s);
+
+    const uint32 head = freeHeads[f][s];
+    blocks[block].prevFree = noBlock;
+    blocks[block].nextFree = head;
+    if (head != noBlock) {
+        blocks[head].prevFree = block;
+    }
+    freeHeads[f][s] = block;
+    firstLevelBitmap |= 1u << f;
+    secondLevelBitmaps[f] |= 1u << s;
+}
+
+//----------------------------------------------------------------------------------------
+void RangeAllocator::removeFree(uint32 block) {
+    uint32 f, s;
+    getClass(blocks[block].size, f, s);
+
+    const uint32 prev = blocks[block].prevFree;
+    const uint32 next = blocks[block].nextFree;
+    if (prev != noBlock) {
+        blocks[prev].nextFree = next;
+    } else {
+        freeHeads[f][s] = next;
+        if (next == noBlock) {
+            secondLevelBitmaps[f] &= ~(1u << s);
+            if (secondLevelBitmaps[f] == 0) {
+                firstLevelBitmap &= ~(1u << f);
+            }
+        }
+    }
+    if (next != noBlock) {
+        blocks[next].prevFree = prev;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return a free block of at least 'size' units, or noBlock.
+ */
+uint32 RangeAllocator::findFree(uint32 size) const {
+    // Round up to the next class boundary, so that any block in the class
+    // found is large enough.
+    uint64_t rounded = size;
+    if (size >= numSecondLevels) {
+        rounded += (uint64_t(1) << (findHighestBit(size) - numSecondLevelBits)) - 1;
+    }
+
+    if (rounded <= 0xFFFFFFFFu) {
+        uint32 f, s;
+        getClass(uint32(rounded), f, s);
+
+        uint32 bitmap = secondLevelBitmaps[f] & (~0u << s);
+        if (bitmap == 0) {
+            const uint32 higherLevels = (f + 1 < numFirstLevels) ?
+                    firstLevelBitmap & (~0u << (f + 1)) : 0;
+            if (higherLevels != 0) {
+                f = findLowestBit(higherLevels);
+                bitmap = secondLevelBitmaps[f];
+            }
+        }
+        if (bitmap != 0) {
+            return freeHeads[f][findLowestBit(bitmap)];
+        }
+    }
+
+    // Only blocks in the same class as 'size' are left, and some of those may
+    // still be large enough.
+    uint32 f, s;
+    getClass(size, f, s);
+    for(uint32 block = freeHeads[f][s]; block != noBlock; block = blocks[block].nextFree) {
+        if (blocks[block].size >= size) {
+            return block;
+        }
+    }
+    return noBlock;
+}
+
+}
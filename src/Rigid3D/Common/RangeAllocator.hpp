@@ -0,0 +1,98 @@
+/**
+ * @brief RangeAllocator
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_RANGE_ALLOCATOR_HPP_
+#define RIGID3D_RANGE_ALLOCATOR_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Hands out ranges of a block of 'capacity' units, such as vertices
+     * or indices within a shared buffer, using a two level segregated fit
+     * (TLSF) free list.
+     *
+     * Free ranges are binned by size into classes of roughly 6% width, with a
+     * bitmap of non-empty classes, so allocate() and free() take constant time
+     * regardless of how fragmented the block is.  Freed ranges are merged with
+     * free neighbours straight away.
+     *
+     * The allocator only does bookkeeping; it never touches the memory the
+     * units refer to.  A freshly reset allocator hands out consecutive ranges
+     * from offset zero, in the order they are requested.
+     */
+    class RangeAllocator {
+    public:
+        static const uint32 invalidOffset = 0xFFFFFFFFu;
+
+        explicit RangeAllocator(uint32 capacity = 0);
+
+        uint32 allocate(uint32 size);
+
+        void free(uint32 offset);
+
+        void grow(uint32 capacity);
+
+        void reset(uint32 capacity);
+
+        uint32 getCapacity() const;
+
+        uint32 getNumFreeUnits() const;
+
+        uint32 getLargestFreeRange() const;
+
+        size_t getNumAllocations() const;
+
+    private:
+        static const uint32 noBlock = 0xFFFFFFFFu;
+        static const uint32 numFirstLevels = 32;
+        static const uint32 numSecondLevelBits = 4;
+        static const uint32 numSecondLevels = 1u << numSecondLevelBits;
+
+        struct Block {
+            uint32 offset;
+            uint32 size;
+            uint32 prevPhysical;
+            uint32 nextPhysical;
+            uint32 prevFree;
+            uint32 nextFree;
+            bool isFree;
+        };
+
+        uint32 createBlock(uint32 offset, uint32 size);
+        void destroyBlock(uint32 block);
+
+        void insertFree(uint32 block);
+        void removeFree(uint32 block);
+        uint32 findFree(uint32 size) const;
+
+        static void getClass(uint32 size, uint32 & firstLevel, uint32 & secondLevel);
+
+        uint32 capacity;
+        uint32 numFreeUnits;
+
+        std::vector<Block> blocks;
+        std::vector<uint32> unusedBlocks;
+        uint32 lastPhysical;
+
+        // Bit 'f' of firstLevelBitmap is set if any bit of secondLevelBitmaps[f]
+        // is, and bit 's' of that if freeHeads[f][s] holds a free block.
+        uint32 firstLevelBitmap;
+        uint32 secondLevelBitmaps[numFirstLevels];
+        uint32 freeHeads[numFirstLevels][numSecondLevels];
+
+        // Allocated blocks by offset.
+        std::unordered_map<uint32, uint32> allocations;
+    };
+
+}
+
+#endif /* RIGID3D_RANGE_ALLOCATOR_HPP_ */
@@ -0,0 +1,113 @@
+/**
+ * @brief SpscRingBuffer
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_SPSCRINGBUFFER_HPP_
+#define RIGID3D_SPSCRINGBUFFER_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * Fixed capacity, lock-free, single producer single consumer ring buffer.
+     *
+     * Storage is allocated once by the constructor.  push() and pop() never
+     * allocate or block: push() fails when the buffer is full, and pop() fails
+     * when it is empty.  Exactly one thread may push and exactly one thread may
+     * pop at any given time.
+     */
+    template <class T>
+    class SpscRingBuffer {
+    public:
+        // Capacity is rounded up to a power of two.
+        explicit SpscRingBuffer(size_t capacity)
+            : mask(0) {
+            head.value.store(0, std::memory_order_relaxed);
+            tail.value.store(0, std::memory_order_relaxed);
+
+            size_t size = 1;
+            while (size < capacity) {
+                size <<= 1;
+            }
+            slots.resize(size);
+            mask = size - 1;
+        }
+
+        // Called by the producer thread only.
+        bool push(const T & value) {
+            const size_t t = tail.value.load(std::memory_order_relaxed);
+            if (t - head.value.load(std::memory_order_acquire) > mask) {
+                return false;
+            }
+            slots[t & mask] = value;
+            tail.value.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Called by the consumer thread only.
+        bool pop(T & value) {
+            const size_t h = head.value.load(std::memory_order_relaxed);
+            if (h == tail.value.load(std::memory_order_acquire)) {
+                return false;
+            }
+            value = slots[h & mask];
+            head.value.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Called by the consumer thread only.  Pops up to 'maxCount' elements
+        // into 'out', and returns the number popped.
+        size_t popMany(T * out, size_t maxCount) {
+            const size_t h = head.value.load(std::memory_order_relaxed);
+            size_t count = tail.value.load(std::memory_order_acquire) - h;
+            if (count > maxCount) {
+                count = maxCount;
+            }
+            for(size_t i = 0; i < count; ++i) {
+                out[i] = slots[(h + i) & mask];
+            }
+            head.value.store(h + count, std::memory_order_release);
+            return count;
+        }
+
+        // Approximate while the other thread is active.
+        size_t size() const {
+            // Load 'head' first, since 'tail' can only move further ahead of it.
+            const size_t h = head.value.load(std::memory_order_acquire);
+            return tail.value.load(std::memory_order_acquire) - h;
+        }
+
+        size_t capacity() const {
+            return mask + 1;
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+    private:
+        SpscRingBuffer(const SpscRingBuffer &);
+        SpscRingBuffer & operator = (const SpscRingBuffer &);
+
+        std::vector<T> slots;
+        size_t mask;
+
+        // Padded so 'head' and 'tail' sit on separate cache lines, and the producer
+        // and consumer do not contend.
+        struct PaddedIndex {
+            std::atomic<size_t> value;
+            char padding[64 - sizeof(std::atomic<size_t>)];
+        };
+
+        PaddedIndex head;  // Next slot to pop, written by the consumer.
+        PaddedIndex tail;  // Next slot to push, written by the producer.
+    };
+
+}
+
+#endif /* RIGID3D_SPSCRINGBUFFER_HPP_ */
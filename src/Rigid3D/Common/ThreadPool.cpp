@@ -0,0 +1,180 @@
+#include "ThreadPool.hpp"
+
+#include <Rigid3D/Common/ParallelFor.hpp>
+
+#include <algorithm>
+#include <exception>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+/**
+ * One call to run().  Lives on the calling thread's stack until every task has
+ * finished.  All members but 'task' and 'context' are guarded by the pool's mutex.
+ */
+struct ThreadPool::Batch {
+    TaskFunction task;
+    void * context;
+    uint32 numTasks;
+
+    // Lowest task index no thread has taken yet.  Task 0 is the caller's own.
+    uint32 nextTask;
+
+    // Tasks finished, not counting task 0.
+    uint32 numFinished;
+
+    std::exception_ptr error;
+};
+
+//----------------------------------------------------------------------------------------
+/**
+ * Starts the worker threads.
+ *
+ * @param numWorkers - number of worker threads.  Zero runs every task on the
+ * thread calling run().
+ */
+ThreadPool::ThreadPool(uint32 numWorkers)
+    : stopping(false) {
+
+    workers.reserve(numWorkers);
+    for(uint32 i = 0; i < numWorkers; ++i) {
+        workers.push_back(std::thread([this]() { runWorker(); }));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Stops and joins the worker threads.  Must not be called while a run() is in
+ * progress.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    batchQueued.notify_all();
+
+    for(std::thread & worker : workers) {
+        worker.join();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the pool shared by parallelFor(), with one worker fewer than there
+ * are hardware threads, since callers run tasks too.  Started on first use.
+ */
+ThreadPool & ThreadPool::getShared() {
+    static ThreadPool pool(resolveThreadCount(0) - 1);
+    return pool;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Calls 'task(context, i)' once for every 'i' in [0, numTasks), and returns
+ * once every call is done.  Task 0 runs on the calling thread, as do any tasks
+ * the workers have not taken by the time it finishes.
+ *
+ * If tasks throw, the remaining tasks still run, and one of the exceptions is
+ * rethrown once all tasks are done.
+ */
+void ThreadPool::run(uint32 numTasks, TaskFunction task, void * context) {
+    if (numTasks == 0) {
+        return;
+    }
+    if (numTasks == 1) {
+        task(context, 0);
+        return;
+    }
+
+    Batch batch;
+    batch.task = task;
+    batch.context = context;
+    batch.numTasks = numTasks;
+    batch.nextTask = 1;
+    batch.numFinished = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queuedBatches.push_back(&batch);
+    }
+    const uint32 numToWake = std::min(numTasks - 1, uint32(workers.size()));
+    for(uint32 i = 0; i < numToWake; ++i) {
+        batchQueued.notify_one();
+    }
+
+    std::exception_ptr firstTaskError;
+    try {
+        task(context, 0);
+    } catch (...) {
+        firstTaskError = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (runNextTask(batch, lock)) { }
+    taskFinished.wait(lock, [&batch]() {
+        return batch.numFinished == batch.numTasks - 1;
+    });
+
+    const std::exception_ptr error = firstTaskError ? firstTaskError : batch.error;
+    lock.unlock();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+uint32 ThreadPool::getNumWorkers() const {
+    return uint32(workers.size());
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Takes and runs the next task of 'batch', unlocking 'lock' while it runs.
+ *
+ * @return false if every task of 'batch' was already taken.
+ */
+bool ThreadPool::runNextTask(Batch & batch, std::unique_lock<std::mutex> & lock) {
+    if (batch.nextTask == batch.numTasks) {
+        return false;
+    }
+
+    const uint32 taskIndex = batch.nextTask++;
+    if (batch.nextTask == batch.numTasks) {
+        queuedBatches.erase(std::find(queuedBatches.begin(), queuedBatches.end(), &batch));
+    }
+
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+        batch.task(batch.context, taskIndex);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    lock.lock();
+
+    if (error && !batch.error) {
+        batch.error = error;
+    }
+    // The caller may return, and 'batch' go away, as soon as the lock is released.
+    if (++batch.numFinished == batch.numTasks - 1) {
+        taskFinished.notify_all();
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+void ThreadPool::runWorker() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    for(;;) {
+        batchQueued.wait(lock, [this]() { return stopping || !queuedBatches.empty(); });
+        if (stopping) {
+            return;
+        }
+
+        runNextTask(*queuedBatches.front(), lock);
+    }
+}
+
+}
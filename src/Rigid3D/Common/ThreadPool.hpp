@@ -0,0 +1,70 @@
+/**
+ * @brief ThreadPool
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_THREAD_POOL_HPP_
+#define RIGID3D_THREAD_POOL_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Fixed set of worker threads, started once, that run batches of
+     * indexed tasks.
+     *
+     * run() hands tasks 1 to n-1 of a batch to the workers, runs task 0 on the
+     * calling thread, and then runs any tasks of the batch no worker has taken
+     * yet, before waiting for the rest.  Because a caller only ever waits on
+     * tasks that are already running, tasks may themselves call run() without
+     * deadlocking, even when every worker is busy.
+     *
+     * Batches from different threads share the workers, first come first
+     * served.
+     */
+    class ThreadPool {
+    public:
+        typedef void (*TaskFunction)(void * context, uint32 taskIndex);
+
+        explicit ThreadPool(uint32 numWorkers);
+
+        ~ThreadPool();
+
+        static ThreadPool & getShared();
+
+        void run(uint32 numTasks, TaskFunction task, void * context);
+
+        uint32 getNumWorkers() const;
+
+    private:
+        ThreadPool(const ThreadPool &);
+        ThreadPool & operator = (const ThreadPool &);
+
+        struct Batch;
+
+        bool runNextTask(Batch & batch, std::unique_lock<std::mutex> & lock);
+
+        void runWorker();
+
+        std::vector<std::thread> workers;
+
+        std::mutex mutex;
+        std::condition_variable batchQueued;
+        std::condition_variable taskFinished;
+
+        // Guarded by 'mutex'.  Batches with tasks that no thread has taken yet.
+        std::deque<Batch *> queuedBatches;
+        bool stopping;
+    };
+
+}
+
+#endif /* RIGID3D_THREAD_POOL_HPP_ */
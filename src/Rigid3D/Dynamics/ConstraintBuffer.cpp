@@ -0,0 +1,83 @@
+#include "ConstraintBuffer.hpp"
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+void ConstraintRowBuffer::clear() {
+    bodyA.clear();
+    bodyB.clear();
+    linearA.clear();
+    angularA.clear();
+    linearB.clear();
+    angularB.clear();
+    effectiveMass.clear();
+    bias.clear();
+    lowerImpulse.clear();
+    upperImpulse.clear();
+    impulse.clear();
+}
+
+//----------------------------------------------------------------------------------------
+void ConstraintRowBuffer::addRow(int32 bodyA, int32 bodyB,
+                                 const vec3 & linearA, const vec3 & angularA,
+                                 const vec3 & linearB, const vec3 & angularB,
+                                 float effectiveMass, float bias,
+                                 float lowerImpulse, float upperImpulse) {
+    this->bodyA.push_back(bodyA);
+    this->bodyB.push_back(bodyB);
+    this->linearA.push_back(linearA);
+    this->angularA.push_back(angularA);
+    this->linearB.push_back(linearB);
+    this->angularB.push_back(angularB);
+    this->effectiveMass.push_back(effectiveMass);
+    this->bias.push_back(bias);
+    this->lowerImpulse.push_back(lowerImpulse);
+    this->upperImpulse.push_back(upperImpulse);
+    this->impulse.push_back(0.0f);
+}
+
+//----------------------------------------------------------------------------------------
+void BlockConstraint3Buffer::clear() {
+    bodyA.clear();
+    bodyB.clear();
+    rA.clear();
+    rB.clear();
+    inverseK.clear();
+    bias.clear();
+}
+
+//----------------------------------------------------------------------------------------
+void BlockConstraint3Buffer::addBlock(int32 bodyA, int32 bodyB,
+                                      const vec3 & rA, const vec3 & rB,
+                                      const mat3 & inverseK, const vec3 & bias) {
+    this->bodyA.push_back(bodyA);
+    this->bodyB.push_back(bodyB);
+    this->rA.push_back(rA);
+    this->rB.push_back(rB);
+    this->inverseK.push_back(inverseK);
+    this->bias.push_back(bias);
+}
+
+//----------------------------------------------------------------------------------------
+void BlockConstraint6Buffer::clear() {
+    bodyA.clear();
+    bodyB.clear();
+    rA.clear();
+    rB.clear();
+    inverseK.clear();
+    bias.clear();
+}
+
+//----------------------------------------------------------------------------------------
+void BlockConstraint6Buffer::addBlock(int32 bodyA, int32 bodyB,
+                                      const vec3 & rA, const vec3 & rB,
+                                      const float * inverseK, const float * bias) {
+    this->bodyA.push_back(bodyA);
+    this->bodyB.push_back(bodyB);
+    this->rA.push_back(rA);
+    this->rB.push_back(rB);
+    this->inverseK.insert(this->inverseK.end(), inverseK, inverseK + 36);
+    this->bias.insert(this->bias.end(), bias, bias + 6);
+}
+
+} // end namespace Rigid3D
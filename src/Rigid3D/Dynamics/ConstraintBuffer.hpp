@@ -0,0 +1,99 @@
+/**
+ * @brief ConstraintBuffer
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_CONSTRAINTBUFFER_HPP_
+#define RIGID3D_CONSTRAINTBUFFER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * Structure of arrays holding scalar constraint rows.
+     *
+     * Row i constrains the relative velocity
+     * \code
+     *  Cdot = linearA[i].vA + angularA[i].wA + linearB[i].vB + angularB[i].wB
+     * \endcode
+     * with the accumulated impulse clamped to [lowerImpulse[i], upperImpulse[i]].
+     */
+    struct ConstraintRowBuffer {
+        std::vector<int32> bodyA;
+        std::vector<int32> bodyB;
+        std::vector<vec3> linearA;
+        std::vector<vec3> angularA;
+        std::vector<vec3> linearB;
+        std::vector<vec3> angularB;
+        std::vector<float> effectiveMass;
+        std::vector<float> bias;
+        std::vector<float> lowerImpulse;
+        std::vector<float> upperImpulse;
+        std::vector<float> impulse;
+
+        size_t size() const { return bodyA.size(); }
+
+        void clear();
+
+        void addRow(int32 bodyA, int32 bodyB,
+                    const vec3 & linearA, const vec3 & angularA,
+                    const vec3 & linearB, const vec3 & angularB,
+                    float effectiveMass, float bias,
+                    float lowerImpulse, float upperImpulse);
+    };
+
+    /**
+     * Structure of arrays holding 3x3 block constraints, which solve three
+     * coupled rows at once by multiplying with the inverse effective mass
+     * matrix.
+     *
+     * Linear blocks constrain the relative velocity of the anchor points
+     * 'rA' and 'rB' (ball-socket).  Angular blocks constrain relative angular
+     * velocity and leave 'rA' and 'rB' unused.
+     */
+    struct BlockConstraint3Buffer {
+        std::vector<int32> bodyA;
+        std::vector<int32> bodyB;
+        std::vector<vec3> rA;
+        std::vector<vec3> rB;
+        std::vector<mat3> inverseK;
+        std::vector<vec3> bias;
+
+        size_t size() const { return bodyA.size(); }
+
+        void clear();
+
+        void addBlock(int32 bodyA, int32 bodyB, const vec3 & rA, const vec3 & rB,
+                      const mat3 & inverseK, const vec3 & bias);
+    };
+
+    /**
+     * Structure of arrays holding 6x6 block constraints, which remove all
+     * relative motion between two bodies at anchors 'rA' and 'rB'.
+     *
+     * The inverse effective mass matrices are stored row-major, 36 floats per
+     * block, and biases 6 floats per block (linear then angular).
+     */
+    struct BlockConstraint6Buffer {
+        std::vector<int32> bodyA;
+        std::vector<int32> bodyB;
+        std::vector<vec3> rA;
+        std::vector<vec3> rB;
+        std::vector<float> inverseK;
+        std::vector<float> bias;
+
+        size_t size() const { return bodyA.size(); }
+
+        void clear();
+
+        void addBlock(int32 bodyA, int32 bodyB, const vec3 & rA, const vec3 & rB,
+                      const float * inverseK, const float * bias);
+    };
+
+}
+
+#endif /* RIGID3D_CONSTRAINTBUFFER_HPP_ */
@@ -0,0 +1,127 @@
+#include "Joint.hpp"
+
+#include <Rigid3D/Dynamics/SolverBody.hpp>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <cmath>
+
+namespace Rigid3D {
+
+using glm::conjugate;
+using glm::cross;
+using glm::normalize;
+
+//----------------------------------------------------------------------------------------
+DofConfig::DofConfig()
+    : mode(DofMode::Free),
+      lowerLimit(0.0f),
+      upperLimit(0.0f),
+      enableMotor(false),
+      motorSpeed(0.0f),
+      maxMotorForce(0.0f) {
+
+}
+
+//----------------------------------------------------------------------------------------
+JointDef::JointDef()
+    : type(JointType::Ball),
+      bodyA(0),
+      bodyB(0),
+      localAnchorA(0.0f),
+      localAnchorB(0.0f),
+      localFrameA(),
+      localFrameB() {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Computes a world space orientation whose x-axis is aligned with 'axis'.
+ */
+static quat frameFromAxis(const vec3 & axis) {
+    vec3 x = normalize(axis);
+
+    // Pick the world axis least aligned with x to build the rest of the basis.
+    vec3 helper = (std::fabs(x.x) < 0.57735f) ? vec3(1.0f, 0.0f, 0.0f)
+                                              : vec3(0.0f, 1.0f, 0.0f);
+    vec3 y = normalize(cross(helper, x));
+    vec3 z = cross(x, y);
+
+    return glm::quat_cast(mat3(x, y, z));
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Initializes local anchors and joint frames for both bodies from a world
+ * space anchor point and axis, using the bodies' current transforms.
+ *
+ * The degrees of freedom in \c linear and \c angular are reset to the
+ * pattern for 'type'.  For a JointType::Generic6Dof all degrees of freedom are
+ * left free.
+ *
+ * @param type - kind of joint to create.
+ * @param bodies - array of bodies indexed by 'bodyA' and 'bodyB'.
+ * @param bodyA - index of the first body.
+ * @param bodyB - index of the second body.
+ * @param worldAnchor - joint origin in world space.
+ * @param worldAxis - joint x-axis in world space.
+ */
+void JointDef::initialize(JointType type,
+                          const SolverBody * bodies,
+                          int32 bodyA,
+                          int32 bodyB,
+                          const vec3 & worldAnchor,
+                          const vec3 & worldAxis) {
+    this->type = type;
+    this->bodyA = bodyA;
+    this->bodyB = bodyB;
+
+    const SolverBody & a = bodies[bodyA];
+    const SolverBody & b = bodies[bodyB];
+
+    quat invOrientationA = conjugate(a.orientation);
+    quat invOrientationB = conjugate(b.orientation);
+
+    localAnchorA = invOrientationA * (worldAnchor - a.position);
+    localAnchorB = invOrientationB * (worldAnchor - b.position);
+
+    quat worldFrame = frameFromAxis(worldAxis);
+    localFrameA = invOrientationA * worldFrame;
+    localFrameB = invOrientationB * worldFrame;
+
+    for(int i = 0; i < 3; ++i) {
+        linear[i] = DofConfig();
+        angular[i] = DofConfig();
+    }
+
+    switch (type) {
+    case JointType::Ball:
+        for(int i = 0; i < 3; ++i) { linear[i].mode = DofMode::Locked; }
+        break;
+
+    case JointType::Hinge:
+        for(int i = 0; i < 3; ++i) { linear[i].mode = DofMode::Locked; }
+        angular[1].mode = DofMode::Locked;
+        angular[2].mode = DofMode::Locked;
+        break;
+
+    case JointType::Slider:
+        for(int i = 0; i < 3; ++i) { angular[i].mode = DofMode::Locked; }
+        linear[1].mode = DofMode::Locked;
+        linear[2].mode = DofMode::Locked;
+        break;
+
+    case JointType::Fixed:
+        for(int i = 0; i < 3; ++i) {
+            linear[i].mode = DofMode::Locked;
+            angular[i].mode = DofMode::Locked;
+        }
+        break;
+
+    case JointType::Generic6Dof:
+        break;
+    }
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,94 @@
+/**
+ * @brief Joint
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_JOINT_HPP_
+#define RIGID3D_JOINT_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+// Forward Declarations
+namespace Rigid3D {
+    struct SolverBody;
+}
+
+namespace Rigid3D {
+
+    enum class JointType {
+        Ball,       // Anchors coincide, rotation is free.
+        Hinge,      // Anchors coincide, rotation only about the joint x-axis.
+        Slider,     // No relative rotation, translation only along the joint x-axis.
+        Fixed,      // No relative motion.
+        Generic6Dof // Each of the six degrees of freedom is configured by a DofConfig.
+    };
+
+    enum class DofMode {
+        Free,
+        Locked,
+        Limited
+    };
+
+    /**
+     * Configuration for a single degree of freedom of a joint, expressed along
+     * or about one of the joint frame axes.
+     *
+     * Linear limits are distances, angular limits are radians.  Motors drive
+     * the relative velocity along the axis towards \c motorSpeed using at most
+     * \c maxMotorForce (or torque).
+     */
+    struct DofConfig {
+        DofMode mode;
+        float lowerLimit;
+        float upperLimit;
+        bool enableMotor;
+        float motorSpeed;
+        float maxMotorForce;
+
+        DofConfig();
+    };
+
+    /**
+     * Describes a joint between two \c SolverBody objects.
+     *
+     * Each body carries a joint frame given by a local anchor point and a
+     * local orientation.  The joint x-axis is the hinge axis for a
+     * JointType::Hinge and the sliding axis for a JointType::Slider.
+     *
+     * \c linear[i] and \c angular[i] configure translation along and rotation
+     * about the joint frame axis i.  JointDef::initialize() fills them in for
+     * the given \c JointType, after which limits and motors can be enabled,
+     * such as the following hinge example:
+     * \code{.cpp}
+     *  JointDef hinge;
+     *  hinge.initialize(JointType::Hinge, bodies, 0, 1, anchor, axis);
+     *  hinge.angular[0].mode = DofMode::Limited;
+     *  hinge.angular[0].lowerLimit = -0.5f * PI;
+     *  hinge.angular[0].upperLimit = 0.5f * PI;
+     * \endcode
+     */
+    struct JointDef {
+        JointType type;
+        int32 bodyA;
+        int32 bodyB;
+        vec3 localAnchorA;
+        vec3 localAnchorB;
+        quat localFrameA;
+        quat localFrameB;
+        DofConfig linear[3];
+        DofConfig angular[3];
+
+        JointDef();
+
+        void initialize(JointType type,
+                        const SolverBody * bodies,
+                        int32 bodyA,
+                        int32 bodyB,
+                        const vec3 & worldAnchor,
+                        const vec3 & worldAxis = vec3(1.0f, 0.0f, 0.0f));
+    };
+
+}
+
+#endif /* RIGID3D_JOINT_HPP_ */
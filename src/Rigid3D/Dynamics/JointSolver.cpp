@@ -0,0 +1,426 @@
+#include "JointSolver.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Dynamics/SolverBody.hpp>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <sstream>
+
+namespace Rigid3D {
+
+using glm::conjugate;
+using glm::cross;
+using glm::dot;
+using std::stringstream;
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the skew symmetric matrix S of 'r', such that S * v = cross(r, v).
+ */
+static mat3 skew(const vec3 & r) {
+    return mat3( 0.0f,  r.z, -r.y,
+                -r.z,  0.0f,  r.x,
+                 r.y, -r.x,  0.0f);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Inverts the row-major 6x6 matrix 'm' using Gauss-Jordan elimination with
+ * partial pivoting.
+ *
+ * @return false if 'm' is singular, in which case 'inverse' is undefined.
+ */
+static bool invertMatrix6(const float * m, float * inverse) {
+    float a[6][12];
+    for(int r = 0; r < 6; ++r) {
+        for(int c = 0; c < 6; ++c) {
+            a[r][c] = m[r * 6 + c];
+            a[r][c + 6] = (r == c) ? 1.0f : 0.0f;
+        }
+    }
+
+    for(int c = 0; c < 6; ++c) {
+        int pivot = c;
+        for(int r = c + 1; r < 6; ++r) {
+            if (std::fabs(a[r][c]) > std::fabs(a[pivot][c])) { pivot = r; }
+        }
+        if (std::fabs(a[pivot][c]) < FLT_EPSILON) { return false; }
+
+        if (pivot != c) {
+            for(int k = 0; k < 12; ++k) { std::swap(a[c][k], a[pivot][k]); }
+        }
+
+        float invDiagonal = 1.0f / a[c][c];
+        for(int k = 0; k < 12; ++k) { a[c][k] *= invDiagonal; }
+
+        for(int r = 0; r < 6; ++r) {
+            if (r == c) { continue; }
+            float factor = a[r][c];
+            for(int k = 0; k < 12; ++k) { a[r][k] -= factor * a[c][k]; }
+        }
+    }
+
+    for(int r = 0; r < 6; ++r) {
+        for(int c = 0; c < 6; ++c) {
+            inverse[r * 6 + c] = a[r][c + 6];
+        }
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Writes the 3x3 matrix 'block' into the row-major 6x6 matrix 'm' with its
+ * upper left corner at ('row', 'col').
+ */
+static void setSubMatrix6(float * m, int row, int col, const mat3 & block) {
+    for(int r = 0; r < 3; ++r) {
+        for(int c = 0; c < 3; ++c) {
+            m[(row + r) * 6 + (col + c)] = block[c][r];
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+JointSolver::JointSolver()
+    : numIterations(10),
+      baumgarte(0.2f) {
+
+}
+
+//----------------------------------------------------------------------------------------
+JointSolver::~JointSolver() {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Adds a joint described by 'jointDef' to the solver.
+ *
+ * @return a \c JointID that can be used to modify the joint through
+ * JointSolver::getJoint().
+ */
+JointID JointSolver::createJoint(const JointDef & jointDef) {
+    if (jointDef.bodyA == jointDef.bodyB) {
+        throw Rigid3DException("Error in method JointSolver::createJoint. "
+                "A joint must connect two different bodies.");
+    }
+
+    joints.push_back(jointDef);
+
+    return JointID(joints.size() - 1);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return a reference to the \c JointDef used by the solver for 'jointId'.
+ * Changes to limits and motors take effect on the next call to
+ * JointSolver::solveVelocities().
+ */
+JointDef & JointSolver::getJoint(JointID jointId) {
+    if (jointId >= joints.size()) {
+        stringstream errorMessage;
+        errorMessage << "Error in method JointSolver::getJoint. " << jointId
+                     << " is not a valid JointID.";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    return joints[jointId];
+}
+
+//----------------------------------------------------------------------------------------
+size_t JointSolver::getNumJoints() const {
+    return joints.size();
+}
+
+//----------------------------------------------------------------------------------------
+void JointSolver::setNumIterations(int32 numIterations) {
+    this->numIterations = numIterations;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sets the fraction of position error removed per time step.
+ * @param baumgarte - value in the range [0, 1], typically 0.1 to 0.3.
+ */
+void JointSolver::setBaumgarteFactor(float baumgarte) {
+    this->baumgarte = baumgarte;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Adds a scalar row to 'rows' for a single degree of freedom, depending on its
+ * mode, current 'position' along the axis, and motor settings.
+ */
+void JointSolver::addDofRow(const DofConfig & dof, float position, float dt,
+                            int32 bodyA, int32 bodyB,
+                            const vec3 & linearA, const vec3 & angularA,
+                            const vec3 & linearB, const vec3 & angularB,
+                            float effectiveMass) {
+    if (effectiveMass == 0.0f) {
+        return;
+    }
+
+    float beta = baumgarte / dt;
+
+    if (dof.mode == DofMode::Locked) {
+        rows.addRow(bodyA, bodyB, linearA, angularA, linearB, angularB,
+                    effectiveMass, beta * position, -FLT_MAX, FLT_MAX);
+        return;
+    }
+
+    if (dof.mode == DofMode::Limited) {
+        if (position <= dof.lowerLimit) {
+            rows.addRow(bodyA, bodyB, linearA, angularA, linearB, angularB,
+                        effectiveMass, beta * (position - dof.lowerLimit), 0.0f, FLT_MAX);
+        } else if (position >= dof.upperLimit) {
+            rows.addRow(bodyA, bodyB, linearA, angularA, linearB, angularB,
+                        effectiveMass, beta * (position - dof.upperLimit), -FLT_MAX, 0.0f);
+        }
+    }
+
+    if (dof.enableMotor) {
+        float maxImpulse = dof.maxMotorForce * dt;
+        rows.addRow(bodyA, bodyB, linearA, angularA, linearB, angularB,
+                    effectiveMass, -dof.motorSpeed, -maxImpulse, maxImpulse);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Converts every joint into block and scalar constraints using the current
+ * state of 'bodies'.
+ */
+void JointSolver::buildConstraints(const SolverBody * bodies, float dt) {
+    rows.clear();
+    linearBlocks.clear();
+    angularBlocks.clear();
+    fixedBlocks.clear();
+
+    const float beta = baumgarte / dt;
+    const mat3 identity;
+
+    for(const JointDef & joint : joints) {
+        const SolverBody & a = bodies[joint.bodyA];
+        const SolverBody & b = bodies[joint.bodyB];
+        const mat3 & invIA = a.inverseInertiaWorld;
+        const mat3 & invIB = b.inverseInertiaWorld;
+        const float mA = a.inverseMass;
+        const float mB = b.inverseMass;
+
+        vec3 rA = a.orientation * joint.localAnchorA;
+        vec3 rB = b.orientation * joint.localAnchorB;
+        vec3 d = (b.position + rB) - (a.position + rA);
+
+        quat frameA = a.orientation * joint.localFrameA;
+        quat frameB = b.orientation * joint.localFrameB;
+
+        // Relative rotation of frame B expressed within frame A.
+        quat relative = conjugate(frameA) * frameB;
+        if (relative.w < 0.0f) {
+            relative = -relative;
+        }
+        vec3 relativeAxis(relative.x, relative.y, relative.z);
+
+        vec3 axes[3] = { frameA * vec3(1.0f, 0.0f, 0.0f),
+                         frameA * vec3(0.0f, 1.0f, 0.0f),
+                         frameA * vec3(0.0f, 0.0f, 1.0f) };
+
+        float angles[3] = { 2.0f * std::atan2(relative.x, relative.w),
+                            2.0f * std::atan2(relative.y, relative.w),
+                            2.0f * std::atan2(relative.z, relative.w) };
+
+        // Rotation error as a world space rotation vector.
+        vec3 angularError = frameA * (2.0f * relativeAxis);
+
+        mat3 sA = skew(rA);
+        mat3 sB = skew(rB);
+        mat3 linearK = (identity * (mA + mB)) - (sA * invIA * sA) - (sB * invIB * sB);
+        mat3 angularK = invIA + invIB;
+
+        bool lockAnchor = joint.type == JointType::Ball || joint.type == JointType::Hinge;
+        bool lockRotation = joint.type == JointType::Slider;
+
+        if (lockAnchor && std::fabs(glm::determinant(linearK)) > FLT_EPSILON) {
+            linearBlocks.addBlock(joint.bodyA, joint.bodyB, rA, rB,
+                                  glm::inverse(linearK), beta * d);
+        }
+
+        if (lockRotation && std::fabs(glm::determinant(angularK)) > FLT_EPSILON) {
+            angularBlocks.addBlock(joint.bodyA, joint.bodyB, vec3(0.0f), vec3(0.0f),
+                                   glm::inverse(angularK), beta * angularError);
+        }
+
+        if (joint.type == JointType::Fixed) {
+            float K[36];
+            setSubMatrix6(K, 0, 0, linearK);
+            setSubMatrix6(K, 0, 3, -(sA * invIA) - (sB * invIB));
+            setSubMatrix6(K, 3, 0, (invIA * sA) + (invIB * sB));
+            setSubMatrix6(K, 3, 3, angularK);
+
+            float inverseK[36];
+            if (invertMatrix6(K, inverseK)) {
+                vec3 linearBias = beta * d;
+                vec3 angularBias = beta * angularError;
+                float bias[6] = { linearBias.x, linearBias.y, linearBias.z,
+                                  angularBias.x, angularBias.y, angularBias.z };
+                fixedBlocks.addBlock(joint.bodyA, joint.bodyB, rA, rB, inverseK, bias);
+            }
+            continue;
+        }
+
+        for(int i = 0; i < 3; ++i) {
+            if (lockAnchor) { break; }
+
+            const vec3 & n = axes[i];
+            vec3 angularA = -cross(rA + d, n);
+            vec3 angularB = cross(rB, n);
+            float k = mA + mB + dot(angularA, invIA * angularA) +
+                    dot(angularB, invIB * angularB);
+
+            addDofRow(joint.linear[i], dot(d, n), dt, joint.bodyA, joint.bodyB,
+                      -n, angularA, n, angularB, (k > 0.0f) ? 1.0f / k : 0.0f);
+        }
+
+        for(int i = 0; i < 3; ++i) {
+            if (lockRotation) { break; }
+
+            const vec3 & n = axes[i];
+            float k = dot(n, invIA * n) + dot(n, invIB * n);
+
+            addDofRow(joint.angular[i], angles[i], dt, joint.bodyA, joint.bodyB,
+                      vec3(0.0f), -n, vec3(0.0f), n, (k > 0.0f) ? 1.0f / k : 0.0f);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+static void solveLinearBlocks(const BlockConstraint3Buffer & blocks, SolverBody * bodies) {
+    const size_t numBlocks = blocks.size();
+    for(size_t i = 0; i < numBlocks; ++i) {
+        SolverBody & a = bodies[blocks.bodyA[i]];
+        SolverBody & b = bodies[blocks.bodyB[i]];
+        const vec3 & rA = blocks.rA[i];
+        const vec3 & rB = blocks.rB[i];
+
+        vec3 cdot = b.linearVelocity + cross(b.angularVelocity, rB) -
+                    a.linearVelocity - cross(a.angularVelocity, rA);
+        vec3 P = -(blocks.inverseK[i] * (cdot + blocks.bias[i]));
+
+        a.linearVelocity -= a.inverseMass * P;
+        a.angularVelocity -= a.inverseInertiaWorld * cross(rA, P);
+        b.linearVelocity += b.inverseMass * P;
+        b.angularVelocity += b.inverseInertiaWorld * cross(rB, P);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+static void solveAngularBlocks(const BlockConstraint3Buffer & blocks, SolverBody * bodies) {
+    const size_t numBlocks = blocks.size();
+    for(size_t i = 0; i < numBlocks; ++i) {
+        SolverBody & a = bodies[blocks.bodyA[i]];
+        SolverBody & b = bodies[blocks.bodyB[i]];
+
+        vec3 cdot = b.angularVelocity - a.angularVelocity;
+        vec3 L = -(blocks.inverseK[i] * (cdot + blocks.bias[i]));
+
+        a.angularVelocity -= a.inverseInertiaWorld * L;
+        b.angularVelocity += b.inverseInertiaWorld * L;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+static void solveFixedBlocks(const BlockConstraint6Buffer & blocks, SolverBody * bodies) {
+    const size_t numBlocks = blocks.size();
+    for(size_t i = 0; i < numBlocks; ++i) {
+        SolverBody & a = bodies[blocks.bodyA[i]];
+        SolverBody & b = bodies[blocks.bodyB[i]];
+        const vec3 & rA = blocks.rA[i];
+        const vec3 & rB = blocks.rB[i];
+        const float * inverseK = &blocks.inverseK[i * 36];
+        const float * bias = &blocks.bias[i * 6];
+
+        vec3 linearCdot = b.linearVelocity + cross(b.angularVelocity, rB) -
+                          a.linearVelocity - cross(a.angularVelocity, rA);
+        vec3 angularCdot = b.angularVelocity - a.angularVelocity;
+
+        float rhs[6] = { linearCdot.x + bias[0], linearCdot.y + bias[1],
+                         linearCdot.z + bias[2], angularCdot.x + bias[3],
+                         angularCdot.y + bias[4], angularCdot.z + bias[5] };
+
+        float lambda[6];
+        for(int r = 0; r < 6; ++r) {
+            float sum = 0.0f;
+            for(int c = 0; c < 6; ++c) {
+                sum += inverseK[r * 6 + c] * rhs[c];
+            }
+            lambda[r] = -sum;
+        }
+
+        vec3 P(lambda[0], lambda[1], lambda[2]);
+        vec3 L(lambda[3], lambda[4], lambda[5]);
+
+        a.linearVelocity -= a.inverseMass * P;
+        a.angularVelocity -= a.inverseInertiaWorld * (cross(rA, P) + L);
+        b.linearVelocity += b.inverseMass * P;
+        b.angularVelocity += b.inverseInertiaWorld * (cross(rB, P) + L);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+static void solveRows(ConstraintRowBuffer & rows, SolverBody * bodies) {
+    const size_t numRows = rows.size();
+    for(size_t i = 0; i < numRows; ++i) {
+        SolverBody & a = bodies[rows.bodyA[i]];
+        SolverBody & b = bodies[rows.bodyB[i]];
+
+        float cdot = dot(rows.linearA[i], a.linearVelocity) +
+                     dot(rows.angularA[i], a.angularVelocity) +
+                     dot(rows.linearB[i], b.linearVelocity) +
+                     dot(rows.angularB[i], b.angularVelocity);
+
+        float lambda = -rows.effectiveMass[i] * (cdot + rows.bias[i]);
+
+        // Clamp the accumulated impulse, not the incremental one.
+        float oldImpulse = rows.impulse[i];
+        float newImpulse = std::min(std::max(oldImpulse + lambda, rows.lowerImpulse[i]),
+                                    rows.upperImpulse[i]);
+        rows.impulse[i] = newImpulse;
+        lambda = newImpulse - oldImpulse;
+
+        a.linearVelocity += (a.inverseMass * lambda) * rows.linearA[i];
+        a.angularVelocity += a.inverseInertiaWorld * (lambda * rows.angularA[i]);
+        b.linearVelocity += (b.inverseMass * lambda) * rows.linearB[i];
+        b.angularVelocity += b.inverseInertiaWorld * (lambda * rows.angularB[i]);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Applies constraint impulses to the linear and angular velocities of
+ * 'bodies' such that all joints are satisfied.
+ *
+ * @param bodies - array of bodies indexed by the joints' 'bodyA' and 'bodyB'.
+ * @param dt - time step in seconds.
+ */
+void JointSolver::solveVelocities(SolverBody * bodies, float dt) {
+    if (joints.empty() || dt <= 0.0f) {
+        return;
+    }
+
+    buildConstraints(bodies, dt);
+
+    for(int32 iteration = 0; iteration < numIterations; ++iteration) {
+        solveFixedBlocks(fixedBlocks, bodies);
+        solveLinearBlocks(linearBlocks, bodies);
+        solveAngularBlocks(angularBlocks, bodies);
+        solveRows(rows, bodies);
+    }
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,89 @@
+/**
+ * @brief JointSolver
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_JOINTSOLVER_HPP_
+#define RIGID3D_JOINTSOLVER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Dynamics/ConstraintBuffer.hpp>
+#include <Rigid3D/Dynamics/Joint.hpp>
+
+#include <vector>
+
+// Forward Declarations
+namespace Rigid3D {
+    struct SolverBody;
+}
+
+namespace Rigid3D {
+
+    typedef uint32 JointID;
+
+    /**
+     * @brief Sequential impulse solver for joints between \c SolverBody objects.
+     *
+     * Each call to JointSolver::solveVelocities() converts every joint into
+     * constraint rows stored in flat structure of arrays buffers, then
+     * iterates over those buffers without any per-joint dispatch:
+     * # Ball-socket anchors of Ball and Hinge joints are solved as 3x3 blocks.
+     * # Rotation locks of Slider joints are solved as 3x3 blocks.
+     * # Fixed joints are solved as a single 6x6 block.
+     * # Remaining locked axes, limits, and motors are solved as scalar rows.
+     *
+     * Position drift is corrected with Baumgarte stabilization.
+     *
+     * \code{.cpp}
+     *  JointSolver solver;
+     *  JointDef def;
+     *  def.initialize(JointType::Ball, bodies, 0, 1, anchor);
+     *  solver.createJoint(def);
+     *
+     *  integrateVelocities(bodies, numBodies, gravity, dt);
+     *  solver.solveVelocities(bodies, dt);
+     *  integratePositions(bodies, numBodies, dt);
+     * \endcode
+     */
+    class JointSolver {
+    public:
+        JointSolver();
+
+        ~JointSolver();
+
+        JointID createJoint(const JointDef & jointDef);
+
+        JointDef & getJoint(JointID jointId);
+
+        size_t getNumJoints() const;
+
+        void setNumIterations(int32 numIterations);
+
+        void setBaumgarteFactor(float baumgarte);
+
+        void solveVelocities(SolverBody * bodies, float dt);
+
+    private:
+        std::vector<JointDef> joints;
+
+        ConstraintRowBuffer rows;
+        BlockConstraint3Buffer linearBlocks;
+        BlockConstraint3Buffer angularBlocks;
+        BlockConstraint6Buffer fixedBlocks;
+
+        int32 numIterations;
+        float baumgarte;
+
+        void buildConstraints(const SolverBody * bodies, float dt);
+
+        void addDofRow(const DofConfig & dof, float position, float dt,
+                       int32 bodyA, int32 bodyB,
+                       const vec3 & linearA, const vec3 & angularA,
+                       const vec3 & linearB, const vec3 & angularB,
+                       float effectiveMass);
+    };
+
+}
+
+#endif /* RIGID3D_JOINTSOLVER_HPP_ */
@@ -0,0 +1,97 @@
+#include "SolverBody.hpp"
+
+#include <glm/gtx/quaternion.hpp>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+/**
+ * Constructs a static \c SolverBody located at the world origin.
+ */
+SolverBody::SolverBody()
+    : position(0.0f),
+      orientation(),
+      linearVelocity(0.0f),
+      angularVelocity(0.0f),
+      inverseMass(0.0f),
+      inverseInertiaLocal(0.0f),
+      inverseInertiaWorld(0.0f) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Makes the body immovable by constraint impulses and integration.
+ */
+void SolverBody::setStatic() {
+    inverseMass = 0.0f;
+    inverseInertiaLocal = mat3(0.0f);
+    inverseInertiaWorld = mat3(0.0f);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sets the mass and the diagonal body space inertia tensor of the body.
+ *
+ * @param mass - must be positive.
+ * @param principalInertia - moments of inertia about the body's x, y, and z axes.
+ */
+void SolverBody::setMass(float mass, const vec3 & principalInertia) {
+    inverseMass = 1.0f / mass;
+
+    inverseInertiaLocal = mat3(0.0f);
+    inverseInertiaLocal[0][0] = 1.0f / principalInertia.x;
+    inverseInertiaLocal[1][1] = 1.0f / principalInertia.y;
+    inverseInertiaLocal[2][2] = 1.0f / principalInertia.z;
+
+    updateInverseInertiaWorld();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Rotates the body space inverse inertia tensor into world space using the
+ * body's current orientation.
+ */
+void SolverBody::updateInverseInertiaWorld() {
+    mat3 R = glm::toMat3(orientation);
+    inverseInertiaWorld = R * inverseInertiaLocal * glm::transpose(R);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Applies gravity to the linear velocity of each dynamic body.
+ */
+void integrateVelocities(SolverBody * bodies, int32 numBodies, const vec3 & gravity,
+        float dt) {
+    for(int32 i = 0; i < numBodies; ++i) {
+        SolverBody & body = bodies[i];
+        if (body.inverseMass > 0.0f) {
+            body.linearVelocity += gravity * dt;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Advances the position and orientation of each body using its current
+ * velocities, then refreshes the world space inverse inertia tensor.
+ */
+void integratePositions(SolverBody * bodies, int32 numBodies, float dt) {
+    for(int32 i = 0; i < numBodies; ++i) {
+        SolverBody & body = bodies[i];
+        body.position += body.linearVelocity * dt;
+
+        // dq/dt = 0.5 * w * q
+        const vec3 & w = body.angularVelocity;
+        quat spin = quat(0.0f, w.x, w.y, w.z) * body.orientation;
+        body.orientation.w += 0.5f * dt * spin.w;
+        body.orientation.x += 0.5f * dt * spin.x;
+        body.orientation.y += 0.5f * dt * spin.y;
+        body.orientation.z += 0.5f * dt * spin.z;
+        body.orientation = glm::normalize(body.orientation);
+
+        body.updateInverseInertiaWorld();
+    }
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,45 @@
+/**
+ * @brief SolverBody
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_SOLVERBODY_HPP_
+#define RIGID3D_SOLVERBODY_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+namespace Rigid3D {
+
+    /**
+     * Rigid body state as seen by the constraint solver.
+     *
+     * A body with an \c inverseMass of zero and an \c inverseInertiaLocal of
+     * zero is treated as static, and is never moved by constraint impulses.
+     */
+    struct SolverBody {
+        vec3 position;            // Center of mass in world space.
+        quat orientation;         // Orientation of body space in world space.
+        vec3 linearVelocity;
+        vec3 angularVelocity;
+        float inverseMass;
+        mat3 inverseInertiaLocal; // Inverse inertia tensor given in body space.
+        mat3 inverseInertiaWorld; // Updated by updateInverseInertiaWorld().
+
+        SolverBody();
+
+        void setStatic();
+
+        void setMass(float mass, const vec3 & principalInertia);
+
+        void updateInverseInertiaWorld();
+    };
+
+    void integrateVelocities(SolverBody * bodies, int32 numBodies, const vec3 & gravity,
+            float dt);
+
+    void integratePositions(SolverBody * bodies, int32 numBodies, float dt);
+
+}
+
+#endif /* RIGID3D_SOLVERBODY_HPP_ */
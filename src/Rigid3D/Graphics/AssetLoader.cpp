@@ -0,0 +1,290 @@
+#include "AssetLoader.hpp"
+
+#include <Rigid3D/Common/MappedFile.hpp>
+#include <Rigid3D/Common/ParallelFor.hpp>
+#include <Rigid3D/Graphics/MeshCache.hpp>
+
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <utility>
+
+namespace Rigid3D {
+
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+//----------------------------------------------------------------------------------------
+/**
+ * One queued load.  load() runs on a worker thread, and publish() later runs on
+ * the owning thread, from update().
+ */
+struct AssetJob {
+    // Size of the loaded asset, counted against the budget passed to update().
+    size_t numBytes;
+
+    std::exception_ptr error;
+
+    // Key of the asset within AssetLoader's pending futures.
+    string pendingKey;
+    bool isMesh;
+
+    AssetJob(const string & pendingKey, bool isMesh)
+        : numBytes(0), pendingKey(pendingKey), isMesh(isMesh) { }
+
+    virtual ~AssetJob() { }
+
+    virtual void load() = 0;
+
+    virtual void publish() = 0;
+};
+
+namespace {
+
+    //------------------------------------------------------------------------------------
+    template <class T>
+    struct TypedAssetJob : public AssetJob {
+        std::promise<shared_ptr<const T> > promise;
+        shared_ptr<const T> asset;
+
+        TypedAssetJob(const string & pendingKey, bool isMesh)
+            : AssetJob(pendingKey, isMesh) { }
+
+        virtual void publish() {
+            if (error) {
+                promise.set_exception(error);
+            } else {
+                promise.set_value(std::move(asset));
+            }
+        }
+    };
+
+    //------------------------------------------------------------------------------------
+    struct MeshJob : public TypedAssetJob<Mesh> {
+        string objFilePath;
+        MeshIndexing indexing;
+
+        MeshJob(const string & pendingKey, const char * objFilePath, MeshIndexing indexing)
+            : TypedAssetJob<Mesh>(pendingKey, true),
+              objFilePath(objFilePath),
+              indexing(indexing) { }
+
+        // Other workers load other assets meanwhile, so parse on this thread alone
+        // rather than starting a thread per hardware thread for every load.
+        virtual void load() {
+            MeshData data;
+            MeshCache::load(objFilePath.c_str(), indexing, data,
+                    MeshCache::getDefaultLodRatios(), 1);
+            numBytes = data.positions.size() * sizeof(vec3) +
+                       data.normals.size() * sizeof(vec3) +
+                       data.uvCoords.size() * sizeof(vec2) +
+                       (data.indices.empty() ? 0 : data.indices.getNumBytes()) +
+                       (data.lodIndices.empty() ? 0 : data.lodIndices.getNumBytes());
+            asset = std::make_shared<Mesh>(std::move(data));
+        }
+    };
+
+    //------------------------------------------------------------------------------------
+    struct FileJob : public TypedAssetJob<vector<char> > {
+        string filePath;
+
+        FileJob(const string & pendingKey, const char * filePath)
+            : TypedAssetJob<vector<char> >(pendingKey, false),
+              filePath(filePath) { }
+
+        virtual void load() {
+            MappedFile file(filePath.c_str());
+            shared_ptr<vector<char> > bytes = std::make_shared<vector<char> >(file.getSize());
+            if (file.getSize() != 0) {
+                std::memcpy(bytes->data(), file.getData(), file.getSize());
+            }
+            numBytes = bytes->size();
+            asset = bytes;
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Starts the worker threads.
+ *
+ * @param numThreads - number of worker threads.  Zero uses one per hardware thread.
+ */
+AssetLoader::AssetLoader(uint32 numThreads)
+    : numRunningJobs(0),
+      stopping(false) {
+
+    numThreads = resolveThreadCount(numThreads);
+    workers.reserve(numThreads);
+    for(uint32 i = 0; i < numThreads; ++i) {
+        workers.push_back(std::thread([this]() { runWorker(); }));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Waits for loads already running, then stops the worker threads.  Loads that
+ * were still queued, or finished but not yet handed over, are abandoned, and
+ * their futures throw std::future_error from get().
+ */
+AssetLoader::~AssetLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobQueued.notify_all();
+
+    for(std::thread & worker : workers) {
+        worker.join();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Queues loading the mesh in 'objFilePath', through its MeshCache file, as by
+ * the Mesh constructor.
+ *
+ * Loading a mesh that is still pending returns the same future.
+ */
+AssetLoader::MeshFuture AssetLoader::loadMesh(const char * objFilePath,
+        MeshIndexing indexing) {
+    string key(objFilePath);
+    key += (indexing == MeshIndexing::Indexed) ? "|indexed" : "|unindexed";
+
+    auto pending = pendingMeshes.find(key);
+    if (pending != pendingMeshes.end()) {
+        return pending->second;
+    }
+
+    shared_ptr<MeshJob> job = std::make_shared<MeshJob>(key, objFilePath, indexing);
+    MeshFuture future = job->promise.get_future().share();
+    pendingMeshes[key] = future;
+    enqueue(job);
+    return future;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Queues reading the whole of 'filePath' into memory, such as shader source or
+ * an image for a texture.
+ *
+ * Loading a file that is still pending returns the same future.
+ */
+AssetLoader::FileFuture AssetLoader::loadFile(const char * filePath) {
+    const string key(filePath);
+
+    auto pending = pendingFiles.find(key);
+    if (pending != pendingFiles.end()) {
+        return pending->second;
+    }
+
+    shared_ptr<FileJob> job = std::make_shared<FileJob>(key, filePath);
+    FileFuture future = job->promise.get_future().share();
+    pendingFiles[key] = future;
+    enqueue(job);
+    return future;
+}
+
+//----------------------------------------------------------------------------------------
+void AssetLoader::enqueue(const shared_ptr<AssetJob> & job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queuedJobs.push_back(job);
+    }
+    jobQueued.notify_one();
+}
+
+//----------------------------------------------------------------------------------------
+void AssetLoader::runWorker() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    for(;;) {
+        jobQueued.wait(lock, [this]() { return stopping || !queuedJobs.empty(); });
+        if (stopping) {
+            return;
+        }
+
+        shared_ptr<AssetJob> job = std::move(queuedJobs.front());
+        queuedJobs.pop_front();
+        ++numRunningJobs;
+
+        lock.unlock();
+        try {
+            job->load();
+        } catch (...) {
+            job->error = std::current_exception();
+        }
+        lock.lock();
+
+        --numRunningJobs;
+        finishedJobs.push_back(std::move(job));
+        jobFinished.notify_all();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Hands finished assets over to the calling thread, making their futures ready,
+ * in the order they finished.  Stops once the assets handed over add up to
+ * 'maxBytes' or more, but always hands over at least one finished asset, so
+ * that assets larger than the budget still arrive.
+ *
+ * Call once per frame.  Never blocks on loads still in progress.
+ *
+ * @return number of assets handed over.
+ */
+uint32 AssetLoader::update(size_t maxBytes) {
+    vector<shared_ptr<AssetJob> > jobs;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t numBytes = 0;
+        while (!finishedJobs.empty() && (jobs.empty() || numBytes < maxBytes)) {
+            numBytes += finishedJobs.front()->numBytes;
+            jobs.push_back(std::move(finishedJobs.front()));
+            finishedJobs.pop_front();
+        }
+    }
+
+    for(const shared_ptr<AssetJob> & job : jobs) {
+        if (job->isMesh) {
+            pendingMeshes.erase(job->pendingKey);
+        } else {
+            pendingFiles.erase(job->pendingKey);
+        }
+        job->publish();
+    }
+    return uint32(jobs.size());
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Blocks until every queued load is done, then hands all of them over,
+ * regardless of budget.  For loading screens and level transitions, where
+ * stalling the main thread is acceptable.
+ */
+void AssetLoader::finish() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        jobFinished.wait(lock, [this]() {
+            return queuedJobs.empty() && numRunningJobs == 0;
+        });
+    }
+    update(std::numeric_limits<size_t>::max());
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of loads queued, running, or finished but not yet handed over.
+ */
+uint32 AssetLoader::getNumPending() const {
+    return uint32(pendingMeshes.size() + pendingFiles.size());
+}
+
+//----------------------------------------------------------------------------------------
+uint32 AssetLoader::getNumThreads() const {
+    return uint32(workers.size());
+}
+
+}
@@ -0,0 +1,116 @@
+/**
+ * @brief AssetLoader
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_ASSET_LOADER_HPP_
+#define RIGID3D_ASSET_LOADER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Rigid3D {
+
+    struct AssetJob;
+
+    /**
+     * @brief Loads assets on a pool of background I/O threads.
+     *
+     * Each load is queued and returns a future straight away.  Worker threads
+     * read and decode assets while the main thread carries on simulating and
+     * rendering, and finished assets wait in a completion queue until the main
+     * thread calls update().  update() hands over finished assets, in the order
+     * they finished, until a byte budget is spent, and only then do their futures
+     * become ready.  This bounds how much newly loaded data, such as buffers to
+     * upload to OpenGL, arrives in any one frame.
+     *
+     * Each worker thread decodes one asset at a time, by itself, so loading uses
+     * no more threads than the AssetLoader was given.
+     *
+     * \code{.cpp}
+     *  AssetLoader loader;
+     *  AssetLoader::MeshFuture bunny = loader.loadMesh("bunny.obj");
+     *
+     *  // Once per frame:
+     *  loader.update(4 * 1024 * 1024);
+     *  if (AssetLoader::isReady(bunny)) {
+     *      uploadMesh(*bunny.get());
+     *  }
+     * \endcode
+     *
+     * Futures only become ready through update() or finish(), so the main thread
+     * must not block on one without calling either.  Loads that fail make their
+     * futures throw the failure's exception from get().
+     *
+     * All member functions are called from the thread that owns the AssetLoader.
+     */
+    class AssetLoader {
+    public:
+        typedef std::shared_future<std::shared_ptr<const Mesh> > MeshFuture;
+        typedef std::shared_future<std::shared_ptr<const std::vector<char> > > FileFuture;
+
+        explicit AssetLoader(uint32 numThreads = 0);
+
+        ~AssetLoader();
+
+        MeshFuture loadMesh(const char * objFilePath,
+                MeshIndexing indexing = MeshIndexing::Unindexed);
+
+        FileFuture loadFile(const char * filePath);
+
+        uint32 update(size_t maxBytes);
+
+        void finish();
+
+        uint32 getNumPending() const;
+
+        uint32 getNumThreads() const;
+
+        template <class T>
+        static bool isReady(const std::shared_future<T> & future) {
+            return future.valid() &&
+                   future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+    private:
+        AssetLoader(const AssetLoader &);
+        AssetLoader & operator = (const AssetLoader &);
+
+        void enqueue(const std::shared_ptr<AssetJob> & job);
+
+        void runWorker();
+
+        std::vector<std::thread> workers;
+
+        mutable std::mutex mutex;
+        std::condition_variable jobQueued;
+        std::condition_variable jobFinished;
+
+        // Guarded by 'mutex'.
+        std::deque<std::shared_ptr<AssetJob> > queuedJobs;
+        std::deque<std::shared_ptr<AssetJob> > finishedJobs;
+        uint32 numRunningJobs;
+        bool stopping;
+
+        // Futures of meshes and files not yet handed over, so that loading the
+        // same asset again shares its future.  Only used by the owning thread.
+        std::unordered_map<std::string, MeshFuture> pendingMeshes;
+        std::unordered_map<std::string, FileFuture> pendingFiles;
+    };
+
+}
+
+#endif /* RIGID3D_ASSET_LOADER_HPP_ */
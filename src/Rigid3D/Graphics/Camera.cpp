@@ -179,6 +179,16 @@ mat4 Camera::getViewMatrix() const {
     return viewMatrix;
 }
 
+//----------------------------------------------------------------------------------------
+/**
+ * Computes the world space planes bounding the \c Camera's view volume.
+ *
+ * @see Frustum::extractPlanes
+ */
+void Camera::getPlanes(vec4 planes[numFrustumPlanes]) const {
+    Frustum::getPlanes(getViewMatrix(), planes);
+}
+
 //----------------------------------------------------------------------------------------
 void Camera::normalizeCamera() {
     l = normalize(l);
@@ -37,6 +37,9 @@ namespace Rigid3D {
         quat getOrientation() const;
         mat4 getViewMatrix() const;
 
+        using Frustum::getPlanes;
+        void getPlanes(vec4 planes[numFrustumPlanes]) const;
+
         // Actions
         void lookAt(const vec3 & center);
         void lookAt(float centerX, float centerY, float centerZ);
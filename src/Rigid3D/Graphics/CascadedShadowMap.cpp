@@ -0,0 +1,612 @@
+#include "CascadedShadowMap.hpp"
+
+#include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/Camera.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/Renderable.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+namespace Rigid3D {
+
+namespace {
+
+    // Index of the lowest set bit of 'x', which must not be zero.
+    inline uint32 findLowestBit(uint32 x) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, x);
+        return uint32(index);
+#else
+        return uint32(__builtin_ctz(x));
+#endif
+    }
+
+    inline void setCapability(GLenum capability, GLboolean enabled) {
+        if (enabled) {
+            glEnable(capability);
+        } else {
+            glDisable(capability);
+        }
+    }
+
+}
+
+const uint32 CascadedShadowMap::maxCascades;
+
+//----------------------------------------------------------------------------------------
+/**
+ * @throws Rigid3DException if 'numCascades' is zero or greater than maxCascades,
+ * or 'resolution' is zero.
+ */
+CascadedShadowMap::CascadedShadowMap(uint32 numCascades, uint32 resolution,
+        uint32 numThreads)
+    : numCascades(numCascades),
+      resolution(resolution),
+      lightDirection(0.0f),
+      shadowDistance(100.0f),
+      splitLambda(0.75f),
+      cascadeMargin(0.1f),
+      depthBiasSlope(2.0f),
+      depthBiasUnits(4.0f),
+      culler(numThreads),
+      depthTexture(0),
+      staticDepthTexture(0),
+      framebuffer(0)
+{
+    if (numCascades == 0 || numCascades > maxCascades) {
+        throw Rigid3DException("Number of cascades out of range within method "
+                "CascadedShadowMap::CascadedShadowMap");
+    }
+    if (resolution == 0) {
+        throw Rigid3DException("Resolution must be positive within method "
+                "CascadedShadowMap::CascadedShadowMap");
+    }
+
+    for(Cascade & cascade : cascades) {
+        cascade.splitDistance = 0.0f;
+        cascade.halfSize = 0.0f;
+        cascade.hasStaticDepth = false;
+    }
+    invalidateCascades();
+    setLightDirection(vec3(0.0f, -1.0f, 0.0f));
+}
+
+//----------------------------------------------------------------------------------------
+CascadedShadowMap::~CascadedShadowMap() {
+    if (framebuffer != 0) {
+        glDeleteFramebuffers(1, &framebuffer);
+    }
+    if (depthTexture != 0) {
+        glDeleteTextures(1, &depthTexture);
+        glDeleteTextures(1, &staticDepthTexture);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sets the direction the light travels in, in world space.
+ *
+ * @throws Rigid3DException if 'direction' has zero length.
+ */
+void CascadedShadowMap::setLightDirection(const vec3 & direction) {
+    const float length = glm::length(direction);
+    if (length == 0.0f) {
+        throw Rigid3DException("Light direction must be non-zero within method "
+                "CascadedShadowMap::setLightDirection");
+    }
+    const vec3 newDirection = direction / length;
+    if (newDirection == lightDirection) {
+        return;
+    }
+    lightDirection = newDirection;
+
+    // Light space is a rotation of world space, looking along the light.
+    const vec3 up = (std::abs(lightDirection.y) < 0.99f) ? vec3(0.0f, 1.0f, 0.0f) :
+                                                          vec3(0.0f, 0.0f, 1.0f);
+    lightViewMatrix = glm::lookAt(vec3(0.0f), lightDirection, up);
+
+    invalidateCascades();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sets the view distance from the camera up to which shadows are drawn, which
+ * the camera's far plane limits further.  Defaults to 100.
+ */
+void CascadedShadowMap::setShadowDistance(float distance) {
+    shadowDistance = distance;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sets the blend of split distances between uniform splits, at zero, and
+ * logarithmic splits, at one.  Defaults to 0.75.
+ */
+void CascadedShadowMap::setSplitLambda(float lambda) {
+    splitLambda = glm::clamp(lambda, 0.0f, 1.0f);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sets how much wider than its slice's bounding sphere a cascade is, as a
+ * fraction of the sphere's radius.  Wider cascades are moved, and so redrawn,
+ * less often as the camera moves, at the cost of shadow resolution.  Defaults
+ * to 0.1.
+ */
+void CascadedShadowMap::setCascadeMargin(float margin) {
+    cascadeMargin = std::max(0.0f, margin);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sets the glPolygonOffset() applied while drawing casters.  Defaults to a
+ * slope factor of 2 and 4 units.
+ */
+void CascadedShadowMap::setDepthBias(float slopeFactor, float units) {
+    depthBiasSlope = slopeFactor;
+    depthBiasUnits = units;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Adds 'renderable' as a shadow caster, bounded by 'bounds' in world space.
+ * Static casters are expected to rarely move, and have their depth cached.
+ *
+ * @return index of the caster, for setCasterBounds() and isCasterInCascade().
+ */
+uint32 CascadedShadowMap::addCaster(Renderable & renderable, const AABB & bounds,
+        bool isStatic) {
+    Caster caster;
+    caster.renderable = &renderable;
+    caster.isStatic = isStatic;
+    casters.push_back(caster);
+
+    const uint32 index = culler.addBox(bounds);
+    movedCasters.push_back(index);
+    return index;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Replaces the bounds of 'caster' after it moved, so that the cascades it
+ * left or entered are redrawn at the next render().
+ *
+ * @throws Rigid3DException if 'caster' is not less than getNumCasters().
+ */
+void CascadedShadowMap::setCasterBounds(uint32 caster, const AABB & bounds) {
+    if (caster >= getNumCasters()) {
+        throw Rigid3DException("Caster index out of range within method "
+                "CascadedShadowMap::setCasterBounds");
+    }
+    culler.setBox(caster, bounds);
+    movedCasters.push_back(caster);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Removes all casters.
+ */
+void CascadedShadowMap::clearCasters() {
+    casters.clear();
+    movedCasters.clear();
+    culler.clear();
+
+    for(uint32 i = 0; i < numCascades; ++i) {
+        cascades[i].visibility.clear();
+        cascades[i].needsRender = true;
+        cascades[i].needsStaticRender = true;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+uint32 CascadedShadowMap::getNumCasters() const {
+    return uint32(casters.size());
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Splits the view volume of 'camera' into cascades, places each cascade's
+ * light space box, culls the casters against it, and marks the cascades that
+ * render() must redraw.  Touches no OpenGL state.
+ *
+ * @throws Rigid3DException if 'camera' does not have a perspective projection.
+ */
+void CascadedShadowMap::update(const Camera & camera) {
+    const mat4 projection = camera.getProjectionMatrix();
+    if (projection[3][3] != 0.0f) {
+        throw Rigid3DException("Camera must have a perspective projection within "
+                "method CascadedShadowMap::update");
+    }
+
+    // Read from the matrix, so that cameras given an infinite perspective
+    // through setProjectionMatrix() work too.
+    const float tanHalfX = 1.0f / projection[0][0];
+    const float tanHalfY = 1.0f / projection[1][1];
+    const float zNear = projection[3][2] / (projection[2][2] - 1.0f);
+    float zFar = shadowDistance;
+    if (projection[2][2] + 1.0f < 0.0f) {
+        zFar = std::min(zFar, projection[3][2] / (projection[2][2] + 1.0f));
+    }
+    if (!(zFar > zNear)) {
+        throw Rigid3DException("Shadow distance must be beyond the camera's near "
+                "plane within method CascadedShadowMap::update");
+    }
+
+    // Squared distance of a slice corner from the view axis, per unit depth squared.
+    const float cornerScale = tanHalfX * tanHalfX + tanHalfY * tanHalfY;
+
+    stats.numCastersCulled = 0;
+    float sliceNear = zNear;
+    for(uint32 i = 0; i < numCascades; ++i) {
+        Cascade & cascade = cascades[i];
+
+        const float t = float(i + 1) / float(numCascades);
+        const float logSplit = zNear * std::pow(zFar / zNear, t);
+        const float uniformSplit = zNear + (zFar - zNear) * t;
+        const float sliceFar = (i + 1 == numCascades) ? zFar :
+                splitLambda * logSplit + (1.0f - splitLambda) * uniformSplit;
+        cascade.splitDistance = sliceFar;
+
+        // Smallest sphere about the view axis through all eight slice corners.
+        const float nearCorner = sliceNear * sliceNear * cornerScale;
+        const float farCorner = sliceFar * sliceFar * cornerScale;
+        float centerDepth = (sliceFar * sliceFar + farCorner - sliceNear * sliceNear -
+                nearCorner) / (2.0f * (sliceFar - sliceNear));
+        centerDepth = glm::clamp(centerDepth, sliceNear, sliceFar);
+        const float radius = std::sqrt(std::max(
+                (centerDepth - sliceNear) * (centerDepth - sliceNear) + nearCorner,
+                (sliceFar - centerDepth) * (sliceFar - centerDepth) + farCorner));
+
+        const vec3 sliceCenter = camera.getPosition() +
+                camera.getForwardDirection() * centerDepth;
+        const bool moved = placeCascade(cascade, sliceCenter, radius);
+
+        // Casters between the light and the cascade still shadow it.
+        vec4 planes[numFrustumPlanes];
+        Frustum::extractPlanes(cascade.viewProjectionMatrix, planes);
+        planes[int(FrustumPlane::Near)] = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        culler.cull(planes);
+        stats.numCastersCulled += culler.getNumCulled();
+
+        if (moved) {
+            cascade.needsRender = true;
+            cascade.needsStaticRender = true;
+        } else {
+            markMovedCasters(cascade, culler.getVisibility());
+        }
+        cascade.visibility = culler.getVisibility();
+
+        sliceNear = sliceFar;
+    }
+
+    movedCasters.clear();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Keeps 'cascade' where it is if the slice sphere of 'sliceCenter' and
+ * 'sliceRadius' still fits inside it, and otherwise centers it on the sphere.
+ *
+ * @return true if the cascade's view-projection matrix changed.
+ */
+bool CascadedShadowMap::placeCascade(Cascade & cascade, const vec3 & sliceCenter,
+        float sliceRadius) {
+    float halfSize = sliceRadius * (1.0f + cascadeMargin);
+
+    // Room for snapping the center by up to half a texel.
+    halfSize += 2.0f * halfSize / float(resolution);
+
+    const vec3 center = vec3(lightViewMatrix * vec4(sliceCenter, 1.0f));
+    if (cascade.isPlaced && cascade.halfSize == halfSize) {
+        const vec3 offset = glm::abs(center - cascade.center);
+        if (std::max(offset.x, std::max(offset.y, offset.z)) + sliceRadius <= halfSize) {
+            return false;
+        }
+    }
+
+    // Moving only by whole texels keeps shadow edges from shimmering.
+    const float texelSize = 2.0f * halfSize / float(resolution);
+    cascade.center.x = std::floor(center.x / texelSize + 0.5f) * texelSize;
+    cascade.center.y = std::floor(center.y / texelSize + 0.5f) * texelSize;
+    cascade.center.z = center.z;
+    cascade.halfSize = halfSize;
+    cascade.isPlaced = true;
+
+    // Light space looks down -z, so the near plane faces the light.
+    const vec3 & c = cascade.center;
+    const mat4 projection = glm::ortho(c.x - halfSize, c.x + halfSize,
+            c.y - halfSize, c.y + halfSize, -c.z - halfSize, -c.z + halfSize);
+    cascade.viewProjectionMatrix = projection * lightViewMatrix;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Marks 'cascade' for redrawing if any caster that moved since the last
+ * update() was in it before, or is in it by 'visibility' now.
+ */
+void CascadedShadowMap::markMovedCasters(Cascade & cascade,
+        const std::vector<uint32> & visibility) {
+    for(uint32 caster : movedCasters) {
+        const uint32 word = caster / 32;
+        const uint32 bit = 1u << (caster % 32);
+        const bool wasInside = word < cascade.visibility.size() &&
+                (cascade.visibility[word] & bit) != 0;
+        const bool isInside = (visibility[word] & bit) != 0;
+
+        if (wasInside || isInside) {
+            cascade.needsRender = true;
+            if (casters[caster].isStatic) {
+                cascade.needsStaticRender = true;
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Redraws the cascades marked by update().  Static casters are drawn into the
+ * cache layer only when a static caster of the cascade moved, or the cascade
+ * did.  Restores the framebuffer bindings, viewport, depth test, depth mask,
+ * depth clamping and polygon offset on return, and leaves 'depthProgram'
+ * enabled and the VAO of the last caster drawn bound.
+ *
+ * @throws ShaderException if 'depthProgram' has no ModelViewProjectionMatrix.
+ */
+void CascadedShadowMap::render(ShaderProgram & depthProgram) {
+    stats.numCascadesRendered = 0;
+    stats.numStaticCascadesRendered = 0;
+    stats.numCastersDrawn = 0;
+
+    if (depthTexture == 0) {
+        createTextures();
+    }
+
+    bool anyNeedsRender = false;
+    for(uint32 i = 0; i < numCascades; ++i) {
+        anyNeedsRender |= cascades[i].needsRender;
+    }
+    if (!anyNeedsRender) {
+        return;
+    }
+
+    const GLint mvpLocation = depthProgram.getUniformLocation("ModelViewProjectionMatrix");
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    GLint previousFramebuffer;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    const GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    const GLboolean depthClamp = glIsEnabled(GL_DEPTH_CLAMP);
+    const GLboolean polygonOffsetFill = glIsEnabled(GL_POLYGON_OFFSET_FILL);
+    GLboolean depthMask;
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+    GLfloat polygonOffsetFactor;
+    GLfloat polygonOffsetUnits;
+    glGetFloatv(GL_POLYGON_OFFSET_FACTOR, &polygonOffsetFactor);
+    glGetFloatv(GL_POLYGON_OFFSET_UNITS, &polygonOffsetUnits);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, resolution, resolution);
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+    glEnable(GL_DEPTH_CLAMP);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(depthBiasSlope, depthBiasUnits);
+    depthProgram.enable();
+
+    for(uint32 i = 0; i < numCascades; ++i) {
+        Cascade & cascade = cascades[i];
+        if (!cascade.needsRender) {
+            continue;
+        }
+
+        if (cascade.needsStaticRender) {
+            glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                    staticDepthTexture, 0, i);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            cascade.hasStaticDepth = drawCasters(cascade, true, depthProgram, mvpLocation) > 0;
+            ++stats.numStaticCascadesRendered;
+        }
+
+        glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                depthTexture, 0, i);
+        if (cascade.hasStaticDepth) {
+            glCopyImageSubData(staticDepthTexture, GL_TEXTURE_2D_ARRAY, 0, 0, 0, i,
+                    depthTexture, GL_TEXTURE_2D_ARRAY, 0, 0, 0, i,
+                    resolution, resolution, 1);
+        } else {
+            glClear(GL_DEPTH_BUFFER_BIT);
+        }
+        drawCasters(cascade, false, depthProgram, mvpLocation);
+        ++stats.numCascadesRendered;
+
+        cascade.needsRender = false;
+        cascade.needsStaticRender = false;
+    }
+
+    setCapability(GL_DEPTH_TEST, depthTest);
+    setCapability(GL_DEPTH_CLAMP, depthClamp);
+    setCapability(GL_POLYGON_OFFSET_FILL, polygonOffsetFill);
+    glDepthMask(depthMask);
+    glPolygonOffset(polygonOffsetFactor, polygonOffsetUnits);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousFramebuffer);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Draws the static or dynamic casters inside 'cascade' with 'depthProgram'.
+ *
+ * @return number of casters drawn.
+ */
+uint32 CascadedShadowMap::drawCasters(const Cascade & cascade, bool staticCasters,
+        ShaderProgram & depthProgram, GLint mvpLocation) {
+    GLuint boundVertexArray = 0;
+    uint32 numDrawn = 0;
+
+    for(uint32 word = 0; word < cascade.visibility.size(); ++word) {
+        for(uint32 bits = cascade.visibility[word]; bits != 0; bits &= bits - 1) {
+            const Caster & caster = casters[32 * word + findLowestBit(bits)];
+            Renderable & renderable = *caster.renderable;
+            if (caster.isStatic != staticCasters || !renderable.isComplete()) {
+                continue;
+            }
+
+            const GLuint vertexArray = renderable.getVertexArray();
+            if (vertexArray != boundVertexArray) {
+                glBindVertexArray(vertexArray);
+                boundVertexArray = vertexArray;
+            }
+            depthProgram.setUniform(mvpLocation,
+                    cascade.viewProjectionMatrix * renderable.getModelMatrix());
+            renderable.drawBatch();
+            ++numDrawn;
+        }
+    }
+
+    stats.numCastersDrawn += numDrawn;
+    return numDrawn;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Allocates the shadow map and static cache texture arrays, and the
+ * framebuffer their layers are attached to in turn.  Leaves the texture and
+ * framebuffer bindings as they were.
+ */
+void CascadedShadowMap::createTextures() {
+    GLint previousTexture;
+    GLint previousDrawFramebuffer;
+    GLint previousReadFramebuffer;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D_ARRAY, &previousTexture);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDrawFramebuffer);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFramebuffer);
+
+    GLuint textures[2];
+    glGenTextures(2, textures);
+    depthTexture = textures[0];
+    staticDepthTexture = textures[1];
+
+    for(GLuint texture : textures) {
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_DEPTH_COMPONENT32F, resolution,
+                resolution, numCascades);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+
+    // Lookups outside the shadow map are lit.
+    const GLfloat borderColor[] = {1.0f, 1.0f, 1.0f, 1.0f};
+    glBindTexture(GL_TEXTURE_2D_ARRAY, depthTexture);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, previousTexture);
+
+    // Bound for both drawing and reading, so that the draw and read buffers
+    // set are the shadow framebuffer's own.
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousDrawFramebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousReadFramebuffer);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 CascadedShadowMap::getNumCascades() const {
+    return numCascades;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 CascadedShadowMap::getResolution() const {
+    return resolution;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the GL_TEXTURE_2D_ARRAY of cascade depths, with one layer per
+ * cascade, or zero before the first render().
+ */
+GLuint CascadedShadowMap::getDepthTexture() const {
+    return depthTexture;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return view distance from the camera at which 'cascade' ends, as of the
+ * last update().
+ */
+float CascadedShadowMap::getSplitDistance(uint32 cascade) const {
+    return cascades[cascade].splitDistance;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return matrix taking world space to the clip space of 'cascade'.
+ */
+const mat4 & CascadedShadowMap::getViewProjectionMatrix(uint32 cascade) const {
+    return cascades[cascade].viewProjectionMatrix;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return matrix taking world space to the texture coordinates and depth of
+ * 'cascade', for lookups into getDepthTexture().
+ */
+mat4 CascadedShadowMap::getShadowMatrix(uint32 cascade) const {
+    const mat4 biasMatrix(vec4(0.5f, 0.0f, 0.0f, 0.0f),
+                          vec4(0.0f, 0.5f, 0.0f, 0.0f),
+                          vec4(0.0f, 0.0f, 0.5f, 0.0f),
+                          vec4(0.5f, 0.5f, 0.5f, 1.0f));
+    return biasMatrix * cascades[cascade].viewProjectionMatrix;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if 'caster' was found inside 'cascade' by the last update().
+ */
+bool CascadedShadowMap::isCasterInCascade(uint32 caster, uint32 cascade) const {
+    const std::vector<uint32> & visibility = cascades[cascade].visibility;
+    const uint32 word = caster / 32;
+    return word < visibility.size() && ((visibility[word] >> (caster % 32)) & 1u);
+}
+
+//----------------------------------------------------------------------------------------
+const ShadowStats & CascadedShadowMap::getStats() const {
+    return stats;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Forces every cascade to be placed anew and redrawn at the next update().
+ */
+void CascadedShadowMap::invalidateCascades() {
+    for(Cascade & cascade : cascades) {
+        cascade.isPlaced = false;
+        cascade.needsRender = true;
+        cascade.needsStaticRender = true;
+    }
+}
+
+}
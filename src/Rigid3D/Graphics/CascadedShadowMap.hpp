@@ -0,0 +1,206 @@
+/**
+ * @brief CascadedShadowMap
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_CASCADED_SHADOW_MAP_HPP_
+#define RIGID3D_CASCADED_SHADOW_MAP_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Graphics/FrustumCuller.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    struct AABB;
+    class Camera;
+    class Renderable;
+    class ShaderProgram;
+}
+
+namespace Rigid3D {
+
+    /**
+     * Counts of the work done by the last CascadedShadowMap::update() and
+     * CascadedShadowMap::render().
+     */
+    struct ShadowStats {
+        // Cascades whose depth was redrawn, and of those, the ones whose
+        // static caster cache was redrawn too.
+        uint32 numCascadesRendered;
+        uint32 numStaticCascadesRendered;
+
+        // Caster draws summed over cascades.
+        uint32 numCastersDrawn;
+
+        // Casters found outside a cascade, summed over cascades.
+        uint32 numCastersCulled;
+
+        ShadowStats()
+                : numCascadesRendered(0), numStaticCascadesRendered(0),
+                  numCastersDrawn(0), numCastersCulled(0) { }
+    };
+
+    /**
+     * @brief Cascaded shadow maps of a directional light, with shadow casters
+     * culled per cascade and the depth of static casters cached between
+     * frames.
+     *
+     * The camera's view volume, up to the shadow distance, is split along its
+     * view direction into slices, each covered by one layer of a depth texture
+     * array.  Split distances blend logarithmic and uniform splits by the split
+     * lambda.  Each cascade is an orthographic light space box around the
+     * bounding sphere of its slice, widened by the cascade margin and snapped
+     * to whole texels, and it stays put while its slice remains inside it, so
+     * cascades neither shimmer nor change every time the camera moves.
+     * \code{.cpp}
+     *  CascadedShadowMap shadowMap(4, 2048);
+     *  shadowMap.setLightDirection(vec3(-1.0f, -2.0f, -1.0f));
+     *  uint32 ground = shadowMap.addCaster(groundRenderable, groundBounds, true);
+     *  uint32 bunny = shadowMap.addCaster(bunnyRenderable, bunnyBounds, false);
+     *
+     *  // Each frame:
+     *  shadowMap.setCasterBounds(bunny, movedBunnyBounds);
+     *  shadowMap.update(camera);
+     *  shadowMap.render(depthProgram);
+     *
+     *  glActiveTexture(GL_TEXTURE0);
+     *  glBindTexture(GL_TEXTURE_2D_ARRAY, shadowMap.getDepthTexture());
+     * \endcode
+     *
+     * update() culls the casters against every cascade with a FrustumCuller,
+     * ignoring each cascade's near plane so that casters between the light and
+     * the cascade still cast into it, and works out which cascades must be
+     * redrawn.  A cascade is redrawn only when its light matrix changed or a
+     * caster that moved was in it before or after moving.  Static casters are
+     * drawn into a cache layer of their own, which is copied into the shadow
+     * map before dynamic casters are drawn over it, so a moving dynamic caster
+     * costs a copy and the dynamic casters of its cascades, not the scene.
+     * Casters report movement through setCasterBounds().
+     *
+     * render() draws casters with 'depthProgram', which must have
+     * \code{.glsl}
+     *  uniform mat4 ModelViewProjectionMatrix;
+     * \endcode
+     * set per caster to the cascade's view-projection matrix times the
+     * Renderable's model matrix, and reads positions from each Renderable's
+     * VAO.  Casters closer to the light than a cascade are flattened onto its
+     * near plane by depth clamping.
+     *
+     * Receivers sample layer i with getShadowMatrix(i) when their view depth
+     * is less than getSplitDistance(i).  The depth texture compares with
+     * GL_LEQUAL, for use as a sampler2DArrayShadow.
+     *
+     * @note Requires OpenGL 4.3, for glCopyImageSubData.
+     * @note Renderables of casters must stay alive until they are cleared.
+     */
+    class CascadedShadowMap {
+    public:
+        static const uint32 maxCascades = 8;
+
+        // Zero 'numThreads' culls with one thread per hardware thread.
+        CascadedShadowMap(uint32 numCascades = 4, uint32 resolution = 2048,
+                uint32 numThreads = 0);
+
+        ~CascadedShadowMap();
+
+        void setLightDirection(const vec3 & direction);
+        void setShadowDistance(float distance);
+        void setSplitLambda(float lambda);
+        void setCascadeMargin(float margin);
+        void setDepthBias(float slopeFactor, float units);
+
+        uint32 addCaster(Renderable & renderable, const AABB & bounds, bool isStatic);
+
+        void setCasterBounds(uint32 caster, const AABB & bounds);
+
+        void clearCasters();
+
+        uint32 getNumCasters() const;
+
+        void update(const Camera & camera);
+
+        void render(ShaderProgram & depthProgram);
+
+        uint32 getNumCascades() const;
+        uint32 getResolution() const;
+        GLuint getDepthTexture() const;
+
+        float getSplitDistance(uint32 cascade) const;
+        const mat4 & getViewProjectionMatrix(uint32 cascade) const;
+        mat4 getShadowMatrix(uint32 cascade) const;
+
+        bool isCasterInCascade(uint32 caster, uint32 cascade) const;
+
+        const ShadowStats & getStats() const;
+
+    private:
+        CascadedShadowMap(const CascadedShadowMap &);
+        CascadedShadowMap & operator = (const CascadedShadowMap &);
+
+        struct Caster {
+            Renderable * renderable;
+            bool isStatic;
+        };
+
+        struct Cascade {
+            float splitDistance;
+
+            // Light space box of half size 'halfSize' around 'center'.
+            vec3 center;
+            float halfSize;
+            bool isPlaced;
+
+            mat4 viewProjectionMatrix;
+            std::vector<uint32> visibility;
+
+            // Redraws pending for the next render().
+            bool needsRender;
+            bool needsStaticRender;
+
+            // Whether the static cache layer holds any casters.
+            bool hasStaticDepth;
+        };
+
+        uint32 numCascades;
+        uint32 resolution;
+
+        vec3 lightDirection;
+        mat4 lightViewMatrix;
+        float shadowDistance;
+        float splitLambda;
+        float cascadeMargin;
+        float depthBiasSlope;
+        float depthBiasUnits;
+
+        std::vector<Caster> casters;
+        std::vector<uint32> movedCasters;
+        FrustumCuller culler;
+
+        Cascade cascades[maxCascades];
+
+        GLuint depthTexture;
+        GLuint staticDepthTexture;
+        GLuint framebuffer;
+
+        ShadowStats stats;
+
+        bool placeCascade(Cascade & cascade, const vec3 & sliceCenter, float sliceRadius);
+
+        void markMovedCasters(Cascade & cascade, const std::vector<uint32> & visibility);
+
+        void createTextures();
+
+        uint32 drawCasters(const Cascade & cascade, bool staticCasters,
+                ShaderProgram & depthProgram, GLint mvpLocation);
+
+        void invalidateCascades();
+    };
+
+}
+
+#endif /* RIGID3D_CASCADED_SHADOW_MAP_HPP_ */
@@ -123,6 +123,43 @@ bool Frustum::isOrthographic() const {
     return !_isPerspective;
 }
 
+//----------------------------------------------------------------------------------------
+/**
+ * Computes the planes bounding this \c Frustum when viewed through
+ * 'viewMatrix', in the space 'viewMatrix' transforms from.
+ *
+ * @see extractPlanes
+ */
+void Frustum::getPlanes(const mat4 & viewMatrix, vec4 planes[numFrustumPlanes]) const {
+    extractPlanes(getProjectionMatrix() * viewMatrix, planes);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Extracts the six clipping planes of 'viewProjectionMatrix', indexed by
+ * \c FrustumPlane.  Each plane is stored as (normal, distance), with a unit
+ * normal pointing into the frustum, so that a point p is inside when
+ * dot(vec3(plane), p) + plane.w >= 0 for all six planes.
+ *
+ * Given a view-projection matrix, the planes are in world space.
+ */
+void Frustum::extractPlanes(const mat4 & viewProjectionMatrix,
+        vec4 planes[numFrustumPlanes]) {
+    const mat4 m = glm::transpose(viewProjectionMatrix);
+
+    // Clip space bounds are -w <= x, y, z <= w.
+    planes[int(FrustumPlane::Left)] = m[3] + m[0];
+    planes[int(FrustumPlane::Right)] = m[3] - m[0];
+    planes[int(FrustumPlane::Bottom)] = m[3] + m[1];
+    planes[int(FrustumPlane::Top)] = m[3] - m[1];
+    planes[int(FrustumPlane::Near)] = m[3] + m[2];
+    planes[int(FrustumPlane::Far)] = m[3] - m[2];
+
+    for(int i = 0; i < numFrustumPlanes; ++i) {
+        planes[i] /= glm::length(vec3(planes[i]));
+    }
+}
+
 //----------------------------------------------------------------------------------------
 /**
  * Sets the \c Frustum field of view angle.
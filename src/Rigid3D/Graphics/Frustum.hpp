@@ -11,6 +11,21 @@
 
 namespace Rigid3D {
 
+    /**
+     * Indices of the planes written by Frustum::extractPlanes(), and so by
+     * Frustum::getPlanes() and Camera::getPlanes(), which call it.
+     */
+    enum class FrustumPlane {
+        Left,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far
+    };
+
+    const int numFrustumPlanes = 6;
+
     class Frustum {
     public:
         Frustum();
@@ -40,6 +55,11 @@ namespace Rigid3D {
         bool isPerspective() const;
         bool isOrthographic() const;
 
+        void getPlanes(const mat4 & viewMatrix, vec4 planes[numFrustumPlanes]) const;
+
+        static void extractPlanes(const mat4 & viewProjectionMatrix,
+                vec4 planes[numFrustumPlanes]);
+
     protected:
         float fovy;
         float aspectRatio;
@@ -0,0 +1,178 @@
+#include "FrustumCuller.hpp"
+
+#include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Common/ParallelFor.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/Camera.hpp>
+#include <Rigid3D/Math/BatchMath.hpp>
+
+#include <algorithm>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+FrustumCuller::FrustumCuller(uint32 numThreads)
+    : numThreads(resolveThreadCount(numThreads)),
+      minBoxesPerThread(4096),
+      threadNumVisible(this->numThreads),
+      numVisible(0),
+      numCulled(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+FrustumCuller::~FrustumCuller() {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Removes all boxes.
+ */
+void FrustumCuller::clear() {
+    for(std::vector<float> & array : boxes) {
+        array.clear();
+    }
+    visibility.clear();
+    numVisible = 0;
+    numCulled = 0;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Appends 'box', given in world space.
+ *
+ * @return index of the box, for isVisible() and setBox().
+ */
+uint32 FrustumCuller::addBox(const AABB & box) {
+    for(std::vector<float> & array : boxes) {
+        array.push_back(0.0f);
+    }
+    const uint32 index = getNumBoxes() - 1;
+    setBox(index, box);
+    return index;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Replaces box 'index', such as after its object moved.
+ *
+ * @throws Rigid3DException if 'index' is not less than getNumBoxes().
+ */
+void FrustumCuller::setBox(uint32 index, const AABB & box) {
+    if (index >= getNumBoxes()) {
+        throw Rigid3DException("Box index out of range within method FrustumCuller::setBox");
+    }
+    const vec3 center = box.getCenter();
+    const vec3 halfExtents = box.getHalfExtents();
+    for(int k = 0; k < 3; ++k) {
+        boxes[k][index] = center[k];
+        boxes[3 + k][index] = halfExtents[k];
+    }
+}
+
+//----------------------------------------------------------------------------------------
+uint32 FrustumCuller::getNumBoxes() const {
+    return uint32(boxes[0].size());
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Tests every box against 'planes', as given by Frustum::extractPlanes(), and
+ * updates the visibility bits and counts.
+ */
+void FrustumCuller::cull(const vec4 planes[numFrustumPlanes]) {
+    const uint32 numBoxes = getNumBoxes();
+    const uint32 numWords = (numBoxes + 31) / 32;
+    visibility.resize(numWords);
+
+    uint32 threadsToUse = numThreads;
+    if (numBoxes < minBoxesPerThread * threadsToUse) {
+        threadsToUse = std::max(uint32(1), numBoxes / minBoxesPerThread);
+    }
+
+    // parallelFor() runs no more chunks than there are words, and the counts of
+    // threads it does not run must not be left over from an earlier cull.
+    threadsToUse = std::min(threadsToUse, std::max(uint32(1), numWords));
+    std::fill(threadNumVisible.begin(), threadNumVisible.begin() + threadsToUse, 0u);
+
+    // Chunks are whole words, so no two threads write the same word.
+    parallelFor(numWords, threadsToUse,
+        [&](size_t beginWord, size_t endWord, uint32 threadIndex) {
+            const size_t begin = 32 * beginWord;
+            const size_t end = std::min(size_t(numBoxes), 32 * endWord);
+            if (begin >= end) {
+                threadNumVisible[threadIndex] = 0;
+                return;
+            }
+
+            const float * chunk[6];
+            for(int k = 0; k < 6; ++k) {
+                chunk[k] = boxes[k].data() + begin;
+            }
+            threadNumVisible[threadIndex] = uint32(batch::cullBoxes(planes, chunk,
+                    visibility.data() + beginWord, end - begin));
+        });
+
+    numVisible = 0;
+    for(uint32 t = 0; t < threadsToUse; ++t) {
+        numVisible += threadNumVisible[t];
+    }
+    numCulled = numBoxes - numVisible;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Tests every box against the view volume of 'camera'.
+ */
+void FrustumCuller::cull(const Camera & camera) {
+    vec4 planes[numFrustumPlanes];
+    camera.getPlanes(planes);
+    cull(planes);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if box 'index' was at least partly inside the frustum at the
+ * last cull().
+ */
+bool FrustumCuller::isVisible(uint32 index) const {
+    return (visibility[index / 32] >> (index % 32)) & 1u;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return visibility bits of the last cull(), with box i at bit (i % 32) of
+ * word i / 32.
+ */
+const std::vector<uint32> & FrustumCuller::getVisibility() const {
+    return visibility;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of boxes found visible by the last cull().
+ */
+uint32 FrustumCuller::getNumVisible() const {
+    return numVisible;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of boxes found outside the frustum by the last cull().
+ */
+uint32 FrustumCuller::getNumCulled() const {
+    return numCulled;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 FrustumCuller::getNumThreads() const {
+    return numThreads;
+}
+
+//----------------------------------------------------------------------------------------
+void FrustumCuller::setMinBoxesPerThread(uint32 minBoxes) {
+    minBoxesPerThread = std::max(uint32(1), minBoxes);
+}
+
+}
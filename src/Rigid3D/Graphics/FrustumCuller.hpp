@@ -0,0 +1,95 @@
+/**
+ * @brief FrustumCuller
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_FRUSTUM_CULLER_HPP_
+#define RIGID3D_FRUSTUM_CULLER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Graphics/Frustum.hpp>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    struct AABB;
+    class Camera;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Culls world space object AABBs against the planes of a view
+     * frustum, producing one visibility bit per box.
+     *
+     * Boxes are stored as a structure of arrays of centers and half extents,
+     * and tested by batch::cullBoxes() with SSE or AVX2 when available.  Large
+     * sets of boxes are split into chunks of whole visibility words, one per
+     * thread.
+     * \code{.cpp}
+     *  FrustumCuller culler;
+     *  for(const AABB & bounds : objectBounds) {
+     *      culler.addBox(bounds);
+     *  }
+     *
+     *  culler.cull(camera);
+     *  for(uint32 i = 0; i < culler.getNumBoxes(); ++i) {
+     *      if (culler.isVisible(i)) {
+     *          queue.submit(renderables[i]);
+     *      }
+     *  }
+     * \endcode
+     *
+     * A box that intersects the frustum's planes but lies outside it near a
+     * corner may be kept, so culling is conservative.
+     */
+    class FrustumCuller {
+    public:
+        // Zero uses one thread per hardware thread.
+        explicit FrustumCuller(uint32 numThreads = 0);
+
+        ~FrustumCuller();
+
+        void clear();
+
+        uint32 addBox(const AABB & box);
+
+        void setBox(uint32 index, const AABB & box);
+
+        uint32 getNumBoxes() const;
+
+        void cull(const vec4 planes[numFrustumPlanes]);
+
+        void cull(const Camera & camera);
+
+        bool isVisible(uint32 index) const;
+
+        const std::vector<uint32> & getVisibility() const;
+
+        uint32 getNumVisible() const;
+
+        uint32 getNumCulled() const;
+
+        uint32 getNumThreads() const;
+
+        // Boxes per thread below which culling runs on the calling thread only.
+        void setMinBoxesPerThread(uint32 minBoxes);
+
+    private:
+        uint32 numThreads;
+        uint32 minBoxesPerThread;
+
+        // centerX, centerY, centerZ, halfExtentX, halfExtentY, halfExtentZ.
+        std::vector<float> boxes[6];
+
+        std::vector<uint32> visibility;
+        std::vector<uint32> threadNumVisible;
+        uint32 numVisible;
+        uint32 numCulled;
+    };
+
+}
+
+#endif /* RIGID3D_FRUSTUM_CULLER_HPP_ */
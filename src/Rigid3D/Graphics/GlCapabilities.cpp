@@ -0,0 +1,40 @@
+#include "GlCapabilities.hpp"
+
+#include <cstring>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if the current context's version is at least
+ * 'majorVersion'.'minorVersion'.
+ */
+bool isGlVersionAtLeast(GLint majorVersion, GLint minorVersion) {
+    GLint major = 0;
+    GLint minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+    return major > majorVersion || (major == majorVersion && minor >= minorVersion);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if the current context lists 'extensionName', such as
+ * "GL_ARB_buffer_storage", among its extensions.
+ */
+bool isGlExtensionSupported(const char * extensionName) {
+    GLint numExtensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+
+    for(GLint i = 0; i < numExtensions; ++i) {
+        const GLubyte * extension = glGetStringi(GL_EXTENSIONS, GLuint(i));
+        if (extension != nullptr &&
+                strcmp(reinterpret_cast<const char *>(extension), extensionName) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,28 @@
+/**
+ * GlCapabilities.hpp
+ *
+ * @brief Queries of the features the current OpenGL context supports.
+ *
+ * Code using entry points newer than the OpenGL 4.1 of <OpenGL/gl3.h> checks
+ * for them twice: at compile time with the header's GL_VERSION_* macros, so
+ * that it still builds against 4.1 headers, and at run time with these
+ * queries, so that it falls back on older contexts.
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_GLCAPABILITIES_HPP_
+#define RIGID3D_GLCAPABILITIES_HPP_
+
+#include <OpenGL/gl3.h>
+
+namespace Rigid3D {
+
+    bool isGlVersionAtLeast(GLint majorVersion, GLint minorVersion);
+
+    bool isGlExtensionSupported(const char * extensionName);
+
+}
+
+
+#endif /* RIGID3D_GLCAPABILITIES_HPP_ */
@@ -0,0 +1,143 @@
+#include "IndexBuffer.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+
+#include <cstring>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+IndexBuffer::IndexBuffer() {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Replaces the contents of this IndexBuffer with 'indices'.
+ *
+ * @param indices - vertex indices, each less than 'numVertices'.
+ * @param numVertices - number of vertices the indices refer to, which
+ * determines whether 16-bit indices suffice.
+ */
+void IndexBuffer::assign(const std::vector<uint32> & indices, uint32 numVertices) {
+    clear();
+
+    if (numVertices <= 0x10000u) {
+        indices16.assign(indices.begin(), indices.end());
+    } else {
+        indices32 = indices;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Replaces the contents of this IndexBuffer with a copy of raw index data, such
+ * as that from getDataPtr().
+ *
+ * @param data - 'numIndices' indices of 'indexSize' bytes each.
+ * @param numIndices - number of indices in 'data'.
+ * @param indexSize - size in bytes of each index, either 2 or 4.
+ */
+void IndexBuffer::assign(const void * data, size_t numIndices, uint32 indexSize) {
+    clear();
+
+    if (indexSize == sizeof(uint16)) {
+        indices16.resize(numIndices);
+        if (numIndices != 0) {
+            std::memcpy(indices16.data(), data, numIndices * sizeof(uint16));
+        }
+    } else if (indexSize == sizeof(uint32)) {
+        indices32.resize(numIndices);
+        if (numIndices != 0) {
+            std::memcpy(indices32.data(), data, numIndices * sizeof(uint32));
+        }
+    } else {
+        throw Rigid3DException("Index size must be 2 or 4 bytes within method "
+                "IndexBuffer::assign");
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Changes the number of indices, keeping existing ones and setting new ones to
+ * zero.  Indices are widened to 32 bits if 'numVertices' no longer fits 16-bit
+ * indices, but are never narrowed again.
+ *
+ * @param numIndices - new number of indices.
+ * @param numVertices - number of vertices the indices may refer to.
+ */
+void IndexBuffer::resize(size_t numIndices, uint32 numVertices) {
+    if (indices32.empty() && numVertices <= 0x10000u) {
+        indices16.resize(numIndices);
+        return;
+    }
+
+    if (indices32.empty()) {
+        indices32.assign(indices16.begin(), indices16.end());
+        std::vector<uint16>().swap(indices16);
+    }
+    indices32.resize(numIndices);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sets index 'i', which must be less than getNumIndices(), to 'index'.
+ */
+void IndexBuffer::set(size_t i, uint32 index) {
+    if (indices32.empty()) {
+        indices16[i] = uint16(index);
+    } else {
+        indices32[i] = index;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void IndexBuffer::clear() {
+    // Swap with empties so the storage is released.
+    std::vector<uint16>().swap(indices16);
+    std::vector<uint32>().swap(indices32);
+}
+
+//----------------------------------------------------------------------------------------
+bool IndexBuffer::empty() const {
+    return indices16.empty() && indices32.empty();
+}
+
+//----------------------------------------------------------------------------------------
+uint32 IndexBuffer::operator [] (size_t i) const {
+    return indices32.empty() ? uint32(indices16[i]) : indices32[i];
+}
+
+//----------------------------------------------------------------------------------------
+size_t IndexBuffer::getNumIndices() const {
+    return indices32.empty() ? indices16.size() : indices32.size();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the total size in bytes of the index data.
+ */
+size_t IndexBuffer::getNumBytes() const {
+    return getNumIndices() * getIndexSize();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return size in bytes of each index, either 2 or 4.
+ */
+uint32 IndexBuffer::getIndexSize() const {
+    return indices32.empty() ? sizeof(uint16) : sizeof(uint32);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return pointer to the first index, whose type is given by getIndexSize().
+ */
+const void * IndexBuffer::getDataPtr() const {
+    if (indices32.empty()) {
+        return indices16.data();
+    }
+    return indices32.data();
+}
+
+}
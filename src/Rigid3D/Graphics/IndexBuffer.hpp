@@ -0,0 +1,63 @@
+/**
+ * @brief IndexBuffer
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_INDEX_BUFFER_HPP_
+#define RIGID3D_INDEX_BUFFER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Triangle vertex indices, stored as 16-bit values when every index
+     * fits, and as 32-bit values otherwise.
+     *
+     * The data pointer and index size can be handed directly to OpenGL:
+     * \code{.cpp}
+     *  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.getNumBytes(),
+     *          indices.getDataPtr(), GL_STATIC_DRAW);
+     *
+     *  GLenum type = (indices.getIndexSize() == 2) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+     *  glDrawElements(GL_TRIANGLES, indices.getNumIndices(), type, 0);
+     * \endcode
+     */
+    class IndexBuffer {
+    public:
+        IndexBuffer();
+
+        void assign(const std::vector<uint32> & indices, uint32 numVertices);
+
+        void assign(const void * data, size_t numIndices, uint32 indexSize);
+
+        void resize(size_t numIndices, uint32 numVertices);
+
+        void set(size_t i, uint32 index);
+
+        void clear();
+
+        bool empty() const;
+
+        uint32 operator [] (size_t i) const;
+
+        size_t getNumIndices() const;
+
+        size_t getNumBytes() const;
+
+        uint32 getIndexSize() const;
+
+        const void * getDataPtr() const;
+
+    private:
+        std::vector<uint16> indices16;
+        std::vector<uint32> indices32;
+    };
+
+}
+
+#endif /* RIGID3D_INDEX_BUFFER_HPP_ */
@@ -9,6 +9,8 @@
 
 #include <Rigid3D/Common/Settings.hpp>
 
+#include <string>
+
 namespace Rigid3D {
 
     /**
@@ -22,6 +24,15 @@ namespace Rigid3D {
         float shininessFactor;  // Specular shininess factor.
     };
 
+    /**
+     * Named material read from a Wavefront .mtl file.
+     */
+    struct Material {
+        std::string name;
+        MaterialProperties properties;
+        std::string diffuseTexture;  // Path given by 'map_Kd', or empty for none.
+    };
+
 }
 
 
@@ -1,8 +1,10 @@
 #include "Mesh.hpp"
 
 #include <Rigid3D/Common/Rigid3DException.hpp>
-#include <Rigid3D/Graphics/ObjFileLoader.hpp>
+#include <Rigid3D/Graphics/Camera.hpp>
+#include <Rigid3D/Graphics/MeshCache.hpp>
 
+#include <algorithm>
 #include <utility>
 
 namespace Rigid3D {
@@ -11,18 +13,45 @@ namespace Rigid3D {
 /**
  * Constructs a Mesh object from a Wavefront .obj file format.
  *
+ * The decoded mesh is cached in a binary file next to 'objFileName', which is
+ * loaded instead on later runs for as long as the .obj file is unchanged.
+ *
  * @param objFileName - path to .obj file
+ * @param indexing - whether to share vertices between triangles through an
+ * index buffer.
+ *
+ * @see MeshCache
+ */
+Mesh::Mesh(const char * objFileName, MeshIndexing indexing) {
+    MeshData data;
+    MeshCache::load(objFileName, indexing, data);
+    *this = Mesh(std::move(data));
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Constructs a Mesh object from already decoded data, such as that loaded on a
+ * background thread by an \c AssetLoader.
+ *
+ * @see MeshCache::load
  */
-Mesh::Mesh(const char * objFileName) {
-    ObjFileLoader::decode(objFileName,
-                          this->vertexPositions,
-                          this->vertexNormals,
-                          this->textureCoords);
+Mesh::Mesh(MeshData && data) {
+    this->vertexPositions = std::move(data.positions);
+    this->vertexNormals = std::move(data.normals);
+    this->textureCoords = std::move(data.uvCoords);
+    this->indices = std::move(data.indices);
+    this->aabb = data.aabb;
+    this->bvh = std::move(data.bvh);
+    this->submeshes = std::move(data.submeshes);
+    this->materials = std::move(data.materials);
+    this->lodIndices = std::move(data.lodIndices);
+    this->lods = std::move(data.lods);
 }
 
 //----------------------------------------------------------------------------------------
 Mesh::Mesh() {
     // Empty, like my ice cold heart.
+    aabb.minBounds = aabb.maxBounds = vec3(0.0f);
 }
 
 //----------------------------------------------------------------------------------------
@@ -33,6 +62,13 @@ Mesh & Mesh::operator = (Mesh && other) {
     this->vertexPositions = std::move(other.vertexPositions);
     this->vertexNormals = std::move(other.vertexNormals);
     this->textureCoords = std::move(other.textureCoords);
+    this->indices = std::move(other.indices);
+    this->aabb = other.aabb;
+    this->bvh = std::move(other.bvh);
+    this->submeshes = std::move(other.submeshes);
+    this->materials = std::move(other.materials);
+    this->lodIndices = std::move(other.lodIndices);
+    this->lods = std::move(other.lods);
 
     return *this;
 }
@@ -148,4 +184,165 @@ unsigned int Mesh::getNumElementsPerTextureCoord() const {
     return num_elements_per_texturedCoord;
 }
 
+//----------------------------------------------------------------------------------------
+/**
+ * Copies this \c Mesh's positions, normals and texture coordinates into a single
+ * vertex buffer, arranged as given by 'layoutType'.  Quantized positions are
+ * stored relative to this \c Mesh's AABB.
+ *
+ * @param layoutType - arrangement of attributes within 'vertexData'.
+ * @param vertexData - resized to hold the vertex buffer.
+ *
+ * @return offsets, strides and formats of each attribute within 'vertexData'.
+ */
+VertexLayout Mesh::getVertexData(VertexLayoutType layoutType,
+        vector<ubyte> & vertexData) const {
+    const size_t numVertices = vertexPositions.size();
+    const bool hasNormals = (vertexNormals.size() == numVertices) && numVertices != 0;
+    const bool hasUvCoords = (textureCoords.size() == numVertices) && numVertices != 0;
+
+    VertexBounds bounds;
+    if (numVertices != 0) {
+        bounds.extend(aabb, textureCoords.data(), hasUvCoords ? numVertices : 0);
+    }
+
+    VertexLayout layout(layoutType, numVertices, hasNormals, hasUvCoords, bounds);
+    vertexData.resize(layout.getNumBytes());
+    layout.writeVertices(vertexData.data(), 0, numVertices, vertexPositions.data(),
+            hasNormals ? vertexNormals.data() : nullptr,
+            hasUvCoords ? textureCoords.data() : nullptr);
+    return layout;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if this \c Mesh's triangles are given by its index buffer, rather
+ * than by consecutive vertices.
+ */
+bool Mesh::isIndexed() const {
+    return !indices.empty();
+}
+
+//----------------------------------------------------------------------------------------
+const IndexBuffer & Mesh::getIndexBuffer() const {
+    return indices;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the number of indices for this \c Mesh, three per triangle, or zero if
+ * the \c Mesh is unindexed.
+ */
+unsigned int Mesh::getNumIndices() const {
+    return (unsigned int)(indices.getNumIndices());
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return bounds of all vertex positions in object space.
+ */
+const AABB & Mesh::getAABB() const {
+    return aabb;
+}
+
+//----------------------------------------------------------------------------------------
+const MeshBvh & Mesh::getBvh() const {
+    return bvh;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return one \c Submesh per group and material of the .obj file, in order of
+ * first use.  Their ranges are of indices if the \c Mesh is indexed, and of
+ * vertices otherwise.
+ */
+const vector<Submesh> & Mesh::getSubmeshes() const {
+    return submeshes;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return materials read from the .mtl files referenced by the .obj file.
+ */
+const vector<Material> & Mesh::getMaterials() const {
+    return materials;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return simplified levels of detail, from finest to coarsest, each a range of
+ * the LOD index buffer over this \c Mesh's vertices.  Empty if the \c Mesh is
+ * unindexed or could not be simplified.
+ */
+const vector<MeshLod> & Mesh::getLods() const {
+    return lods;
+}
+
+//----------------------------------------------------------------------------------------
+const IndexBuffer & Mesh::getLodIndexBuffer() const {
+    return lodIndices;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Chooses the coarsest level of detail whose simplification error, projected
+ * onto the screen, is within 'maxPixelError' pixels.
+ *
+ * The \c Mesh is bounded by a sphere around its AABB, placed and scaled by
+ * 'modelMatrix'.  Perspective cameras measure error at the point of that sphere
+ * nearest to them, so a level is never coarser than the closest part of the
+ * \c Mesh allows.
+ *
+ * @param camera - camera the \c Mesh is drawn with.
+ * @param modelMatrix - transform from this \c Mesh's object space to world space.
+ * @param viewportHeight - height of the viewport in pixels.
+ * @param maxPixelError - largest acceptable error in pixels.
+ *
+ * @return 0 to draw the full detail \c Mesh, or 'k' to draw getLods()[k - 1].
+ */
+uint32 Mesh::selectLod(const Camera & camera, const mat4 & modelMatrix,
+        float viewportHeight, float maxPixelError) const {
+    if (lods.empty()) {
+        return 0;
+    }
+
+    const float scale = std::max(glm::length(vec3(modelMatrix[0])),
+            std::max(glm::length(vec3(modelMatrix[1])), glm::length(vec3(modelMatrix[2]))));
+
+    // Pixels per world space unit at unit distance, or everywhere for
+    // orthographic cameras.
+    const mat4 projectionMatrix = camera.getProjectionMatrix();
+    float pixelsPerUnit = 0.5f * viewportHeight * projectionMatrix[1][1];
+
+    if (camera.isPerspective()) {
+        const vec3 center = vec3(modelMatrix *
+                vec4((aabb.minBounds + aabb.maxBounds) * 0.5f, 1.0f));
+        const float radius = glm::length(aabb.maxBounds - aabb.minBounds) * 0.5f * scale;
+        const float distance = glm::length(center - camera.getPosition()) - radius;
+        pixelsPerUnit /= std::max(distance, camera.getNearZDistance());
+    }
+
+    return selectLod(pixelsPerUnit * scale, maxPixelError);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param pixelsPerUnit - size on screen, in pixels, of one unit of this \c Mesh's
+ * object space.
+ * @param maxPixelError - largest acceptable error in pixels.
+ *
+ * @return 0 to draw the full detail \c Mesh, or 'k' to draw getLods()[k - 1],
+ * the coarsest level whose error covers at most 'maxPixelError' pixels.
+ */
+uint32 Mesh::selectLod(float pixelsPerUnit, float maxPixelError) const {
+    uint32 level = 0;
+    for(uint32 k = 0; k < lods.size(); ++k) {
+        if (lods[k].error * pixelsPerUnit > maxPixelError) {
+            break;
+        }
+        level = k + 1;
+    }
+    return level;
+}
+
 } // end namespace GlUtils
@@ -2,6 +2,13 @@
 #define RIGID3D_MESH_HPP_
 
 #include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Graphics/IndexBuffer.hpp>
+#include <Rigid3D/Graphics/MaterialProperties.hpp>
+#include <Rigid3D/Graphics/MeshBvh.hpp>
+#include <Rigid3D/Graphics/MeshSimplifier.hpp>
+#include <Rigid3D/Graphics/Submesh.hpp>
+#include <Rigid3D/Graphics/VertexLayout.hpp>
 
 #include <vector>
 #include <string>
@@ -11,9 +18,26 @@ namespace Rigid3D {
 using std::vector;
 using std::string;
 
+    /**
+     * How a Mesh loaded from an .obj file stores its triangles.
+     */
+    enum class MeshIndexing {
+        // Three vertices per triangle, drawn with glDrawArrays.
+        Unindexed,
+
+        // One vertex per distinct (v, vt, vn) corner, with three indices per
+        // triangle, drawn with glDrawElements.
+        Indexed
+    };
+
+    struct MeshData;
+    class Camera;
+
     class Mesh {
     public:
-        Mesh(const char * objFileName);
+        Mesh(const char * objFileName, MeshIndexing indexing = MeshIndexing::Unindexed);
+
+        explicit Mesh(MeshData && data);
 
         Mesh();
 
@@ -40,6 +64,27 @@ using std::string;
         unsigned int getNumElementsPerVertexNormal() const;
         unsigned int getNumElementsPerTextureCoord() const;
 
+        VertexLayout getVertexData(VertexLayoutType layoutType,
+                vector<ubyte> & vertexData) const;
+
+        bool isIndexed() const;
+        const IndexBuffer & getIndexBuffer() const;
+        unsigned int getNumIndices() const;
+
+        const AABB & getAABB() const;
+        const MeshBvh & getBvh() const;
+
+        const vector<Submesh> & getSubmeshes() const;
+        const vector<Material> & getMaterials() const;
+
+        const vector<MeshLod> & getLods() const;
+        const IndexBuffer & getLodIndexBuffer() const;
+
+        uint32 selectLod(const Camera & camera, const mat4 & modelMatrix,
+                float viewportHeight, float maxPixelError = 1.0f) const;
+
+        uint32 selectLod(float pixelsPerUnit, float maxPixelError = 1.0f) const;
+
     private:
         vector<vec3> vertexPositions;
         static const short num_elements_per_vertex_position = 3;
@@ -49,6 +94,21 @@ using std::string;
 
         vector<vec2> textureCoords;
         static const short num_elements_per_texturedCoord = 2;
+
+        // Empty for unindexed meshes.
+        IndexBuffer indices;
+
+        AABB aabb;
+        MeshBvh bvh;
+
+        // Ranges of triangles per group and material, covering the whole mesh.
+        vector<Submesh> submeshes;
+        vector<Material> materials;
+
+        // Simplified levels of detail, coarsest last, indexing the same vertices.
+        // Empty for unindexed meshes.
+        IndexBuffer lodIndices;
+        vector<MeshLod> lods;
     };
 }
 
@@ -0,0 +1,147 @@
+#include "MeshBvh.hpp"
+
+#include <Rigid3D/Graphics/IndexBuffer.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace Rigid3D {
+
+using std::vector;
+
+namespace {
+
+    struct BuildEntry {
+        uint32 node;
+        uint32 begin;
+        uint32 end;
+    };
+
+}
+
+const uint32 MeshBvh::maxTrianglesPerLeaf;
+
+//----------------------------------------------------------------------------------------
+MeshBvh::MeshBvh() {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Builds the hierarchy top down, splitting each node's triangles at the median
+ * centroid along the longest axis of their centroids' bounds, until at most
+ * maxTrianglesPerLeaf remain.
+ *
+ * @param positions - vertex positions of the Mesh.
+ * @param indices - triangle indices of the Mesh, or empty if each consecutive
+ * triple of positions is a triangle.
+ */
+void MeshBvh::build(const vector<vec3> & positions, const IndexBuffer & indices) {
+    clear();
+
+    const bool indexed = !indices.empty();
+    const size_t numTriangles = (indexed ? indices.getNumIndices() : positions.size()) / 3;
+    if (numTriangles == 0) {
+        return;
+    }
+
+    vector<AABB> bounds(numTriangles);
+    vector<vec3> centroids(numTriangles);
+    for(size_t t = 0; t < numTriangles; ++t) {
+        const vec3 & a = positions[indexed ? indices[3 * t] : 3 * t];
+        const vec3 & b = positions[indexed ? indices[3 * t + 1] : 3 * t + 1];
+        const vec3 & c = positions[indexed ? indices[3 * t + 2] : 3 * t + 2];
+        bounds[t].minBounds = glm::min(a, glm::min(b, c));
+        bounds[t].maxBounds = glm::max(a, glm::max(b, c));
+        centroids[t] = (bounds[t].minBounds + bounds[t].maxBounds) * 0.5f;
+    }
+
+    triangles.resize(numTriangles);
+    for(size_t t = 0; t < numTriangles; ++t) {
+        triangles[t] = uint32(t);
+    }
+
+    // A binary tree with at least one triangle per leaf has fewer than twice as
+    // many nodes as triangles.
+    nodes.reserve(2 * (numTriangles / maxTrianglesPerLeaf + 1));
+    nodes.push_back(MeshBvhNode());
+
+    vector<BuildEntry> stack;
+    stack.push_back(BuildEntry{0, 0, uint32(numTriangles)});
+
+    while (!stack.empty()) {
+        BuildEntry entry = stack.back();
+        stack.pop_back();
+
+        AABB nodeBounds = bounds[triangles[entry.begin]];
+        AABB centroidBounds = {centroids[triangles[entry.begin]],
+                               centroids[triangles[entry.begin]]};
+        for(uint32 i = entry.begin + 1; i < entry.end; ++i) {
+            nodeBounds = AABB::combine(nodeBounds, bounds[triangles[i]]);
+            centroidBounds.minBounds = glm::min(centroidBounds.minBounds, centroids[triangles[i]]);
+            centroidBounds.maxBounds = glm::max(centroidBounds.maxBounds, centroids[triangles[i]]);
+        }
+        nodes[entry.node].aabb = nodeBounds;
+
+        const uint32 count = entry.end - entry.begin;
+        if (count <= maxTrianglesPerLeaf) {
+            nodes[entry.node].first = entry.begin;
+            nodes[entry.node].count = count;
+            continue;
+        }
+
+        vec3 extents = centroidBounds.maxBounds - centroidBounds.minBounds;
+        int axis = 0;
+        if (extents.y > extents[axis]) { axis = 1; }
+        if (extents.z > extents[axis]) { axis = 2; }
+
+        const uint32 middle = entry.begin + count / 2;
+        std::nth_element(triangles.begin() + entry.begin, triangles.begin() + middle,
+                triangles.begin() + entry.end,
+                [&centroids, axis](uint32 a, uint32 b) {
+                    return centroids[a][axis] < centroids[b][axis];
+                });
+
+        const uint32 firstChild = uint32(nodes.size());
+        nodes[entry.node].first = firstChild;
+        nodes[entry.node].count = 0;
+        nodes.push_back(MeshBvhNode());
+        nodes.push_back(MeshBvhNode());
+
+        stack.push_back(BuildEntry{firstChild, entry.begin, middle});
+        stack.push_back(BuildEntry{firstChild + 1, middle, entry.end});
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Replaces the hierarchy with previously built 'nodes' and 'triangles', such as
+ * those read back from a mesh cache file.
+ */
+void MeshBvh::assign(vector<MeshBvhNode> && nodes, vector<uint32> && triangles) {
+    this->nodes = std::move(nodes);
+    this->triangles = std::move(triangles);
+}
+
+//----------------------------------------------------------------------------------------
+void MeshBvh::clear() {
+    nodes.clear();
+    triangles.clear();
+}
+
+//----------------------------------------------------------------------------------------
+bool MeshBvh::empty() const {
+    return nodes.empty();
+}
+
+//----------------------------------------------------------------------------------------
+const vector<MeshBvhNode> & MeshBvh::getNodes() const {
+    return nodes;
+}
+
+//----------------------------------------------------------------------------------------
+const vector<uint32> & MeshBvh::getTriangles() const {
+    return triangles;
+}
+
+}
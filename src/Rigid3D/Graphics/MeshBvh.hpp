@@ -0,0 +1,101 @@
+/**
+ * @brief MeshBvh
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_MESH_BVH_HPP_
+#define RIGID3D_MESH_BVH_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Collision/AABB.hpp>
+
+#include <vector>
+
+// Forward Declarations
+namespace Rigid3D {
+    class IndexBuffer;
+}
+
+namespace Rigid3D {
+
+    struct MeshBvhNode {
+        AABB aabb;
+        uint32 first;  // First child for interior nodes, first triangle entry for leaves.
+        uint32 count;  // Number of triangles for leaves, zero for interior nodes.
+
+        bool isLeaf() const { return count != 0; }
+    };
+
+    /**
+     * @brief Static bounding volume hierarchy over the triangles of a Mesh.
+     *
+     * Nodes are stored in a flat array, with the root at index zero and the two
+     * children of an interior node stored next to each other.  Leaves refer to
+     * a range of getTriangles(), which holds triangle indices, so that triangle
+     * 't' is made of vertices 3t, 3t+1 and 3t+2, or of the vertices given by
+     * indices 3t, 3t+1 and 3t+2 for an indexed Mesh.
+     *
+     * Being two flat arrays, a MeshBvh can be written to and read from a file
+     * without any pointer fix up.
+     */
+    class MeshBvh {
+    public:
+        static const uint32 maxTrianglesPerLeaf = 4;
+
+        MeshBvh();
+
+        void build(const std::vector<vec3> & positions, const IndexBuffer & indices);
+
+        void assign(std::vector<MeshBvhNode> && nodes, std::vector<uint32> && triangles);
+
+        void clear();
+
+        bool empty() const;
+
+        const std::vector<MeshBvhNode> & getNodes() const;
+
+        const std::vector<uint32> & getTriangles() const;
+
+        // Calls 'callback(triangleIndex)' for every triangle in a leaf whose AABB
+        // overlaps 'aabb'.
+        template <class Callback>
+        void query(const AABB & aabb, Callback && callback) const;
+
+    private:
+        std::vector<MeshBvhNode> nodes;
+        std::vector<uint32> triangles;
+    };
+
+    //------------------------------------------------------------------------------------
+    template <class Callback>
+    void MeshBvh::query(const AABB & aabb, Callback && callback) const {
+        if (nodes.empty()) {
+            return;
+        }
+
+        // Median splits keep the depth near log2 of the triangle count.
+        uint32 stack[64];
+        int stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0) {
+            const MeshBvhNode & node = nodes[stack[--stackSize]];
+            if (!node.aabb.overlaps(aabb)) {
+                continue;
+            }
+
+            if (node.isLeaf()) {
+                for(uint32 i = node.first; i < node.first + node.count; ++i) {
+                    callback(triangles[i]);
+                }
+            } else {
+                stack[stackSize++] = node.first;
+                stack[stackSize++] = node.first + 1;
+            }
+        }
+    }
+
+}
+
+#endif /* RIGID3D_MESH_BVH_HPP_ */
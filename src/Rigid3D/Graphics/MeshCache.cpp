@@ -0,0 +1,739 @@
+#include "MeshCache.hpp"
+
+#include <Rigid3D/Common/MappedFile.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/MeshOptimizer.hpp>
+#include <Rigid3D/Graphics/ObjFileLoader.hpp>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <utility>
+
+namespace Rigid3D {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+    const char cacheMagic[8] = {'R', '3', 'D', 'M', 'E', 'S', 'H', '\0'};
+
+    const uint32 indexedFlag = 1u << 0;
+
+    const size_t streamAlignment = 16;
+
+    enum Stream {
+        PositionStream,
+        NormalStream,
+        UvCoordStream,
+        IndexStream,
+        BvhNodeStream,
+        BvhTriangleStream,
+        LodIndexStream,
+        MetadataStream,
+        NumStreams
+    };
+
+    struct MeshCacheHeader {
+        char magic[8];
+        uint32 version;
+        uint32 flags;
+
+        uint64_t sourceSize;
+        int64_t sourceModifiedTime;
+        uint64_t sourceHash;
+
+        uint32 numPositions;
+        uint32 numNormals;
+        uint32 numUvCoords;
+        uint32 numIndices;
+        uint32 indexSize;
+        uint32 numBvhNodes;
+        uint32 numBvhTriangles;
+        uint32 numMetadataBytes;
+        uint32 numLodIndices;
+        uint32 reserved;
+
+        float aabbMin[3];
+        float aabbMax[3];
+
+        // Byte offset and size of each stream from the start of the file.
+        uint64_t streamOffsets[NumStreams];
+        uint64_t streamBytes[NumStreams];
+    };
+
+    //------------------------------------------------------------------------------------
+    template <class T>
+    bool readStream(const MeshCacheHeader & header, const char * fileData,
+            Stream stream, size_t count, vector<T> & out) {
+        if (header.streamBytes[stream] != count * sizeof(T)) {
+            return false;
+        }
+        out.resize(count);
+        if (count != 0) {
+            std::memcpy(out.data(), fileData + header.streamOffsets[stream],
+                    count * sizeof(T));
+        }
+        return true;
+    }
+
+    //------------------------------------------------------------------------------------
+    /**
+     * Appends submeshes, materials, levels of detail and .mtl file details to a
+     * byte array, as
+     * counts followed by fixed size fields and length prefixed strings.
+     */
+    class MetadataWriter {
+    public:
+        vector<char> bytes;
+
+        template <class T>
+        void write(const T & value) {
+            const char * first = reinterpret_cast<const char *>(&value);
+            bytes.insert(bytes.end(), first, first + sizeof(T));
+        }
+
+        void write(const string & value) {
+            write(uint32(value.size()));
+            bytes.insert(bytes.end(), value.begin(), value.end());
+        }
+    };
+
+    //------------------------------------------------------------------------------------
+    // Reads what MetadataWriter wrote, failing rather than reading past the end.
+    class MetadataReader {
+    public:
+        MetadataReader(const char * data, size_t size)
+            : p(data), end(data + size) { }
+
+        template <class T>
+        bool read(T & value) {
+            if (size_t(end - p) < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&value, p, sizeof(T));
+            p += sizeof(T);
+            return true;
+        }
+
+        bool read(string & value) {
+            uint32 length;
+            if (!read(length) || size_t(end - p) < length) {
+                return false;
+            }
+            value.assign(p, length);
+            p += length;
+            return true;
+        }
+
+        // @return false if 'count' elements of at least 'minBytes' each cannot fit.
+        bool canHold(uint32 count, size_t minBytes) const {
+            return uint64_t(count) * minBytes <= uint64_t(end - p);
+        }
+
+    private:
+        const char * p;
+        const char * end;
+    };
+
+    //------------------------------------------------------------------------------------
+    // Size and modification time of a .mtl file, or an impossible size if missing.
+    MeshSourceInfo getMaterialLibraryInfo(const char * objFilePath,
+            const string & materialLibrary) {
+        const string mtlFilePath = ObjFileLoader::getMaterialLibraryPath(objFilePath,
+                materialLibrary);
+        MeshSourceInfo info;
+        if (!MeshCache::getSourceInfo(mtlFilePath.c_str(), info)) {
+            info.size = ~uint64_t(0);
+            info.modifiedTime = 0;
+        }
+        return info;
+    }
+
+    //------------------------------------------------------------------------------------
+    void writeSubmeshes(MetadataWriter & writer, const vector<Submesh> & submeshes) {
+        writer.write(uint32(submeshes.size()));
+        for(const Submesh & submesh : submeshes) {
+            writer.write(submesh.name);
+            writer.write(submesh.materialName);
+            writer.write(submesh.materialIndex);
+            writer.write(submesh.startIndex);
+            writer.write(submesh.numIndices);
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    bool readSubmeshes(MetadataReader & reader, vector<Submesh> & submeshes) {
+        uint32 numSubmeshes;
+        if (!reader.read(numSubmeshes) || !reader.canHold(numSubmeshes, 20)) {
+            return false;
+        }
+        submeshes.resize(numSubmeshes);
+        for(Submesh & submesh : submeshes) {
+            if (!reader.read(submesh.name) || !reader.read(submesh.materialName) ||
+                !reader.read(submesh.materialIndex) || !reader.read(submesh.startIndex) ||
+                !reader.read(submesh.numIndices)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //------------------------------------------------------------------------------------
+    vector<char> writeMetadata(const char * objFilePath, const MeshData & data) {
+        MetadataWriter writer;
+
+        writeSubmeshes(writer, data.submeshes);
+
+        writer.write(uint32(data.materials.size()));
+        for(const Material & material : data.materials) {
+            writer.write(material.name);
+            writer.write(material.properties);
+            writer.write(material.diffuseTexture);
+        }
+
+        writer.write(uint32(data.materialLibraries.size()));
+        for(const string & materialLibrary : data.materialLibraries) {
+            const MeshSourceInfo info = getMaterialLibraryInfo(objFilePath, materialLibrary);
+            writer.write(materialLibrary);
+            writer.write(info.size);
+            writer.write(info.modifiedTime);
+        }
+
+        writer.write(uint32(data.lodRatios.size()));
+        for(float ratio : data.lodRatios) {
+            writer.write(ratio);
+        }
+        writer.write(uint32(data.lods.size()));
+        for(const MeshLod & lod : data.lods) {
+            writer.write(lod.error);
+            writer.write(lod.startIndex);
+            writer.write(lod.numIndices);
+            writeSubmeshes(writer, lod.submeshes);
+        }
+
+        return std::move(writer.bytes);
+    }
+
+    //------------------------------------------------------------------------------------
+    // @return false if the metadata is invalid, or any .mtl file has changed.
+    bool readMetadata(const char * objFilePath, const char * bytes, size_t numBytes,
+            MeshData & data) {
+        MetadataReader reader(bytes, numBytes);
+
+        if (!readSubmeshes(reader, data.submeshes)) {
+            return false;
+        }
+
+        uint32 numMaterials;
+        if (!reader.read(numMaterials) ||
+            !reader.canHold(numMaterials, 8 + sizeof(MaterialProperties))) {
+            return false;
+        }
+        data.materials.resize(numMaterials);
+        for(Material & material : data.materials) {
+            if (!reader.read(material.name) || !reader.read(material.properties) ||
+                !reader.read(material.diffuseTexture)) {
+                return false;
+            }
+        }
+
+        uint32 numMaterialLibraries;
+        if (!reader.read(numMaterialLibraries) || !reader.canHold(numMaterialLibraries, 20)) {
+            return false;
+        }
+        data.materialLibraries.resize(numMaterialLibraries);
+        for(string & materialLibrary : data.materialLibraries) {
+            MeshSourceInfo cached;
+            if (!reader.read(materialLibrary) || !reader.read(cached.size) ||
+                !reader.read(cached.modifiedTime)) {
+                return false;
+            }
+            const MeshSourceInfo current = getMaterialLibraryInfo(objFilePath,
+                    materialLibrary);
+            if (current.size != cached.size || current.modifiedTime != cached.modifiedTime) {
+                return false;
+            }
+        }
+
+        uint32 numLodRatios;
+        if (!reader.read(numLodRatios) || !reader.canHold(numLodRatios, sizeof(float))) {
+            return false;
+        }
+        data.lodRatios.resize(numLodRatios);
+        for(float & ratio : data.lodRatios) {
+            if (!reader.read(ratio)) {
+                return false;
+            }
+        }
+
+        uint32 numLods;
+        if (!reader.read(numLods) || !reader.canHold(numLods, 16)) {
+            return false;
+        }
+        data.lods.resize(numLods);
+        for(MeshLod & lod : data.lods) {
+            if (!reader.read(lod.error) || !reader.read(lod.startIndex) ||
+                !reader.read(lod.numIndices) || !readSubmeshes(reader, lod.submeshes)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //------------------------------------------------------------------------------------
+    template <class T>
+    bool valuesBelow(const void * data, size_t count, uint32 limit) {
+        const T * values = static_cast<const T *>(data);
+        return count == 0 || *std::max_element(values, values + count) < limit;
+    }
+
+    //------------------------------------------------------------------------------------
+    // @return true if every index in 'indices' refers to one of 'numVertices' vertices.
+    bool indicesInRange(const IndexBuffer & indices, uint32 numVertices) {
+        if (indices.empty()) {
+            return true;
+        }
+        if (indices.getIndexSize() == sizeof(uint16)) {
+            return valuesBelow<uint16>(indices.getDataPtr(), indices.getNumIndices(),
+                    numVertices);
+        }
+        return valuesBelow<uint32>(indices.getDataPtr(), indices.getNumIndices(),
+                numVertices);
+    }
+
+    //------------------------------------------------------------------------------------
+    // Empty for cache files next to their .obj files.
+    string & cacheDirectory() {
+        static string directory;
+        return directory;
+    }
+
+    //------------------------------------------------------------------------------------
+    bool & cacheEnabled() {
+        static bool enabled = true;
+        return enabled;
+    }
+
+    //------------------------------------------------------------------------------------
+    AABB computeAABB(const vector<vec3> & positions) {
+        AABB aabb = {vec3(0.0f), vec3(0.0f)};
+        if (!positions.empty()) {
+            aabb.minBounds = aabb.maxBounds = positions[0];
+            for(const vec3 & position : positions) {
+                aabb.minBounds = glm::min(aabb.minBounds, position);
+                aabb.maxBounds = glm::max(aabb.maxBounds, position);
+            }
+        }
+        return aabb;
+    }
+
+}
+
+const uint32 MeshCache::formatVersion;
+
+//----------------------------------------------------------------------------------------
+/**
+ * Places cache files in 'directory', which must already exist, rather than
+ * next to their .obj files.  An empty 'directory', the default, places them
+ * next to their .obj files again.
+ */
+void MeshCache::setCacheDirectory(const string & directory) {
+    cacheDirectory() = directory;
+}
+
+//----------------------------------------------------------------------------------------
+const string & MeshCache::getCacheDirectory() {
+    return cacheDirectory();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Turns caching on or off.  While off, load() always decodes the .obj file and
+ * neither reads nor writes cache files.  Caching is on by default.
+ */
+void MeshCache::setEnabled(bool enabled) {
+    cacheEnabled() = enabled;
+}
+
+//----------------------------------------------------------------------------------------
+bool MeshCache::isEnabled() {
+    return cacheEnabled();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return path of the cache file for 'objFilePath', which sits next to it, or
+ * in the cache directory if one was set.  There, the file is named after the
+ * .obj file and a hash of 'objFilePath', so that .obj files of the same name
+ * in different directories do not share a cache file.  Indexed and unindexed
+ * meshes are cached separately.
+ */
+string MeshCache::getCachePath(const char * objFilePath, MeshIndexing indexing) {
+    string cachePath(objFilePath);
+    const string & directory = cacheDirectory();
+    if (!directory.empty()) {
+        const size_t separator = cachePath.find_last_of("/\\");
+        const string fileName = (separator == string::npos) ? cachePath :
+                cachePath.substr(separator + 1);
+
+        char pathHash[17];
+        std::snprintf(pathHash, sizeof(pathHash), "%016llx",
+                static_cast<unsigned long long>(std::hash<string>()(cachePath)));
+
+        cachePath = directory;
+        if (cachePath.back() != '/' && cachePath.back() != '\\') {
+            cachePath += '/';
+        }
+        cachePath += fileName + "." + pathHash;
+    }
+    if (indexing == MeshIndexing::Indexed) {
+        cachePath += ".indexed";
+    }
+    cachePath += ".r3dmesh";
+    return cachePath;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Loads the mesh in 'objFilePath', from its cache file if that is up to date,
+ * and otherwise by decoding the .obj file and then writing the cache file.
+ * Only decodes the .obj file if caching is disabled.
+ *
+ * @param numThreads - threads to parse the .obj file with, as by
+ * ObjFileLoader::decodeModelBuffer().
+ *
+ * @return true if 'data' was read from the cache file.
+ *
+ * @throws Rigid3DException if the .obj file cannot be read.
+ */
+bool MeshCache::load(const char * objFilePath, MeshIndexing indexing, MeshData & data,
+        const vector<float> & lodRatios, uint32 numThreads) {
+    if (!isEnabled()) {
+        decodeObj(objFilePath, indexing, data, lodRatios, numThreads);
+        return false;
+    }
+
+    const string cachePath = getCachePath(objFilePath, indexing);
+
+    MeshSourceInfo source;
+    const bool haveSource = getSourceInfo(objFilePath, source);
+    if (haveSource &&
+        read(cachePath.c_str(), objFilePath, source, indexing, data, lodRatios)) {
+        return true;
+    }
+
+    decodeObj(objFilePath, indexing, data, lodRatios, numThreads);
+
+    if (haveSource) {
+        write(cachePath.c_str(), objFilePath, source, hashFile(objFilePath), indexing,
+                data);
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Decodes 'objFilePath' and its materials, and computes the bounding box and MeshBvh of the result.
+ * Indexed meshes are reordered by MeshOptimizer first, and simplified into a
+ * level of detail per ratio in 'lodRatios', so the cost is paid once per cache
+ * file rather than per load.  The .obj file is parsed with 'numThreads'
+ * threads, as by ObjFileLoader::decodeModelBuffer().
+ */
+void MeshCache::decodeObj(const char * objFilePath, MeshIndexing indexing,
+        MeshData & data, const vector<float> & lodRatios, uint32 numThreads) {
+    ObjModel model;
+    ObjFileLoader::decodeModel(objFilePath, indexing, model, numThreads);
+    if (indexing == MeshIndexing::Indexed) {
+        MeshOptimizer::optimize(model.indices, model.positions, model.normals,
+                model.uvCoords, model.submeshes);
+    }
+
+    data.positions = std::move(model.positions);
+    data.normals = std::move(model.normals);
+    data.uvCoords = std::move(model.uvCoords);
+    data.indices.clear();
+    data.lodIndices.clear();
+    data.lods.clear();
+    data.lodRatios = lodRatios;
+    if (indexing == MeshIndexing::Indexed) {
+        const uint32 numVertices = uint32(data.positions.size());
+        data.indices.assign(model.indices, numVertices);
+
+        vector<uint32> lodIndices;
+        MeshSimplifier::generateLods(data.positions, model.indices, model.submeshes,
+                lodRatios, lodIndices, data.lods);
+        if (!lodIndices.empty()) {
+            data.lodIndices.assign(lodIndices, numVertices);
+        }
+    }
+    data.submeshes = std::move(model.submeshes);
+    data.materials = std::move(model.materials);
+    data.materialLibraries = std::move(model.materialLibraries);
+
+    data.aabb = computeAABB(data.positions);
+    data.bvh.build(data.positions, data.indices);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Reads 'cachePath' into 'data', provided it is a valid cache file for the
+ * current contents of 'objFilePath', with levels of detail for 'lodRatios'.
+ *
+ * @return false, leaving 'data' in an unspecified state, if the cache file is
+ * missing, invalid or out of date, including if any index or BVH triangle is
+ * out of range.
+ */
+bool MeshCache::read(const char * cachePath, const char * objFilePath,
+        const MeshSourceInfo & source, MeshIndexing indexing, MeshData & data,
+        const vector<float> & lodRatios) {
+    try {
+        MappedFile file(cachePath);
+        const char * fileData = file.getData();
+        const size_t fileSize = file.getSize();
+
+        if (fileSize < sizeof(MeshCacheHeader)) {
+            return false;
+        }
+
+        MeshCacheHeader header;
+        std::memcpy(&header, fileData, sizeof(header));
+
+        const uint32 expectedFlags = (indexing == MeshIndexing::Indexed) ? indexedFlag : 0;
+        if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 ||
+            header.version != formatVersion ||
+            header.flags != expectedFlags ||
+            header.sourceSize != source.size) {
+            return false;
+        }
+
+        for(int s = 0; s < NumStreams; ++s) {
+            if (header.streamOffsets[s] > fileSize ||
+                header.streamBytes[s] > fileSize - header.streamOffsets[s]) {
+                return false;
+            }
+        }
+
+        // A changed modification time alone, such as from a checkout or copy,
+        // does not invalidate the cache if the contents are unchanged.
+        if (header.sourceModifiedTime != source.modifiedTime &&
+            header.sourceHash != hashFile(objFilePath)) {
+            return false;
+        }
+
+        vector<MeshBvhNode> bvhNodes;
+        vector<uint32> bvhTriangles;
+        if (!readStream(header, fileData, PositionStream, header.numPositions, data.positions) ||
+            !readStream(header, fileData, NormalStream, header.numNormals, data.normals) ||
+            !readStream(header, fileData, UvCoordStream, header.numUvCoords, data.uvCoords) ||
+            !readStream(header, fileData, BvhNodeStream, header.numBvhNodes, bvhNodes) ||
+            !readStream(header, fileData, BvhTriangleStream, header.numBvhTriangles, bvhTriangles)) {
+            return false;
+        }
+
+        if (header.streamBytes[IndexStream] != uint64_t(header.numIndices) * header.indexSize) {
+            return false;
+        }
+        if (header.numIndices == 0) {
+            data.indices.clear();
+        } else {
+            data.indices.assign(fileData + header.streamOffsets[IndexStream],
+                    header.numIndices, header.indexSize);
+        }
+
+        if (header.streamBytes[LodIndexStream] !=
+                uint64_t(header.numLodIndices) * header.indexSize) {
+            return false;
+        }
+        if (header.numLodIndices == 0) {
+            data.lodIndices.clear();
+        } else {
+            data.lodIndices.assign(fileData + header.streamOffsets[LodIndexStream],
+                    header.numLodIndices, header.indexSize);
+        }
+
+        // Indices are used without further checks, so must refer to cached vertices.
+        const uint32 numTriangles = uint32(data.indices.empty() ?
+                header.numPositions / 3 : header.numIndices / 3);
+        if (!indicesInRange(data.indices, header.numPositions) ||
+            !indicesInRange(data.lodIndices, header.numPositions) ||
+            !valuesBelow<uint32>(bvhTriangles.data(), bvhTriangles.size(), numTriangles)) {
+            return false;
+        }
+
+        if (header.streamBytes[MetadataStream] != header.numMetadataBytes ||
+            !readMetadata(objFilePath, fileData + header.streamOffsets[MetadataStream],
+                    header.numMetadataBytes, data) ||
+            data.lodRatios != lodRatios) {
+            return false;
+        }
+
+        data.aabb.minBounds = vec3(header.aabbMin[0], header.aabbMin[1], header.aabbMin[2]);
+        data.aabb.maxBounds = vec3(header.aabbMax[0], header.aabbMax[1], header.aabbMax[2]);
+        data.bvh.assign(std::move(bvhNodes), std::move(bvhTriangles));
+        return true;
+
+    } catch (const Rigid3DException &) {
+        return false;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Writes 'data', decoded from 'objFilePath', to 'cachePath', by way of a temporary file that then replaces
+ * any existing cache file, so that a partially written cache is never read.
+ *
+ * @return false if the cache file could not be written.
+ */
+bool MeshCache::write(const char * cachePath, const char * objFilePath,
+        const MeshSourceInfo & source, uint64_t sourceHash, MeshIndexing indexing,
+        const MeshData & data) {
+    const vector<char> metadata = writeMetadata(objFilePath, data);
+
+    MeshCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = formatVersion;
+    header.flags = (indexing == MeshIndexing::Indexed) ? indexedFlag : 0;
+    header.sourceSize = source.size;
+    header.sourceModifiedTime = source.modifiedTime;
+    header.sourceHash = sourceHash;
+    header.numPositions = uint32(data.positions.size());
+    header.numNormals = uint32(data.normals.size());
+    header.numUvCoords = uint32(data.uvCoords.size());
+    header.numIndices = uint32(data.indices.getNumIndices());
+    header.indexSize = data.indices.empty() ? 0 : data.indices.getIndexSize();
+    header.numBvhNodes = uint32(data.bvh.getNodes().size());
+    header.numBvhTriangles = uint32(data.bvh.getTriangles().size());
+    header.numMetadataBytes = uint32(metadata.size());
+    header.numLodIndices = uint32(data.lodIndices.getNumIndices());
+    for(int i = 0; i < 3; ++i) {
+        header.aabbMin[i] = data.aabb.minBounds[i];
+        header.aabbMax[i] = data.aabb.maxBounds[i];
+    }
+
+    const void * streamData[NumStreams] = {
+        data.positions.data(),
+        data.normals.data(),
+        data.uvCoords.data(),
+        data.indices.getDataPtr(),
+        data.bvh.getNodes().data(),
+        data.bvh.getTriangles().data(),
+        data.lodIndices.getDataPtr(),
+        metadata.data()
+    };
+    header.streamBytes[PositionStream] = data.positions.size() * sizeof(vec3);
+    header.streamBytes[NormalStream] = data.normals.size() * sizeof(vec3);
+    header.streamBytes[UvCoordStream] = data.uvCoords.size() * sizeof(vec2);
+    header.streamBytes[IndexStream] = data.indices.empty() ? 0 : data.indices.getNumBytes();
+    header.streamBytes[BvhNodeStream] = data.bvh.getNodes().size() * sizeof(MeshBvhNode);
+    header.streamBytes[BvhTriangleStream] = data.bvh.getTriangles().size() * sizeof(uint32);
+    header.streamBytes[LodIndexStream] =
+            data.lodIndices.empty() ? 0 : data.lodIndices.getNumBytes();
+    header.streamBytes[MetadataStream] = metadata.size();
+
+    uint64_t offset = sizeof(header);
+    for(int s = 0; s < NumStreams; ++s) {
+        offset = (offset + streamAlignment - 1) & ~uint64_t(streamAlignment - 1);
+        header.streamOffsets[s] = offset;
+        offset += header.streamBytes[s];
+    }
+
+    const string tempPath = string(cachePath) + ".tmp";
+    {
+        std::ofstream out(tempPath.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+
+        const char padding[streamAlignment] = {};
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        uint64_t position = sizeof(header);
+        for(int s = 0; s < NumStreams; ++s) {
+            out.write(padding, std::streamsize(header.streamOffsets[s] - position));
+            out.write(static_cast<const char *>(streamData[s]),
+                    std::streamsize(header.streamBytes[s]));
+            position = header.streamOffsets[s] + header.streamBytes[s];
+        }
+
+        if (!out) {
+            out.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+#if defined(_WIN32)
+    // rename() does not replace existing files on Windows.
+    std::remove(cachePath);
+#endif
+    if (std::rename(tempPath.c_str(), cachePath) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return false if 'objFilePath' does not exist.
+ */
+bool MeshCache::getSourceInfo(const char * objFilePath, MeshSourceInfo & source) {
+#if defined(_WIN32)
+    struct _stat64 fileStatus;
+    if (_stat64(objFilePath, &fileStatus) != 0) {
+        return false;
+    }
+#else
+    struct stat fileStatus;
+    if (stat(objFilePath, &fileStatus) != 0) {
+        return false;
+    }
+#endif
+    source.size = uint64_t(fileStatus.st_size);
+    source.modifiedTime = int64_t(fileStatus.st_mtime);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return 64-bit hash of the contents of 'filePath', reading 8 bytes at a time.
+ */
+uint64_t MeshCache::hashFile(const char * filePath) {
+    MappedFile file(filePath);
+    const char * data = file.getData();
+    const size_t size = file.getSize();
+
+    const uint64_t prime = 0x100000001B3ull;
+    uint64_t hash = 0xCBF29CE484222325ull ^ size;
+
+    size_t i = 0;
+    for(; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 32;
+    }
+    for(; i < size; ++i) {
+        hash = (hash ^ uint64_t(uint8(data[i]))) * prime;
+    }
+    return hash;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return ratios of the original triangle count that levels of detail are
+ * generated for when none are given: half, a quarter and an eighth.
+ */
+const vector<float> & MeshCache::getDefaultLodRatios() {
+    static const vector<float> ratios = {0.5f, 0.25f, 0.125f};
+    return ratios;
+}
+
+}
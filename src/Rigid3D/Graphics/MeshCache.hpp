@@ -0,0 +1,126 @@
+/**
+ * @brief MeshCache
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_MESH_CACHE_HPP_
+#define RIGID3D_MESH_CACHE_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Graphics/IndexBuffer.hpp>
+#include <Rigid3D/Graphics/MaterialProperties.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/MeshBvh.hpp>
+#include <Rigid3D/Graphics/MeshSimplifier.hpp>
+#include <Rigid3D/Graphics/Submesh.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * Everything a Mesh loads from an .obj file or its cache.
+     */
+    struct MeshData {
+        std::vector<vec3> positions;
+        std::vector<vec3> normals;
+        std::vector<vec2> uvCoords;
+        IndexBuffer indices;
+        AABB aabb;
+        MeshBvh bvh;
+        std::vector<Submesh> submeshes;
+        std::vector<Material> materials;
+
+        // .mtl file names given by the .obj file's 'mtllib' lines.
+        std::vector<std::string> materialLibraries;
+
+        // Simplified levels of detail, and the ratios they were generated for.
+        // Only indexed meshes have levels of detail.
+        IndexBuffer lodIndices;
+        std::vector<MeshLod> lods;
+        std::vector<float> lodRatios;
+    };
+
+    /**
+     * Size and modification time of a mesh's source .obj file, used to tell
+     * whether a cache file is out of date.
+     */
+    struct MeshSourceInfo {
+        uint64_t size;
+        int64_t modifiedTime;
+    };
+
+    /**
+     * @brief Binary cache of decoded .obj files.
+     *
+     * The first time an .obj file is loaded, its decoded vertex data, indices
+     * (reordered by MeshOptimizer), bounding box and MeshBvh are written to a
+     * cache file, next to it unless setCacheDirectory() gave a directory for
+     * cache files.  Later loads memory map the cache file and copy each
+     * stream out with a single memcpy, skipping text parsing entirely.
+     *
+     * A cache file starts with a versioned header recording the source file's
+     * size, modification time and content hash, followed by 16 byte aligned
+     * streams in native byte order: positions, normals, texture coordinates,
+     * indices, BVH nodes, BVH triangles, LOD indices, and a metadata stream
+     * holding submeshes, materials, levels of detail, and the size and
+     * modification time of each .mtl file.  The cache is used if the source's
+     * size and modification time match, or if only the modification time differs
+     * but the content hash still matches, and if no .mtl file has changed and the
+     * levels of detail were generated for the same ratios.  Otherwise, or if the
+     * cache file is missing, truncated or from another format version, the .obj
+     * file is decoded and the cache rewritten.
+     *
+     * Failing to write a cache file, such as in a read-only directory, is not an
+     * error; the mesh is simply decoded again next time.  Neither is a cache file
+     * whose indices refer past its vertices, which is treated as out of date.
+     *
+     * setEnabled(false) turns caching off, so that every load decodes the .obj
+     * file and no cache file is read or written.  The cache directory and
+     * whether caching is enabled are shared by all threads, and must not be
+     * changed while meshes are loading.
+     */
+    class MeshCache {
+    public:
+        static const uint32 formatVersion = 4;
+
+        static void setCacheDirectory(const std::string & directory);
+
+        static const std::string & getCacheDirectory();
+
+        static void setEnabled(bool enabled);
+
+        static bool isEnabled();
+
+        static std::string getCachePath(const char * objFilePath, MeshIndexing indexing);
+
+        static bool load(const char * objFilePath, MeshIndexing indexing, MeshData & data,
+                const std::vector<float> & lodRatios = getDefaultLodRatios(),
+                uint32 numThreads = 0);
+
+        static void decodeObj(const char * objFilePath, MeshIndexing indexing,
+                MeshData & data, const std::vector<float> & lodRatios = getDefaultLodRatios(),
+                uint32 numThreads = 0);
+
+        static bool read(const char * cachePath, const char * objFilePath,
+                const MeshSourceInfo & source, MeshIndexing indexing, MeshData & data,
+                const std::vector<float> & lodRatios = getDefaultLodRatios());
+
+        static bool write(const char * cachePath, const char * objFilePath,
+                const MeshSourceInfo & source, uint64_t sourceHash, MeshIndexing indexing,
+                const MeshData & data);
+
+        static bool getSourceInfo(const char * objFilePath, MeshSourceInfo & source);
+
+        static uint64_t hashFile(const char * filePath);
+
+        static const std::vector<float> & getDefaultLodRatios();
+    };
+
+}
+
+#endif /* RIGID3D_MESH_CACHE_HPP_ */
@@ -1,25 +1,40 @@
 #include "MeshConsolidator.hpp"
 
+#include <Rigid3D/Common/ParallelFor.hpp>
 #include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/AssetLoader.hpp>
 
+#include <algorithm>
 #include <cstring>
-#include <cstdlib>
 
 namespace Rigid3D {
     
 using namespace std;
 
+namespace {
+
+    // @return true if 'inner' lies within 'outer', which must not be empty.
+    bool isWithin(const VertexBounds & inner, const VertexBounds & outer) {
+        return glm::max(inner.positions.minBounds, outer.positions.minBounds) ==
+                       inner.positions.minBounds &&
+               glm::min(inner.positions.maxBounds, outer.positions.maxBounds) ==
+                       inner.positions.maxBounds &&
+               glm::max(inner.minUvCoord, outer.minUvCoord) == inner.minUvCoord &&
+               glm::min(inner.maxUvCoord, outer.maxUvCoord) == inner.maxUvCoord;
+    }
+
+}
+
 //----------------------------------------------------------------------------------------
 /**
  * Default constructor
  */
 MeshConsolidator::MeshConsolidator()
-        : totalPositionBytes(0),
-          totalNormalBytes(0),
-          vertexPositionDataPtr_head(nullptr),
-          vertexPositionDataPtr_tail(nullptr),
-          normalDataPtr_head(nullptr),
-          normalDataPtr_tail(nullptr) { }
+        : layoutType(VertexLayoutType::Separate),
+          indexed(false),
+          hasNormals(false),
+          hasUvCoords(false),
+          numConsolidatedVertices(0) { }
 
 
 //----------------------------------------------------------------------------------------
@@ -28,9 +43,12 @@ MeshConsolidator::MeshConsolidator()
  * c-string identifiers, and mapped values equal to Mesh pointers.
  *
  * @param list
+ * @param layoutType - arrangement of the consolidated vertex data.
  */
-MeshConsolidator::MeshConsolidator(initializer_list<pair<const char *, const Mesh *> > list)
-        : totalPositionBytes(0), totalNormalBytes(0) {
+MeshConsolidator::MeshConsolidator(initializer_list<pair<const char *, const Mesh *> > list,
+        VertexLayoutType layoutType)
+        : layoutType(layoutType), indexed(false), hasNormals(false), hasUvCoords(false),
+          numConsolidatedVertices(0) {
 
     unordered_map<const char *, const Mesh *> meshMap;
     for(auto key_value : list) {
@@ -45,60 +63,103 @@ MeshConsolidator::MeshConsolidator(initializer_list<pair<const char *, const Mes
  * Constructs a \c MeshConsolidator object from an \c unordered_map with keys equal to
  * c-string identifiers, and mapped values equal to Wavefront .obj file names.
  *
+ * The .obj files are loaded concurrently by an \c AssetLoader with one thread per
+ * file, up to one per hardware thread.  To keep loading off the calling thread
+ * entirely, load the meshes with an \c AssetLoader and consolidate them once
+ * ready, using the \c Mesh pointer constructor.
+ *
  * @param list
+ * @param layoutType - arrangement of the consolidated vertex data.
  */
-MeshConsolidator::MeshConsolidator(initializer_list<pair<const char *, const char *> > list)
-        : totalPositionBytes(0), totalNormalBytes(0) {
+MeshConsolidator::MeshConsolidator(initializer_list<pair<const char *, const char *> > list,
+        VertexLayoutType layoutType)
+        : layoutType(layoutType), indexed(false), hasNormals(false), hasUvCoords(false),
+          numConsolidatedVertices(0) {
 
     // Need to keep Mesh objects in memory for processing until the end of this block.
-    // Use vector<shared_ptr<Mesh>> as memory requirements could be large for some Meshes.
-    // Meshes will auto-destruct at the end of this method when vector goes out of scope.
-    vector<shared_ptr<Mesh> > meshVector;
-    meshVector.resize(list.size());
+    // Meshes will auto-destruct at the end of this method when futures go out of scope.
+    AssetLoader loader(std::max(uint32(1),
+            std::min(uint32(list.size()), resolveThreadCount(0))));
+    vector<AssetLoader::MeshFuture> meshFutures;
+    meshFutures.reserve(list.size());
+    for(auto key_value : list) {
+        meshFutures.push_back(loader.loadMesh(key_value.second));
+    }
+    loader.finish();
 
     unordered_map<const char *, const Mesh *> meshMap;
     int i = 0;
     for(auto key_value : list) {
         const char * meshId = key_value.first;
-        const char * meshFileName = key_value.second;
-        meshVector[i] = make_shared<Mesh>(meshFileName);
-        meshMap[meshId] = meshVector[i].get();
+        meshMap[meshId] = meshFutures[i].get().get();
         i++;
     }
 
     processMeshes(meshMap);
 }
 
+//----------------------------------------------------------------------------------------
+/**
+ * Constructs an empty \c MeshConsolidator for meshes to be added and removed
+ * one at a time.
+ *
+ * @param layoutType - arrangement of the consolidated vertex data.
+ * @param indexing - whether batches are ranges of a consolidated index buffer.
+ * Unindexed meshes may be added to an indexed \c MeshConsolidator, but not the
+ * other way around.
+ * @param hasNormals - whether to store normals.
+ * @param hasUvCoords - whether to store texture coordinates.
+ * @param bounds - range of the positions and texture coordinates of every
+ * \c Mesh that will be added, which quantized layouts require.
+ */
+MeshConsolidator::MeshConsolidator(VertexLayoutType layoutType, MeshIndexing indexing,
+        bool hasNormals, bool hasUvCoords, const VertexBounds & bounds)
+        : layoutType(layoutType),
+          layout(layoutType, 0, hasNormals, hasUvCoords, bounds),
+          indexed(indexing == MeshIndexing::Indexed),
+          hasNormals(hasNormals),
+          hasUvCoords(hasUvCoords),
+          bounds(bounds),
+          numConsolidatedVertices(0) { }
+
 //----------------------------------------------------------------------------------------
 void MeshConsolidator::processMeshes(const unordered_map<const char *, const Mesh *> & meshMap) {
 
-    // Calculate the total number of bytes for both vertex and normal data.
+    // Count vertices, and find which attributes any Mesh has, and their bounds.
+    VertexBounds bounds;
+    size_t numVertices = 0;
+    bool anyNormals = false;
+    bool anyUvCoords = false;
+    bool anyIndexed = false;
+    size_t totalIndices = 0;
     for(auto key_value: meshMap) {
         const Mesh & mesh = *(key_value.second);
-        totalPositionBytes += mesh.getNumVertexPositionBytes();
-        totalNormalBytes += mesh.getNumVertexNormalBytes();
-    }
+        numVertices += mesh.getNumVertexPositions();
+        anyNormals |= (mesh.getNumVertexNormals() != 0);
+        anyUvCoords |= (mesh.getNumTextureCoords() != 0);
+        if (mesh.getNumVertexPositions() != 0) {
+            bounds.extend(mesh.getAABB(), mesh.getTextureCoordVector()->data(),
+                    mesh.getNumTextureCoords());
+        }
 
-    // Allocate memory for vertex position data.
-    vertexPositionDataPtr_head = shared_ptr<float>((float *)malloc(totalPositionBytes), free);
-    if (vertexPositionDataPtr_head.get() == (float *)0) {
-        throw Rigid3DException("Unable to allocate system memory within method MeshConsolidator::processMeshes");
+        anyIndexed |= mesh.isIndexed();
+        totalIndices += mesh.isIndexed() ? mesh.getNumIndices() : mesh.getNumVertexPositions();
     }
 
-    // Allocate memory for normal data.
-    normalDataPtr_head = shared_ptr<float>((float *)malloc(totalNormalBytes), free);
-    if (vertexPositionDataPtr_head.get() == (float *)0) {
-        throw Rigid3DException("Unable to allocate system memory within method MeshConsolidator::processMeshes");
-    }
+    this->indexed = anyIndexed;
+    this->hasNormals = anyNormals;
+    this->hasUvCoords = anyUvCoords;
+    this->bounds = bounds;
 
-    // Assign pointers to beginning of memory blocks.
-    vertexPositionDataPtr_tail = vertexPositionDataPtr_head.get();
-    normalDataPtr_tail = normalDataPtr_head.get();
+    // Reserving exactly what is needed up front packs the meshes back to back,
+    // and sizes indices for the final number of vertices.
+    layout = VertexLayout(layoutType, 0, anyNormals, anyUvCoords, bounds);
+    reserve(numVertices, anyIndexed ? totalIndices : 0);
 
     for(auto key_value : meshMap) {
         const char * meshId = key_value.first;
         const Mesh & mesh = *(key_value.second);
-        consolidateMesh(meshId, mesh);
+        addMesh(meshId, mesh);
     }
 }
 
@@ -108,17 +169,263 @@ MeshConsolidator::~MeshConsolidator() {
 }
 
 //----------------------------------------------------------------------------------------
-void MeshConsolidator::consolidateMesh(const char * meshId, const Mesh & mesh) {
-    unsigned int startIndex = (unsigned int)((vertexPositionDataPtr_tail - vertexPositionDataPtr_head.get()) / num_floats_per_vertex);
-    unsigned int numIndices = mesh.getNumVertexPositions();
+/**
+ * Copies the vertices and indices of 'mesh' into free ranges of the
+ * consolidated buffers, growing them if needed.
+ *
+ * @return the \c Mesh's batch, which stays valid until removeMesh() is called
+ * with 'meshId', and is updated in place whenever the \c Mesh's data moves.
+ *
+ * @throws Rigid3DException if 'meshId' is already in use, if 'mesh' is indexed
+ * but this \c MeshConsolidator is not, or if the layout is quantized and 'mesh'
+ * lies outside its bounds.
+ */
+const BatchInfo * MeshConsolidator::addMesh(const char * meshId, const Mesh & mesh) {
+    if (batches.count(meshId) != 0) {
+        throw Rigid3DException("Mesh ID is already in use within method "
+                "MeshConsolidator::addMesh");
+    }
+    if (mesh.isIndexed() && !indexed) {
+        throw Rigid3DException("Indexed Mesh added to unindexed MeshConsolidator within "
+                "method MeshConsolidator::addMesh");
+    }
+
+    // Attributes the Mesh lacks, but others have, are written as zeros.
+    const uint32 numVertices = mesh.getNumVertexPositions();
+    const bool meshHasNormals = (mesh.getNumVertexNormals() == numVertices);
+    const bool meshHasUvCoords = (mesh.getNumTextureCoords() == numVertices);
+
+    if (layoutType == VertexLayoutType::Quantized && numVertices != 0) {
+        VertexBounds meshBounds;
+        meshBounds.extend(mesh.getAABB(), mesh.getTextureCoordVector()->data(),
+                (hasUvCoords && meshHasUvCoords) ? numVertices : 0);
+        if (bounds.isEmpty() || !isWithin(meshBounds, bounds)) {
+            throw Rigid3DException("Mesh lies outside the quantization bounds within "
+                    "method MeshConsolidator::addMesh");
+        }
+    }
+
+    Batch batch;
+    batch.numVertices = numVertices;
+    batch.firstVertex = (numVertices != 0) ? allocateVertices(numVertices) : 0;
+    layout.writeVertices(vertexData.data(), batch.firstVertex, numVertices,
+            mesh.getVertexPositionVector()->data(),
+            meshHasNormals ? mesh.getVertexNormalVector()->data() : nullptr,
+            meshHasUvCoords ? mesh.getTextureCoordVector()->data() : nullptr);
+    numConsolidatedVertices += numVertices;
+
+    batch.firstIndex = 0;
+    batch.numIndices = 0;
+    if (indexed) {
+        // Offset indices to refer to this Mesh's position within the consolidated
+        // vertex data.  Unindexed meshes get sequential indices.
+        batch.numIndices = mesh.isIndexed() ? mesh.getNumIndices() : numVertices;
+        batch.firstIndex = (batch.numIndices != 0) ? allocateIndices(batch.numIndices) : 0;
+
+        const IndexBuffer & meshIndices = mesh.getIndexBuffer();
+        for(uint32 i = 0; i < batch.numIndices; ++i) {
+            const uint32 index = mesh.isIndexed() ? meshIndices[i] : i;
+            indices.set(batch.firstIndex + i, batch.firstVertex + index);
+        }
+        batch.batchInfo = BatchInfo(batch.firstIndex, batch.numIndices,
+                indices.getIndexSize());
+    } else {
+        batch.batchInfo = BatchInfo(batch.firstVertex, numVertices);
+    }
+
+    Batch & stored = batches[meshId];
+    stored = batch;
+    return &stored.batchInfo;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Frees the ranges of the \c Mesh added as 'meshId' for reuse, and invalidates
+ * its \c BatchInfo.  The buffers keep their size until compact() is called.
+ *
+ * @return false if no \c Mesh was added as 'meshId'.
+ */
+bool MeshConsolidator::removeMesh(const char * meshId) {
+    const auto found = batches.find(meshId);
+    if (found == batches.end()) {
+        return false;
+    }
+
+    const Batch & batch = found->second;
+    if (batch.numVertices != 0) {
+        vertexAllocator.free(batch.firstVertex);
+        numConsolidatedVertices -= batch.numVertices;
+    }
+    if (batch.numIndices != 0) {
+        indexAllocator.free(batch.firstIndex);
+    }
+    batches.erase(found);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Moves every \c Mesh's vertices and indices towards the start of their
+ * buffers, in their current order, so that all free space is left in one
+ * range at the end.  \c BatchInfo pointers from addMesh() are updated in
+ * place, and the whole of both buffers should be uploaded again.
+ */
+void MeshConsolidator::compact() {
+    vector<Batch *> order;
+    order.reserve(batches.size());
+    for(auto & key_value : batches) {
+        order.push_back(&key_value.second);
+    }
+
+    // A freshly reset allocator hands out consecutive ranges, so allocating in
+    // order of current offset only ever moves data towards the start.
+    std::sort(order.begin(), order.end(), [](const Batch * a, const Batch * b) {
+        return a->firstVertex < b->firstVertex;
+    });
+    vector<uint32> vertexShifts(order.size(), 0);
+    vertexAllocator.reset(uint32(layout.getNumVertices()));
+    for(size_t i = 0; i < order.size(); ++i) {
+        Batch & batch = *order[i];
+        if (batch.numVertices == 0) {
+            continue;
+        }
+        const uint32 firstVertex = vertexAllocator.allocate(batch.numVertices);
+        if (firstVertex != batch.firstVertex) {
+            moveVertices(batch.firstVertex, batch.numVertices, firstVertex);
+        }
+        vertexShifts[i] = batch.firstVertex - firstVertex;
+        batch.firstVertex = firstVertex;
+        if (!indexed) {
+            batch.batchInfo.startIndex = firstVertex;
+        }
+    }
+
+    if (indexed) {
+        // Shifts are only needed by batch, not by vertex order, from here on.
+        unordered_map<const Batch *, uint32> shiftsByBatch;
+        for(size_t i = 0; i < order.size(); ++i) {
+            shiftsByBatch[order[i]] = vertexShifts[i];
+        }
 
-    memcpy(vertexPositionDataPtr_tail, mesh.getVertexPositionDataPtr(), mesh.getNumVertexPositionBytes());
-    vertexPositionDataPtr_tail += mesh.getNumVertexPositionBytes() / sizeof(float);
+        std::sort(order.begin(), order.end(), [](const Batch * a, const Batch * b) {
+            return a->firstIndex < b->firstIndex;
+        });
+        indexAllocator.reset(uint32(indices.getNumIndices()));
+        for(Batch * batch : order) {
+            if (batch->numIndices == 0) {
+                continue;
+            }
+            const uint32 firstIndex = indexAllocator.allocate(batch->numIndices);
+            const uint32 shift = shiftsByBatch[batch];
+            for(uint32 i = 0; i < batch->numIndices; ++i) {
+                indices.set(firstIndex + i, indices[batch->firstIndex + i] - shift);
+            }
+            batch->firstIndex = firstIndex;
+            batch->batchInfo.startIndex = firstIndex;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Grows the consolidated buffers to hold at least 'numVertices' vertices and
+ * 'numIndices' indices, moving the vertex data if its layout requires it.
+ * Offsets of existing meshes do not change.
+ */
+void MeshConsolidator::reserve(size_t numVertices, size_t numIndices) {
+    const size_t vertexCapacity = layout.getNumVertices();
+    if (numVertices > vertexCapacity) {
+        VertexLayout newLayout(layoutType, numVertices, hasNormals, hasUvCoords, bounds);
+        vector<ubyte> newVertexData(newLayout.getNumBytes());
+
+        if (layoutType == VertexLayoutType::Separate) {
+            // Each attribute's block starts further along in the larger buffer.
+            const VertexAttributeFormat * oldFormats[] = {&layout.getPositionFormat(),
+                    &layout.getNormalFormat(), &layout.getUvCoordFormat()};
+            const VertexAttributeFormat * newFormats[] = {&newLayout.getPositionFormat(),
+                    &newLayout.getNormalFormat(), &newLayout.getUvCoordFormat()};
+            for(int a = 0; a < 3; ++a) {
+                if (oldFormats[a]->isEnabled() && vertexCapacity != 0) {
+                    std::memcpy(newVertexData.data() + newFormats[a]->offset,
+                            vertexData.data() + oldFormats[a]->offset,
+                            vertexCapacity * oldFormats[a]->stride);
+                }
+            }
+        } else if (!vertexData.empty()) {
+            std::memcpy(newVertexData.data(), vertexData.data(), vertexData.size());
+        }
+
+        layout = newLayout;
+        vertexData.swap(newVertexData);
+        vertexAllocator.grow(uint32(numVertices));
+        if (indexed) {
+            indices.resize(indices.getNumIndices(), uint32(numVertices));
+        }
+    }
+
+    if (indexed && numIndices > indices.getNumIndices()) {
+        indices.resize(numIndices, uint32(layout.getNumVertices()));
+        indexAllocator.grow(uint32(numIndices));
+    }
+
+    // Indices may have been widened to 32 bits.
+    if (indexed) {
+        for(auto & key_value : batches) {
+            key_value.second.batchInfo.indexSize = indices.getIndexSize();
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return first of 'numVertices' free vertices, growing the vertex buffer to at
+ * least twice its size if no free range is large enough.
+ */
+uint32 MeshConsolidator::allocateVertices(uint32 numVertices) {
+    uint32 firstVertex = vertexAllocator.allocate(numVertices);
+    if (firstVertex == RangeAllocator::invalidOffset) {
+        const size_t capacity = layout.getNumVertices();
+        reserve(std::max(capacity * 2, capacity + numVertices), 0);
+        firstVertex = vertexAllocator.allocate(numVertices);
+    }
+    return firstVertex;
+}
 
-    memcpy(normalDataPtr_tail, mesh.getVertexNormalDataPtr(), mesh.getNumVertexNormalBytes());
-    normalDataPtr_tail += mesh.getNumVertexNormalBytes() / sizeof(float);
+//----------------------------------------------------------------------------------------
+/**
+ * @return first of 'numIndices' free indices, growing the index buffer to at
+ * least twice its size if no free range is large enough.
+ */
+uint32 MeshConsolidator::allocateIndices(uint32 numIndices) {
+    uint32 firstIndex = indexAllocator.allocate(numIndices);
+    if (firstIndex == RangeAllocator::invalidOffset) {
+        const size_t capacity = indices.getNumIndices();
+        reserve(0, std::max(capacity * 2, capacity + numIndices));
+        firstIndex = indexAllocator.allocate(numIndices);
+    }
+    return firstIndex;
+}
 
-    batchInfoMap[meshId] = BatchInfo(startIndex, numIndices);
+//----------------------------------------------------------------------------------------
+void MeshConsolidator::moveVertices(uint32 firstVertex, uint32 numVertices,
+        uint32 newFirstVertex) {
+    if (layoutType == VertexLayoutType::Separate) {
+        const VertexAttributeFormat * formats[] = {&layout.getPositionFormat(),
+                &layout.getNormalFormat(), &layout.getUvCoordFormat()};
+        for(const VertexAttributeFormat * format : formats) {
+            if (format->isEnabled()) {
+                ubyte * block = vertexData.data() + format->offset;
+                std::memmove(block + size_t(newFirstVertex) * format->stride,
+                        block + size_t(firstVertex) * format->stride,
+                        size_t(numVertices) * format->stride);
+            }
+        }
+    } else {
+        // Interleaved vertices are contiguous, starting with their position.
+        const size_t stride = layout.getPositionFormat().stride;
+        std::memmove(vertexData.data() + newFirstVertex * stride,
+                vertexData.data() + firstVertex * stride, numVertices * stride);
+    }
 }
 
 //----------------------------------------------------------------------------------------
@@ -132,43 +439,155 @@ void MeshConsolidator::consolidateMesh(const char * meshId, const Mesh & mesh) {
  * @see BatchInfo
  */
 void MeshConsolidator::getBatchInfo(unordered_map<const char *, BatchInfo> & batchInfoMap) const {
-    for(const auto & key_value : this->batchInfoMap) {
+    for(const auto & key_value : batches) {
         const char * meshId = key_value.first;
-        BatchInfo batchInfo = key_value.second;
+        BatchInfo batchInfo = key_value.second.batchInfo;
         batchInfoMap[meshId] = batchInfo;
     }
 }
 
 //----------------------------------------------------------------------------------------
 /**
- * @return the starting memory location for all consolidated \c Mesh vertex data.
+ * @return the batch of the \c Mesh added as 'meshId', as returned by addMesh(),
+ * or nullptr if there is none.
+ */
+const BatchInfo * MeshConsolidator::getBatchInfo(const char * meshId) const {
+    const auto found = batches.find(meshId);
+    if (found == batches.end()) {
+        return nullptr;
+    }
+    return &found->second.batchInfo;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return start of the consolidated vertex buffer, holding every attribute of
+ * every \c Mesh arranged as described by getVertexLayout().
+ */
+const void * MeshConsolidator::getVertexDataPtr() const {
+    return vertexData.data();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return size in bytes of the consolidated vertex buffer.
+ */
+unsigned long MeshConsolidator::getNumVertexBytes() const {
+    return (unsigned long)(vertexData.size());
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return offsets, strides and formats of each attribute within the buffer
+ * returned by getVertexDataPtr().
+ */
+const VertexLayout & MeshConsolidator::getVertexLayout() const {
+    return layout;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return a pointer into the consolidated vertex buffer at the start of an
+ * attribute's tightly packed block, or nullptr if the layout interleaves
+ * attributes or lacks the attribute.
+ */
+const float * MeshConsolidator::getSeparateAttributePtr(
+        const VertexAttributeFormat & format) const {
+    if (layout.getType() != VertexLayoutType::Separate || !format.isEnabled()) {
+        return nullptr;
+    }
+    return reinterpret_cast<const float *>(vertexData.data() + format.offset);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the starting memory location for all consolidated \c Mesh vertex data,
+ * or nullptr unless the layout is \c VertexLayoutType::Separate.
  */
 const float * MeshConsolidator::getVertexPositionDataPtr() const {
-    return vertexPositionDataPtr_head.get();
+    return getSeparateAttributePtr(layout.getPositionFormat());
 }
 
 //----------------------------------------------------------------------------------------
 /**
- * @return the starting memory location for all consolidated \c Mesh normal data.
+ * @return the starting memory location for all consolidated \c Mesh normal data,
+ * or nullptr unless the layout is \c VertexLayoutType::Separate.
  */
 const float * MeshConsolidator::getVertexNormalDataPtr() const {
-    return normalDataPtr_head.get();
+    return getSeparateAttributePtr(layout.getNormalFormat());
 }
 
 //----------------------------------------------------------------------------------------
 /**
- * @return the total number of bytes of all consolidated \c Mesh vertex data.
+ * @return the starting memory location for all consolidated \c Mesh texture
+ * coordinates, or nullptr unless the layout is \c VertexLayoutType::Separate.
+ */
+const float * MeshConsolidator::getTextureCoordDataPtr() const {
+    return getSeparateAttributePtr(layout.getUvCoordFormat());
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the total number of bytes of all consolidated \c Mesh vertex data, or
+ * zero unless the layout is \c VertexLayoutType::Separate.
  */
 unsigned long MeshConsolidator::getNumVertexPositionBytes() const {
-    return totalPositionBytes;
+    return getSeparateAttributePtr(layout.getPositionFormat()) ?
+            (unsigned long)(layout.getNumVertices() * layout.getPositionFormat().stride) : 0;
 }
 
 //----------------------------------------------------------------------------------------
 /**
- * @return the total number of bytes of all consolidated \c Mesh normal data.
+ * @return the total number of bytes of all consolidated \c Mesh normal data, or
+ * zero unless the layout is \c VertexLayoutType::Separate.
  */
 unsigned long MeshConsolidator::getNumVertexNormalBytes() const {
-    return totalNormalBytes;
+    return getSeparateAttributePtr(layout.getNormalFormat()) ?
+            (unsigned long)(layout.getNumVertices() * layout.getNormalFormat().stride) : 0;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the total number of bytes of all consolidated \c Mesh texture
+ * coordinates, or zero unless the layout is \c VertexLayoutType::Separate.
+ */
+unsigned long MeshConsolidator::getNumTextureCoordBytes() const {
+    return getSeparateAttributePtr(layout.getUvCoordFormat()) ?
+            (unsigned long)(layout.getNumVertices() * layout.getUvCoordFormat().stride) : 0;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if \c BatchInfo ranges refer to the consolidated index buffer.
+ */
+bool MeshConsolidator::isIndexed() const {
+    return indexed;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return consolidated indices of all \c Mesh objects, which is empty unless
+ * isIndexed().  Ranges freed by removeMesh() hold stale indices until reused.
+ */
+const IndexBuffer & MeshConsolidator::getIndexBuffer() const {
+    return indices;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of vertices belonging to meshes currently added.
+ */
+size_t MeshConsolidator::getNumVertices() const {
+    return numConsolidatedVertices;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of vertices the vertex buffer has room for, including free
+ * ranges.
+ */
+size_t MeshConsolidator::getVertexCapacity() const {
+    return layout.getNumVertices();
 }
 
 } // end namespace Rigid3D
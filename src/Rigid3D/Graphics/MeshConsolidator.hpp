@@ -1,7 +1,9 @@
 #ifndef RIGID3D_MESH_CONSOLIDATOR_HPP_
 #define RIGID3D_MESH_CONSOLIDATOR_HPP_
 
+#include <Rigid3D/Common/RangeAllocator.hpp>
 #include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/VertexLayout.hpp>
 
 #include <initializer_list>
 #include <utility>
@@ -24,19 +26,31 @@ namespace Rigid3D {
      *  glDrawArrays(GL_TRIANGLES, batchInfo.startIndex, batchInfo.numIndices);
      * \endcode
      *
+     * For indexed batches, 'indexSize' is the size in bytes of each index, and
+     * 'startIndex' and 'numIndices' refer to the index buffer instead:
+     * \code{.cpp}
+     *  GLenum type = (batchInfo.indexSize == 2) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+     *  glDrawElements(GL_TRIANGLES, batchInfo.numIndices, type,
+     *          (const GLvoid *)(size_t(batchInfo.startIndex) * batchInfo.indexSize));
+     * \endcode
      */
     struct BatchInfo {
         unsigned int startIndex;
         unsigned int numIndices;
 
+        // Zero for unindexed batches.
+        unsigned int indexSize;
+
         BatchInfo()
-                : startIndex(0), numIndices(0) { }
+                : startIndex(0), numIndices(0), indexSize(0) { }
 
-        BatchInfo(unsigned int startIndex, unsigned int numIndices)
-                : startIndex(startIndex), numIndices(numIndices) { }
+        BatchInfo(unsigned int startIndex, unsigned int numIndices,
+                  unsigned int indexSize = 0)
+                : startIndex(startIndex), numIndices(numIndices), indexSize(indexSize) { }
 
-        BatchInfo(const BatchInfo & other)
-                : startIndex(other.startIndex), numIndices(other.numIndices) { }
+        bool isIndexed() const {
+            return indexSize != 0;
+        }
     };
 
     /**
@@ -73,6 +87,57 @@ namespace Rigid3D {
      *  }
      * \endcode
      *
+     * All attributes, including texture coordinates, can instead be consolidated
+     * into one vertex buffer that is interleaved or packed, by passing a
+     * \c VertexLayoutType.  \c getVertexLayout() then gives the offset and stride
+     * of each attribute within the buffer returned by \c getVertexDataPtr():
+     *
+     * \code{.cpp}
+     *  MeshConsolidator meshConsolidator({{"cube", "cube.obj"}, {"torus", "torus.obj"}},
+     *          VertexLayoutType::Interleaved);
+     *  glBufferData(GL_ARRAY_BUFFER, meshConsolidator.getNumVertexBytes(),
+     *          meshConsolidator.getVertexDataPtr(), GL_STATIC_DRAW);
+     *
+     *  const VertexAttributeFormat & position = meshConsolidator.getVertexLayout().getPositionFormat();
+     *  glVertexAttribPointer(0, position.numComponents, GL_FLOAT, GL_FALSE,
+     *          position.stride, (const GLvoid *)size_t(position.offset));
+     * \endcode
+     *
+     * With \c VertexLayoutType::Quantized, positions and texture coordinates are
+     * stored relative to the bounds of all consolidated meshes, so a single
+     * \c VertexQuantization from \c getVertexLayout() decodes every batch.  Its
+     * fields feed the PositionOffset, PositionScale, UvCoordOffset and
+     * UvCoordScale uniforms of the *_Quantized.vert shaders in data/shaders.
+     *
+     * With the default \c VertexLayoutType::Separate, the vertex buffer holds
+     * one block per attribute, which the per-attribute accessors point into.
+     *
+     * If any \c Mesh is indexed, all of their indices are consolidated into a
+     * single index buffer, offset to refer to the consolidated vertex data, and
+     * every \c BatchInfo describes a range of that index buffer.  Unindexed meshes
+     * are given sequential indices in that case.
+     *
+     * Meshes can also be streamed in and out of a \c MeshConsolidator whose
+     * layout is fixed up front.  Each \c Mesh's vertices and indices are written
+     * to ranges sub-allocated by a \c RangeAllocator, so adding or removing a
+     * \c Mesh only touches its own ranges, and the buffers grow when full:
+     *
+     * \code{.cpp}
+     *  MeshConsolidator meshConsolidator(VertexLayoutType::Interleaved, MeshIndexing::Indexed);
+     *  const BatchInfo * torus = meshConsolidator.addMesh("torus", torusMesh);
+     *  ...
+     *  meshConsolidator.removeMesh("torus");
+     *  meshConsolidator.compact();
+     * \endcode
+     *
+     * The \c BatchInfo pointers returned by addMesh() stay valid until the
+     * \c Mesh is removed, and are updated in place whenever its ranges move, as
+     * they do in compact(), which packs all meshes together to remove the holes
+     * left by removed ones.  A \c Renderable drawing a batch therefore never
+     * needs to look it up again.  After adding meshes, upload their new ranges,
+     * or the whole buffers if getVertexCapacity() changed or compact() was
+     * called.
+     *
      * @see BatchInfo
      * @see Mesh
      */
@@ -80,39 +145,97 @@ namespace Rigid3D {
     public:
         MeshConsolidator();
 
-        MeshConsolidator(std::initializer_list<std::pair<MeshID, const Mesh *> > list);
+        MeshConsolidator(std::initializer_list<std::pair<MeshID, const Mesh *> > list,
+                VertexLayoutType layoutType = VertexLayoutType::Separate);
+
+        MeshConsolidator(std::initializer_list<std::pair<MeshID, ObjFile> > list,
+                VertexLayoutType layoutType = VertexLayoutType::Separate);
 
-        MeshConsolidator(std::initializer_list<std::pair<MeshID, ObjFile> > list);
+        MeshConsolidator(VertexLayoutType layoutType, MeshIndexing indexing,
+                bool hasNormals = true, bool hasUvCoords = true,
+                const VertexBounds & bounds = VertexBounds());
 
         ~MeshConsolidator();
 
+        const void * getVertexDataPtr() const;
+
+        unsigned long getNumVertexBytes() const;
+
+        const VertexLayout & getVertexLayout() const;
+
         const float * getVertexPositionDataPtr() const;
 
         const float * getVertexNormalDataPtr() const;
 
+        const float * getTextureCoordDataPtr() const;
+
         unsigned long getNumVertexPositionBytes() const;
 
         unsigned long getNumVertexNormalBytes() const;
 
+        unsigned long getNumTextureCoordBytes() const;
+
+        bool isIndexed() const;
+
+        const IndexBuffer & getIndexBuffer() const;
+
         void getBatchInfo(std::unordered_map<const char *, BatchInfo> & batchInfoMap) const;
 
+        const BatchInfo * getBatchInfo(MeshID meshId) const;
+
+        const BatchInfo * addMesh(MeshID meshId, const Mesh & mesh);
+
+        bool removeMesh(MeshID meshId);
+
+        void compact();
+
+        void reserve(size_t numVertices, size_t numIndices);
+
+        size_t getNumVertices() const;
+
+        size_t getVertexCapacity() const;
+
     private:
+        // Where one Mesh's vertices and indices live.
+        struct Batch {
+            BatchInfo batchInfo;
+            uint32 firstVertex;
+            uint32 numVertices;
+            uint32 firstIndex;
+            uint32 numIndices;
+        };
+
         void processMeshes(const std::unordered_map<MeshID, const Mesh *> & meshMap);
 
-        void consolidateMesh(MeshID meshId, const Mesh & mesh);
+        uint32 allocateVertices(uint32 numVertices);
+        uint32 allocateIndices(uint32 numIndices);
+
+        void moveVertices(uint32 firstVertex, uint32 numVertices, uint32 newFirstVertex);
+
+        const float * getSeparateAttributePtr(const VertexAttributeFormat & format) const;
 
-        unsigned long totalPositionBytes;
-        unsigned long totalNormalBytes;
+        VertexLayoutType layoutType;
+        VertexLayout layout;
 
-        std::shared_ptr<float> vertexPositionDataPtr_head;
-        float * vertexPositionDataPtr_tail;
+        // Fixed for the lifetime of the MeshConsolidator.
+        bool indexed;
+        bool hasNormals;
+        bool hasUvCoords;
+        VertexBounds bounds;
 
-        std::shared_ptr<float> normalDataPtr_head;
-        float * normalDataPtr_tail;
+        // Every attribute of every Mesh, arranged by 'layout', whose number of
+        // vertices is the capacity.
+        std::vector<ubyte> vertexData;
+        RangeAllocator vertexAllocator;
+        size_t numConsolidatedVertices;
 
-        std::unordered_map<MeshID, BatchInfo> batchInfoMap;
+        // Nodes of an unordered_map never move, so pointers to each
+        // Batch::batchInfo stay valid until the Mesh is removed.
+        std::unordered_map<MeshID, Batch> batches;
 
-        static const short num_floats_per_vertex = 3;
+        // Empty unless indexed.
+        IndexBuffer indices;
+        RangeAllocator indexAllocator;
     };
 
 } // end namespace GlUtils
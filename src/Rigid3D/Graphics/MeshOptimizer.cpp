@@ -0,0 +1,477 @@
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace Rigid3D {
+
+using std::vector;
+
+const uint32 MeshOptimizer::defaultCacheSize;
+const float MeshOptimizer::defaultOverdrawThreshold = 1.05f;
+
+namespace {
+
+    // Size of the LRU cache modelled by the Forsyth scores.  Scores favour the
+    // most recent vertices, so this works well for smaller FIFO caches too.
+    const uint32 forsythCacheSize = 32;
+
+    const uint32 maxValenceScore = 64;
+
+    //------------------------------------------------------------------------------------
+    // Vertex scores from "Linear-Speed Vertex Cache Optimisation", by cache
+    // position and by number of triangles not yet emitted.
+    struct ForsythScores {
+        float cachePosition[forsythCacheSize];
+        float valence[maxValenceScore];
+
+        ForsythScores() {
+            const float cacheDecayPower = 1.5f;
+            const float lastTriangleScore = 0.75f;
+            const float valenceBoostScale = 2.0f;
+            const float valenceBoostPower = 0.5f;
+
+            for(uint32 i = 0; i < forsythCacheSize; ++i) {
+                if (i < 3) {
+                    // The last triangle's vertices get a fixed score, so that
+                    // its neighbours aren't strongly favoured over other nearby
+                    // triangles.
+                    cachePosition[i] = lastTriangleScore;
+                } else {
+                    const float t = 1.0f - float(i - 3) / float(forsythCacheSize - 3);
+                    cachePosition[i] = std::pow(t, cacheDecayPower);
+                }
+            }
+
+            // Boost vertices with few triangles left, to finish them off rather
+            // than leave lone triangles behind.
+            valence[0] = 0.0f;
+            for(uint32 i = 1; i < maxValenceScore; ++i) {
+                valence[i] = valenceBoostScale * std::pow(float(i), -valenceBoostPower);
+            }
+        }
+
+        float getScore(int32 cachePositionIndex, uint32 numRemaining) const {
+            if (numRemaining == 0) {
+                return -1.0f;
+            }
+            float score = valence[std::min(numRemaining, maxValenceScore - 1)];
+            if (cachePositionIndex >= 0) {
+                score += cachePosition[cachePositionIndex];
+            }
+            return score;
+        }
+    };
+
+    //------------------------------------------------------------------------------------
+    // Post-transform cache holding the last 'cacheSize' vertices missed.
+    class FifoCache {
+    public:
+        FifoCache(uint32 numVertices, uint32 cacheSize)
+            : timestamps(numVertices, 0),
+              time(cacheSize + 1),
+              cacheSize(cacheSize) { }
+
+        // @return true if 'vertex' had to be transformed.
+        bool access(uint32 vertex) {
+            if (time - timestamps[vertex] <= cacheSize) {
+                return false;
+            }
+            timestamps[vertex] = time++;
+            return true;
+        }
+
+        uint32 accessTriangle(const uint32 * triangle) {
+            return uint32(access(triangle[0])) + uint32(access(triangle[1])) +
+                   uint32(access(triangle[2]));
+        }
+
+        void clear() {
+            time += cacheSize + 1;
+        }
+
+    private:
+        vector<uint32> timestamps;
+        uint32 time;
+        uint32 cacheSize;
+    };
+
+    //------------------------------------------------------------------------------------
+    uint32 getVertexCount(const uint32 * indices, size_t numIndices) {
+        uint32 numVertices = 0;
+        for(size_t i = 0; i < numIndices; ++i) {
+            numVertices = std::max(numVertices, indices[i] + 1);
+        }
+        return numVertices;
+    }
+
+    //------------------------------------------------------------------------------------
+    template <class T>
+    void permute(vector<T> & values, const vector<uint32> & newToOld) {
+        if (values.size() != newToOld.size()) {
+            return;
+        }
+        vector<T> permuted(values.size());
+        for(size_t i = 0; i < newToOld.size(); ++i) {
+            permuted[i] = values[newToOld[i]];
+        }
+        values.swap(permuted);
+    }
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Runs every optimization over an indexed mesh: vertex cache and overdraw
+ * ordering within each submesh, so that submesh index ranges still hold the
+ * same triangles, then vertex fetch ordering over the whole mesh.
+ *
+ * @param normals - reordered along with positions if of the same size.
+ * @param uvCoords - reordered along with positions if of the same size.
+ * @param submeshes - ranges of 'indices' to optimize separately.  If empty, all
+ * of 'indices' is one range.
+ * @param overdrawThreshold - see optimizeOverdraw().  Below 1, overdraw is not
+ * optimized.
+ *
+ * @return simulated ACMR of 'indices' before and after optimizing.
+ */
+MeshOptimizationStats MeshOptimizer::optimize(vector<uint32> & indices,
+                                              vector<vec3> & positions,
+                                              vector<vec3> & normals,
+                                              vector<vec2> & uvCoords,
+                                              const vector<Submesh> & submeshes,
+                                              float overdrawThreshold) {
+    const uint32 numVertices = uint32(positions.size());
+
+    MeshOptimizationStats stats;
+    stats.acmrBefore = getAcmr(indices.data(), indices.size(), numVertices);
+
+    vector<std::pair<uint32, uint32> > ranges;
+    for(const Submesh & submesh : submeshes) {
+        ranges.push_back(std::make_pair(submesh.startIndex, submesh.numIndices));
+    }
+    if (ranges.empty()) {
+        ranges.push_back(std::make_pair(0u, uint32(indices.size())));
+    }
+
+    for(const auto & range : ranges) {
+        uint32 * rangeIndices = indices.data() + range.first;
+        optimizeVertexCache(rangeIndices, range.second, numVertices);
+        if (overdrawThreshold >= 1.0f) {
+            optimizeOverdraw(rangeIndices, range.second, positions, overdrawThreshold);
+        }
+    }
+
+    optimizeVertexFetch(indices, positions, normals, uvCoords);
+
+    stats.acmrAfter = getAcmr(indices.data(), indices.size(), numVertices);
+    return stats;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Reorders the triangles of 'indices' to make the most of the post-transform
+ * vertex cache.
+ *
+ * Each vertex is scored by its position in a simulated LRU cache and by how
+ * many of its triangles are left, and the triangle whose vertices score
+ * highest is emitted next.  Only triangles of vertices in the cache are
+ * rescored and considered after each step, keeping the whole pass linear in
+ * the number of triangles.
+ *
+ * @param numVertices - one more than the largest index.
+ */
+void MeshOptimizer::optimizeVertexCache(uint32 * indices, size_t numIndices,
+        uint32 numVertices) {
+    static const ForsythScores scores;
+
+    const size_t numTriangles = numIndices / 3;
+    if (numTriangles < 2) {
+        return;
+    }
+
+    // Triangles of each vertex, with those not yet emitted first.
+    vector<uint32> numRemaining(numVertices, 0);
+    for(size_t i = 0; i < numTriangles * 3; ++i) {
+        ++numRemaining[indices[i]];
+    }
+    vector<uint32> firstTriangle(numVertices + 1, 0);
+    std::partial_sum(numRemaining.begin(), numRemaining.end(), firstTriangle.begin() + 1);
+    vector<uint32> vertexTriangles(numTriangles * 3);
+    {
+        vector<uint32> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+        for(size_t i = 0; i < numTriangles * 3; ++i) {
+            vertexTriangles[fill[indices[i]]++] = uint32(i / 3);
+        }
+    }
+
+    vector<int32> cachePositions(numVertices, -1);
+    vector<float> vertexScores(numVertices);
+    for(uint32 v = 0; v < numVertices; ++v) {
+        vertexScores[v] = scores.getScore(-1, numRemaining[v]);
+    }
+
+    vector<float> triangleScores(numTriangles);
+    uint32 bestTriangle = 0;
+    for(size_t t = 0; t < numTriangles; ++t) {
+        const uint32 * triangle = indices + t * 3;
+        triangleScores[t] = vertexScores[triangle[0]] + vertexScores[triangle[1]] +
+                vertexScores[triangle[2]];
+        if (triangleScores[t] > triangleScores[bestTriangle]) {
+            bestTriangle = uint32(t);
+        }
+    }
+
+    const vector<uint32> input(indices, indices + numTriangles * 3);
+    vector<bool> emitted(numTriangles, false);
+    size_t nextUnemitted = 0;
+
+    // Room for the three vertices of the newest triangle ahead of a full cache.
+    uint32 cache[forsythCacheSize + 3];
+    uint32 newCache[forsythCacheSize + 3];
+    uint32 cacheCount = 0;
+
+    for(size_t numEmitted = 0; numEmitted < numTriangles; ++numEmitted) {
+        if (bestTriangle == uint32(-1)) {
+            // Nothing in the cache has triangles left, so start over elsewhere.
+            while (emitted[nextUnemitted]) {
+                ++nextUnemitted;
+            }
+            bestTriangle = uint32(nextUnemitted);
+        }
+
+        const uint32 * triangle = &input[bestTriangle * 3];
+        std::copy(triangle, triangle + 3, indices + numEmitted * 3);
+        emitted[bestTriangle] = true;
+
+        for(int i = 0; i < 3; ++i) {
+            const uint32 v = triangle[i];
+            uint32 * begin = &vertexTriangles[firstTriangle[v]];
+            uint32 * last = begin + --numRemaining[v];
+            *std::find(begin, last + 1, bestTriangle) = *last;
+            *last = bestTriangle;
+        }
+
+        // Move the triangle's vertices to the front of the cache.
+        uint32 newCacheCount = 0;
+        for(int i = 0; i < 3; ++i) {
+            newCache[newCacheCount++] = triangle[i];
+        }
+        for(uint32 i = 0; i < cacheCount; ++i) {
+            const uint32 v = cache[i];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+                newCache[newCacheCount++] = v;
+            }
+        }
+
+        // Rescore the cache, including vertices just pushed out of it.
+        for(uint32 i = 0; i < newCacheCount; ++i) {
+            const uint32 v = newCache[i];
+            cachePositions[v] = (i < forsythCacheSize) ? int32(i) : -1;
+            vertexScores[v] = scores.getScore(cachePositions[v], numRemaining[v]);
+        }
+
+        bestTriangle = uint32(-1);
+        float bestScore = -1.0f;
+        for(uint32 i = 0; i < newCacheCount; ++i) {
+            const uint32 v = newCache[i];
+            const uint32 * adjacent = &vertexTriangles[firstTriangle[v]];
+            for(uint32 j = 0; j < numRemaining[v]; ++j) {
+                const uint32 t = adjacent[j];
+                const uint32 * other = &input[t * 3];
+                triangleScores[t] = vertexScores[other[0]] + vertexScores[other[1]] +
+                        vertexScores[other[2]];
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCacheCount, forsythCacheSize);
+        std::copy(newCache, newCache + cacheCount, cache);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sorts clusters of triangles so that those facing away from the mesh's centre
+ * are drawn first, which lets early depth testing reject more of the triangles
+ * drawn after them.  Run after optimizeVertexCache().
+ *
+ * Clusters are split where the simulated cache restarts from cold anyway, and
+ * further wherever a cluster's own ACMR, drawn from a cold cache, is within
+ * 'threshold' times that of the order it came from.  Sorting clusters therefore
+ * raises ACMR by roughly 'threshold' at most.
+ *
+ * @param positions - vertex positions indexed by 'indices'.
+ * @param threshold - largest ratio of ACMR after to before, such as 1.05.
+ */
+void MeshOptimizer::optimizeOverdraw(uint32 * indices, size_t numIndices,
+        const vector<vec3> & positions, float threshold, uint32 cacheSize) {
+    const size_t numTriangles = numIndices / 3;
+    if (numTriangles < 2) {
+        return;
+    }
+    const uint32 numVertices = uint32(positions.size());
+
+    // Hard boundaries: triangles whose vertices all miss the cache.
+    vector<size_t> hardBoundaries;
+    {
+        FifoCache cache(numVertices, cacheSize);
+        for(size_t t = 0; t < numTriangles; ++t) {
+            if (cache.accessTriangle(indices + t * 3) == 3) {
+                hardBoundaries.push_back(t);
+            }
+        }
+        hardBoundaries.push_back(numTriangles);
+    }
+
+    // Soft boundaries within each hard cluster.
+    vector<size_t> clusterStarts;
+    {
+        FifoCache cache(numVertices, cacheSize);
+        for(size_t i = 0; i + 1 < hardBoundaries.size(); ++i) {
+            const size_t begin = hardBoundaries[i];
+            const size_t end = hardBoundaries[i + 1];
+
+            cache.clear();
+            uint32 numMisses = 0;
+            for(size_t t = begin; t < end; ++t) {
+                numMisses += cache.accessTriangle(indices + t * 3);
+            }
+            const float maxAcmr = threshold * float(numMisses) / float(end - begin);
+
+            cache.clear();
+            clusterStarts.push_back(begin);
+            numMisses = 0;
+            for(size_t t = begin; t < end; ++t) {
+                numMisses += cache.accessTriangle(indices + t * 3);
+                const size_t clusterSize = t + 1 - clusterStarts.back();
+                if (t + 1 < end && float(numMisses) <= maxAcmr * float(clusterSize)) {
+                    clusterStarts.push_back(t + 1);
+                    cache.clear();
+                    numMisses = 0;
+                }
+            }
+        }
+        clusterStarts.push_back(numTriangles);
+    }
+
+    const size_t numClusters = clusterStarts.size() - 1;
+    if (numClusters < 2) {
+        return;
+    }
+
+    // Area weighted centroid and normal of each cluster.
+    vector<vec3> clusterCentroids(numClusters, vec3(0.0f));
+    vector<vec3> clusterNormals(numClusters, vec3(0.0f));
+    vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for(size_t c = 0; c < numClusters; ++c) {
+        float clusterArea = 0.0f;
+        for(size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t) {
+            const vec3 & p0 = positions[indices[t * 3]];
+            const vec3 & p1 = positions[indices[t * 3 + 1]];
+            const vec3 & p2 = positions[indices[t * 3 + 2]];
+            const vec3 areaNormal = glm::cross(p1 - p0, p2 - p0);
+            const float area = glm::length(areaNormal);
+            clusterCentroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+            clusterNormals[c] += areaNormal;
+            clusterArea += area;
+        }
+        meshCentroid += clusterCentroids[c];
+        meshArea += clusterArea;
+        if (clusterArea > 0.0f) {
+            clusterCentroids[c] *= 1.0f / clusterArea;
+        }
+    }
+    if (meshArea > 0.0f) {
+        meshCentroid *= 1.0f / meshArea;
+    }
+
+    vector<float> sortKeys(numClusters);
+    vector<uint32> order(numClusters);
+    for(size_t c = 0; c < numClusters; ++c) {
+        const float normalLength = glm::length(clusterNormals[c]);
+        sortKeys[c] = (normalLength > 0.0f) ?
+                glm::dot(clusterCentroids[c] - meshCentroid, clusterNormals[c]) / normalLength :
+                0.0f;
+        order[c] = uint32(c);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32 a, uint32 b) {
+        return sortKeys[a] > sortKeys[b];
+    });
+
+    const vector<uint32> input(indices, indices + numTriangles * 3);
+    uint32 * out = indices;
+    for(uint32 c : order) {
+        out = std::copy(&input[clusterStarts[c] * 3], &input[clusterStarts[c + 1] * 3], out);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Renumbers vertices in the order 'indices' first uses them, and reorders
+ * 'positions', 'normals' and 'uvCoords' to match.  Vertices no triangle uses are
+ * kept, after all others.
+ *
+ * @param normals - reordered if of the same size as 'positions'.
+ * @param uvCoords - reordered if of the same size as 'positions'.
+ */
+void MeshOptimizer::optimizeVertexFetch(vector<uint32> & indices,
+                                        vector<vec3> & positions,
+                                        vector<vec3> & normals,
+                                        vector<vec2> & uvCoords) {
+    const uint32 numVertices = uint32(positions.size());
+    const uint32 unassigned = uint32(-1);
+
+    vector<uint32> oldToNew(numVertices, unassigned);
+    vector<uint32> newToOld;
+    newToOld.reserve(numVertices);
+    for(uint32 & index : indices) {
+        if (oldToNew[index] == unassigned) {
+            oldToNew[index] = uint32(newToOld.size());
+            newToOld.push_back(index);
+        }
+        index = oldToNew[index];
+    }
+    for(uint32 v = 0; v < numVertices; ++v) {
+        if (oldToNew[v] == unassigned) {
+            oldToNew[v] = uint32(newToOld.size());
+            newToOld.push_back(v);
+        }
+    }
+
+    permute(positions, newToOld);
+    permute(normals, newToOld);
+    permute(uvCoords, newToOld);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return average number of vertices transformed per triangle, when drawing
+ * 'indices' through a FIFO post-transform cache of 'cacheSize' vertices.
+ *
+ * @param numVertices - one more than the largest index, or zero to find it.
+ */
+float MeshOptimizer::getAcmr(const uint32 * indices, size_t numIndices, uint32 numVertices,
+        uint32 cacheSize) {
+    const size_t numTriangles = numIndices / 3;
+    if (numTriangles == 0) {
+        return 0.0f;
+    }
+    if (numVertices == 0) {
+        numVertices = getVertexCount(indices, numIndices);
+    }
+
+    FifoCache cache(numVertices, cacheSize);
+    size_t numMisses = 0;
+    for(size_t t = 0; t < numTriangles; ++t) {
+        numMisses += cache.accessTriangle(indices + t * 3);
+    }
+    return float(numMisses) / float(numTriangles);
+}
+
+}
@@ -0,0 +1,578 @@
+#include "MeshSimplifier.hpp"
+
+#include <Rigid3D/Graphics/MeshOptimizer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Rigid3D {
+
+using std::vector;
+
+namespace {
+
+    const uint32 noVertex = uint32(-1);
+    const uint32 multipleVertices = uint32(-2);
+
+    // Collapse passes to try before giving up on reaching the target.
+    const int maxPasses = 64;
+
+    // Weight of the planes keeping borders and seams in place, relative to
+    // triangle planes.
+    const double borderWeight = 10.0;
+
+    enum class VertexKind {
+        // Interior vertex with a unique position; may collapse onto any neighbour.
+        Manifold,
+
+        // On an open border; may only collapse along it.
+        Border,
+
+        // One of two vertices sharing a position on an attribute seam; may only
+        // collapse along the seam, together with the vertex on the other side.
+        Seam,
+
+        // Corners, seam and border junctions, and anything else ambiguous.
+        Locked
+    };
+
+    //------------------------------------------------------------------------------------
+    // Sum of squared distances to a set of weighted planes, as the symmetric
+    // matrix of Garland and Heckbert.
+    struct Quadric {
+        double a2, b2, c2, d2;
+        double ab, ac, ad;
+        double bc, bd;
+        double cd;
+        double weight;
+
+        Quadric()
+            : a2(0), b2(0), c2(0), d2(0), ab(0), ac(0), ad(0), bc(0), bd(0), cd(0),
+              weight(0) { }
+
+        // Plane through 'point' with unit 'normal'.
+        void addPlane(const vec3 & normal, const vec3 & point, double planeWeight) {
+            const double a = normal.x;
+            const double b = normal.y;
+            const double c = normal.z;
+            const double d = -(a * point.x + b * point.y + c * point.z);
+            a2 += planeWeight * a * a;
+            b2 += planeWeight * b * b;
+            c2 += planeWeight * c * c;
+            d2 += planeWeight * d * d;
+            ab += planeWeight * a * b;
+            ac += planeWeight * a * c;
+            ad += planeWeight * a * d;
+            bc += planeWeight * b * c;
+            bd += planeWeight * b * d;
+            cd += planeWeight * c * d;
+            weight += planeWeight;
+        }
+
+        void add(const Quadric & other) {
+            a2 += other.a2; b2 += other.b2; c2 += other.c2; d2 += other.d2;
+            ab += other.ab; ac += other.ac; ad += other.ad;
+            bc += other.bc; bd += other.bd;
+            cd += other.cd;
+            weight += other.weight;
+        }
+
+        // @return weighted mean squared distance of 'p' to the planes.
+        double getError(const vec3 & p) const {
+            if (weight <= 0.0) {
+                return 0.0;
+            }
+            const double x = p.x;
+            const double y = p.y;
+            const double z = p.z;
+            const double sum = a2 * x * x + b2 * y * y + c2 * z * z +
+                    2.0 * (ab * x * y + ac * x * z + bc * y * z) +
+                    2.0 * (ad * x + bd * y + cd * z) + d2;
+            return std::max(sum / weight, 0.0);
+        }
+    };
+
+    struct Collapse {
+        uint32 from;
+        uint32 to;
+        double cost;
+    };
+
+    //------------------------------------------------------------------------------------
+    uint64_t getEdgeKey(uint32 a, uint32 b) {
+        return (uint64_t(a) << 32) | b;
+    }
+
+    //------------------------------------------------------------------------------------
+    struct PositionHash {
+        size_t operator () (const vec3 & p) const {
+            uint32 bits[3];
+            std::memcpy(bits, &p, sizeof(bits));
+            return size_t(bits[0] * 73856093u ^ bits[1] * 19349663u ^ bits[2] * 83492791u);
+        }
+    };
+
+    //------------------------------------------------------------------------------------
+    /**
+     * Groups vertices by position.  'positionGroups' maps each vertex to the
+     * first vertex with its position, and 'nextSiblings' links the vertices of
+     * each group in a circular list.
+     */
+    void groupByPosition(const vector<vec3> & positions, vector<uint32> & positionGroups,
+            vector<uint32> & nextSiblings) {
+        const uint32 numVertices = uint32(positions.size());
+        positionGroups.resize(numVertices);
+        nextSiblings.resize(numVertices);
+
+        std::unordered_map<vec3, uint32, PositionHash> firstVertices;
+        firstVertices.reserve(numVertices);
+        for(uint32 v = 0; v < numVertices; ++v) {
+            const uint32 group = firstVertices.insert(std::make_pair(positions[v], v)).first->second;
+            positionGroups[v] = group;
+            if (group == v) {
+                nextSiblings[v] = v;
+            } else {
+                nextSiblings[v] = nextSiblings[group];
+                nextSiblings[group] = v;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    void recordOpenEdge(vector<uint32> & openEdges, uint32 v, uint32 other) {
+        if (openEdges[v] == noVertex) {
+            openEdges[v] = other;
+        } else if (openEdges[v] != other) {
+            openEdges[v] = multipleVertices;
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    bool isSingle(uint32 openEdge) {
+        return openEdge != noVertex && openEdge != multipleVertices;
+    }
+
+    //------------------------------------------------------------------------------------
+    /**
+     * Collapses edges of one range of triangles, in passes of independent
+     * collapses in order of increasing cost, until 'targetNumIndices' is reached
+     * or nothing more can collapse.
+     *
+     * @param lockedGroups - position groups that must not move, such as those
+     * shared with other ranges, or empty for none.
+     *
+     * @return square root of the largest collapse cost.
+     */
+    float simplifyRange(const vector<vec3> & positions,
+                        const vector<uint32> & positionGroups,
+                        const vector<uint32> & nextSiblings,
+                        const vector<bool> & lockedGroups,
+                        const uint32 * indices,
+                        size_t numIndices,
+                        size_t targetNumIndices,
+                        vector<uint32> & result) {
+        result.assign(indices, indices + (numIndices - numIndices % 3));
+        if (result.size() <= targetNumIndices) {
+            return 0.0f;
+        }
+
+        const uint32 numVertices = uint32(positions.size());
+        const size_t targetNumTriangles = targetNumIndices / 3;
+        const vector<uint32> & groups = positionGroups;
+
+        // Indexed by position group.
+        vector<Quadric> quadrics(numVertices);
+        vector<bool> touched(numVertices);
+
+        // Indexed by vertex.
+        vector<uint32> openOut(numVertices);
+        vector<uint32> openIn(numVertices);
+        vector<bool> onBorder(numVertices);
+        vector<bool> onSeam(numVertices);
+        vector<VertexKind> kinds(numVertices);
+        vector<uint32> remap(numVertices);
+        vector<uint32> numVertexTriangles(numVertices);
+        vector<uint32> firstVertexTriangle(numVertices + 1);
+        vector<uint32> vertexTriangles;
+
+        std::unordered_set<uint64_t> halfEdges;
+        std::unordered_set<uint64_t> positionHalfEdges;
+        vector<Collapse> collapses;
+
+        double maxCost = 0.0;
+
+        for(int pass = 0; pass < maxPasses && result.size() > targetNumIndices; ++pass) {
+            const size_t numTriangles = result.size() / 3;
+
+            // Half edges without an opposite are open: in position space they
+            // are borders, and otherwise seams.
+            halfEdges.clear();
+            positionHalfEdges.clear();
+            for(size_t i = 0; i < result.size(); i += 3) {
+                for(int e = 0; e < 3; ++e) {
+                    const uint32 a = result[i + e];
+                    const uint32 b = result[i + (e + 1) % 3];
+                    halfEdges.insert(getEdgeKey(a, b));
+                    positionHalfEdges.insert(getEdgeKey(groups[a], groups[b]));
+                }
+            }
+
+            std::fill(openOut.begin(), openOut.end(), noVertex);
+            std::fill(openIn.begin(), openIn.end(), noVertex);
+            std::fill(onBorder.begin(), onBorder.end(), false);
+            std::fill(onSeam.begin(), onSeam.end(), false);
+            std::fill(numVertexTriangles.begin(), numVertexTriangles.end(), 0);
+            for(size_t i = 0; i < result.size(); i += 3) {
+                const vec3 & p0 = positions[result[i]];
+                const vec3 areaNormal = glm::cross(positions[result[i + 1]] - p0,
+                        positions[result[i + 2]] - p0);
+                const float doubleArea = glm::length(areaNormal);
+
+                for(int e = 0; e < 3; ++e) {
+                    const uint32 a = result[i + e];
+                    const uint32 b = result[i + (e + 1) % 3];
+                    ++numVertexTriangles[a];
+
+                    if (halfEdges.count(getEdgeKey(b, a)) != 0) {
+                        continue;
+                    }
+                    recordOpenEdge(openOut, a, b);
+                    recordOpenEdge(openIn, b, a);
+                    const bool isBorder =
+                            positionHalfEdges.count(getEdgeKey(groups[b], groups[a])) == 0;
+                    if (isBorder) {
+                        onBorder[a] = onBorder[b] = true;
+                    } else {
+                        onSeam[a] = onSeam[b] = true;
+                    }
+
+                    // Planes through open edges, perpendicular to their triangle,
+                    // keep borders and seams from drifting.
+                    if (pass == 0 && doubleArea > 0.0f) {
+                        const vec3 edge = positions[b] - positions[a];
+                        const vec3 edgeNormal = glm::cross(edge, areaNormal / doubleArea);
+                        const float edgeLength = glm::length(edge);
+                        if (edgeLength > 0.0f) {
+                            const double planeWeight = borderWeight * edgeLength * edgeLength;
+                            quadrics[groups[a]].addPlane(edgeNormal / edgeLength, positions[a],
+                                    planeWeight);
+                            quadrics[groups[b]].addPlane(edgeNormal / edgeLength, positions[b],
+                                    planeWeight);
+                        }
+                    }
+                }
+
+                if (pass == 0 && doubleArea > 0.0f) {
+                    for(int c = 0; c < 3; ++c) {
+                        quadrics[groups[result[i + c]]].addPlane(areaNormal / doubleArea,
+                                p0, 0.5 * doubleArea);
+                    }
+                }
+            }
+
+            // Triangles around each vertex.
+            firstVertexTriangle[0] = 0;
+            for(uint32 v = 0; v < numVertices; ++v) {
+                firstVertexTriangle[v + 1] = firstVertexTriangle[v] + numVertexTriangles[v];
+            }
+            vertexTriangles.resize(result.size());
+            {
+                vector<uint32> fill(firstVertexTriangle.begin(), firstVertexTriangle.end() - 1);
+                for(size_t i = 0; i < result.size(); ++i) {
+                    vertexTriangles[fill[result[i]]++] = uint32(i / 3);
+                }
+            }
+
+            for(uint32 v = 0; v < numVertices; ++v) {
+                const uint32 sibling = nextSiblings[v];
+                kinds[v] = VertexKind::Locked;
+                if (numVertexTriangles[v] == 0 ||
+                    (!lockedGroups.empty() && lockedGroups[groups[v]])) {
+                    continue;
+                }
+                if (sibling == v) {
+                    if (openOut[v] == noVertex && openIn[v] == noVertex) {
+                        kinds[v] = VertexKind::Manifold;
+                    } else if (isSingle(openOut[v]) && isSingle(openIn[v]) && !onSeam[v]) {
+                        kinds[v] = VertexKind::Border;
+                    }
+                } else if (nextSiblings[sibling] == v) {
+                    if (isSingle(openOut[v]) && isSingle(openIn[v]) && !onBorder[v] &&
+                        isSingle(openOut[sibling]) && isSingle(openIn[sibling]) &&
+                        !onBorder[sibling]) {
+                        kinds[v] = VertexKind::Seam;
+                    }
+                }
+            }
+
+            auto canCollapse = [&](uint32 from, uint32 to) {
+                switch (kinds[from]) {
+                    case VertexKind::Manifold:
+                        return true;
+                    case VertexKind::Border:
+                        return to == openOut[from] || to == openIn[from];
+                    case VertexKind::Seam: {
+                        if ((to != openOut[from] && to != openIn[from]) ||
+                            kinds[to] != VertexKind::Seam) {
+                            return false;
+                        }
+                        const uint32 fromSibling = nextSiblings[from];
+                        const uint32 toSibling = nextSiblings[to];
+                        return openOut[fromSibling] == toSibling ||
+                               openIn[fromSibling] == toSibling;
+                    }
+                    case VertexKind::Locked:
+                        return false;
+                }
+                return false;
+            };
+
+            collapses.clear();
+            for(size_t i = 0; i < result.size(); i += 3) {
+                for(int e = 0; e < 3; ++e) {
+                    const uint32 a = result[i + e];
+                    const uint32 b = result[i + (e + 1) % 3];
+
+                    // Consider each edge once, from whichever side sees it first.
+                    if (a > b && halfEdges.count(getEdgeKey(b, a)) != 0) {
+                        continue;
+                    }
+
+                    Collapse collapse;
+                    collapse.cost = -1.0;
+                    if (canCollapse(a, b)) {
+                        collapse.from = a;
+                        collapse.to = b;
+                        collapse.cost = quadrics[groups[a]].getError(positions[b]);
+                    }
+                    if (canCollapse(b, a)) {
+                        const double cost = quadrics[groups[b]].getError(positions[a]);
+                        if (collapse.cost < 0.0 || cost < collapse.cost) {
+                            collapse.from = b;
+                            collapse.to = a;
+                            collapse.cost = cost;
+                        }
+                    }
+                    if (collapse.cost >= 0.0) {
+                        collapses.push_back(collapse);
+                    }
+                }
+            }
+            std::sort(collapses.begin(), collapses.end(),
+                    [](const Collapse & x, const Collapse & y) { return x.cost < y.cost; });
+
+            // Moving 'from' onto 'to' must not turn any remaining triangle over,
+            // or flatten it into a line.
+            auto hasFlips = [&](uint32 from, uint32 to) {
+                for(uint32 j = firstVertexTriangle[from]; j < firstVertexTriangle[from + 1]; ++j) {
+                    const uint32 * triangle = &result[vertexTriangles[j] * 3];
+                    const int corner = (triangle[0] == from) ? 0 : (triangle[1] == from) ? 1 : 2;
+                    const uint32 b = triangle[(corner + 1) % 3];
+                    const uint32 c = triangle[(corner + 2) % 3];
+                    if (groups[b] == groups[to] || groups[c] == groups[to]) {
+                        continue;
+                    }
+                    const vec3 before = glm::cross(positions[b] - positions[from],
+                            positions[c] - positions[from]);
+                    const vec3 after = glm::cross(positions[b] - positions[to],
+                            positions[c] - positions[to]);
+                    if (glm::dot(before, after) <= 0.0f) {
+                        return true;
+                    }
+                }
+                return false;
+            };
+
+            auto touchTriangles = [&](uint32 v) {
+                for(uint32 j = firstVertexTriangle[v]; j < firstVertexTriangle[v + 1]; ++j) {
+                    const uint32 * triangle = &result[vertexTriangles[j] * 3];
+                    for(int c = 0; c < 3; ++c) {
+                        touched[groups[triangle[c]]] = true;
+                    }
+                }
+            };
+
+            for(uint32 v = 0; v < numVertices; ++v) {
+                remap[v] = v;
+            }
+            std::fill(touched.begin(), touched.end(), false);
+
+            size_t numRemaining = numTriangles;
+            size_t numCollapsed = 0;
+            for(const Collapse & collapse : collapses) {
+                if (numRemaining <= targetNumTriangles) {
+                    break;
+                }
+                const uint32 from = collapse.from;
+                const uint32 to = collapse.to;
+                if (touched[groups[from]] || touched[groups[to]]) {
+                    continue;
+                }
+
+                const bool isSeam = (kinds[from] == VertexKind::Seam);
+                if (hasFlips(from, to) ||
+                    (isSeam && hasFlips(nextSiblings[from], nextSiblings[to]))) {
+                    continue;
+                }
+
+                remap[from] = to;
+                if (isSeam) {
+                    remap[nextSiblings[from]] = nextSiblings[to];
+                }
+                quadrics[groups[to]].add(quadrics[groups[from]]);
+
+                // Flips were only checked against the current positions, so no
+                // other corner of the triangles that moved may move this pass.
+                touchTriangles(from);
+                if (isSeam) {
+                    touchTriangles(nextSiblings[from]);
+                }
+                touched[groups[to]] = true;
+
+                maxCost = std::max(maxCost, collapse.cost);
+                numRemaining -= (kinds[from] == VertexKind::Border) ? 1 : 2;
+                ++numCollapsed;
+            }
+            if (numCollapsed == 0) {
+                break;
+            }
+
+            // Drop triangles that collapsed to a line or point.
+            size_t numKept = 0;
+            for(size_t i = 0; i < result.size(); i += 3) {
+                const uint32 a = remap[result[i]];
+                const uint32 b = remap[result[i + 1]];
+                const uint32 c = remap[result[i + 2]];
+                if (groups[a] != groups[b] && groups[b] != groups[c] && groups[c] != groups[a]) {
+                    result[numKept++] = a;
+                    result[numKept++] = b;
+                    result[numKept++] = c;
+                }
+            }
+            result.resize(numKept);
+        }
+
+        return float(std::sqrt(maxCost));
+    }
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Simplifies the triangles given by 'indices' to at most 'targetNumIndices'
+ * indices, where the mesh's borders, seams and shape allow it.
+ *
+ * @param positions - vertex positions referred to by 'indices'.
+ * @param result - receives the simplified triangles, indexing 'positions'.
+ *
+ * @return an estimate of how far, in mesh units, the surface moved.
+ */
+float MeshSimplifier::simplify(const vector<vec3> & positions,
+                               const uint32 * indices,
+                               size_t numIndices,
+                               size_t targetNumIndices,
+                               vector<uint32> & result) {
+    vector<uint32> positionGroups;
+    vector<uint32> nextSiblings;
+    groupByPosition(positions, positionGroups, nextSiblings);
+
+    return simplifyRange(positions, positionGroups, nextSiblings, vector<bool>(), indices,
+            numIndices, targetNumIndices, result);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Generates a chain of levels of detail, one per entry of 'ratios', each
+ * simplified from the full mesh to that fraction of its triangles and ordered
+ * for the vertex cache.  The chain ends early once a level can't be made
+ * smaller than the one before it.
+ *
+ * Each submesh is simplified on its own, keeping vertices shared with other
+ * submeshes in place, so submeshes stay separately drawable without cracks
+ * between them.
+ *
+ * @param submeshes - ranges of 'indices' to simplify separately.  If empty, all
+ * of 'indices' is one range.
+ * @param ratios - decreasing fractions of the full triangle count, such as 0.5.
+ * @param lodIndices - receives the triangles of every level.
+ * @param lods - receives the levels, as ranges of 'lodIndices'.
+ */
+void MeshSimplifier::generateLods(const vector<vec3> & positions,
+                                  const vector<uint32> & indices,
+                                  const vector<Submesh> & submeshes,
+                                  const vector<float> & ratios,
+                                  vector<uint32> & lodIndices,
+                                  vector<MeshLod> & lods) {
+    lodIndices.clear();
+    lods.clear();
+
+    const uint32 numVertices = uint32(positions.size());
+    vector<uint32> positionGroups;
+    vector<uint32> nextSiblings;
+    groupByPosition(positions, positionGroups, nextSiblings);
+
+    vector<std::pair<uint32, uint32> > ranges;
+    for(const Submesh & submesh : submeshes) {
+        ranges.push_back(std::make_pair(submesh.startIndex, submesh.numIndices));
+    }
+    if (ranges.empty()) {
+        ranges.push_back(std::make_pair(0u, uint32(indices.size())));
+    }
+
+    // Lock positions used by more than one range.
+    vector<bool> lockedGroups;
+    if (ranges.size() > 1) {
+        lockedGroups.assign(numVertices, false);
+        vector<uint32> owners(numVertices, noVertex);
+        for(size_t r = 0; r < ranges.size(); ++r) {
+            for(uint32 i = 0; i < ranges[r].second; ++i) {
+                const uint32 group = positionGroups[indices[ranges[r].first + i]];
+                if (owners[group] == noVertex) {
+                    owners[group] = uint32(r);
+                } else if (owners[group] != r) {
+                    lockedGroups[group] = true;
+                }
+            }
+        }
+    }
+
+    size_t previousNumIndices = indices.size();
+    vector<uint32> simplified;
+    for(float ratio : ratios) {
+        MeshLod lod;
+        lod.error = 0.0f;
+        lod.startIndex = uint32(lodIndices.size());
+
+        for(size_t r = 0; r < ranges.size(); ++r) {
+            const uint32 numRangeIndices = ranges[r].second;
+            const size_t targetNumIndices = size_t(numRangeIndices / 3 * ratio) * 3;
+            const float error = simplifyRange(positions, positionGroups, nextSiblings,
+                    lockedGroups, indices.data() + ranges[r].first, numRangeIndices,
+                    targetNumIndices, simplified);
+            MeshOptimizer::optimizeVertexCache(simplified.data(), simplified.size(),
+                    numVertices);
+
+            if (!submeshes.empty()) {
+                Submesh submesh = submeshes[r];
+                submesh.startIndex = uint32(lodIndices.size());
+                submesh.numIndices = uint32(simplified.size());
+                lod.submeshes.push_back(submesh);
+            }
+            lodIndices.insert(lodIndices.end(), simplified.begin(), simplified.end());
+            lod.error = std::max(lod.error, error);
+        }
+
+        lod.numIndices = uint32(lodIndices.size()) - lod.startIndex;
+        if (lod.numIndices >= previousNumIndices) {
+            lodIndices.resize(lod.startIndex);
+            break;
+        }
+        previousNumIndices = lod.numIndices;
+        lods.push_back(std::move(lod));
+    }
+}
+
+}
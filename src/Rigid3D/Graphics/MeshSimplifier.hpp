@@ -0,0 +1,65 @@
+/**
+ * @brief MeshSimplifier
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_MESH_SIMPLIFIER_HPP_
+#define RIGID3D_MESH_SIMPLIFIER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Graphics/Submesh.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * One simplified level of detail of an indexed mesh, drawn with the mesh's
+     * own vertices and a range of its LOD index buffer.
+     */
+    struct MeshLod {
+        // Largest distance, in mesh units, that the surface moved by simplifying.
+        float error;
+
+        // Range of the LOD index buffer holding every triangle of this level.
+        uint32 startIndex;
+        uint32 numIndices;
+
+        // The mesh's submeshes, with ranges of the LOD index buffer, or empty if
+        // the mesh has none.
+        std::vector<Submesh> submeshes;
+    };
+
+    /**
+     * @brief Reduces the triangle count of indexed meshes by collapsing edges in
+     * order of quadric error, after Garland and Heckbert's "Surface
+     * Simplification Using Quadric Error Metrics".
+     *
+     * Vertices are only ever collapsed onto other existing vertices, so
+     * simplified triangles index the original vertex data.  Vertices sharing a
+     * position, which mark seams in texture coordinates or normals, may only
+     * collapse along their seam, both sides at once, and vertices on open
+     * borders only along their border.  Seams and borders therefore keep their
+     * attributes intact.
+     */
+    class MeshSimplifier {
+    public:
+        static float simplify(const std::vector<vec3> & positions,
+                              const uint32 * indices,
+                              size_t numIndices,
+                              size_t targetNumIndices,
+                              std::vector<uint32> & result);
+
+        static void generateLods(const std::vector<vec3> & positions,
+                                 const std::vector<uint32> & indices,
+                                 const std::vector<Submesh> & submeshes,
+                                 const std::vector<float> & ratios,
+                                 std::vector<uint32> & lodIndices,
+                                 std::vector<MeshLod> & lods);
+    };
+
+}
+
+#endif /* RIGID3D_MESH_SIMPLIFIER_HPP_ */
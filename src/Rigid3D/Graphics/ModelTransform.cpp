@@ -1,6 +1,6 @@
 #include "ModelTransform.hpp"
 
-#include <glm/gtx/quaternion.hpp>
+#include <Rigid3D/Math/Transform.hpp>
 
 namespace Rigid3D {
 
@@ -70,23 +70,8 @@ mat4 ModelTransform::getModelMatrix() {
         return modelMatrix;
     }
 
-    // 1. Scale
-    // 2. Rotate
-    // 3. Translate
-
-    // Scale
-    modelMatrix = mat4();
-    modelMatrix[0][0] *= scaleFactor[0];
-    modelMatrix[1][1] *= scaleFactor[1];
-    modelMatrix[2][2] *= scaleFactor[2];
-
-    // Rotate
-    modelMatrix = glm::toMat4(pose) * modelMatrix;
-
-    // Translate
-    modelMatrix[3][0] = position.x;
-    modelMatrix[3][1] = position.y;
-    modelMatrix[3][2] = position.z;
+    // Scale, then rotate, then translate.
+    modelMatrix = Transform(position, pose).getMatrix(scaleFactor);
 
     recalcModelMatrix = false;
     return modelMatrix;
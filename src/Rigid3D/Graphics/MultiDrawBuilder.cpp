@@ -0,0 +1,129 @@
+#include "MultiDrawBuilder.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlCapabilities.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/MeshConsolidator.hpp>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+MultiDrawBuilder::MultiDrawBuilder()
+    : indirectBuffer(0)
+{
+
+}
+
+//----------------------------------------------------------------------------------------
+MultiDrawBuilder::~MultiDrawBuilder() {
+    if (indirectBuffer != 0) {
+        glDeleteBuffers(1, &indirectBuffer);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if the current context can draw() commands, base instances
+ * included.
+ */
+bool MultiDrawBuilder::isSupported() {
+#ifdef GL_VERSION_4_3
+    return isGlVersionAtLeast(4, 3) ||
+            (isGlExtensionSupported("GL_ARB_multi_draw_indirect") &&
+             isGlExtensionSupported("GL_ARB_base_instance"));
+#else
+    return false;
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Removes all commands, ready for the next frame.
+ */
+void MultiDrawBuilder::clear() {
+    commands.clear();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Appends a command drawing 'numInstances' instances of 'batch', with instanced
+ * attributes read from 'baseInstance' onwards.  Indexed batches are expected to
+ * index consolidated vertex data directly, so their base vertex is zero.
+ *
+ * @return index of the command, for passing to draw().
+ */
+uint32 MultiDrawBuilder::addCommand(const BatchInfo & batch, uint32 numInstances,
+        uint32 baseInstance) {
+    DrawCommand command;
+    command.count = batch.numIndices;
+    command.instanceCount = numInstances;
+    command.first = batch.startIndex;
+    if (batch.isIndexed()) {
+        command.params[0] = 0;
+        command.params[1] = baseInstance;
+    } else {
+        command.params[0] = baseInstance;
+        command.params[1] = 0;
+    }
+
+    commands.push_back(command);
+    return uint32(commands.size() - 1);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Streams all commands into the indirect buffer, orphaning the previous
+ * upload's storage, and leaves the buffer bound to GL_DRAW_INDIRECT_BUFFER.
+ */
+void MultiDrawBuilder::upload() {
+    if (indirectBuffer == 0) {
+        glGenBuffers(1, &indirectBuffer);
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawCommand),
+            commands.data(), GL_STREAM_DRAW);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Issues commands [firstCommand, firstCommand + numCommands) with one multi-draw
+ * call, using whichever VAO and ShaderProgram are bound.  The commands must all
+ * be indexed with 'indexSize' byte indices, or all unindexed if 'indexSize' is
+ * zero.  Only call when isSupported().
+ *
+ * @throws Rigid3DException if the range is past the last uploaded command, or
+ * if built without OpenGL 4.3 headers.
+ */
+void MultiDrawBuilder::draw(uint32 firstCommand, uint32 numCommands, uint32 indexSize) const {
+    if (size_t(firstCommand) + numCommands > commands.size()) {
+        throw Rigid3DException("Command range out of bounds within method "
+                "MultiDrawBuilder::draw");
+    }
+
+#ifdef GL_VERSION_4_3
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    const GLvoid * offset = reinterpret_cast<const GLvoid *>(
+            size_t(firstCommand) * sizeof(DrawCommand));
+    if (indexSize != 0) {
+        GLenum indexType = (indexSize == 2) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        glMultiDrawElementsIndirect(GL_TRIANGLES, indexType, offset, numCommands,
+                sizeof(DrawCommand));
+    } else {
+        glMultiDrawArraysIndirect(GL_TRIANGLES, offset, numCommands, sizeof(DrawCommand));
+    }
+
+    CHECK_GL_ERRORS;
+#else
+    throw Rigid3DException("Multi-draws need OpenGL 4.3 headers within method "
+            "MultiDrawBuilder::draw");
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+const std::vector<DrawCommand> & MultiDrawBuilder::getCommands() const {
+    return commands;
+}
+
+}
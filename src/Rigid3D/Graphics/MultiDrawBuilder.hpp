@@ -0,0 +1,89 @@
+/**
+ * @brief MultiDrawBuilder
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_MULTI_DRAW_BUILDER_HPP_
+#define RIGID3D_MULTI_DRAW_BUILDER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    struct BatchInfo;
+}
+
+namespace Rigid3D {
+
+    /**
+     * One record of the indirect buffer, laid out as the
+     * DrawElementsIndirectCommand of OpenGL for indexed draws, and as
+     * DrawArraysIndirectCommand followed by an unused word otherwise.
+     */
+    struct DrawCommand {
+        uint32 count;
+        uint32 instanceCount;
+        uint32 first;
+
+        // For indexed draws, baseVertex then baseInstance.  For unindexed
+        // draws, baseInstance then unused.
+        uint32 params[2];
+    };
+
+    /**
+     * @brief Builds an indirect buffer of draw commands from \c BatchInfo
+     * ranges, so that many meshes sharing a \c MeshConsolidator's buffers are
+     * drawn with one glMultiDraw*Indirect call.
+     *
+     * Commands are added for a frame, uploaded together, and then drawn in
+     * contiguous ranges, typically one range per shader and state bucket:
+     * \code{.cpp}
+     *  builder.clear();
+     *  uint32 first = builder.addCommand(*cube, 1, 0);
+     *  builder.addCommand(*torus, 1, 1);
+     *  builder.upload();
+     *  builder.draw(first, 2, cube->indexSize);
+     * \endcode
+     *
+     * Each command's base instance offsets instanced vertex attributes, which
+     * is how a draw within a multi-draw finds its own per-object data.
+     *
+     * @note Drawing requires OpenGL 4.3, or ARB_multi_draw_indirect with
+     * ARB_base_instance, which isSupported() checks for.  Against headers
+     * older than 4.3, such as <OpenGL/gl3.h>, draw() is not compiled in and
+     * isSupported() is always false.
+     */
+    class MultiDrawBuilder {
+    public:
+        MultiDrawBuilder();
+
+        ~MultiDrawBuilder();
+
+        static bool isSupported();
+
+        void clear();
+
+        uint32 addCommand(const BatchInfo & batch, uint32 numInstances, uint32 baseInstance);
+
+        void upload();
+
+        void draw(uint32 firstCommand, uint32 numCommands, uint32 indexSize) const;
+
+        const std::vector<DrawCommand> & getCommands() const;
+
+    private:
+        MultiDrawBuilder(const MultiDrawBuilder &);
+        MultiDrawBuilder & operator = (const MultiDrawBuilder &);
+
+        std::vector<DrawCommand> commands;
+        GLuint indirectBuffer;
+    };
+
+}
+
+#endif /* RIGID3D_MULTI_DRAW_BUILDER_HPP_ */
@@ -1,17 +1,932 @@
 #include "Rigid3D/Graphics/ObjFileLoader.hpp"
 
+#include <Rigid3D/Common/MappedFile.hpp>
+#include <Rigid3D/Common/ParallelFor.hpp>
 #include <Rigid3D/Common/Rigid3DException.hpp>
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <map>
+#include <unordered_map>
+#include <utility>
 
 namespace Rigid3D {
 
 using namespace std;
 
+namespace {
+
+    // Powers of ten exactly representable as float and double respectively.
+    const float floatPowersOfTen[] = {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+
+    const double doublePowersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    inline bool isDigit(char c) {
+        return (c >= '0') && (c <= '9');
+    }
+
+    inline bool isBlank(char c) {
+        return (c == ' ') || (c == '\t') || (c == '\r');
+    }
+
+    inline const char * skipBlanks(const char * p, const char * end) {
+        while (p < end && isBlank(*p)) {
+            ++p;
+        }
+        return p;
+    }
+
+    //------------------------------------------------------------------------------------
+    // True if 'd' lies exactly halfway between two adjacent floats, in which case
+    // rounding 'd' to float may differ from rounding the decimal value it came from.
+    bool isFloatMidpoint(double d) {
+        float f = static_cast<float>(d);
+        if (static_cast<double>(f) == d) {
+            return false;
+        }
+        float neighbor = std::nextafter(f, (d > f) ? HUGE_VALF : -HUGE_VALF);
+        return (static_cast<double>(f) + static_cast<double>(neighbor)) * 0.5 == d;
+    }
+
+    //------------------------------------------------------------------------------------
+    /**
+     * Parses a decimal floating point number at 'p', advancing 'p' past it.
+     *
+     * Produces the correctly rounded float, the same as operator>> of a stream in
+     * the classic locale.  Most values take an exact fast path; the rest are handed
+     * to strtof.
+     *
+     * @return false, leaving 'p' unchanged, if no number starts at 'p'.
+     */
+    bool parseFloat(const char * & p, const char * end, float & value) {
+        const char * start = p;
+        const char * c = p;
+
+        bool negative = false;
+        if (c < end && (*c == '-' || *c == '+')) {
+            negative = (*c == '-');
+            ++c;
+        }
+
+        uint64_t mantissa = 0;
+        int numSignificantDigits = 0;
+        int exponent = 0;
+        bool anyDigits = false;
+        bool truncated = false;
+
+        for(; c < end && isDigit(*c); ++c) {
+            anyDigits = true;
+            if (numSignificantDigits < 19) {
+                mantissa = mantissa * 10 + uint64_t(*c - '0');
+                if (mantissa != 0) { ++numSignificantDigits; }
+            } else {
+                ++exponent;
+                truncated |= (*c != '0');
+            }
+        }
+
+        if (c < end && *c == '.') {
+            ++c;
+            for(; c < end && isDigit(*c); ++c) {
+                anyDigits = true;
+                if (numSignificantDigits < 19) {
+                    mantissa = mantissa * 10 + uint64_t(*c - '0');
+                    if (mantissa != 0) { ++numSignificantDigits; }
+                    --exponent;
+                } else {
+                    truncated |= (*c != '0');
+                }
+            }
+        }
+
+        if (!anyDigits) {
+            return false;
+        }
+
+        if (c < end && (*c == 'e' || *c == 'E')) {
+            const char * e = c + 1;
+            bool negativeExponent = false;
+            if (e < end && (*e == '-' || *e == '+')) {
+                negativeExponent = (*e == '-');
+                ++e;
+            }
+            if (e < end && isDigit(*e)) {
+                int explicitExponent = 0;
+                for(; e < end && isDigit(*e); ++e) {
+                    if (explicitExponent < 100000) {
+                        explicitExponent = explicitExponent * 10 + (*e - '0');
+                    }
+                }
+                exponent += negativeExponent ? -explicitExponent : explicitExponent;
+                c = e;
+            }
+        }
+
+        p = c;
+
+        if (!truncated) {
+            // One correctly rounded float operation on exact operands.
+            if (mantissa <= (uint64_t(1) << 24) && exponent >= -10 && exponent <= 10) {
+                float f = static_cast<float>(mantissa);
+                f = (exponent < 0) ? f / floatPowersOfTen[-exponent] :
+                                     f * floatPowersOfTen[exponent];
+                value = negative ? -f : f;
+                return true;
+            }
+
+            // One correctly rounded double operation, then rounding to float,
+            // which is exact unless the double landed on a float midpoint.
+            if (mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+                double d = static_cast<double>(mantissa);
+                d = (exponent < 0) ? d / doublePowersOfTen[-exponent] :
+                                     d * doublePowersOfTen[exponent];
+                if (!isFloatMidpoint(d)) {
+                    float f = static_cast<float>(d);
+                    value = negative ? -f : f;
+                    return true;
+                }
+            }
+        }
+
+        // Slow path for long or extreme values.
+        char buffer[64];
+        size_t length = static_cast<size_t>(p - start);
+        if (length < sizeof(buffer)) {
+            std::memcpy(buffer, start, length);
+            buffer[length] = '\0';
+            value = std::strtof(buffer, nullptr);
+        } else {
+            value = std::strtof(string(start, length).c_str(), nullptr);
+        }
+        return true;
+    }
+
+    //------------------------------------------------------------------------------------
+    /**
+     * Parses a decimal integer at 'p', advancing 'p' past it.  Magnitudes past
+     * INT_MAX saturate, so that huge indices are rejected as out of range rather
+     * than overflowing into valid ones.
+     *
+     * @return false, leaving 'p' unchanged, if no integer starts at 'p'.
+     */
+    bool parseInt(const char * & p, const char * end, int & value) {
+        const char * c = p;
+
+        bool negative = false;
+        if (c < end && (*c == '-' || *c == '+')) {
+            negative = (*c == '-');
+            ++c;
+        }
+
+        if (c == end || !isDigit(*c)) {
+            return false;
+        }
+
+        int result = 0;
+        for(; c < end && isDigit(*c); ++c) {
+            const int digit = *c - '0';
+            result = (result > (INT_MAX - digit) / 10) ? INT_MAX : result * 10 + digit;
+        }
+
+        value = negative ? -result : result;
+        p = c;
+        return true;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Parses up to 'count' blank separated floats.  Components that are missing
+    // are left unchanged, matching the stream based decoder.
+    void parseFloats(const char * p, const char * end, float * values, int count) {
+        for(int i = 0; i < count; ++i) {
+            p = skipBlanks(p, end);
+            if (!parseFloat(p, end, values[i])) {
+                return;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Bits of FaceCorner::relative, marking indices that were negative in the file,
+    // and so are counted from the vertex data parsed so far.
+    const uint32 relativePosition = 1u << 0;
+    const uint32 relativeUvCoord = 1u << 1;
+    const uint32 relativeNormal = 1u << 2;
+
+    struct FaceCorner {
+        int position;
+        int uvCoord;
+        int normal;
+        uint32 relative;
+    };
+
+    //------------------------------------------------------------------------------------
+    template <class T>
+    const T & lookup(const vector<T> & elements, int objIndex, const char * elementName) {
+        // .obj file uses indices that start at 1.
+        if (objIndex < 1 || size_t(objIndex) > elements.size()) {
+            stringstream errorMessage;
+            errorMessage << "Face references " << elementName << " index " << objIndex
+                         << ", but only " << elements.size() << " are defined, within "
+                         << "method ObjFileLoader::decodeBuffer";
+            throw Rigid3DException(errorMessage.str());
+        }
+        return elements[objIndex - 1];
+    }
+
+    //------------------------------------------------------------------------------------
+    // Files smaller than this per hardware thread are parsed on fewer threads.
+    const size_t minBytesPerChunk = size_t(1) << 20;
+
+    // One triangle of a face, fan triangulated if the face has more corners.
+    struct ObjFace {
+        FaceCorner corners[3];
+        uint32 state;
+    };
+
+    //------------------------------------------------------------------------------------
+    /**
+     * Group and material that a run of faces was parsed under.
+     *
+     * A chunk starts out in whatever state the previous chunk ended in, which is
+     * not known until all chunks are parsed, so names only count once set.
+     */
+    struct ObjState {
+        string group;
+        string material;
+        bool groupSet;
+        bool materialSet;
+        uint32 numTriangles;
+
+        // Assigned once all chunks are parsed.
+        uint32 submesh;
+        size_t firstTriangle;
+
+        ObjState()
+            : groupSet(false), materialSet(false), numTriangles(0),
+              submesh(0), firstTriangle(0) { }
+    };
+
+    //------------------------------------------------------------------------------------
+    /**
+     * A range of whole lines within an .obj file, along with the vertex data and
+     * faces parsed from them.  Face indices are left unresolved, since they may
+     * refer to vertices defined in earlier chunks.
+     */
+    struct ObjChunk {
+        const char * begin;
+        const char * end;
+
+        vector<vec3> positions;
+        vector<vec3> normals;
+        vector<vec2> uvCoords;
+        vector<ObjFace> faces;
+        vector<ObjState> states;
+        vector<string> materialLibraries;
+
+        // Whether any face has normals or texture coordinates.
+        bool hasNormals;
+        bool hasUvCoords;
+
+        bool hasRelativeIndices;
+
+        // Offsets of this chunk's vertex data within the global vertex arrays.
+        size_t positionBase;
+        size_t normalBase;
+        size_t uvCoordBase;
+
+        std::exception_ptr error;
+
+        ObjChunk()
+            : begin(nullptr), end(nullptr),
+              states(1),
+              hasNormals(false), hasUvCoords(false), hasRelativeIndices(false),
+              positionBase(0), normalBase(0), uvCoordBase(0) { }
+    };
+
+    struct ObjVertexData {
+        vector<vec3> positions;
+        vector<vec3> normals;
+        vector<vec2> uvCoords;
+    };
+
+    //------------------------------------------------------------------------------------
+    // Splits [data, data + numBytes) into one chunk per element of 'chunks', of
+    // roughly equal size, with every boundary falling just after a newline.
+    void splitAtLines(const char * data, size_t numBytes, vector<ObjChunk> & chunks) {
+        const char * const fileEnd = data + numBytes;
+        const uint32 numChunks = uint32(chunks.size());
+
+        const char * begin = data;
+        for(uint32 i = 0; i < numChunks; ++i) {
+            const char * end = fileEnd;
+            if (i + 1 < numChunks) {
+                end = std::max(begin, data + chunkBegin(numBytes, numChunks, i + 1));
+                if (end > data && end < fileEnd && end[-1] != '\n') {
+                    const char * newline = static_cast<const char *>(
+                            std::memchr(end, '\n', size_t(fileEnd - end)));
+                    end = (newline == nullptr) ? fileEnd : newline + 1;
+                }
+            }
+            chunks[i].begin = begin;
+            chunks[i].end = end;
+            begin = end;
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Runs 'function' on every chunk, one parallelFor() chunk each, rethrowing the
+    // first chunk's exception, in chunk order, once all chunks are done.
+    template <class Function>
+    void forEachChunk(vector<ObjChunk> & chunks, const Function & function) {
+        parallelFor(chunks.size(), uint32(chunks.size()),
+            [&](size_t begin, size_t end, uint32) {
+                for(size_t i = begin; i < end; ++i) {
+                    try {
+                        function(chunks[i]);
+                    } catch (...) {
+                        chunks[i].error = std::current_exception();
+                    }
+                }
+            });
+
+        for(const ObjChunk & chunk : chunks) {
+            if (chunk.error) {
+                std::rethrow_exception(chunk.error);
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    template <class T>
+    void copyInto(const vector<T> & source, vector<T> & destination, size_t offset) {
+        if (!source.empty()) {
+            std::memcpy(&destination[offset], source.data(), source.size() * sizeof(T));
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    /**
+     * If 'line' starts with 'keyword' followed by a blank or the end of the line,
+     * @return a pointer just past the keyword, and otherwise nullptr.
+     */
+    const char * matchKeyword(const char * line, const char * lineEnd,
+            const char * keyword, size_t keywordLength) {
+        if (size_t(lineEnd - line) < keywordLength ||
+            std::memcmp(line, keyword, keywordLength) != 0) {
+            return nullptr;
+        }
+        const char * p = line + keywordLength;
+        return (p == lineEnd || isBlank(*p)) ? p : nullptr;
+    }
+
+    //------------------------------------------------------------------------------------
+    // @return [p, lineEnd) without leading or trailing blanks.
+    string trimmedString(const char * p, const char * lineEnd) {
+        p = skipBlanks(p, lineEnd);
+        while (lineEnd > p && isBlank(lineEnd[-1])) {
+            --lineEnd;
+        }
+        return string(p, lineEnd);
+    }
+
+    //------------------------------------------------------------------------------------
+    // Makes a negative .obj index relative to the chunk's first element, by
+    // counting back from the 'numParsed' elements parsed so far in the chunk.
+    inline void makeChunkRelative(int & index, size_t numParsed, uint32 flag,
+            FaceCorner & corner) {
+        if (index < 0) {
+            index += int(numParsed) + 1;
+            corner.relative |= flag;
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Turns a chunk relative index back into an absolute one.  Indices that end up
+    // before the first element of the file become -1, so that lookup() rejects them.
+    inline void makeAbsolute(int & index, size_t base, uint32 flag, uint32 relative) {
+        if (relative & flag) {
+            index += int(base);
+            if (index < 1) {
+                index = -1;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    /**
+     * Parses a face corner of the form v, v/vt, v//vn, or v/vt/vn.  Indices that
+     * are absent are set to zero, which is never a valid .obj index, and negative
+     * indices are made chunk relative.
+     *
+     * @return false, leaving 'p' unchanged, if no corner starts at 'p'.
+     */
+    bool parseFaceCorner(const char * & p, const char * end, ObjChunk & chunk,
+            FaceCorner & corner, bool & hasUvCoord, bool & hasNormal) {
+        corner.position = corner.uvCoord = corner.normal = 0;
+        corner.relative = 0;
+        hasUvCoord = hasNormal = false;
+
+        if (!parseInt(p, end, corner.position)) {
+            return false;
+        }
+        if (p < end && *p == '/') {
+            ++p;
+            hasUvCoord = parseInt(p, end, corner.uvCoord);
+            if (p < end && *p == '/') {
+                ++p;
+                hasNormal = parseInt(p, end, corner.normal);
+            }
+        }
+
+        makeChunkRelative(corner.position, chunk.positions.size(), relativePosition, corner);
+        makeChunkRelative(corner.uvCoord, chunk.uvCoords.size(), relativeUvCoord, corner);
+        makeChunkRelative(corner.normal, chunk.normals.size(), relativeNormal, corner);
+        chunk.hasRelativeIndices |= (corner.relative != 0);
+        return true;
+    }
+
+    //------------------------------------------------------------------------------------
+    /**
+     * Parses the corners of an 'f' line, fan triangulating faces with more than
+     * three corners.  Whether the face has texture coordinates and normals is
+     * decided by its first corner.
+     */
+    void parseFace(const char * p, const char * lineEnd, ObjChunk & chunk) {
+        ObjFace face;
+        face.state = uint32(chunk.states.size() - 1);
+
+        bool hasUvCoords, hasNormals, cornerHasUvCoord, cornerHasNormal;
+        p = skipBlanks(p, lineEnd);
+        if (!parseFaceCorner(p, lineEnd, chunk, face.corners[0], hasUvCoords, hasNormals)) {
+            return;
+        }
+        p = skipBlanks(p, lineEnd);
+        if (!parseFaceCorner(p, lineEnd, chunk, face.corners[1], cornerHasUvCoord,
+                cornerHasNormal)) {
+            return;
+        }
+
+        uint32 numTriangles = 0;
+        for(;;) {
+            p = skipBlanks(p, lineEnd);
+            if (!parseFaceCorner(p, lineEnd, chunk, face.corners[2], cornerHasUvCoord,
+                    cornerHasNormal)) {
+                break;
+            }
+            chunk.faces.push_back(face);
+            face.corners[1] = face.corners[2];
+            ++numTriangles;
+        }
+
+        if (numTriangles != 0) {
+            chunk.states.back().numTriangles += numTriangles;
+            chunk.hasUvCoords |= hasUvCoords;
+            chunk.hasNormals |= hasNormals;
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // @return the chunk's current state, first starting a new one if the current
+    // state already has faces.
+    ObjState & beginState(ObjChunk & chunk) {
+        if (chunk.states.back().numTriangles != 0) {
+            ObjState state = chunk.states.back();
+            state.numTriangles = 0;
+            chunk.states.push_back(state);
+        }
+        return chunk.states.back();
+    }
+
+    //------------------------------------------------------------------------------------
+    // Parses the lines of a chunk in place, without copying or allocating per
+    // vertex or face line.
+    void parseChunk(ObjChunk & chunk) {
+        const char * p = chunk.begin;
+        const char * const chunkEnd = chunk.end;
+
+        while (p < chunkEnd) {
+            const char * lineEnd = static_cast<const char *>(
+                    std::memchr(p, '\n', size_t(chunkEnd - p)));
+            if (lineEnd == nullptr) {
+                lineEnd = chunkEnd;
+            }
+
+            const size_t lineLength = size_t(lineEnd - p);
+            const char * arguments;
+
+            if (lineLength >= 2 && p[0] == 'v' && isBlank(p[1])) {
+                vec3 vertex;
+                parseFloats(p + 2, lineEnd, &vertex.x, 3);
+                chunk.positions.push_back(vertex);
+
+            } else if (lineLength >= 3 && p[0] == 'v' && p[1] == 'n' && isBlank(p[2])) {
+                vec3 normal;
+                parseFloats(p + 3, lineEnd, &normal.x, 3);
+                chunk.normals.push_back(normal);
+
+            } else if (lineLength >= 3 && p[0] == 'v' && p[1] == 't' && isBlank(p[2])) {
+                vec2 textureCoord;
+                parseFloats(p + 3, lineEnd, &textureCoord.s, 2);
+                chunk.uvCoords.push_back(textureCoord);
+
+            } else if (lineLength >= 2 && p[0] == 'f' && isBlank(p[1])) {
+                parseFace(p + 2, lineEnd, chunk);
+
+            } else if ((arguments = matchKeyword(p, lineEnd, "g", 1)) ||
+                       (arguments = matchKeyword(p, lineEnd, "o", 1))) {
+                ObjState & state = beginState(chunk);
+                state.group = trimmedString(arguments, lineEnd);
+                state.groupSet = true;
+
+            } else if ((arguments = matchKeyword(p, lineEnd, "usemtl", 6))) {
+                ObjState & state = beginState(chunk);
+                state.material = trimmedString(arguments, lineEnd);
+                state.materialSet = true;
+
+            } else if ((arguments = matchKeyword(p, lineEnd, "mtllib", 6))) {
+                // Any number of blank separated file names.
+                for(;;) {
+                    const char * name = skipBlanks(arguments, lineEnd);
+                    arguments = name;
+                    while (arguments < lineEnd && !isBlank(*arguments)) {
+                        ++arguments;
+                    }
+                    if (name == arguments) {
+                        break;
+                    }
+                    chunk.materialLibraries.push_back(string(name, arguments));
+                }
+            }
+
+            p = lineEnd + 1;
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Makes the chunk relative indices of a chunk's faces absolute.
+    void resolveRelativeIndices(ObjChunk & chunk) {
+        for(ObjFace & face : chunk.faces) {
+            for(FaceCorner & corner : face.corners) {
+                if (corner.relative != 0) {
+                    makeAbsolute(corner.position, chunk.positionBase, relativePosition,
+                            corner.relative);
+                    makeAbsolute(corner.uvCoord, chunk.uvCoordBase, relativeUvCoord,
+                            corner.relative);
+                    makeAbsolute(corner.normal, chunk.normalBase, relativeNormal,
+                            corner.relative);
+                    corner.relative = 0;
+                }
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    /**
+     * Splits 'data' at line boundaries into one chunk per thread, parses every
+     * chunk independently, then concatenates the chunks' vertex data into
+     * 'vertices', using prefix sums over the chunk sizes as offsets.
+     */
+    void parseChunks(const char * data, size_t numBytes, uint32 numThreads,
+                     vector<ObjChunk> & chunks, ObjVertexData & vertices) {
+        uint32 numChunks = resolveThreadCount(numThreads);
+        if (numThreads == 0) {
+            // Small files are not worth splitting across threads.
+            numChunks = uint32(std::min(size_t(numChunks),
+                    std::max(size_t(1), numBytes / minBytesPerChunk)));
+        }
+
+        chunks.resize(numChunks);
+        splitAtLines(data, numBytes, chunks);
+
+        forEachChunk(chunks, [](ObjChunk & chunk) {
+            parseChunk(chunk);
+        });
+
+        size_t numPositions = 0, numNormals = 0, numUvCoords = 0;
+        for(ObjChunk & chunk : chunks) {
+            chunk.positionBase = numPositions;
+            chunk.normalBase = numNormals;
+            chunk.uvCoordBase = numUvCoords;
+            numPositions += chunk.positions.size();
+            numNormals += chunk.normals.size();
+            numUvCoords += chunk.uvCoords.size();
+        }
+
+        vertices.positions.resize(numPositions);
+        vertices.normals.resize(numNormals);
+        vertices.uvCoords.resize(numUvCoords);
+
+        forEachChunk(chunks, [&](ObjChunk & chunk) {
+            copyInto(chunk.positions, vertices.positions, chunk.positionBase);
+            copyInto(chunk.normals, vertices.normals, chunk.normalBase);
+            copyInto(chunk.uvCoords, vertices.uvCoords, chunk.uvCoordBase);
+            if (chunk.hasRelativeIndices) {
+                resolveRelativeIndices(chunk);
+            }
+        });
+    }
+
+    //------------------------------------------------------------------------------------
+    /**
+     * Gives every state with faces a submesh, one per distinct group and material,
+     * numbered in order of first face.  Then places each state's triangles within
+     * the output, so that every submesh's triangles are contiguous and otherwise
+     * in file order.
+     *
+     * Only walks the states, not the faces, so is cheap to run on one thread.
+     *
+     * @return total number of triangles.
+     */
+    size_t assignSubmeshes(vector<ObjChunk> & chunks, vector<Submesh> & submeshes) {
+        std::map<std::pair<string, string>, uint32> submeshIndices;
+        vector<size_t> submeshTriangles;
+
+        string group, material;
+        for(ObjChunk & chunk : chunks) {
+            for(ObjState & state : chunk.states) {
+                if (state.groupSet) {
+                    group = state.group;
+                } else {
+                    state.group = group;
+                }
+                if (state.materialSet) {
+                    material = state.material;
+                } else {
+                    state.material = material;
+                }
+                if (state.numTriangles == 0) {
+                    continue;
+                }
+
+                auto inserted = submeshIndices.insert(std::make_pair(
+                        std::make_pair(group, material), uint32(submeshTriangles.size())));
+                if (inserted.second) {
+                    Submesh submesh;
+                    submesh.name = group;
+                    submesh.materialName = material;
+                    submesh.materialIndex = -1;
+                    submesh.startIndex = 0;
+                    submesh.numIndices = 0;
+                    submeshes.push_back(submesh);
+                    submeshTriangles.push_back(0);
+                }
+                state.submesh = inserted.first->second;
+                submeshTriangles[state.submesh] += state.numTriangles;
+            }
+        }
+
+        // Prefix sums over the submeshes' triangle counts give their first triangles.
+        vector<size_t> nextTriangle(submeshTriangles.size());
+        size_t numTriangles = 0;
+        for(size_t s = 0; s < submeshTriangles.size(); ++s) {
+            nextTriangle[s] = numTriangles;
+            numTriangles += submeshTriangles[s];
+        }
+
+        for(ObjChunk & chunk : chunks) {
+            for(ObjState & state : chunk.states) {
+                // States without faces were given no submesh above.
+                if (state.numTriangles == 0) {
+                    continue;
+                }
+                state.firstTriangle = nextTriangle[state.submesh];
+                nextTriangle[state.submesh] += state.numTriangles;
+            }
+        }
+
+        const size_t firstSubmesh = submeshes.size() - submeshTriangles.size();
+        for(size_t s = 0; s < submeshTriangles.size(); ++s) {
+            Submesh & submesh = submeshes[firstSubmesh + s];
+            submesh.startIndex = uint32((nextTriangle[s] - submeshTriangles[s]) * 3);
+            submesh.numIndices = uint32(submeshTriangles[s] * 3);
+        }
+
+        return numTriangles;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Calls function(face, triangle) for each of a chunk's faces, along with the
+    // output triangle assigned to it by assignSubmeshes().
+    template <class Function>
+    void forEachPlacedFace(const ObjChunk & chunk, const Function & function) {
+        uint32 state = uint32(-1);
+        size_t triangle = 0;
+        for(const ObjFace & face : chunk.faces) {
+            if (face.state != state) {
+                state = face.state;
+                triangle = chunk.states[state].firstTriangle;
+            }
+            function(face, triangle++);
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    /**
+     * Writes the vertex data of a chunk's faces into their triangles' places
+     * within the output arrays, which start at 'firstVertex'.
+     */
+    void resolveFaces(const ObjChunk & chunk,
+                      const ObjVertexData & vertices,
+                      size_t firstVertex,
+                      vector<vec3> & positions,
+                      vector<vec3> * normals,
+                      vector<vec2> * uvCoords) {
+        forEachPlacedFace(chunk, [&](const ObjFace & face, size_t triangle) {
+            const bool hasUvCoords = (face.corners[0].uvCoord != 0);
+            const bool hasNormals = (face.corners[0].normal != 0);
+            const size_t out = firstVertex + triangle * 3;
+
+            for(int i = 0; i < 3; ++i) {
+                const FaceCorner & corner = face.corners[i];
+                positions[out + i] = lookup(vertices.positions, corner.position, "position");
+                if (uvCoords) {
+                    (*uvCoords)[out + i] = hasUvCoords ?
+                            lookup(vertices.uvCoords, corner.uvCoord, "texture coordinate") :
+                            vec2(0.0f);
+                }
+                if (normals) {
+                    (*normals)[out + i] = hasNormals ?
+                            lookup(vertices.normals, corner.normal, "normal") :
+                            vec3(0.0f);
+                }
+            }
+        });
+    }
+
+    //------------------------------------------------------------------------------------
+    inline bool operator == (const FaceCorner & a, const FaceCorner & b) {
+        return a.position == b.position && a.uvCoord == b.uvCoord && a.normal == b.normal;
+    }
+
+    struct FaceCornerHash {
+        size_t operator () (const FaceCorner & corner) const {
+            uint64_t h = uint64_t(uint32(corner.position)) * 0x9E3779B97F4A7C15ull;
+            h ^= uint64_t(uint32(corner.uvCoord)) * 0xC2B2AE3D27D4EB4Full;
+            h ^= uint64_t(uint32(corner.normal)) * 0x165667B19E3779F9ull;
+            return size_t(h ^ (h >> 29));
+        }
+    };
+
+    //------------------------------------------------------------------------------------
+    /**
+     * Gives each distinct (v, vt, vn) corner of the chunks' faces one output
+     * vertex, in order of first use, and appends three indices per face, with
+     * faces ordered as placed by assignSubmeshes().
+     */
+    void resolveIndexedFaces(vector<ObjChunk> & chunks,
+                             const ObjVertexData & vertices,
+                             size_t numTriangles,
+                             bool anyNormals,
+                             bool anyUvCoords,
+                             vector<vec3> & positions,
+                             vector<vec3> & normals,
+                             vector<vec2> & uvCoords,
+                             vector<uint32> & indices) {
+        vector<const ObjFace *> orderedFaces(numTriangles);
+        forEachChunk(chunks, [&](ObjChunk & chunk) {
+            forEachPlacedFace(chunk, [&](const ObjFace & face, size_t triangle) {
+                orderedFaces[triangle] = &face;
+            });
+        });
+
+        std::unordered_map<FaceCorner, uint32, FaceCornerHash> vertexIndices;
+        vertexIndices.reserve(numTriangles * 3);
+        indices.reserve(indices.size() + numTriangles * 3);
+
+        for(const ObjFace * face : orderedFaces) {
+            const bool hasUvCoords = (face->corners[0].uvCoord != 0);
+            const bool hasNormals = (face->corners[0].normal != 0);
+
+            for(FaceCorner corner : face->corners) {
+                if (!hasUvCoords) { corner.uvCoord = 0; }
+                if (!hasNormals) { corner.normal = 0; }
+
+                auto inserted = vertexIndices.insert(
+                        std::make_pair(corner, uint32(positions.size())));
+                if (inserted.second) {
+                    positions.push_back(lookup(vertices.positions, corner.position,
+                            "position"));
+                    if (anyNormals) {
+                        normals.push_back(hasNormals ?
+                                lookup(vertices.normals, corner.normal, "normal") :
+                                vec3(0.0f));
+                    }
+                    if (anyUvCoords) {
+                        uvCoords.push_back(hasUvCoords ?
+                                lookup(vertices.uvCoords, corner.uvCoord,
+                                        "texture coordinate") :
+                                vec2(0.0f));
+                    }
+                }
+                indices.push_back(inserted.first->second);
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    /**
+     * Decodes an .obj file held in memory, appending to the output arrays.  Decodes
+     * indexed if 'indices' is given.  Submesh ranges account for any vertices, or
+     * indices, already in the output.
+     */
+    void decodeObj(const char * data,
+                   size_t numBytes,
+                   uint32 numThreads,
+                   vector<vec3> & positions,
+                   vector<vec3> & normals,
+                   vector<vec2> & uvCoords,
+                   vector<uint32> * indices,
+                   vector<Submesh> & submeshes,
+                   vector<string> & materialLibraries) {
+        vector<ObjChunk> chunks;
+        ObjVertexData vertices;
+        parseChunks(data, numBytes, numThreads, chunks, vertices);
+
+        const size_t firstSubmesh = submeshes.size();
+        const size_t numTriangles = assignSubmeshes(chunks, submeshes);
+
+        bool anyNormals = false;
+        bool anyUvCoords = false;
+        for(const ObjChunk & chunk : chunks) {
+            anyNormals |= chunk.hasNormals;
+            anyUvCoords |= chunk.hasUvCoords;
+            materialLibraries.insert(materialLibraries.end(),
+                    chunk.materialLibraries.begin(), chunk.materialLibraries.end());
+        }
+
+        // Output vertices stay parallel, even if 'normals' or 'uvCoords' were
+        // shorter than 'positions' on entry.
+        const size_t firstVertex = positions.size();
+        if (anyNormals) {
+            normals.resize(firstVertex);
+        }
+        if (anyUvCoords) {
+            uvCoords.resize(firstVertex);
+        }
+
+        size_t firstIndex = firstVertex;
+        if (indices) {
+            firstIndex = indices->size();
+            resolveIndexedFaces(chunks, vertices, numTriangles, anyNormals, anyUvCoords,
+                    positions, normals, uvCoords, *indices);
+        } else {
+            const size_t numVertices = firstVertex + numTriangles * 3;
+            positions.resize(numVertices);
+            if (anyNormals) {
+                normals.resize(numVertices);
+            }
+            if (anyUvCoords) {
+                uvCoords.resize(numVertices);
+            }
+
+            // Faces may reference vertices from any chunk.
+            forEachChunk(chunks, [&](ObjChunk & chunk) {
+                resolveFaces(chunk, vertices, firstVertex, positions,
+                        anyNormals ? &normals : nullptr,
+                        anyUvCoords ? &uvCoords : nullptr);
+            });
+        }
+
+        for(size_t s = firstSubmesh; s < submeshes.size(); ++s) {
+            submeshes[s].startIndex += uint32(firstIndex);
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Parses up to three floats of an .mtl line into 'color', for which a single
+    // value gives all three components.
+    vec3 parseColor(const char * p, const char * lineEnd) {
+        vec3 color(0.0f);
+        p = skipBlanks(p, lineEnd);
+        if (parseFloat(p, lineEnd, color.r)) {
+            color.g = color.b = color.r;
+            parseFloats(p, lineEnd, &color.g, 2);
+        }
+        return color;
+    }
+
+}
+
+//----------------------------------------------------------------------------------------
 /**
-* Extracts vertex data from a Wavefront .obj file
+* Extracts vertex data from a Wavefront .obj file.
+*
+* The file is memory mapped and parsed in place by decodeBuffer().
+*
 * @param objFilePath - path to .obj file
 * @param positions - positions given in (x,y,z) object space.
 * @param normals - normals given in (x,y,z) object space.
@@ -22,13 +937,321 @@ void ObjFileLoader::decode(const char * objFilePath,
                            std::vector<vec3> & normals,
                            std::vector<vec2> & uvCoords) {
 
+    MappedFile file(objFilePath);
+    decodeBuffer(file.getData(), file.getSize(), positions, normals, uvCoords);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+* Extracts vertex data from the contents of a Wavefront .obj file held in memory.
+*
+* Faces may have any number of corners, given as v, v/vt, v//vn or v/vt/vn, with
+* negative indices counting back from the last vertex data defined.  Faces with
+* more than three corners are fan triangulated, and every triangle adds three
+* entries to 'positions'.  'normals' and 'uvCoords' are parallel to 'positions'
+* if any face has normals or texture coordinates, and are zero for the corners
+* of faces that do not.
+*
+* Triangles are grouped by their 'o' or 'g' group and 'usemtl' material, with
+* groups in order of first use, and in file order within each.  See
+* decodeModelBuffer() for the resulting submesh ranges.
+*
+* The buffer is split at line boundaries into one chunk per thread, and each
+* chunk is parsed into its own vertex and face arrays.  Prefix sums over the
+* chunk sizes then place each chunk's vertices within the global vertex arrays,
+* and its faces within the output arrays, so that only face resolution needs
+* the vertices of other chunks.  Output is identical for any number of threads.
+*
+* @param data - .obj file contents, which need not be null terminated.
+* @param numBytes - size of 'data' in bytes.
+* @param positions - positions given in (x,y,z) object space.
+* @param normals - normals given in (x,y,z) object space.
+* @param uvCoords - texture coordinates.
+* @param numThreads - threads to parse with.  Zero uses one thread per hardware
+* thread, but no more than one per megabyte of 'data'.
+*/
+void ObjFileLoader::decodeBuffer(const char * data,
+                                 size_t numBytes,
+                                 std::vector<vec3> & positions,
+                                 std::vector<vec3> & normals,
+                                 std::vector<vec2> & uvCoords,
+                                 uint32 numThreads) {
+
+    vector<Submesh> submeshes;
+    vector<string> materialLibraries;
+    decodeObj(data, numBytes, numThreads, positions, normals, uvCoords, nullptr,
+            submeshes, materialLibraries);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+* Extracts indexed vertex data from a Wavefront .obj file.
+*
+* The file is memory mapped and parsed in place by decodeBufferIndexed().
+*
+* @param objFilePath - path to .obj file
+* @param positions - positions given in (x,y,z) object space.
+* @param normals - normals given in (x,y,z) object space.
+* @param uvCoords - texture coordinates.
+* @param indices - three vertex indices per triangle.
+*/
+void ObjFileLoader::decodeIndexed(const char * objFilePath,
+                                  std::vector<vec3> & positions,
+                                  std::vector<vec3> & normals,
+                                  std::vector<vec2> & uvCoords,
+                                  std::vector<uint32> & indices) {
+
+    MappedFile file(objFilePath);
+    decodeBufferIndexed(file.getData(), file.getSize(), positions, normals, uvCoords,
+            indices);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+* Extracts indexed vertex data from the contents of a Wavefront .obj file held
+* in memory.
+*
+* Rather than expanding every face corner into its own vertex, as decodeBuffer()
+* does, each distinct (v, vt, vn) combination becomes one vertex, and faces are
+* output as indices into the vertex arrays.  Vertices are numbered in order of
+* first use, and indices account for any vertices already in 'positions'.
+*
+* 'positions', 'normals' and 'uvCoords' are parallel arrays.  Normals and
+* texture coordinates are only output if some face has them, and are zero for
+* vertices of faces that do not.  Triangles are ordered as by decodeBuffer().
+*
+* Parsing runs on multiple threads, as with decodeBuffer(), after which vertices
+* are deduplicated on the calling thread.
+*
+* @param data - .obj file contents, which need not be null terminated.
+* @param numBytes - size of 'data' in bytes.
+* @param positions - positions given in (x,y,z) object space.
+* @param normals - normals given in (x,y,z) object space.
+* @param uvCoords - texture coordinates.
+* @param indices - three vertex indices per triangle.
+* @param numThreads - threads to parse with.  Zero uses one thread per hardware
+* thread, but no more than one per megabyte of 'data'.
+*/
+void ObjFileLoader::decodeBufferIndexed(const char * data,
+                                        size_t numBytes,
+                                        std::vector<vec3> & positions,
+                                        std::vector<vec3> & normals,
+                                        std::vector<vec2> & uvCoords,
+                                        std::vector<uint32> & indices,
+                                        uint32 numThreads) {
+
+    vector<Submesh> submeshes;
+    vector<string> materialLibraries;
+    decodeObj(data, numBytes, numThreads, positions, normals, uvCoords, &indices,
+            submeshes, materialLibraries);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+* Decodes a Wavefront .obj file, along with the materials of the .mtl files
+* named by its 'mtllib' lines.
+*
+* .mtl files are looked up relative to the .obj file's directory.  Missing
+* .mtl files are skipped, leaving the submeshes that use their materials with a
+* 'materialIndex' of -1, so that a mesh exported without its materials still
+* loads.
+*
+* @param objFilePath - path to .obj file
+* @param indexing - whether to output indices, as by decodeBufferIndexed().
+* @param model - cleared, then filled with the decoded model.
+* @param numThreads - threads to parse with, as by decodeModelBuffer().
+*/
+void ObjFileLoader::decodeModel(const char * objFilePath,
+                                MeshIndexing indexing,
+                                ObjModel & model,
+                                uint32 numThreads) {
+
+    {
+        MappedFile file(objFilePath);
+        decodeModelBuffer(file.getData(), file.getSize(), indexing, model, numThreads);
+    }
+
+    for(const string & materialLibrary : model.materialLibraries) {
+        const string mtlFilePath = getMaterialLibraryPath(objFilePath, materialLibrary);
+        try {
+            decodeMaterials(mtlFilePath.c_str(), model.materials);
+        } catch (const Rigid3DException &) {
+            continue;
+        }
+    }
+
+    for(Submesh & submesh : model.submeshes) {
+        for(size_t i = 0; i < model.materials.size(); ++i) {
+            if (model.materials[i].name == submesh.materialName) {
+                submesh.materialIndex = int32(i);
+                break;
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+* Decodes the contents of a Wavefront .obj file held in memory, as by
+* decodeBuffer() or decodeBufferIndexed(), and also outputs one Submesh per
+* distinct group and material.
+*
+* Materials are not loaded, so every submesh's 'materialIndex' is -1.
+*
+* @param data - .obj file contents, which need not be null terminated.
+* @param numBytes - size of 'data' in bytes.
+* @param indexing - whether to output indices.
+* @param model - cleared, then filled with the decoded model.
+* @param numThreads - threads to parse with.  Zero uses one thread per hardware
+* thread, but no more than one per megabyte of 'data'.
+*/
+void ObjFileLoader::decodeModelBuffer(const char * data,
+                                      size_t numBytes,
+                                      MeshIndexing indexing,
+                                      ObjModel & model,
+                                      uint32 numThreads) {
+
+    model = ObjModel();
+    decodeObj(data, numBytes, numThreads, model.positions, model.normals,
+            model.uvCoords,
+            (indexing == MeshIndexing::Indexed) ? &model.indices : nullptr,
+            model.submeshes, model.materialLibraries);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+* Appends the materials of a Wavefront .mtl file to 'materials'.
+*
+* @throws Rigid3DException if the file cannot be read.
+*/
+void ObjFileLoader::decodeMaterials(const char * mtlFilePath,
+                                    std::vector<Material> & materials) {
+
+    MappedFile file(mtlFilePath);
+    decodeMaterialsBuffer(file.getData(), file.getSize(), materials);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+* Appends the materials of a Wavefront .mtl file held in memory to 'materials'.
+*
+* Reads the 'newmtl', 'Ka', 'Kd', 'Ks', 'Ke', 'Ns' and 'map_Kd' statements,
+* ignoring all others.  Since MaterialProperties has a single specular
+* coefficient, 'Ks' is averaged over its RGB components.  Properties that are not
+* given keep the defaults of a Renderable.
+*
+* @param data - .mtl file contents, which need not be null terminated.
+* @param numBytes - size of 'data' in bytes.
+* @param materials - materials in order of their 'newmtl' statements.
+*/
+void ObjFileLoader::decodeMaterialsBuffer(const char * data,
+                                          size_t numBytes,
+                                          std::vector<Material> & materials) {
+
+    const char * p = data;
+    const char * const end = data + numBytes;
+    Material * material = nullptr;
+
+    while (p < end) {
+        const char * lineEnd = static_cast<const char *>(
+                std::memchr(p, '\n', size_t(end - p)));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+
+        const char * line = skipBlanks(p, lineEnd);
+        const char * arguments;
+
+        if ((arguments = matchKeyword(line, lineEnd, "newmtl", 6))) {
+            Material newMaterial;
+            newMaterial.name = trimmedString(arguments, lineEnd);
+            newMaterial.properties.emission = vec3(0.0f);
+            newMaterial.properties.Ka = vec3(1.0f);
+            newMaterial.properties.Kd = vec3(1.0f);
+            newMaterial.properties.Ks = 1.0f;
+            newMaterial.properties.shininessFactor = 1.0f;
+            materials.push_back(newMaterial);
+            material = &materials.back();
+
+        } else if (material == nullptr) {
+            // Statements before the first 'newmtl' have no material to apply to.
+
+        } else if ((arguments = matchKeyword(line, lineEnd, "Ka", 2))) {
+            material->properties.Ka = parseColor(arguments, lineEnd);
+
+        } else if ((arguments = matchKeyword(line, lineEnd, "Kd", 2))) {
+            material->properties.Kd = parseColor(arguments, lineEnd);
+
+        } else if ((arguments = matchKeyword(line, lineEnd, "Ks", 2))) {
+            vec3 specular = parseColor(arguments, lineEnd);
+            material->properties.Ks = (specular.r + specular.g + specular.b) / 3.0f;
+
+        } else if ((arguments = matchKeyword(line, lineEnd, "Ke", 2))) {
+            material->properties.emission = parseColor(arguments, lineEnd);
+
+        } else if ((arguments = matchKeyword(line, lineEnd, "Ns", 2))) {
+            parseFloats(arguments, lineEnd, &material->properties.shininessFactor, 1);
+
+        } else if ((arguments = matchKeyword(line, lineEnd, "map_Kd", 6))) {
+            // Options such as '-s 1 1 1' may precede the file name, which is last.
+            string path = trimmedString(arguments, lineEnd);
+            size_t nameStart = path.find_last_of(" \t");
+            material->diffuseTexture = (nameStart == string::npos) ? path :
+                    path.substr(nameStart + 1);
+        }
+
+        p = lineEnd + 1;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+* @return path of the .mtl file named 'materialLibrary' by an 'mtllib' line of
+* 'objFilePath', which is relative to the .obj file's directory unless absolute.
+*/
+std::string ObjFileLoader::getMaterialLibraryPath(const char * objFilePath,
+                                                  const std::string & materialLibrary) {
+
+    const bool isAbsolute = !materialLibrary.empty() &&
+            (materialLibrary[0] == '/' || materialLibrary[0] == '\\' ||
+             (materialLibrary.size() > 1 && materialLibrary[1] == ':'));
+    if (isAbsolute) {
+        return materialLibrary;
+    }
+
+    const string objPath(objFilePath);
+    const size_t separator = objPath.find_last_of("/\\");
+    if (separator == string::npos) {
+        return materialLibrary;
+    }
+    return objPath.substr(0, separator + 1) + materialLibrary;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+* Extracts vertex data from a Wavefront .obj file, reading it line by line with
+* getline, istringstream and sscanf.
+*
+* This is the original decoder, and is several times slower than decode().  It is
+* kept as a reference implementation for tests and benchmarks.
+*
+* @param objFilePath - path to .obj file
+* @param positions - positions given in (x,y,z) object space.
+* @param normals - normals given in (x,y,z) object space.
+* @param uvCoords - texture coordinates.
+*/
+void ObjFileLoader::decodeWithStreams(const char * objFilePath,
+                                      std::vector<vec3> & positions,
+                                      std::vector<vec3> & normals,
+                                      std::vector<vec2> & uvCoords) {
+
     ifstream in(objFilePath, std::ios::in);
     in.exceptions(std::ifstream::badbit);
 
     if (!in) {
         stringstream errorMessage;
         errorMessage << "Unable to open .obj file " << objFilePath
-            << " within method ObjFileLoader::decode" << endl;
+            << " within method ObjFileLoader::decodeWithStreams" << endl;
 
         throw Rigid3DException(errorMessage.str().c_str());
     }
@@ -8,10 +8,33 @@
 #define RIGID3D_OBJ_FILE_LOADER_HPP_
 
 #include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Graphics/MaterialProperties.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/Submesh.hpp>
+#include <cstddef>
+#include <string>
 #include <vector>
 
 namespace Rigid3D {
 
+/**
+ * Everything decoded from an .obj file and the .mtl files it references.
+ */
+struct ObjModel {
+    std::vector<vec3> positions;
+    std::vector<vec3> normals;
+    std::vector<vec2> uvCoords;
+
+    // Three per triangle, or empty if decoded unindexed.
+    std::vector<uint32> indices;
+
+    std::vector<Submesh> submeshes;
+    std::vector<Material> materials;
+
+    // .mtl file names given by 'mtllib' lines, as written in the .obj file.
+    std::vector<std::string> materialLibraries;
+};
+
 class ObjFileLoader {
 public:
     static void decode(const char * objFilePath,
@@ -23,6 +46,55 @@ public:
                        std::vector<vec3> & positions,
                        std::vector<vec3> & normals);
 
+    static void decodeBuffer(const char * data,
+                             size_t numBytes,
+                             std::vector<vec3> & positions,
+                             std::vector<vec3> & normals,
+                             std::vector<vec2> & uvCoords,
+                             uint32 numThreads = 0);
+
+    static void decodeIndexed(const char * objFilePath,
+                              std::vector<vec3> & positions,
+                              std::vector<vec3> & normals,
+                              std::vector<vec2> & uvCoords,
+                              std::vector<uint32> & indices);
+
+    static void decodeBufferIndexed(const char * data,
+                                    size_t numBytes,
+                                    std::vector<vec3> & positions,
+                                    std::vector<vec3> & normals,
+                                    std::vector<vec2> & uvCoords,
+                                    std::vector<uint32> & indices,
+                                    uint32 numThreads = 0);
+
+    static void decodeModel(const char * objFilePath,
+                            MeshIndexing indexing,
+                            ObjModel & model,
+                            uint32 numThreads = 0);
+
+    static void decodeModelBuffer(const char * data,
+                                  size_t numBytes,
+                                  MeshIndexing indexing,
+                                  ObjModel & model,
+                                  uint32 numThreads = 0);
+
+    static void decodeMaterials(const char * mtlFilePath,
+                                std::vector<Material> & materials);
+
+    static void decodeMaterialsBuffer(const char * data,
+                                      size_t numBytes,
+                                      std::vector<Material> & materials);
+
+    static std::string getMaterialLibraryPath(const char * objFilePath,
+                                              const std::string & materialLibrary);
+
+    // Original getline/istringstream based decoder, kept as a reference for
+    // verifying and benchmarking decode().
+    static void decodeWithStreams(const char * objFilePath,
+                                  std::vector<vec3> & positions,
+                                  std::vector<vec3> & normals,
+                                  std::vector<vec2> & uvCoords);
+
 };
 
 }
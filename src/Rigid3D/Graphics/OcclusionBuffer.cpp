@@ -0,0 +1,461 @@
+#include "OcclusionBuffer.hpp"
+
+#include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Math/SimdLevel.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(RIGID3D_SIMD_X86)
+#include <emmintrin.h>
+#endif
+
+namespace Rigid3D {
+
+using std::max;
+using std::min;
+
+namespace {
+
+    // SSE2 is part of the x86-64 baseline, so only the scalar setting opts out.
+    inline bool useSse() {
+#if defined(RIGID3D_SIMD_X86)
+        return getSimdLevel() != SimdLevel::Scalar;
+#else
+        return false;
+#endif
+    }
+
+    // Signed distance of a clip space vertex from the near plane, z = -w.
+    inline float nearDistance(const vec4 & v) {
+        return v.z + v.w;
+    }
+
+    inline bool isInside(const vec4 & v) {
+        return nearDistance(v) >= 0.0f;
+    }
+
+    // Clamps window coordinate 'x' to [0, size - 1] while still a float, since
+    // converting an out of range float to an integer is undefined.  NaN
+    // clamps to zero.
+    inline uint32 toTexel(float x, uint32 size) {
+        return uint32(min(max(0.0f, x), float(size - 1)));
+    }
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Constructs a depth buffer of 'width' by 'height' pixels, along with its
+ * hierarchical-Z levels.
+ *
+ * @throws Rigid3DException if 'width' is not a positive multiple of 4, or
+ * 'height' is zero.
+ */
+OcclusionBuffer::OcclusionBuffer(uint32 width, uint32 height)
+    : width(width),
+      height(height),
+      hiZIsCurrent(false),
+      numRasterizedTriangles(0)
+{
+    if (width == 0 || width % 4 != 0 || height == 0) {
+        throw Rigid3DException("Width must be a positive multiple of 4, and height "
+                "positive, within method OcclusionBuffer::OcclusionBuffer");
+    }
+
+    uint32 levelWidth = width;
+    uint32 levelHeight = height;
+    while (true) {
+        Level level;
+        level.width = levelWidth;
+        level.height = levelHeight;
+        level.depths.assign(levelWidth * levelHeight, 1.0f);
+        levels.push_back(level);
+
+        if (levelWidth == 1 && levelHeight == 1) {
+            break;
+        }
+        levelWidth = (levelWidth + 1) / 2;
+        levelHeight = (levelHeight + 1) / 2;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+OcclusionBuffer::~OcclusionBuffer() {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Resets every depth to the far plane, ready for the occluders of a frame
+ * viewed through 'viewProjectionMatrix'.
+ */
+void OcclusionBuffer::clear(const mat4 & viewProjectionMatrix) {
+    this->viewProjectionMatrix = viewProjectionMatrix;
+    std::fill(levels[0].depths.begin(), levels[0].depths.end(), 1.0f);
+    hiZIsCurrent = false;
+    numRasterizedTriangles = 0;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Rasterizes the triangle list 'positions', three vertices per triangle, as
+ * placed in the world by 'modelMatrix'.
+ */
+void OcclusionBuffer::addOccluder(const vec3 * positions, size_t numVertices,
+        const mat4 & modelMatrix) {
+    rasterizeTriangles(positions, numVertices, modelMatrix,
+            [](size_t i) { return uint32(i); });
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Rasterizes the indexed triangle list given by 'positions' and 'indices', as
+ * placed in the world by 'modelMatrix'.
+ */
+void OcclusionBuffer::addOccluder(const vec3 * positions, const uint32 * indices,
+        size_t numIndices, const mat4 & modelMatrix) {
+    rasterizeTriangles(positions, numIndices, modelMatrix,
+            [indices](size_t i) { return indices[i]; });
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Rasterizes every triangle of 'mesh', indexed or not, as placed in the world by
+ * 'modelMatrix'.  Simple, closed meshes such as walls make the best occluders.
+ */
+void OcclusionBuffer::addOccluder(const Mesh & mesh, const mat4 & modelMatrix) {
+    const vec3 * positions = mesh.getVertexPositionVector()->data();
+    if (mesh.isIndexed()) {
+        const IndexBuffer & indices = mesh.getIndexBuffer();
+        rasterizeTriangles(positions, indices.getNumIndices(), modelMatrix,
+                [&indices](size_t i) { return indices[i]; });
+    } else {
+        addOccluder(positions, mesh.getNumVertexPositions(), modelMatrix);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+template <class IndexAt>
+void OcclusionBuffer::rasterizeTriangles(const vec3 * positions, size_t numIndices,
+        const mat4 & modelMatrix, const IndexAt & indexAt) {
+    const mat4 modelViewProjection = viewProjectionMatrix * modelMatrix;
+    for(size_t i = 0; i + 2 < numIndices; i += 3) {
+        clipAndRasterize(modelViewProjection * vec4(positions[indexAt(i)], 1.0f),
+                         modelViewProjection * vec4(positions[indexAt(i + 1)], 1.0f),
+                         modelViewProjection * vec4(positions[indexAt(i + 2)], 1.0f));
+    }
+    hiZIsCurrent = false;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Clips a clip space triangle against the near plane, leaving up to two
+ * triangles, and rasterizes them in window space.  Triangles entirely outside
+ * one of the side planes are skipped.
+ */
+void OcclusionBuffer::clipAndRasterize(const vec4 & a, const vec4 & b, const vec4 & c) {
+    for(int axis = 0; axis < 2; ++axis) {
+        if ((a[axis] > a.w && b[axis] > b.w && c[axis] > c.w) ||
+                (a[axis] < -a.w && b[axis] < -b.w && c[axis] < -c.w)) {
+            return;
+        }
+    }
+
+    const vec4 input[3] = {a, b, c};
+    vec4 polygon[4];
+    int numVertices = 0;
+    for(int i = 0; i < 3; ++i) {
+        const vec4 & current = input[i];
+        const vec4 & next = input[(i + 1) % 3];
+        if (isInside(current)) {
+            polygon[numVertices++] = current;
+        }
+        if (isInside(current) != isInside(next)) {
+            const float t = nearDistance(current) /
+                    (nearDistance(current) - nearDistance(next));
+            polygon[numVertices++] = current + (next - current) * t;
+        }
+    }
+    if (numVertices < 3) {
+        return;
+    }
+
+    vec3 window[4];
+    for(int i = 0; i < numVertices; ++i) {
+        const vec4 & v = polygon[i];
+        const float invW = 1.0f / v.w;
+        window[i] = vec3((v.x * invW * 0.5f + 0.5f) * float(width),
+                         (v.y * invW * 0.5f + 0.5f) * float(height),
+                         v.z * invW * 0.5f + 0.5f);
+    }
+
+    rasterize(window[0], window[1], window[2]);
+    if (numVertices == 4) {
+        rasterize(window[0], window[2], window[3]);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Writes the nearer of the current and triangle depths at every pixel whose
+ * center the window space triangle covers.  Rows are processed four pixels at
+ * a time with SSE.
+ */
+void OcclusionBuffer::rasterize(const vec3 & v0, const vec3 & v1In, const vec3 & v2In) {
+    vec3 v1 = v1In;
+    vec3 v2 = v2In;
+    float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+    if (area < 0.0f) {
+        std::swap(v1, v2);
+        area = -area;
+    }
+    if (!(area > 0.0f)) {
+        return;
+    }
+
+    const float minXf = max(0.0f, min(v0.x, min(v1.x, v2.x)));
+    const float maxXf = min(float(width - 1), max(v0.x, max(v1.x, v2.x)));
+    const float minYf = max(0.0f, min(v0.y, min(v1.y, v2.y)));
+    const float maxYf = min(float(height - 1), max(v0.y, max(v1.y, v2.y)));
+    if (minXf > maxXf || minYf > maxYf) {
+        return;
+    }
+    const int minX = int(minXf) & ~3;
+    const int maxX = int(maxXf);
+    const int minY = int(minYf);
+    const int maxY = int(maxYf);
+
+    // Edge functions A * x + B * y + C, non-negative on the inner side, each
+    // named after the vertex opposite it.
+    const vec3 * vertices[3] = {&v0, &v1, &v2};
+    float A[3], B[3], C[3];
+    for(int e = 0; e < 3; ++e) {
+        const vec3 & from = *vertices[(e + 1) % 3];
+        const vec3 & to = *vertices[(e + 2) % 3];
+        A[e] = from.y - to.y;
+        B[e] = to.x - from.x;
+        C[e] = from.x * to.y - from.y * to.x;
+    }
+
+    // Depth plane, interpolated with the barycentric weights E[e] / area.
+    const float invArea = 1.0f / area;
+    const float zA = (A[0] * v0.z + A[1] * v1.z + A[2] * v2.z) * invArea;
+    const float zB = (B[0] * v0.z + B[1] * v1.z + B[2] * v2.z) * invArea;
+    const float zC = (C[0] * v0.z + C[1] * v1.z + C[2] * v2.z) * invArea;
+
+    float * depths = levels[0].depths.data();
+
+#if defined(RIGID3D_SIMD_X86)
+    if (useSse()) {
+        const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+        const __m128 zero = _mm_setzero_ps();
+        __m128 a[3];
+        for(int e = 0; e < 3; ++e) {
+            a[e] = _mm_set1_ps(A[e]);
+        }
+        const __m128 za = _mm_set1_ps(zA);
+
+        for(int y = minY; y <= maxY; ++y) {
+            const float py = float(y) + 0.5f;
+            __m128 rowE[3];
+            for(int e = 0; e < 3; ++e) {
+                rowE[e] = _mm_set1_ps(B[e] * py + C[e]);
+            }
+            const __m128 rowZ = _mm_set1_ps(zB * py + zC);
+
+            float * row = depths + y * width;
+            for(int x = minX; x <= maxX; x += 4) {
+                const __m128 px = _mm_add_ps(_mm_set1_ps(float(x)), laneOffsets);
+
+                __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a[0], px), rowE[0]), zero);
+                inside = _mm_and_ps(inside,
+                        _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a[1], px), rowE[1]), zero));
+                inside = _mm_and_ps(inside,
+                        _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a[2], px), rowE[2]), zero));
+                if (_mm_movemask_ps(inside) == 0) {
+                    continue;
+                }
+
+                const __m128 z = _mm_add_ps(_mm_mul_ps(za, px), rowZ);
+                const __m128 current = _mm_loadu_ps(row + x);
+                const __m128 nearer = _mm_min_ps(current, z);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer),
+                        _mm_andnot_ps(inside, current)));
+            }
+        }
+        ++numRasterizedTriangles;
+        return;
+    }
+#endif
+
+    for(int y = minY; y <= maxY; ++y) {
+        const float py = float(y) + 0.5f;
+        float rowE[3];
+        for(int e = 0; e < 3; ++e) {
+            rowE[e] = B[e] * py + C[e];
+        }
+        const float rowZ = zB * py + zC;
+
+        float * row = depths + y * width;
+        for(int x = minX; x <= maxX; ++x) {
+            const float px = float(x) + 0.5f;
+            if (A[0] * px + rowE[0] >= 0.0f && A[1] * px + rowE[1] >= 0.0f &&
+                    A[2] * px + rowE[2] >= 0.0f) {
+                row[x] = min(row[x], zA * px + rowZ);
+            }
+        }
+    }
+    ++numRasterizedTriangles;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Builds each hierarchical-Z level from the maximum depth of 2x2 texels of the
+ * level below.  Must be called after adding occluders, and before isOccluded().
+ */
+void OcclusionBuffer::buildHiZ() {
+    for(size_t k = 1; k < levels.size(); ++k) {
+        const Level & source = levels[k - 1];
+        Level & level = levels[k];
+
+        for(uint32 y = 0; y < level.height; ++y) {
+            const float * row0 = &source.depths[(2 * y) * source.width];
+            const float * row1 = (2 * y + 1 < source.height) ?
+                    row0 + source.width : row0;
+            float * out = &level.depths[y * level.width];
+
+            uint32 x = 0;
+#if defined(RIGID3D_SIMD_X86)
+            if (useSse()) {
+                // Eight source texels of two rows reduce to four texels.
+                for(; 2 * x + 8 <= source.width; x += 4) {
+                    const __m128 a = _mm_max_ps(_mm_loadu_ps(row0 + 2 * x),
+                            _mm_loadu_ps(row1 + 2 * x));
+                    const __m128 b = _mm_max_ps(_mm_loadu_ps(row0 + 2 * x + 4),
+                            _mm_loadu_ps(row1 + 2 * x + 4));
+                    _mm_storeu_ps(out + x, _mm_max_ps(
+                            _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)),
+                            _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))));
+                }
+            }
+#endif
+            for(; x < level.width; ++x) {
+                const uint32 x0 = 2 * x;
+                const uint32 x1 = min(x0 + 1, source.width - 1);
+                out[x] = max(max(row0[x0], row0[x1]), max(row1[x0], row1[x1]));
+            }
+        }
+    }
+    hiZIsCurrent = true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if 'aabb', given in world space, is hidden behind the
+ * occluders.  AABBs crossing the near plane, or entirely off screen, are never
+ * reported occluded.
+ *
+ * @throws Rigid3DException if occluders were added since the last buildHiZ().
+ */
+bool OcclusionBuffer::isOccluded(const AABB & aabb) const {
+    if (!hiZIsCurrent) {
+        throw Rigid3DException("buildHiZ() must follow the last occluder within "
+                "method OcclusionBuffer::isOccluded");
+    }
+
+    float minX = float(width);
+    float maxX = 0.0f;
+    float minY = float(height);
+    float maxY = 0.0f;
+    float minDepth = 1.0f;
+    for(int corner = 0; corner < 8; ++corner) {
+        const vec4 point((corner & 1) ? aabb.maxBounds.x : aabb.minBounds.x,
+                         (corner & 2) ? aabb.maxBounds.y : aabb.minBounds.y,
+                         (corner & 4) ? aabb.maxBounds.z : aabb.minBounds.z,
+                         1.0f);
+        const vec4 clip = viewProjectionMatrix * point;
+        if (!(clip.w > 0.0f) || !isInside(clip)) {
+            return false;
+        }
+
+        const float invW = 1.0f / clip.w;
+        const float x = (clip.x * invW * 0.5f + 0.5f) * float(width);
+        const float y = (clip.y * invW * 0.5f + 0.5f) * float(height);
+        minX = min(minX, x);
+        maxX = max(maxX, x);
+        minY = min(minY, y);
+        maxY = max(maxY, y);
+        minDepth = min(minDepth, clip.z * invW * 0.5f + 0.5f);
+    }
+    if (maxX < 0.0f || maxY < 0.0f || minX >= float(width) || minY >= float(height)) {
+        return false;
+    }
+
+    const uint32 x0 = toTexel(minX, width);
+    const uint32 x1 = toTexel(maxX, width);
+    const uint32 y0 = toTexel(minY, height);
+    const uint32 y1 = toTexel(maxY, height);
+
+    // Coarsest level at which the AABB covers at most 2x2 texels.
+    uint32 k = 0;
+    while (k + 1 < levels.size() &&
+            ((x1 >> k) - (x0 >> k) > 1 || (y1 >> k) - (y0 >> k) > 1)) {
+        ++k;
+    }
+
+    const Level & level = levels[k];
+    for(uint32 y = y0 >> k; y <= (y1 >> k); ++y) {
+        for(uint32 x = x0 >> k; x <= (x1 >> k); ++x) {
+            if (minDepth <= level.depths[y * level.width + x]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 OcclusionBuffer::getWidth() const {
+    return width;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 OcclusionBuffer::getHeight() const {
+    return height;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return depth at pixel (x, y), with y = 0 at the bottom of the view.
+ */
+float OcclusionBuffer::getDepth(uint32 x, uint32 y) const {
+    return levels[0].depths[y * width + x];
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of hierarchical-Z levels, including the full resolution depth
+ * buffer as level 0, down to a single texel.
+ */
+uint32 OcclusionBuffer::getNumHiZLevels() const {
+    return uint32(levels.size());
+}
+
+//----------------------------------------------------------------------------------------
+float OcclusionBuffer::getHiZDepth(uint32 level, uint32 x, uint32 y) const {
+    return levels[level].depths[y * levels[level].width + x];
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of triangles, after near plane clipping, rasterized since the
+ * last clear().
+ */
+uint32 OcclusionBuffer::getNumRasterizedTriangles() const {
+    return numRasterizedTriangles;
+}
+
+}
@@ -0,0 +1,109 @@
+/**
+ * @brief OcclusionBuffer
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_OCCLUSION_BUFFER_HPP_
+#define RIGID3D_OCCLUSION_BUFFER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    struct AABB;
+    class Mesh;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Low resolution CPU depth buffer of a few large occluders, used to
+     * cull objects hidden behind them.
+     *
+     * Each frame, the occluders are rasterized into the depth buffer, a
+     * hierarchical-Z pyramid of maximum depths is built over it, and occludee
+     * AABBs are then tested against the coarsest pyramid level at which they
+     * cover at most 2x2 texels:
+     * \code{.cpp}
+     *  occlusion.clear(camera.getProjectionMatrix() * camera.getViewMatrix());
+     *  occlusion.addOccluder(wallMesh, wallModelMatrix);
+     *  occlusion.buildHiZ();
+     *
+     *  for(uint32 i = 0; i < numObjects; ++i) {
+     *      if (!occlusion.isOccluded(worldBounds[i])) {
+     *          queue.submit(renderables[i]);
+     *      }
+     *  }
+     * \endcode
+     *
+     * Rasterization and pyramid building use SSE unless getSimdLevel() is
+     * SimdLevel::Scalar.  Nothing here touches OpenGL, so the whole pass can
+     * run on a worker thread.
+     *
+     * Depths are window space, in [0, 1].  Occluders are clipped against the
+     * near plane, and pixels are covered when their centers are, so an
+     * occludee is only reported occluded when every texel it overlaps holds an
+     * occluder in front of it.
+     */
+    class OcclusionBuffer {
+    public:
+        // 'width' must be a multiple of 4.
+        OcclusionBuffer(uint32 width = 256, uint32 height = 128);
+
+        ~OcclusionBuffer();
+
+        void clear(const mat4 & viewProjectionMatrix);
+
+        void addOccluder(const vec3 * positions, size_t numVertices, const mat4 & modelMatrix);
+
+        void addOccluder(const vec3 * positions, const uint32 * indices, size_t numIndices,
+                const mat4 & modelMatrix);
+
+        void addOccluder(const Mesh & mesh, const mat4 & modelMatrix);
+
+        void buildHiZ();
+
+        bool isOccluded(const AABB & aabb) const;
+
+        uint32 getWidth() const;
+        uint32 getHeight() const;
+        float getDepth(uint32 x, uint32 y) const;
+
+        uint32 getNumHiZLevels() const;
+        float getHiZDepth(uint32 level, uint32 x, uint32 y) const;
+
+        uint32 getNumRasterizedTriangles() const;
+
+    private:
+        struct Level {
+            uint32 width;
+            uint32 height;
+            std::vector<float> depths;
+        };
+
+        template <class IndexAt>
+        void rasterizeTriangles(const vec3 * positions, size_t numIndices,
+                const mat4 & modelMatrix, const IndexAt & indexAt);
+
+        void clipAndRasterize(const vec4 & a, const vec4 & b, const vec4 & c);
+
+        void rasterize(const vec3 & a, const vec3 & b, const vec3 & c);
+
+        uint32 width;
+        uint32 height;
+        mat4 viewProjectionMatrix;
+
+        // levels[0] is the depth buffer, and each further level holds the
+        // maximum depth of 2x2 texels of the level before.
+        std::vector<Level> levels;
+        bool hiZIsCurrent;
+
+        uint32 numRasterizedTriangles;
+    };
+
+}
+
+#endif /* RIGID3D_OCCLUSION_BUFFER_HPP_ */
@@ -0,0 +1,450 @@
+#include "RenderQueue.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/MeshConsolidator.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include <Rigid3D/Graphics/UniformRingBuffer.hpp>
+
+#include <cstddef>
+#include <cstring>
+
+namespace Rigid3D {
+
+namespace {
+
+    // Widths of the sort key fields, from most to least significant.
+    const uint32 passBits = 4;
+    const uint32 programBits = 10;
+    const uint32 vertexArrayBits = 10;
+    const uint32 materialBits = 12;
+    const uint32 batchBits = 12;
+    const uint32 depthBits = 16;
+
+    const uint32 stateBits = programBits + vertexArrayBits + materialBits + batchBits;
+
+    inline uint64_t mask(uint32 value, uint32 numBits) {
+        return uint64_t(value) & ((uint64_t(1) << numBits) - 1);
+    }
+
+    // Positive floats compare the same as their bit patterns, so the top bits
+    // of those 31 bits give a monotonic fixed point depth.
+    inline uint32 quantizeDepth(float depth) {
+        if (!(depth > 0.0f)) {
+            return 0;
+        }
+        uint32 bits;
+        memcpy(&bits, &depth, sizeof(bits));
+        return bits >> (31 - depthBits);
+    }
+
+    // FNV-1a hash of the bytes of 'material'.
+    uint64_t hashMaterial(const MaterialProperties & material) {
+        const uint8 * bytes = reinterpret_cast<const uint8 *>(&material);
+        uint64_t hash = 14695981039346656037ull;
+        for(size_t i = 0; i < sizeof(MaterialProperties); ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    template <typename Key>
+    uint32 getId(std::unordered_map<Key, uint32> & ids, const Key & key) {
+        auto result = ids.insert(std::make_pair(key, uint32(ids.size())));
+        return result.first->second;
+    }
+
+    // Items that can share an instanced draw call.
+    inline bool isSameBatch(const RenderQueue::Item & a, const RenderQueue::Item & b) {
+        return a.pass == b.pass && a.programId == b.programId &&
+                a.vertexArrayId == b.vertexArrayId && a.materialId == b.materialId &&
+                a.batchId == b.batchId;
+    }
+
+    // Items that can share a multi-draw call, given both are drawn instanced.
+    inline bool isSameBucket(const RenderQueue::Item & a, const RenderQueue::Item & b) {
+        return a.pass == b.pass && a.programId == b.programId &&
+                a.vertexArrayId == b.vertexArrayId && a.materialId == b.materialId &&
+                a.renderable->getBatchInfo()->indexSize ==
+                b.renderable->getBatchInfo()->indexSize;
+    }
+
+    const uint32 noInstances = 0xFFFFFFFFu;
+
+}
+
+const uint32 RenderQueue::numPasses;
+const GLuint RenderQueue::instanceAttribLocation;
+
+//----------------------------------------------------------------------------------------
+RenderQueue::RenderQueue()
+    : multiDraw(false),
+      instanceBuffer(0)
+{
+    for(uint32 i = 0; i < numPasses; ++i) {
+        depthOrders[i] = DepthOrder::FrontToBack;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+RenderQueue::~RenderQueue() {
+    if (instanceBuffer != 0) {
+        glDeleteBuffers(1, &instanceBuffer);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sets how Renderables submitted to 'pass' are ordered by depth.  All passes
+ * default to DepthOrder::FrontToBack.
+ *
+ * @throws Rigid3DException if 'pass' is not less than numPasses.
+ */
+void RenderQueue::setDepthOrder(uint32 pass, DepthOrder order) {
+    if (pass >= numPasses) {
+        throw Rigid3DException("Pass out of range within method RenderQueue::setDepthOrder");
+    }
+    depthOrders[pass] = order;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Enables or disables drawing the runs of instanced ShaderPrograms with
+ * glMultiDraw*Indirect.  Disabled by default, and stays disabled if the current
+ * context does not support multi-draws.
+ */
+void RenderQueue::setMultiDraw(bool enabled) {
+    multiDraw = enabled && MultiDrawBuilder::isSupported();
+}
+
+//----------------------------------------------------------------------------------------
+bool RenderQueue::isMultiDrawEnabled() const {
+    return multiDraw;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Queues 'renderable' to be drawn in 'pass'.  Passes are drawn in increasing
+ * order.  Renderables without a VAO, ShaderProgram or BatchInfo are ignored.
+ *
+ * @throws Rigid3DException if 'pass' is not less than numPasses.
+ */
+void RenderQueue::submit(Renderable & renderable, uint32 pass) {
+    if (pass >= numPasses) {
+        throw Rigid3DException("Pass out of range within method RenderQueue::submit");
+    }
+    if (!renderable.isComplete()) {
+        return;
+    }
+
+    Item item;
+    item.sortKey = 0;
+    item.renderable = &renderable;
+    item.pass = pass;
+    item.programId = getId(programIds,
+            static_cast<const ShaderProgram *>(renderable.getShaderProgram()));
+    item.vertexArrayId = getId(vertexArrayIds, renderable.getVertexArray());
+    item.materialId = getMaterialId(renderable.getMaterial());
+    item.batchId = getId(batchIds, renderable.getBatchInfo());
+    items.push_back(item);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Removes all queued Renderables, ready for the next frame, and forgets the IDs
+ * given to their state, so that materials animated from frame to frame do not
+ * use up IDs.
+ */
+void RenderQueue::clear() {
+    items.clear();
+    programIds.clear();
+    vertexArrayIds.clear();
+    materialIds.clear();
+    batchIds.clear();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Builds each queued Renderable's sort key, using its depth along the view
+ * direction of 'viewMatrix', and sorts the queue by key.  Called by execute().
+ */
+void RenderQueue::sort(const mat4 & viewMatrix) {
+    for(Item & item : items) {
+        const vec4 origin = viewMatrix * item.renderable->getModelMatrix()[3];
+        uint64_t depth = quantizeDepth(-origin.z);
+
+        uint64_t state = mask(item.programId, programBits);
+        state = (state << vertexArrayBits) | mask(item.vertexArrayId, vertexArrayBits);
+        state = (state << materialBits) | mask(item.materialId, materialBits);
+        state = (state << batchBits) | mask(item.batchId, batchBits);
+
+        uint64_t key = uint64_t(item.pass) << (64 - passBits);
+        if (depthOrders[item.pass] == DepthOrder::BackToFront) {
+            depth = ((uint64_t(1) << depthBits) - 1) - depth;
+            key |= (depth << stateBits) | state;
+        } else {
+            key |= (state << depthBits) | depth;
+        }
+        item.sortKey = key;
+    }
+    radixSort();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sorts 'items' by key, one byte at a time starting from the least significant.
+ * The histograms of all eight bytes are built in a single pass, and bytes that
+ * are the same in every key are skipped.
+ */
+void RenderQueue::radixSort() {
+    const size_t numItems = items.size();
+    if (numItems < 2) {
+        return;
+    }
+    scratch.resize(numItems);
+
+    uint32 counts[8][256];
+    memset(counts, 0, sizeof(counts));
+    for(const Item & item : items) {
+        for(uint32 digit = 0; digit < 8; ++digit) {
+            ++counts[digit][(item.sortKey >> (8 * digit)) & 0xFF];
+        }
+    }
+
+    for(uint32 digit = 0; digit < 8; ++digit) {
+        const uint32 shift = 8 * digit;
+        uint32 * count = counts[digit];
+        if (count[(items[0].sortKey >> shift) & 0xFF] == numItems) {
+            continue;
+        }
+
+        uint32 offset = 0;
+        for(uint32 i = 0; i < 256; ++i) {
+            const uint32 n = count[i];
+            count[i] = offset;
+            offset += n;
+        }
+        for(const Item & item : items) {
+            scratch[count[(item.sortKey >> shift) & 0xFF]++] = item;
+        }
+        items.swap(scratch);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sorts and draws the queue, setting each Renderable's uniforms with
+ * ShaderProgram::setUniform.  Material uniforms are only set when the material
+ * or ShaderProgram differs from the previous draw's.
+ */
+void RenderQueue::execute(const RenderContext & context) {
+    execute(context, nullptr);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sorts and draws the queue, with each Renderable's uniforms written to
+ * 'uniformBuffer' as an ObjectUniforms block.  The FrameUniforms block must
+ * already be bound.
+ */
+void RenderQueue::execute(const RenderContext & context, UniformRingBuffer & uniformBuffer) {
+    execute(context, &uniformBuffer);
+}
+
+//----------------------------------------------------------------------------------------
+void RenderQueue::execute(const RenderContext & context, UniformRingBuffer * uniformBuffer) {
+    sort(context.viewMatrix);
+    buildDrawRuns(context.viewMatrix);
+    uploadInstanceData();
+    if (drawCommands.getCommands().size() > 0) {
+        drawCommands.upload();
+    }
+    stats = RenderStats();
+
+    const Item * previous = nullptr;
+    for(const DrawRun & run : runs) {
+        const Item & item = items[run.firstItem];
+        Renderable & renderable = *item.renderable;
+
+        const bool programChanged = previous == nullptr ||
+                item.programId != previous->programId;
+        if (programChanged) {
+            renderable.getShaderProgram()->enable();
+            ++stats.numProgramChanges;
+        }
+        if (previous == nullptr || item.vertexArrayId != previous->vertexArrayId) {
+            glBindVertexArray(renderable.getVertexArray());
+            ++stats.numVertexArrayChanges;
+        }
+
+        // Instanced programs read their matrices per instance, and every other
+        // uniform is shared by the run.
+        if (uniformBuffer != nullptr) {
+            renderable.writeObjectUniforms(context, *uniformBuffer);
+        } else {
+            renderable.loadTransformUniforms(context);
+            if (programChanged || item.materialId != previous->materialId) {
+                renderable.loadMaterialUniforms();
+                ++stats.numMaterialChanges;
+            }
+        }
+
+        if (run.numCommands > 0) {
+            // Commands carry their own base instances.
+            attachInstanceBuffer(0);
+            drawCommands.draw(run.firstCommand, run.numCommands,
+                    renderable.getBatchInfo()->indexSize);
+            ++stats.numMultiDrawCalls;
+            stats.numDrawCommands += run.numCommands;
+        } else if (run.baseInstance == noInstances) {
+            renderable.drawBatch();
+        } else {
+            attachInstanceBuffer(run.baseInstance);
+            renderable.drawBatch(run.numItems);
+            ++stats.numInstancedDrawCalls;
+        }
+        ++stats.numDrawCalls;
+        previous = &items[run.firstItem + run.numItems - 1];
+    }
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Splits the sorted items into runs drawn with one draw call each, and gathers
+ * the per-instance data of runs drawn instanced.  With multi-draw enabled,
+ * instanced runs also get a draw command, and runs that can share a multi-draw
+ * call are merged.
+ */
+void RenderQueue::buildDrawRuns(const mat4 & viewMatrix) {
+    runs.clear();
+    instanceData.clear();
+    drawCommands.clear();
+
+    const uint32 numItems = uint32(items.size());
+    for(uint32 first = 0; first < numItems; ) {
+        uint32 end = first + 1;
+        while (end < numItems && isSameBatch(items[first], items[end])) {
+            ++end;
+        }
+
+        const ShaderProgram * program = items[first].renderable->getShaderProgram();
+        const bool instanced = (end - first > 1 || multiDraw) &&
+                program->findAttribLocation("InstanceModelViewMatrix") ==
+                GLint(instanceAttribLocation);
+        if (!instanced) {
+            for(uint32 i = first; i < end; ++i) {
+                DrawRun run = {i, 1, noInstances, 0, 0};
+                runs.push_back(run);
+            }
+            first = end;
+            continue;
+        }
+
+        const uint32 baseInstance = uint32(instanceData.size());
+        if (multiDraw) {
+            const uint32 command = drawCommands.addCommand(
+                    *items[first].renderable->getBatchInfo(), end - first, baseInstance);
+            if (!runs.empty() && runs.back().numCommands > 0 &&
+                    isSameBucket(items[runs.back().firstItem], items[first])) {
+                runs.back().numItems += end - first;
+                ++runs.back().numCommands;
+            } else {
+                DrawRun run = {first, end - first, baseInstance, command, 1};
+                runs.push_back(run);
+            }
+        } else {
+            DrawRun run = {first, end - first, baseInstance, 0, 0};
+            runs.push_back(run);
+        }
+
+        for(uint32 i = first; i < end; ++i) {
+            const mat4 modelView = viewMatrix * items[i].renderable->getModelMatrix();
+            const mat3 normalMatrix = glm::transpose(glm::inverse(mat3(modelView)));
+
+            InstanceData instance;
+            instance.modelViewMatrix = modelView;
+            for(int c = 0; c < 3; ++c) {
+                instance.normalMatrix[c] = vec4(normalMatrix[c], 0.0f);
+            }
+            instanceData.push_back(instance);
+        }
+        first = end;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Streams this frame's instance data into the instance buffer, orphaning last
+ * frame's storage so the upload never waits on draws still reading it.
+ */
+void RenderQueue::uploadInstanceData() {
+    if (instanceData.empty()) {
+        return;
+    }
+    if (instanceBuffer == 0) {
+        glGenBuffers(1, &instanceBuffer);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, instanceData.size() * sizeof(InstanceData),
+            instanceData.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Points the instanced attributes of the bound VAO at the instance buffer,
+ * starting from instance 'baseInstance'.  Every VAO is set up again on every
+ * instanced draw, so that VAOs recreated under a deleted one's name are too.
+ */
+void RenderQueue::attachInstanceBuffer(uint32 baseInstance) {
+    const GLsizei stride = sizeof(InstanceData);
+    const size_t base = size_t(baseInstance) * sizeof(InstanceData);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    for(GLuint c = 0; c < 4; ++c) {
+        const size_t offset = base + offsetof(InstanceData, modelViewMatrix) +
+                c * sizeof(vec4);
+        glVertexAttribPointer(instanceAttribLocation + c, 4, GL_FLOAT, GL_FALSE, stride,
+                reinterpret_cast<const GLvoid *>(offset));
+        glVertexAttribDivisor(instanceAttribLocation + c, 1);
+        glEnableVertexAttribArray(instanceAttribLocation + c);
+    }
+    for(GLuint c = 0; c < 3; ++c) {
+        const GLuint location = instanceAttribLocation + 4 + c;
+        const size_t offset = base + offsetof(InstanceData, normalMatrix) +
+                c * sizeof(vec4);
+        glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, stride,
+                reinterpret_cast<const GLvoid *>(offset));
+        glVertexAttribDivisor(location, 1);
+        glEnableVertexAttribArray(location);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the queued Renderables, in draw order after sort() or execute().
+ */
+const std::vector<RenderQueue::Item> & RenderQueue::getItems() const {
+    return items;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return counts of the draw calls and state changes made by the last execute().
+ */
+const RenderStats & RenderQueue::getStats() const {
+    return stats;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Equal materials share an ID, so Renderables with separate copies of the same
+ * MaterialProperties still sort together.
+ */
+uint32 RenderQueue::getMaterialId(const MaterialProperties & material) {
+    return getId(materialIds, hashMaterial(material));
+}
+
+}
@@ -0,0 +1,206 @@
+/**
+ * @brief RenderQueue
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_RENDER_QUEUE_HPP_
+#define RIGID3D_RENDER_QUEUE_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Graphics/MultiDrawBuilder.hpp>
+#include <Rigid3D/Graphics/Renderable.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class UniformRingBuffer;
+}
+
+namespace Rigid3D {
+
+    /**
+     * Counts of the draw calls and GL state changes made by one
+     * RenderQueue::execute().
+     */
+    struct RenderStats {
+        uint32 numDrawCalls;
+        uint32 numProgramChanges;
+        uint32 numVertexArrayChanges;
+        uint32 numMaterialChanges;
+
+        // Draw calls above that drew more than one instance.
+        uint32 numInstancedDrawCalls;
+
+        // Draw calls above that were multi-draws, and the draws they issued.
+        uint32 numMultiDrawCalls;
+        uint32 numDrawCommands;
+
+        RenderStats()
+                : numDrawCalls(0), numProgramChanges(0), numVertexArrayChanges(0),
+                  numMaterialChanges(0), numInstancedDrawCalls(0), numMultiDrawCalls(0),
+                  numDrawCommands(0) { }
+
+        uint32 getNumStateChanges() const {
+            return numProgramChanges + numVertexArrayChanges + numMaterialChanges;
+        }
+    };
+
+    /**
+     * Order in which Renderables of one pass are drawn by depth.
+     */
+    enum class DepthOrder {
+        // Grouped by state first, then front to back to make use of early depth
+        // rejection.  For opaque geometry.
+        FrontToBack,
+
+        // Strictly back to front, then grouped by state.  For blended geometry.
+        BackToFront
+    };
+
+    /**
+     * Per-instance vertex attributes streamed by RenderQueue for instanced
+     * draws, read by vertex shaders as:
+     * \code{.glsl}
+     *  layout (location = 8) in mat4 InstanceModelViewMatrix;
+     *  layout (location = 12) in mat3 InstanceNormalMatrix;
+     * \endcode
+     * Each column of the normal matrix is padded to a vec4.
+     */
+    struct InstanceData {
+        mat4 modelViewMatrix;
+        vec4 normalMatrix[3];
+    };
+
+    /**
+     * @brief Collects the Renderables to draw in a frame, and draws them sorted
+     * so that GL state changes only when it has to.
+     *
+     * Each submitted Renderable gets a 64-bit sort key.  From the most
+     * significant bits down, the key holds the pass, ShaderProgram, VAO,
+     * material, BatchInfo and view depth, so sorting the keys groups Renderables by state,
+     * with the most expensive state changes the rarest.  Passes whose
+     * DepthOrder is BackToFront move depth up to just below the pass.
+     *
+     * Keys are sorted with an LSD radix sort, which skips every byte that all
+     * keys share, and the queue is then executed in order, binding a program,
+     * VAO or material only when it differs from the previous draw's.
+     * \code{.cpp}
+     *  queue.clear();
+     *  for(Renderable & renderable : renderables) {
+     *      queue.submit(renderable);
+     *  }
+     *  queue.submit(window, 1);
+     *  queue.execute(context);
+     * \endcode
+     *
+     * Consecutive Renderables sharing a pass, program, VAO, material and
+     * BatchInfo are drawn with one instanced draw call when their ShaderProgram
+     * has the InstanceModelViewMatrix attribute of InstanceData.  Their
+     * matrices are uploaded together once per execute() into an instance buffer,
+     * and each instanced draw points the attributes of its VAO at locations
+     * instanceAttribLocation onwards at its own instances in that buffer.
+     * Instanced draws therefore need no base instance, and only OpenGL 3.3.
+     *
+     * With setMultiDraw(true), every run of an instanced ShaderProgram becomes
+     * a command of a MultiDrawBuilder instead, even a run of one, and
+     * consecutive runs that differ only in BatchInfo are drawn with a single
+     * multi-draw call.  This requires all BatchInfos drawn with a VAO to come
+     * from the one MeshConsolidator.  Where MultiDrawBuilder::isSupported() is
+     * false, setMultiDraw(true) leaves multi-draw disabled, and runs are drawn
+     * instanced one by one.
+     *
+     * @note Renderables must stay alive until execute() returns.
+     */
+    class RenderQueue {
+    public:
+        static const uint32 numPasses = 16;
+        static const GLuint instanceAttribLocation = 8;
+
+        struct Item {
+            uint64_t sortKey;
+            Renderable * renderable;
+            uint32 pass;
+            uint32 programId;
+            uint32 vertexArrayId;
+            uint32 materialId;
+            uint32 batchId;
+        };
+
+        RenderQueue();
+
+        ~RenderQueue();
+
+        void setDepthOrder(uint32 pass, DepthOrder order);
+
+        void setMultiDraw(bool enabled);
+
+        bool isMultiDrawEnabled() const;
+
+        void submit(Renderable & renderable, uint32 pass = 0);
+
+        void clear();
+
+        void sort(const mat4 & viewMatrix);
+
+        void execute(const RenderContext & context);
+
+        void execute(const RenderContext & context, UniformRingBuffer & uniformBuffer);
+
+        const std::vector<Item> & getItems() const;
+
+        const RenderStats & getStats() const;
+
+    private:
+        RenderQueue(const RenderQueue &);
+        RenderQueue & operator = (const RenderQueue &);
+
+        // Consecutive items drawn with one draw call.  Multi-draw runs have
+        // commands, and other runs have none.
+        struct DrawRun {
+            uint32 firstItem;
+            uint32 numItems;
+            uint32 baseInstance;
+            uint32 firstCommand;
+            uint32 numCommands;
+        };
+
+        DepthOrder depthOrders[numPasses];
+        bool multiDraw;
+
+        std::vector<Item> items;
+        std::vector<Item> scratch;
+
+        // Small integer IDs packed into sort keys, assigned in order of first
+        // submission within a frame.  Past the width of their key field, IDs
+        // share key bits, which only weakens grouping, as draws compare the
+        // whole IDs.
+        std::unordered_map<const ShaderProgram *, uint32> programIds;
+        std::unordered_map<GLuint, uint32> vertexArrayIds;
+        std::unordered_map<uint64_t, uint32> materialIds;
+        std::unordered_map<const BatchInfo *, uint32> batchIds;
+
+        std::vector<DrawRun> runs;
+        std::vector<InstanceData> instanceData;
+        GLuint instanceBuffer;
+        MultiDrawBuilder drawCommands;
+
+        RenderStats stats;
+
+        uint32 getMaterialId(const MaterialProperties & material);
+
+        void radixSort();
+
+        void buildDrawRuns(const mat4 & viewMatrix);
+        void uploadInstanceData();
+        void attachInstanceBuffer(uint32 baseInstance);
+
+        void execute(const RenderContext & context, UniformRingBuffer * uniformBuffer);
+    };
+
+}
+
+#endif /* RIGID3D_RENDER_QUEUE_HPP_ */
@@ -3,6 +3,8 @@
 #include <Rigid3D/Graphics/ShaderProgram.hpp>
 #include <Rigid3D/Graphics/MeshConsolidator.hpp>
 #include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/UniformBlocks.hpp>
+#include <Rigid3D/Graphics/UniformRingBuffer.hpp>
 
 namespace Rigid3D {
 
@@ -12,16 +14,20 @@ Renderable::Renderable(const GLuint * vao,
                        const BatchInfo * batchInfo)
     : vao(const_cast<GLuint *>(vao)),
       shaderProgram(const_cast<ShaderProgram *>(shaderProgram)),
-      batchInfo(const_cast<BatchInfo *>(batchInfo)) {
-
+      batchInfo(const_cast<BatchInfo *>(batchInfo)),
+      uniformProgram(nullptr),
+      uniformLinkGeneration(0) {
+    init();
 }
 
 //---------------------------------------------------------------------------------------
 Renderable::Renderable()
     : vao(nullptr),
       shaderProgram(nullptr),
-      batchInfo(nullptr) {
-
+      batchInfo(nullptr),
+      uniformProgram(nullptr),
+      uniformLinkGeneration(0) {
+    init();
 }
 
 //---------------------------------------------------------------------------------------
@@ -41,30 +47,109 @@ Renderable::~Renderable() {
 
 //---------------------------------------------------------------------------------------
 void Renderable::render(const RenderContext & context) {
-    if (vao == nullptr || shaderProgram == nullptr || batchInfo == nullptr) {
+    if (!isComplete()) {
         return;
     }
 
-    loadUniformData(context);
-
-    // 1. Get and save currently bound VAO.
-    // 2. Bind local VAO.
-    // 3. Enable ShaderProgram
-    // 4. Call glDraw*(...)
-    // 5. Disable ShaderProgram
-    // 6. Bind previous VAO.
+    loadTransformUniforms(context);
+    loadMaterialUniforms();
 
-    GLint prev_vao;
-    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prev_vao);
     glBindVertexArray(*vao);
+    shaderProgram->enable();
+    drawBatch();
+}
 
+//---------------------------------------------------------------------------------------
+/**
+ * Writes this Renderable's ObjectUniforms block into 'uniformBuffer', which must
+ * be within a frame, and draws with the block bound by offset.  The caller binds
+ * the FrameUniforms block once per frame.
+ */
+void Renderable::render(const RenderContext & context, UniformRingBuffer & uniformBuffer) {
+    if (!isComplete()) {
+        return;
+    }
+
+    writeObjectUniforms(context, uniformBuffer);
+
+    glBindVertexArray(*vao);
     shaderProgram->enable();
+    drawBatch();
+}
+
+//---------------------------------------------------------------------------------------
+/**
+ * Issues the draw call for this Renderable's BatchInfo, using whichever VAO and
+ * ShaderProgram are currently bound.
+ */
+void Renderable::drawBatch() const {
+    if (batchInfo->isIndexed()) {
+        // Indices are read from the GL_ELEMENT_ARRAY_BUFFER bound to the VAO.
+        GLenum indexType = (batchInfo->indexSize == 2) ? GL_UNSIGNED_SHORT :
+                                                         GL_UNSIGNED_INT;
+        size_t byteOffset = size_t(batchInfo->startIndex) * batchInfo->indexSize;
+        glDrawElements(GL_TRIANGLES, batchInfo->numIndices, indexType,
+                reinterpret_cast<const GLvoid *>(byteOffset));
+    } else {
         glDrawArrays(GL_TRIANGLES, batchInfo->startIndex, batchInfo->numIndices);
-    shaderProgram->disable();
+    }
+
+    CHECK_GL_ERRORS;
+}
+
+//---------------------------------------------------------------------------------------
+/**
+ * Draws 'numInstances' instances of this Renderable's BatchInfo.  Instanced
+ * vertex attributes are read from the first element their pointers address, so
+ * callers drawing from the middle of an instance buffer offset the pointers,
+ * which needs only OpenGL 3.3, unlike base instances.
+ */
+void Renderable::drawBatch(uint32 numInstances) const {
+    if (batchInfo->isIndexed()) {
+        GLenum indexType = (batchInfo->indexSize == 2) ? GL_UNSIGNED_SHORT :
+                                                         GL_UNSIGNED_INT;
+        size_t byteOffset = size_t(batchInfo->startIndex) * batchInfo->indexSize;
+        glDrawElementsInstanced(GL_TRIANGLES, batchInfo->numIndices, indexType,
+                reinterpret_cast<const GLvoid *>(byteOffset), numInstances);
+    } else {
+        glDrawArraysInstanced(GL_TRIANGLES, batchInfo->startIndex, batchInfo->numIndices,
+                numInstances);
+    }
+
+    CHECK_GL_ERRORS;
+}
+
+//---------------------------------------------------------------------------------------
+/**
+ * @return true if a VAO, ShaderProgram and BatchInfo have all been set.
+ */
+bool Renderable::isComplete() const {
+    return vao != nullptr && shaderProgram != nullptr && batchInfo != nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+GLuint Renderable::getVertexArray() const {
+    return (vao != nullptr) ? *vao : 0;
+}
 
-    glBindVertexArray(prev_vao);
+//---------------------------------------------------------------------------------------
+ShaderProgram * Renderable::getShaderProgram() const {
+    return shaderProgram;
+}
 
-    Rigid3D::checkGLErrors(__FILE__, __LINE__);
+//---------------------------------------------------------------------------------------
+const BatchInfo * Renderable::getBatchInfo() const {
+    return batchInfo;
+}
+
+//---------------------------------------------------------------------------------------
+const MaterialProperties & Renderable::getMaterial() const {
+    return material;
+}
+
+//---------------------------------------------------------------------------------------
+mat4 Renderable::getModelMatrix() {
+    return modelTransform.getModelMatrix();
 }
 
 //---------------------------------------------------------------------------------------
@@ -120,20 +205,81 @@ void Renderable::setShininessFactor(float shininessfactor) {
 }
 
 //---------------------------------------------------------------------------------------
-void Renderable::loadUniformData(const RenderContext & context) {
+void Renderable::findUniformLocations() {
+    // Instanced programs take these two per instance instead.
+    uniforms.modelViewMatrix = shaderProgram->findUniformLocation("ModelViewMatrix");
+    uniforms.projectionMatrix = shaderProgram->getUniformLocation("ProjectionMatrix");
+    uniforms.normalMatrix = shaderProgram->findUniformLocation("NormalMatrix");
+
+    uniforms.emission = shaderProgram->getUniformLocation("material.emission");
+    uniforms.Ka = shaderProgram->getUniformLocation("material.Ka");
+    uniforms.Kd = shaderProgram->getUniformLocation("material.Kd");
+    uniforms.Ks = shaderProgram->getUniformLocation("material.Ks");
+    uniforms.shininessFactor = shaderProgram->getUniformLocation("material.shininessFactor");
+
+    uniformProgram = shaderProgram;
+    uniformLinkGeneration = shaderProgram->getLinkGeneration();
+}
+
+//---------------------------------------------------------------------------------------
+/**
+ * @return true if the cached uniform locations belong to the current ShaderProgram,
+ * and it has not been relinked since they were looked up.
+ */
+bool Renderable::hasUniformLocations() const {
+    return uniformProgram == shaderProgram &&
+            uniformLinkGeneration == shaderProgram->getLinkGeneration();
+}
+
+//---------------------------------------------------------------------------------------
+void Renderable::loadTransformUniforms(const RenderContext & context) {
+    if (!hasUniformLocations()) {
+        findUniformLocations();
+    }
     mat4 modelView = context.viewMatrix * modelTransform.getModelMatrix();
 
-    shaderProgram->setUniform("ModelViewMatrix", modelView);
-    shaderProgram->setUniform("ProjectionMatrix", context.projectionMatrix);
-    shaderProgram->setUniform("NormalMatrix", glm::transpose(glm::inverse(mat3(modelView))));
+    shaderProgram->setUniform(uniforms.modelViewMatrix, modelView);
+    shaderProgram->setUniform(uniforms.projectionMatrix, context.projectionMatrix);
+    shaderProgram->setUniform(uniforms.normalMatrix,
+            glm::transpose(glm::inverse(mat3(modelView))));
+}
 
-    shaderProgram->setUniform("material.emission", material.emission);
-    shaderProgram->setUniform("material.Ka", material.Ka);
-    shaderProgram->setUniform("material.Kd", material.Kd);
-    shaderProgram->setUniform("material.Ks", material.Ks);
-    shaderProgram->setUniform("material.shininessFactor", material.shininessFactor);
+//---------------------------------------------------------------------------------------
+void Renderable::loadMaterialUniforms() {
+    if (!hasUniformLocations()) {
+        findUniformLocations();
+    }
+    shaderProgram->setUniform(uniforms.emission, material.emission);
+    shaderProgram->setUniform(uniforms.Ka, material.Ka);
+    shaderProgram->setUniform(uniforms.Kd, material.Kd);
+    shaderProgram->setUniform(uniforms.Ks, material.Ks);
+    shaderProgram->setUniform(uniforms.shininessFactor, material.shininessFactor);
 }
 
+//---------------------------------------------------------------------------------------
+/**
+ * Writes this Renderable's ObjectUniforms block into 'uniformBuffer', and binds it
+ * to ObjectUniforms::bindingPoint.
+ */
+void Renderable::writeObjectUniforms(const RenderContext & context,
+        UniformRingBuffer & uniformBuffer) {
+    const mat4 modelView = context.viewMatrix * modelTransform.getModelMatrix();
+    const mat3 normalMatrix = glm::transpose(glm::inverse(mat3(modelView)));
 
-} // end namespace GlUtils
+    ObjectUniforms objectUniforms;
+    objectUniforms.modelViewMatrix = modelView;
+    for(int i = 0; i < 3; ++i) {
+        objectUniforms.normalMatrix[i] = vec4(normalMatrix[i], 0.0f);
+    }
+    objectUniforms.emission = vec4(material.emission, 1.0f);
+    objectUniforms.Ka = vec4(material.Ka, 1.0f);
+    objectUniforms.Kd = vec4(material.Kd, 1.0f);
+    objectUniforms.Ks = material.Ks;
+    objectUniforms.shininessFactor = material.shininessFactor;
+    objectUniforms.padding[0] = objectUniforms.padding[1] = 0.0f;
 
+    uniformBuffer.bindBlock(ObjectUniforms::bindingPoint, objectUniforms);
+}
+
+
+} // end namespace GlUtils
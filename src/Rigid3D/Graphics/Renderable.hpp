@@ -17,6 +17,7 @@
 namespace Rigid3D {
     struct BatchInfo;
     class ShaderProgram;
+    class UniformRingBuffer;
 }
 
 namespace Rigid3D {
@@ -54,6 +55,21 @@ namespace Rigid3D {
      *      float shininessFactor;
      *   };
      *   uniform MaterialProperties material;
+     *
+     * ModelViewMatrix and NormalMatrix may be left out of instanced programs,
+     * which RenderQueue feeds per-instance attributes instead.
+     *
+     * @note When rendering with a UniformRingBuffer, the ShaderProgram instead
+     * reads the FrameUniforms and ObjectUniforms blocks of UniformBlocks.hpp,
+     * with the blocks bound to their binding points.
+     *
+     * @note Indexed 'BatchInfo' objects are drawn with glDrawElements, in which
+     * case the VAO must have the index buffer bound to GL_ELEMENT_ARRAY_BUFFER.
+     *
+     * @note render() leaves its VAO bound and its ShaderProgram enabled, so that
+     * consecutive Renderables sharing a program do not switch programs.  Uniform
+     * locations are looked up the first time a ShaderProgram is rendered with,
+     * and again whenever it has been relinked since.
      */
     class Renderable {
     public:
@@ -67,8 +83,26 @@ namespace Rigid3D {
 
         void render(const RenderContext & context);
 
+        void render(const RenderContext & context, UniformRingBuffer & uniformBuffer);
+
         void setShaderProgram(ShaderProgram & shaderProgram);
 
+        // For renderers such as RenderQueue that bind the VAO and ShaderProgram
+        // themselves, and draw with drawBatch().
+        bool isComplete() const;
+        GLuint getVertexArray() const;
+        ShaderProgram * getShaderProgram() const;
+        const BatchInfo * getBatchInfo() const;
+        const MaterialProperties & getMaterial() const;
+        mat4 getModelMatrix();
+
+        void loadTransformUniforms(const RenderContext & context);
+        void loadMaterialUniforms();
+        void writeObjectUniforms(const RenderContext & context,
+                UniformRingBuffer & uniformBuffer);
+        void drawBatch() const;
+        void drawBatch(uint32 numInstances) const;
+
         // Model Transform Operations
         void setPosition(const vec3 & position);
         void setPose(const quat & pose);
@@ -88,8 +122,25 @@ namespace Rigid3D {
         MaterialProperties material;
         ModelTransform modelTransform;
 
+        // Locations of the uniforms listed above, within 'uniformProgram' as of
+        // its link generation 'uniformLinkGeneration'.
+        struct UniformLocations {
+            GLint modelViewMatrix;
+            GLint projectionMatrix;
+            GLint normalMatrix;
+            GLint emission;
+            GLint Ka;
+            GLint Kd;
+            GLint Ks;
+            GLint shininessFactor;
+        };
+        UniformLocations uniforms;
+        const ShaderProgram * uniformProgram;
+        uint32 uniformLinkGeneration;
+
         void init();
-        void loadUniformData(const RenderContext & context);
+        void findUniformLocations();
+        bool hasUniformLocations() const;
 
     };
 }
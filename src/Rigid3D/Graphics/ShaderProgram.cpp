@@ -5,12 +5,16 @@
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+
 #include <fstream>
 
 #include <iostream>
 
 #include <sstream>
 
+#include <vector>
+
 
 namespace Rigid3D {
 
@@ -20,6 +24,9 @@ using std::cerr;
 using std::endl;
 using std::stringstream;
 
+GLuint ShaderProgram::programInUse = 0;
+uint32 ShaderProgram::lastLinkGeneration = 0;
+
 //------------------------------------------------------------------------------------
 ShaderProgram::Shader::Shader()
     : shaderObject(0),
@@ -31,8 +38,7 @@ ShaderProgram::Shader::Shader()
 //------------------------------------------------------------------------------------
 ShaderProgram::ShaderProgram()
         : programObject(0),
-          prevProgramObject(0),
-          activeProgram(0)
+          linkGeneration(0)
 {
 
 }
@@ -76,10 +82,18 @@ void ShaderProgram::extractSourceCodeAndCompile(const Shader & shader) {
 }
 
 //------------------------------------------------------------------------------------
+/**
+* Recompiles each attached shader from its file.  Call link() afterwards for the
+* program to pick up the changes.
+*/
 void ShaderProgram::recompileShaders() {
-    extractSourceCodeAndCompile(vertexShader);
-    extractSourceCodeAndCompile(fragmentShader);
-    extractSourceCodeAndCompile(geometryShader);
+    const Shader * shaders[] = {&vertexShader, &fragmentShader, &geometryShader};
+    for(const Shader * shader : shaders) {
+        // Shaders never attached have no file to read.
+        if (shader->shaderObject != 0) {
+            extractSourceCodeAndCompile(*shader);
+        }
+    }
 }
 
 //------------------------------------------------------------------------------------
@@ -116,24 +130,32 @@ void ShaderProgram::extractSourceCode(string & shaderSource, const string & file
 * Links attached shaders within the ShaderProgram.
 *
 * @note This method must be called once before calling ShaderProgram::enable(), or
-* before attempting to set uniform values
+* before attempting to set uniform values.  Locations previously returned by
+* getUniformLocation() or getAttribLocation() may change when relinking, which
+* getLinkGeneration() reports.
 */
 void ShaderProgram::link() {
-    if(vertexShader.shaderObject != 0) {
-        glAttachShader(programObject, vertexShader.shaderObject);
+    const Shader * shaders[] = {&vertexShader, &fragmentShader, &geometryShader};
+    for(const Shader * shader : shaders) {
+        if(shader->shaderObject != 0) {
+            glAttachShader(programObject, shader->shaderObject);
+        }
     }
 
-    if(fragmentShader.shaderObject != 0) {
-        glAttachShader(programObject, fragmentShader.shaderObject);
-    }
+    glLinkProgram(programObject);
 
-    if(geometryShader.shaderObject != 0) {
-        glAttachShader(programObject, geometryShader.shaderObject);
+    // Detached so that relinking, after recompileShaders(), can attach them again.
+    for(const Shader * shader : shaders) {
+        if(shader->shaderObject != 0) {
+            glDetachShader(programObject, shader->shaderObject);
+        }
     }
-
-    glLinkProgram(programObject);
     checkLinkStatus();
 
+    reflectUniforms();
+    reflectAttributes();
+    linkGeneration = ++lastLinkGeneration;
+
     CHECK_GL_ERRORS;
 }
 
@@ -144,6 +166,9 @@ ShaderProgram::~ShaderProgram() {
 
 //------------------------------------------------------------------------------------
 void ShaderProgram::deleteShaders() {
+    if (programInUse == programObject) {
+        programInUse = 0;
+    }
     glDeleteShader(vertexShader.shaderObject);
     glDeleteShader(fragmentShader.shaderObject);
     glDeleteShader(geometryShader.shaderObject);
@@ -192,14 +217,91 @@ void ShaderProgram::checkCompilationStatus(GLuint shaderObject) {
 
 //------------------------------------------------------------------------------------
 void ShaderProgram::enable() const {
-    glUseProgram(programObject);
-    CHECK_GL_ERRORS;
+    useProgram(programObject);
 }
 
 //------------------------------------------------------------------------------------
 void ShaderProgram::disable() const {
-    glUseProgram((GLuint)NULL);
-    CHECK_GL_ERRORS;
+    useProgram(0);
+}
+
+//------------------------------------------------------------------------------------
+void ShaderProgram::useProgram(GLuint program) const {
+    if (program != programInUse) {
+        glUseProgram(program);
+        programInUse = program;
+        CHECK_GL_ERRORS;
+    }
+}
+
+//------------------------------------------------------------------------------------
+/**
+ * Records the location of every active uniform outside of a uniform block.  Each
+ * element of a uniform array is recorded under its own name, with the first also
+ * recorded under the bare array name.
+ */
+void ShaderProgram::reflectUniforms() {
+    uniformLocations.clear();
+
+    GLint numUniforms = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(programObject, GL_ACTIVE_UNIFORMS, &numUniforms);
+    glGetProgramiv(programObject, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    std::vector<GLchar> nameBuffer(std::max(maxNameLength, 1));
+    for(GLint i = 0; i < numUniforms; ++i) {
+        GLint arraySize;
+        GLenum type;
+        glGetActiveUniform(programObject, GLuint(i), GLsizei(nameBuffer.size()), NULL,
+                &arraySize, &type, nameBuffer.data());
+        string name(nameBuffer.data());
+
+        GLint location = glGetUniformLocation(programObject, name.c_str());
+        if (location == -1) {
+            // Uniform block members have no location.
+            continue;
+        }
+        uniformLocations[name] = location;
+
+        const size_t bracket = name.rfind("[0]");
+        if (bracket == string::npos || bracket + 3 != name.size()) {
+            continue;
+        }
+        name.erase(bracket);
+        uniformLocations[name] = location;
+
+        for(GLint element = 1; element < arraySize; ++element) {
+            stringstream elementName;
+            elementName << name << '[' << element << ']';
+            location = glGetUniformLocation(programObject, elementName.str().c_str());
+            if (location != -1) {
+                uniformLocations[elementName.str()] = location;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------
+void ShaderProgram::reflectAttributes() {
+    attribLocations.clear();
+
+    GLint numAttributes = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(programObject, GL_ACTIVE_ATTRIBUTES, &numAttributes);
+    glGetProgramiv(programObject, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxNameLength);
+
+    std::vector<GLchar> nameBuffer(std::max(maxNameLength, 1));
+    for(GLint i = 0; i < numAttributes; ++i) {
+        GLint size;
+        GLenum type;
+        glGetActiveAttrib(programObject, GLuint(i), GLsizei(nameBuffer.size()), NULL,
+                &size, &type, nameBuffer.data());
+
+        const GLint location = glGetAttribLocation(programObject, nameBuffer.data());
+        if (location != -1) {
+            attribLocations[nameBuffer.data()] = location;
+        }
+    }
 }
 
 //------------------------------------------------------------------------------------
@@ -232,28 +334,39 @@ GLuint ShaderProgram::getProgramObject() const {
     return programObject;
 }
 
+//------------------------------------------------------------------------------------
+/**
+ * @return a number that changes every time this program is linked, and that no
+ * other ShaderProgram shares, or zero if the program was never linked.
+ */
+uint32 ShaderProgram::getLinkGeneration() const {
+    return linkGeneration;
+}
+
+
 //------------------------------------------------------------------------------------
 /**
  * Gets the location of a uniform variable within the shader program.
  *
  * @param uniformName - string representing the name of the uniform variable.
  *
- * @return a GLint location of the requested uniform variable.
+ * @return a GLint location of the requested uniform variable, which stays valid
+ * until the program is linked again.
  *
  * @throws ShaderException  if \c uniformName does not correspond to an active
  * uniform variable within the shader program or if \c uniformName
  * starts with the reserved prefix "gl_".
  */
 GLint ShaderProgram::getUniformLocation(const char * uniformName) const {
-    GLint result = glGetUniformLocation(programObject, (const GLchar *)uniformName);
+    const auto location = uniformLocations.find(uniformName);
 
-    if (result == -1) {
+    if (location == uniformLocations.end()) {
         stringstream errorMessage;
         errorMessage << "Error obtaining uniform location: " << uniformName;
         throw ShaderException(errorMessage.str());
     }
 
-    return result;
+    return location->second;
 }
 
 //------------------------------------------------------------------------------------
@@ -269,15 +382,35 @@ GLint ShaderProgram::getUniformLocation(const char * uniformName) const {
  * starts with the reserved prefix "gl_".
  */
 GLint ShaderProgram::getAttribLocation(const char * attributeName) const {
-    GLint result = glGetAttribLocation(programObject, (const GLchar *)attributeName);
+    const auto location = attribLocations.find(attributeName);
 
-    if (result == -1) {
+    if (location == attribLocations.end()) {
         stringstream errorMessage;
         errorMessage << "Error obtaining attribute location: " << attributeName;
         throw ShaderException(errorMessage.str());
     }
 
-    return result;
+    return location->second;
+}
+
+//------------------------------------------------------------------------------------
+/**
+ * @return location of the uniform variable 'uniformName', or -1 if it is not an
+ * active uniform.  Setting a uniform at location -1 is silently ignored.
+ */
+GLint ShaderProgram::findUniformLocation(const char * uniformName) const {
+    const auto location = uniformLocations.find(uniformName);
+    return (location != uniformLocations.end()) ? location->second : -1;
+}
+
+//------------------------------------------------------------------------------------
+/**
+ * @return location of the attribute variable 'attributeName', or -1 if it is not
+ * an active attribute.
+ */
+GLint ShaderProgram::findAttribLocation(const char * attributeName) const {
+    const auto location = attribLocations.find(attributeName);
+    return (location != attribLocations.end()) ? location->second : -1;
 }
 
 //------------------------------------------------------------------------------------
@@ -288,13 +421,7 @@ GLint ShaderProgram::getAttribLocation(const char * attributeName) const {
  * @param b
  */
 void ShaderProgram::setUniform(const char * uniformName, bool b) {
-    glGetIntegerv(GL_CURRENT_PROGRAM, (GLint *)&activeProgram);
-    glUseProgram(programObject);
-    GLint uniformLocation = getUniformLocation(uniformName);
-    glUniform1i(uniformLocation, b);
-    glUseProgram(activeProgram);
-
-    CHECK_GL_ERRORS;
+    setUniform(getUniformLocation(uniformName), b);
 }
 
 //------------------------------------------------------------------------------------
@@ -305,13 +432,7 @@ void ShaderProgram::setUniform(const char * uniformName, bool b) {
  * @param i
  */
 void ShaderProgram::setUniform(const char * uniformName, int i) {
-    glGetIntegerv(GL_CURRENT_PROGRAM, (GLint *)&activeProgram);
-    glUseProgram(programObject);
-    GLint uniformLocation = getUniformLocation(uniformName);
-    glUniform1i(uniformLocation, i);
-    glUseProgram(activeProgram);
-
-    CHECK_GL_ERRORS;
+    setUniform(getUniformLocation(uniformName), i);
 }
 
 //------------------------------------------------------------------------------------
@@ -322,13 +443,7 @@ void ShaderProgram::setUniform(const char * uniformName, int i) {
  * @param ui
  */
 void ShaderProgram::setUniform(const char * uniformName, unsigned int ui) {
-    glGetIntegerv(GL_CURRENT_PROGRAM, (GLint *)&activeProgram);
-    glUseProgram(programObject);
-    GLint uniformLocation = getUniformLocation(uniformName);
-    glUniform1ui(uniformLocation, ui);
-    glUseProgram(activeProgram);
-
-    CHECK_GL_ERRORS;
+    setUniform(getUniformLocation(uniformName), ui);
 }
 
 //------------------------------------------------------------------------------------
@@ -339,13 +454,7 @@ void ShaderProgram::setUniform(const char * uniformName, unsigned int ui) {
  * @param f
  */
 void ShaderProgram::setUniform(const char * uniformName, float f) {
-    glGetIntegerv(GL_CURRENT_PROGRAM, (GLint *)&activeProgram);
-    glUseProgram(programObject);
-    GLint uniformLocation = getUniformLocation(uniformName);
-    glUniform1f(uniformLocation, f);
-    glUseProgram(activeProgram);
-
-    CHECK_GL_ERRORS;
+    setUniform(getUniformLocation(uniformName), f);
 }
 
 //------------------------------------------------------------------------------------
@@ -357,13 +466,7 @@ void ShaderProgram::setUniform(const char * uniformName, float f) {
  * @param y
  */
 void ShaderProgram::setUniform(const char * uniformName, float x, float y) {
-    glGetIntegerv(GL_CURRENT_PROGRAM, (GLint *)&activeProgram);
-    glUseProgram(programObject);
-    GLint uniformLocation = getUniformLocation(uniformName);
-    glUniform2f(uniformLocation, x, y);
-    glUseProgram(activeProgram);
-
-    CHECK_GL_ERRORS;
+    setUniform(getUniformLocation(uniformName), vec2(x, y));
 }
 
 //------------------------------------------------------------------------------------
@@ -376,13 +479,7 @@ void ShaderProgram::setUniform(const char * uniformName, float x, float y) {
  * @param z
  */
 void ShaderProgram::setUniform(const char * uniformName, float x, float y, float z) {
-    glGetIntegerv(GL_CURRENT_PROGRAM, (GLint *)&activeProgram);
-    glUseProgram(programObject);
-    GLint uniformLocation = getUniformLocation(uniformName);
-    glUniform3f(uniformLocation, x, y, z);
-    glUseProgram(activeProgram);
-
-    CHECK_GL_ERRORS;
+    setUniform(getUniformLocation(uniformName), vec3(x, y, z));
 }
 
 //------------------------------------------------------------------------------------
@@ -396,13 +493,7 @@ void ShaderProgram::setUniform(const char * uniformName, float x, float y, float
  * @param w
  */
 void ShaderProgram::setUniform(const char * uniformName, float x, float y, float z, float w) {
-    glGetIntegerv(GL_CURRENT_PROGRAM, (GLint *)&activeProgram);
-    glUseProgram(programObject);
-    GLint uniformLocation = getUniformLocation(uniformName);
-    glUniform4f(uniformLocation, x, y, z, w);
-    glUseProgram(activeProgram);
-
-    CHECK_GL_ERRORS;
+    setUniform(getUniformLocation(uniformName), vec4(x, y, z, w));
 }
 
 //------------------------------------------------------------------------------------
@@ -413,7 +504,7 @@ void ShaderProgram::setUniform(const char * uniformName, float x, float y, float
  * @param v
  */
 void ShaderProgram::setUniform(const char * uniformName, const vec2 & v) {
-    this->setUniform(uniformName, v.x, v.y);
+    setUniform(getUniformLocation(uniformName), v);
 }
 
 //------------------------------------------------------------------------------------
@@ -424,7 +515,7 @@ void ShaderProgram::setUniform(const char * uniformName, const vec2 & v) {
  * @param v
  */
 void ShaderProgram::setUniform(const char * uniformName, const vec3 & v) {
-    this->setUniform(uniformName, v.x, v.y, v.z);
+    setUniform(getUniformLocation(uniformName), v);
 }
 
 //------------------------------------------------------------------------------------
@@ -435,7 +526,7 @@ void ShaderProgram::setUniform(const char * uniformName, const vec3 & v) {
  * @param v
  */
 void ShaderProgram::setUniform(const char * uniformName, const vec4 & v) {
-    this->setUniform(uniformName, v.x, v.y, v.z, v.w);
+    setUniform(getUniformLocation(uniformName), v);
 }
 
 //------------------------------------------------------------------------------------
@@ -446,13 +537,7 @@ void ShaderProgram::setUniform(const char * uniformName, const vec4 & v) {
  * @param m
  */
 void ShaderProgram::setUniform(const char * uniformName, const mat2 & m) {
-    glGetIntegerv(GL_CURRENT_PROGRAM, (GLint *)&activeProgram);
-    glUseProgram(programObject);
-    GLint uniformLocation = getUniformLocation(uniformName);
-    glUniformMatrix2fv(uniformLocation, 1, GL_FALSE, glm::value_ptr(m));
-    glUseProgram(activeProgram);
-
-    CHECK_GL_ERRORS;
+    setUniform(getUniformLocation(uniformName), m);
 }
 
 //------------------------------------------------------------------------------------
@@ -463,13 +548,7 @@ void ShaderProgram::setUniform(const char * uniformName, const mat2 & m) {
  * @param m
  */
 void ShaderProgram::setUniform(const char * uniformName, const mat3 & m) {
-    glGetIntegerv(GL_CURRENT_PROGRAM, (GLint *)&activeProgram);
-    glUseProgram(programObject);
-    GLint uniformLocation = getUniformLocation(uniformName);
-    glUniformMatrix3fv(uniformLocation, 1, GL_FALSE, glm::value_ptr(m));
-    glUseProgram(activeProgram);
-
-    CHECK_GL_ERRORS;
+    setUniform(getUniformLocation(uniformName), m);
 }
 
 //------------------------------------------------------------------------------------
@@ -480,18 +559,81 @@ void ShaderProgram::setUniform(const char * uniformName, const mat3 & m) {
  * @param m
  */
 void ShaderProgram::setUniform(const char * uniformName, const mat4 & m) {
-    glGetIntegerv(GL_CURRENT_PROGRAM, (GLint *)&activeProgram);
-    glUseProgram(programObject);
-    GLint uniformLocation = getUniformLocation(uniformName);
-    glUniformMatrix4fv(uniformLocation, 1, GL_FALSE, glm::value_ptr(m));
-    glUseProgram(activeProgram);
+    setUniform(getUniformLocation(uniformName), m);
+}
 
+//------------------------------------------------------------------------------------
+/**
+ * Set the value of the uniform variable at 'location', as returned by
+ * getUniformLocation().
+ */
+void ShaderProgram::setUniform(GLint location, bool b) {
+    glProgramUniform1i(programObject, location, b);
+    CHECK_GL_ERRORS;
+}
+
+//------------------------------------------------------------------------------------
+void ShaderProgram::setUniform(GLint location, int i) {
+    glProgramUniform1i(programObject, location, i);
+    CHECK_GL_ERRORS;
+}
+
+//------------------------------------------------------------------------------------
+void ShaderProgram::setUniform(GLint location, unsigned int ui) {
+    glProgramUniform1ui(programObject, location, ui);
+    CHECK_GL_ERRORS;
+}
+
+//------------------------------------------------------------------------------------
+void ShaderProgram::setUniform(GLint location, float f) {
+    glProgramUniform1f(programObject, location, f);
+    CHECK_GL_ERRORS;
+}
+
+//------------------------------------------------------------------------------------
+void ShaderProgram::setUniform(GLint location, const vec2 & v) {
+    glProgramUniform2f(programObject, location, v.x, v.y);
+    CHECK_GL_ERRORS;
+}
+
+//------------------------------------------------------------------------------------
+void ShaderProgram::setUniform(GLint location, const vec3 & v) {
+    glProgramUniform3f(programObject, location, v.x, v.y, v.z);
     CHECK_GL_ERRORS;
 }
 
 //------------------------------------------------------------------------------------
+void ShaderProgram::setUniform(GLint location, const vec4 & v) {
+    glProgramUniform4f(programObject, location, v.x, v.y, v.z, v.w);
+    CHECK_GL_ERRORS;
+}
+
+//------------------------------------------------------------------------------------
+void ShaderProgram::setUniform(GLint location, const mat2 & m) {
+    glProgramUniformMatrix2fv(programObject, location, 1, GL_FALSE, value_ptr(m));
+    CHECK_GL_ERRORS;
+}
+
+//------------------------------------------------------------------------------------
+void ShaderProgram::setUniform(GLint location, const mat3 & m) {
+    glProgramUniformMatrix3fv(programObject, location, 1, GL_FALSE, value_ptr(m));
+    CHECK_GL_ERRORS;
+}
+
+//------------------------------------------------------------------------------------
+void ShaderProgram::setUniform(GLint location, const mat4 & m) {
+    glProgramUniformMatrix4fv(programObject, location, 1, GL_FALSE, value_ptr(m));
+    CHECK_GL_ERRORS;
+}
+
+//------------------------------------------------------------------------------------
+/**
+ * Selects the subroutine 'subroutineName' for stage 'shaderType'.
+ *
+ * @note Subroutine selections are reset whenever a program is put in use, so
+ * this should be called after ShaderProgram::enable().
+ */
 void ShaderProgram::setUniformSubroutine(GLenum shaderType, const char * subroutineName) {
-    glGetIntegerv(GL_CURRENT_PROGRAM, (GLint *)&activeProgram);
     GLuint index = glGetSubroutineIndex(programObject, shaderType, subroutineName);
     if (index == GL_INVALID_INDEX) {
         stringstream errorMessage;
@@ -500,9 +642,29 @@ void ShaderProgram::setUniformSubroutine(GLenum shaderType, const char * subrout
                      << subroutineName << " is not a known subroutine.";
         throw ShaderException(errorMessage.str());
     }
-    glUseProgram(programObject);
+    const GLuint previousProgram = programInUse;
+    useProgram(programObject);
     glUniformSubroutinesuiv(shaderType, 1, &index);
-    glUseProgram(activeProgram);
+    useProgram(previousProgram);
+
+    CHECK_GL_ERRORS;
+}
+
+//------------------------------------------------------------------------------------
+/**
+ * Sources the uniform block 'blockName' from whichever buffer range is bound to
+ * 'bindingPoint', such as FrameUniforms::bindingPoint.
+ *
+ * @throws ShaderException if \c blockName is not an active uniform block.
+ */
+void ShaderProgram::bindUniformBlock(const char * blockName, GLuint bindingPoint) {
+    GLuint blockIndex = glGetUniformBlockIndex(programObject, blockName);
+    if (blockIndex == GL_INVALID_INDEX) {
+        stringstream errorMessage;
+        errorMessage << "Error obtaining uniform block index: " << blockName;
+        throw ShaderException(errorMessage.str());
+    }
+    glUniformBlockBinding(programObject, blockIndex, bindingPoint);
 
     CHECK_GL_ERRORS;
 }
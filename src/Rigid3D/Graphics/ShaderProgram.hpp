@@ -6,10 +6,29 @@
 #include <OpenGL/gl3.h>
 
 #include <string>
+#include <unordered_map>
 
 
 namespace Rigid3D {
 
+    /**
+     * @brief Compiles and links GLSL shaders, and sets their uniform variables.
+     *
+     * The locations of all active uniforms and attributes are read once when the
+     * program is linked, so looking one up by name is a hash table lookup rather
+     * than a call into the driver.  Callers that set the same uniform every frame
+     * can fetch its location once with getUniformLocation(), and pass that to
+     * the setUniform() overloads taking a location instead.
+     *
+     * Every successful link() gets a new link generation, unique across all
+     * ShaderPrograms, so that callers caching locations can tell when a program
+     * was relinked, such as after recompileShaders(), and look them up again.
+     *
+     * Uniforms are set with glProgramUniform*, so setting them never changes
+     * which program is in use.  enable() skips the call to glUseProgram when the
+     * program is already in use, which assumes that programs are only switched
+     * through ShaderProgram.
+     */
     class ShaderProgram {
     public:
         ShaderProgram();
@@ -32,10 +51,16 @@ namespace Rigid3D {
 
         GLuint getProgramObject() const;
 
+        uint32 getLinkGeneration() const;
+
         GLint getUniformLocation(const char * uniformName) const;
 
         GLint getAttribLocation(const char * attributeName) const;
 
+        GLint findUniformLocation(const char * uniformName) const;
+
+        GLint findAttribLocation(const char * attributeName) const;
+
         void setUniform(const char * uniformName, bool b);
 
         void setUniform(const char * uniformName, int i);
@@ -62,8 +87,30 @@ namespace Rigid3D {
 
         void setUniform(const char * uniformName, const mat4 & m);
 
+        void setUniform(GLint location, bool b);
+
+        void setUniform(GLint location, int i);
+
+        void setUniform(GLint location, unsigned int i);
+
+        void setUniform(GLint location, float f);
+
+        void setUniform(GLint location, const vec2 & v);
+
+        void setUniform(GLint location, const vec3 & v);
+
+        void setUniform(GLint location, const vec4 & v);
+
+        void setUniform(GLint location, const mat2 & m);
+
+        void setUniform(GLint location, const mat3 & m);
+
+        void setUniform(GLint location, const mat4 & m);
+
         void setUniformSubroutine(GLenum shaderType, const char * subroutineName);
 
+        void bindUniformBlock(const char * blockName, GLuint bindingPoint);
+
 
     private:
         struct Shader {
@@ -78,8 +125,24 @@ namespace Rigid3D {
         Shader geometryShader;
 
         GLuint programObject;
-        GLuint prevProgramObject;
-        GLuint activeProgram;
+
+        // Zero until linked.
+        uint32 linkGeneration;
+
+        // Locations by name, filled in by link().
+        std::unordered_map<std::string, GLint> uniformLocations;
+        std::unordered_map<std::string, GLint> attribLocations;
+
+        // Program last passed to glUseProgram by any ShaderProgram.
+        static GLuint programInUse;
+
+        // Link generation given to the last program linked.
+        static uint32 lastLinkGeneration;
+
+        void useProgram(GLuint program) const;
+
+        void reflectUniforms();
+        void reflectAttributes();
 
         void extractSourceCode(std::string & shaderSource, const std::string & filePath);
         void extractSourceCodeAndCompile(const Shader &shader);
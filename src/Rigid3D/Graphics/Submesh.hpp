@@ -0,0 +1,32 @@
+/**
+ * @brief Submesh
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_SUBMESH_HPP_
+#define RIGID3D_SUBMESH_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <string>
+
+namespace Rigid3D {
+
+    /**
+     * Contiguous range of a mesh's triangles sharing one group and material.
+     *
+     * For indexed meshes the range is of indices, and otherwise of vertices, so
+     * that it can be passed straight to glDrawElements or glDrawArrays.
+     */
+    struct Submesh {
+        std::string name;          // Name given by the .obj file's last 'o' or 'g' line.
+        std::string materialName;  // Name given by 'usemtl', or empty for none.
+        int32 materialIndex;       // Index into the mesh's materials, or -1 if not found.
+        uint32 startIndex;         // First index, or vertex if unindexed.
+        uint32 numIndices;         // Three per triangle.
+    };
+
+}
+
+#endif /* RIGID3D_SUBMESH_HPP_ */
@@ -0,0 +1,76 @@
+/**
+ * @brief UniformBlocks
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_UNIFORM_BLOCKS_HPP_
+#define RIGID3D_UNIFORM_BLOCKS_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gltypes.h>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Per-frame uniform data shared by every object drawn from one
+     * view, laid out to match the std140 block below.
+     *
+     * \code{.glsl}
+     *  layout (std140) uniform FrameUniforms {
+     *      mat4 ViewMatrix;
+     *      mat4 ProjectionMatrix;
+     *      vec4 LightPositions[4];  // Eye space.
+     *      vec4 LightColors[4];
+     *      int NumLights;
+     *  };
+     * \endcode
+     */
+    struct FrameUniforms {
+        static const GLuint bindingPoint = 0;
+        static const uint32 maxLights = 4;
+
+        mat4 viewMatrix;
+        mat4 projectionMatrix;
+        vec4 lightPositions[maxLights];
+        vec4 lightColors[maxLights];
+        int32 numLights;
+        int32 padding[3];
+    };
+
+    /**
+     * @brief Per-object uniform data written by Renderable, laid out to match
+     * the std140 block below.  A std140 mat3 is stored as three vec4 columns.
+     *
+     * \code{.glsl}
+     *  layout (std140) uniform ObjectUniforms {
+     *      mat4 ModelViewMatrix;
+     *      mat3 NormalMatrix;
+     *      vec4 Emission;  // Material properties, with the rgb components used.
+     *      vec4 Ka;
+     *      vec4 Kd;
+     *      float Ks;
+     *      float ShininessFactor;
+     *  };
+     * \endcode
+     */
+    struct ObjectUniforms {
+        static const GLuint bindingPoint = 1;
+
+        mat4 modelViewMatrix;
+        vec4 normalMatrix[3];
+        vec4 emission;
+        vec4 Ka;
+        vec4 Kd;
+        float Ks;
+        float shininessFactor;
+        float padding[2];
+    };
+
+    static_assert(sizeof(FrameUniforms) == 272, "FrameUniforms must match std140 layout");
+    static_assert(sizeof(ObjectUniforms) == 176, "ObjectUniforms must match std140 layout");
+
+}
+
+#endif /* RIGID3D_UNIFORM_BLOCKS_HPP_ */
@@ -0,0 +1,244 @@
+#include "UniformRingBuffer.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlCapabilities.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+
+#include <cstring>
+#include <sstream>
+
+namespace Rigid3D {
+
+using std::stringstream;
+
+namespace {
+
+    // Whether the context and the headers built against provide glBufferStorage.
+    bool isBufferStorageSupported() {
+#ifdef GL_VERSION_4_4
+        return isGlVersionAtLeast(4, 4) ||
+                isGlExtensionSupported("GL_ARB_buffer_storage");
+#else
+        return false;
+#endif
+    }
+
+}
+
+const uint32 UniformRingBuffer::numRegions;
+
+//----------------------------------------------------------------------------------------
+/**
+ * Creates a buffer with 'regionSize' bytes for each frame in flight, and maps it
+ * persistently when 'allowPersistentMapping' is true and the context supports
+ * it.  'regionSize' is rounded up to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+ *
+ * @throws Rigid3DException if the buffer cannot be mapped.
+ */
+UniformRingBuffer::UniformRingBuffer(uint32 regionSize, bool allowPersistentMapping)
+    : bufferObject(0),
+      mappedData(nullptr),
+      regionSize(0),
+      offsetAlignment(1),
+      currentRegion(numRegions - 1),
+      numBytesUsed(0),
+      inFrame(false)
+{
+    for(uint32 i = 0; i < numRegions; ++i) {
+        fences[i] = 0;
+    }
+
+    GLint alignment;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment > 1) {
+        offsetAlignment = uint32(alignment);
+    }
+    this->regionSize = (regionSize + offsetAlignment - 1) / offsetAlignment * offsetAlignment;
+
+    const GLsizeiptr numBytes = GLsizeiptr(this->regionSize) * numRegions;
+
+    glGenBuffers(1, &bufferObject);
+    glBindBuffer(GL_UNIFORM_BUFFER, bufferObject);
+    if (!allowPersistentMapping || !isBufferStorageSupported()) {
+        glBufferData(GL_UNIFORM_BUFFER, numBytes, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        CHECK_GL_ERRORS;
+        return;
+    }
+
+#ifdef GL_VERSION_4_4
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+            GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_UNIFORM_BUFFER, numBytes, nullptr, flags);
+    mappedData = static_cast<uint8 *>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, numBytes,
+            flags));
+#endif
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    if (mappedData == nullptr) {
+        glDeleteBuffers(1, &bufferObject);
+        throw Rigid3DException("Unable to persistently map uniform buffer within method "
+                "UniformRingBuffer::UniformRingBuffer");
+    }
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+UniformRingBuffer::~UniformRingBuffer() {
+    for(uint32 i = 0; i < numRegions; ++i) {
+        if (fences[i] != 0) {
+            glDeleteSync(fences[i]);
+        }
+    }
+    if (mappedData != nullptr) {
+        glBindBuffer(GL_UNIFORM_BUFFER, bufferObject);
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &bufferObject);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Moves on to the next region, waiting until the GPU has finished reading it
+ * from numRegions frames ago.
+ */
+void UniformRingBuffer::beginFrame() {
+    if (inFrame) {
+        throw Rigid3DException("endFrame() must be called before beginning another "
+                "frame within method UniformRingBuffer::beginFrame");
+    }
+    currentRegion = (currentRegion + 1) % numRegions;
+    numBytesUsed = 0;
+    inFrame = true;
+
+    GLsync & fence = fences[currentRegion];
+    if (fence != 0) {
+        GLbitfield waitFlags = 0;
+        GLuint64 timeout = 0;
+        for(;;) {
+            const GLenum status = glClientWaitSync(fence, waitFlags, timeout);
+            if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+                break;
+            }
+            if (status == GL_WAIT_FAILED) {
+                throw Rigid3DException("Waiting on fence failed within method "
+                        "UniformRingBuffer::beginFrame");
+            }
+            // Flush so the fence is guaranteed to signal, then wait in 1ms steps.
+            waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            timeout = 1000000;
+        }
+        glDeleteSync(fence);
+        fence = 0;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Fences the current region, so that it is not overwritten until the GPU has
+ * finished with every draw issued this frame.
+ */
+void UniformRingBuffer::endFrame() {
+    if (!inFrame) {
+        throw Rigid3DException("beginFrame() must be called before ending a frame "
+                "within method UniformRingBuffer::endFrame");
+    }
+    fences[currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    inFrame = false;
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Copies 'numBytes' of 'data' into the current frame's region.
+ *
+ * @return offset of the copy within the buffer, which is a multiple of
+ * getOffsetAlignment().
+ *
+ * @throws Rigid3DException if called outside of a frame, or if the region has
+ * no room left.
+ */
+uint32 UniformRingBuffer::write(const void * data, uint32 numBytes) {
+    if (!inFrame) {
+        throw Rigid3DException("beginFrame() must be called before writing within "
+                "method UniformRingBuffer::write");
+    }
+    const uint32 start = (numBytesUsed + offsetAlignment - 1) / offsetAlignment *
+            offsetAlignment;
+    if (numBytes > regionSize || start > regionSize - numBytes) {
+        stringstream errorMessage;
+        errorMessage << "Writing " << numBytes << " bytes would overflow the " <<
+                regionSize << " byte region within method UniformRingBuffer::write";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    const uint32 offset = currentRegion * regionSize + start;
+    if (mappedData != nullptr) {
+        memcpy(mappedData + offset, data, numBytes);
+    } else if (numBytes > 0) {
+        // The region's fence has signalled, so nothing the GPU still reads is
+        // overwritten.
+        glBindBuffer(GL_UNIFORM_BUFFER, bufferObject);
+        void * mapping = glMapBufferRange(GL_UNIFORM_BUFFER, GLintptr(offset),
+                GLsizeiptr(numBytes), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                GL_MAP_UNSYNCHRONIZED_BIT);
+        if (mapping != nullptr) {
+            memcpy(mapping, data, numBytes);
+            glUnmapBuffer(GL_UNIFORM_BUFFER);
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        if (mapping == nullptr) {
+            throw Rigid3DException("Unable to map uniform buffer within method "
+                    "UniformRingBuffer::write");
+        }
+    }
+    numBytesUsed = start + numBytes;
+    return offset;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Binds 'numBytes' of the buffer starting at 'offset', as returned by write(),
+ * to the uniform block 'bindingPoint'.
+ */
+void UniformRingBuffer::bindRange(GLuint bindingPoint, uint32 offset, uint32 numBytes) const {
+    glBindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, bufferObject, GLintptr(offset),
+            GLsizeiptr(numBytes));
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint UniformRingBuffer::getBufferObject() const {
+    return bufferObject;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 UniformRingBuffer::getRegionSize() const {
+    return regionSize;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of bytes written to the current region, including alignment
+ * padding.
+ */
+uint32 UniformRingBuffer::getNumBytesUsed() const {
+    return numBytesUsed;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 UniformRingBuffer::getOffsetAlignment() const {
+    return offsetAlignment;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return false if writes map the buffer one at a time, because the context lacks
+ * glBufferStorage or persistent mapping was not allowed.
+ */
+bool UniformRingBuffer::isPersistentlyMapped() const {
+    return mappedData != nullptr;
+}
+
+}
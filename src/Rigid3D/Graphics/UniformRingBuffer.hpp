@@ -0,0 +1,104 @@
+/**
+ * @brief UniformRingBuffer
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_UNIFORM_RING_BUFFER_HPP_
+#define RIGID3D_UNIFORM_RING_BUFFER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Persistently mapped uniform buffer that uniform blocks are written
+     * into each frame, then bound by offset.
+     *
+     * The buffer is split into numRegions regions, one per frame in flight.
+     * Writes go straight into the mapping of the current frame's region, and
+     * endFrame() fences it.  beginFrame() only waits when the GPU is still
+     * reading the region about to be reused, three frames later.
+     *
+     * Without OpenGL 4.4 or ARB_buffer_storage, or when persistent mapping is
+     * turned down, the buffer is allocated with glBufferData instead, and each
+     * write maps just the bytes it copies with GL_MAP_UNSYNCHRONIZED_BIT, which
+     * the fences keep safe.
+     * \code{.cpp}
+     *  ring.beginFrame();
+     *  ring.bindBlock(FrameUniforms::bindingPoint, frameUniforms);
+     *  for(Renderable & renderable : renderables) {
+     *      renderable.render(context, ring);
+     *  }
+     *  ring.endFrame();
+     * \endcode
+     *
+     * @note Requires a current context for its whole lifetime.
+     */
+    class UniformRingBuffer {
+    public:
+        static const uint32 numRegions = 3;
+
+        explicit UniformRingBuffer(uint32 regionSize, bool allowPersistentMapping = true);
+
+        ~UniformRingBuffer();
+
+        void beginFrame();
+
+        void endFrame();
+
+        uint32 write(const void * data, uint32 numBytes);
+
+        template <typename Block>
+        uint32 bindBlock(GLuint bindingPoint, const Block & block);
+
+        void bindRange(GLuint bindingPoint, uint32 offset, uint32 numBytes) const;
+
+        GLuint getBufferObject() const;
+
+        uint32 getRegionSize() const;
+
+        uint32 getNumBytesUsed() const;
+
+        uint32 getOffsetAlignment() const;
+
+        bool isPersistentlyMapped() const;
+
+    private:
+        UniformRingBuffer(const UniformRingBuffer &);
+        UniformRingBuffer & operator = (const UniformRingBuffer &);
+
+        GLuint bufferObject;
+
+        // Null unless the buffer is persistently mapped.
+        uint8 * mappedData;
+        uint32 regionSize;
+        uint32 offsetAlignment;
+
+        uint32 currentRegion;
+        uint32 numBytesUsed;
+        bool inFrame;
+
+        // Signalled once the GPU has finished with each region.
+        GLsync fences[numRegions];
+    };
+
+    //------------------------------------------------------------------------------------
+    /**
+     * Writes 'block' into the current frame's region, and binds it to the
+     * uniform block 'bindingPoint'.
+     *
+     * @return offset of the block within the buffer.
+     */
+    template <typename Block>
+    uint32 UniformRingBuffer::bindBlock(GLuint bindingPoint, const Block & block) {
+        const uint32 offset = write(&block, uint32(sizeof(Block)));
+        bindRange(bindingPoint, offset, uint32(sizeof(Block)));
+        return offset;
+    }
+
+}
+
+#endif /* RIGID3D_UNIFORM_RING_BUFFER_HPP_ */
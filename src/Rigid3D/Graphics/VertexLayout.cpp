@@ -0,0 +1,495 @@
+#include "VertexLayout.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <cstring>
+
+namespace Rigid3D {
+
+namespace {
+
+    //------------------------------------------------------------------------------------
+    VertexAttributeFormat makeFormat(uint32 numComponents, VertexComponentType componentType,
+            bool normalized) {
+        VertexAttributeFormat format;
+        format.numComponents = numComponents;
+        format.componentType = componentType;
+        format.normalized = normalized;
+        format.offset = 0;
+        format.stride = 0;
+        return format;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Size in bytes of one vertex's worth of an attribute.
+    uint32 getElementSize(const VertexAttributeFormat & format) {
+        if (!format.isEnabled()) {
+            return 0;
+        }
+        switch (format.componentType) {
+            case VertexComponentType::Float32: return format.numComponents * 4;
+            case VertexComponentType::Float16: return format.numComponents * 2;
+            case VertexComponentType::Int2_10_10_10: return 4;
+
+            // Padded to keep the next attribute 4-byte aligned, as GL prefers.
+            case VertexComponentType::UInt16:
+            case VertexComponentType::Int16: return (format.numComponents * 2 + 3) & ~3u;
+        }
+        return 0;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Quantizes 'value' within [offset, offset + scale] to an unsigned normalized
+    // 16-bit integer, clamping values outside it.
+    uint16 packUnorm16(float value, float offset, float scale) {
+        if (scale <= 0.0f) {
+            return 0;
+        }
+        const float t = std::min(std::max((value - offset) / scale, 0.0f), 1.0f);
+        return uint16(std::lround(t * 65535.0f));
+    }
+
+    //------------------------------------------------------------------------------------
+    // Largest rounding error of a half float with magnitude up to 'maxMagnitude'.
+    float getHalfFloatError(float maxMagnitude) {
+        if (maxMagnitude <= 0.0f) {
+            return 0.0f;
+        }
+        int exponent;
+        std::frexp(maxMagnitude, &exponent);
+        // Half a unit in the last place, where the smallest exponent of a half is -14.
+        return std::ldexp(1.0f, std::max(exponent - 1, -14) - 11);
+    }
+
+    //------------------------------------------------------------------------------------
+    float signNotZero(float value) {
+        return (value >= 0.0f) ? 1.0f : -1.0f;
+    }
+
+    //------------------------------------------------------------------------------------
+    template <class Writer>
+    void writeAttribute(char * vertexData, const VertexAttributeFormat & format,
+            size_t firstVertex, size_t count, const Writer & writer) {
+        if (!format.isEnabled()) {
+            return;
+        }
+        char * out = vertexData + format.offset + firstVertex * format.stride;
+        for(size_t i = 0; i < count; ++i, out += format.stride) {
+            writer(out, i);
+        }
+    }
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Constructs empty bounds, which the first call to extend() replaces.
+ */
+VertexBounds::VertexBounds()
+    : minUvCoord(FLT_MAX),
+      maxUvCoord(-FLT_MAX) {
+    positions.minBounds = vec3(FLT_MAX);
+    positions.maxBounds = vec3(-FLT_MAX);
+}
+
+//----------------------------------------------------------------------------------------
+bool VertexBounds::isEmpty() const {
+    return positions.minBounds.x > positions.maxBounds.x;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Grows these bounds to contain 'positionBounds' and every one of 'uvCoords'.
+ */
+void VertexBounds::extend(const AABB & positionBounds, const vec2 * uvCoords,
+        size_t numUvCoords) {
+    positions.minBounds = glm::min(positions.minBounds, positionBounds.minBounds);
+    positions.maxBounds = glm::max(positions.maxBounds, positionBounds.maxBounds);
+
+    for(size_t i = 0; i < numUvCoords; ++i) {
+        minUvCoord = glm::min(minUvCoord, uvCoords[i]);
+        maxUvCoord = glm::max(maxUvCoord, uvCoords[i]);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+VertexLayout::VertexLayout()
+    : type(VertexLayoutType::Separate),
+      numVertices(0),
+      numBytes(0),
+      position(makeFormat(0, VertexComponentType::Float32, false)),
+      normal(makeFormat(0, VertexComponentType::Float32, false)),
+      uvCoord(makeFormat(0, VertexComponentType::Float32, false)) {
+    quantization.positionOffset = vec3(0.0f);
+    quantization.positionScale = vec3(1.0f);
+    quantization.uvCoordOffset = vec2(0.0f);
+    quantization.uvCoordScale = vec2(1.0f);
+    decodeError.position = vec3(0.0f);
+    decodeError.normalAngle = 0.0f;
+    decodeError.uvCoord = vec2(0.0f);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Lays out 'numVertices' vertices.  Positions are always stored; normals and
+ * texture coordinates only if 'hasNormals' or 'hasUvCoords'.
+ *
+ * @param bounds - range of the vertices' positions and texture coordinates.
+ * Quantized layouts store attributes relative to it, and getDecodeError() is
+ * computed from it.
+ */
+VertexLayout::VertexLayout(VertexLayoutType type, size_t numVertices, bool hasNormals,
+        bool hasUvCoords, const VertexBounds & bounds)
+    : VertexLayout() {
+
+    this->type = type;
+    this->numVertices = numVertices;
+    position = makeFormat(3, VertexComponentType::Float32, false);
+
+    if (type == VertexLayoutType::Quantized) {
+        position = makeFormat(3, VertexComponentType::UInt16, true);
+        if (hasNormals) {
+            normal = makeFormat(2, VertexComponentType::Int16, true);
+        }
+        if (hasUvCoords) {
+            uvCoord = makeFormat(2, VertexComponentType::UInt16, true);
+        }
+        if (!bounds.isEmpty()) {
+            quantization.positionOffset = bounds.positions.minBounds;
+            quantization.positionScale = bounds.positions.maxBounds - bounds.positions.minBounds;
+            if (hasUvCoords) {
+                quantization.uvCoordOffset = bounds.minUvCoord;
+                quantization.uvCoordScale = bounds.maxUvCoord - bounds.minUvCoord;
+            }
+        }
+    } else if (type == VertexLayoutType::Packed) {
+        if (hasNormals) {
+            normal = makeFormat(4, VertexComponentType::Int2_10_10_10, true);
+        }
+        if (hasUvCoords) {
+            uvCoord = makeFormat(2, VertexComponentType::Float16, false);
+        }
+    } else {
+        if (hasNormals) {
+            normal = makeFormat(3, VertexComponentType::Float32, false);
+        }
+        if (hasUvCoords) {
+            uvCoord = makeFormat(2, VertexComponentType::Float32, false);
+        }
+    }
+
+    VertexAttributeFormat * attributes[] = {&position, &normal, &uvCoord};
+
+    if (type == VertexLayoutType::Separate) {
+        size_t offset = 0;
+        for(VertexAttributeFormat * attribute : attributes) {
+            attribute->offset = uint32(offset);
+            attribute->stride = getElementSize(*attribute);
+            offset += numVertices * attribute->stride;
+        }
+        numBytes = offset;
+    } else {
+        uint32 vertexSize = 0;
+        for(VertexAttributeFormat * attribute : attributes) {
+            attribute->offset = vertexSize;
+            vertexSize += getElementSize(*attribute);
+        }
+        for(VertexAttributeFormat * attribute : attributes) {
+            attribute->stride = vertexSize;
+        }
+        numBytes = numVertices * vertexSize;
+    }
+
+    // Each quantized value is rounded to the nearest of its evenly spaced steps.
+    if (position.componentType == VertexComponentType::UInt16) {
+        decodeError.position = quantization.positionScale * (0.5f / 65535.0f);
+    }
+    if (uvCoord.componentType == VertexComponentType::UInt16) {
+        decodeError.uvCoord = quantization.uvCoordScale * (0.5f / 65535.0f);
+    } else if (uvCoord.componentType == VertexComponentType::Float16 && !bounds.isEmpty()) {
+        const vec2 maxMagnitude = glm::max(glm::abs(bounds.minUvCoord),
+                                           glm::abs(bounds.maxUvCoord));
+        decodeError.uvCoord = vec2(getHalfFloatError(maxMagnitude.x),
+                                   getHalfFloatError(maxMagnitude.y));
+    }
+    if (normal.componentType == VertexComponentType::Int2_10_10_10) {
+        // Each component is off by at most half a step of 1/511.
+        decodeError.normalAngle = std::asin(std::sqrt(3.0f) * 0.5f / 511.0f);
+    } else if (normal.componentType == VertexComponentType::Int16) {
+        // Half a step of 1/32767 in each octahedral coordinate moves the point on
+        // the octahedron by at most sqrt(6) half steps, and no point on the
+        // octahedron is closer to the origin than 1/sqrt(3).
+        decodeError.normalAngle = std::asin(std::sqrt(18.0f) * 0.5f / 32767.0f);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+VertexLayoutType VertexLayout::getType() const {
+    return type;
+}
+
+//----------------------------------------------------------------------------------------
+size_t VertexLayout::getNumVertices() const {
+    return numVertices;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return size of the vertex buffer this layout describes.
+ */
+size_t VertexLayout::getNumBytes() const {
+    return numBytes;
+}
+
+//----------------------------------------------------------------------------------------
+const VertexAttributeFormat & VertexLayout::getPositionFormat() const {
+    return position;
+}
+
+//----------------------------------------------------------------------------------------
+const VertexAttributeFormat & VertexLayout::getNormalFormat() const {
+    return normal;
+}
+
+//----------------------------------------------------------------------------------------
+const VertexAttributeFormat & VertexLayout::getUvCoordFormat() const {
+    return uvCoord;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return how shaders map quantized positions and texture coordinates back to
+ * their original range.
+ */
+const VertexQuantization & VertexLayout::getQuantization() const {
+    return quantization;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return bounds on the error of each attribute once decoded, which is zero for
+ * attributes stored as 32-bit floats.
+ */
+const VertexDecodeError & VertexLayout::getDecodeError() const {
+    return decodeError;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Writes 'count' vertices into a vertex buffer of this layout, starting at
+ * vertex 'firstVertex'.
+ *
+ * @param vertexData - start of a buffer of at least getNumBytes() bytes.
+ * @param normals - may be null, in which case zero normals are written.
+ * @param uvCoords - may be null, in which case zero texture coordinates are written.
+ */
+void VertexLayout::writeVertices(void * vertexData,
+                                 size_t firstVertex,
+                                 size_t count,
+                                 const vec3 * positions,
+                                 const vec3 * normals,
+                                 const vec2 * uvCoords) const {
+
+    char * data = static_cast<char *>(vertexData);
+
+    if (position.componentType == VertexComponentType::UInt16) {
+        const vec3 & offset = quantization.positionOffset;
+        const vec3 & scale = quantization.positionScale;
+        writeAttribute(data, position, firstVertex, count, [&](char * out, size_t i) {
+            const uint16 packed[4] = {
+                packUnorm16(positions[i].x, offset.x, scale.x),
+                packUnorm16(positions[i].y, offset.y, scale.y),
+                packUnorm16(positions[i].z, offset.z, scale.z),
+                0
+            };
+            std::memcpy(out, packed, sizeof(packed));
+        });
+    } else {
+        writeAttribute(data, position, firstVertex, count, [&](char * out, size_t i) {
+            std::memcpy(out, &positions[i], sizeof(vec3));
+        });
+    }
+
+    if (normal.componentType == VertexComponentType::Int16) {
+        writeAttribute(data, normal, firstVertex, count, [&](char * out, size_t i) {
+            const uint32 packed = normals ? packOctahedralNormal(normals[i]) : 0;
+            std::memcpy(out, &packed, sizeof(packed));
+        });
+    } else if (normal.componentType == VertexComponentType::Int2_10_10_10) {
+        writeAttribute(data, normal, firstVertex, count, [&](char * out, size_t i) {
+            const uint32 packed = normals ? packNormal(normals[i]) : 0;
+            std::memcpy(out, &packed, sizeof(packed));
+        });
+    } else {
+        writeAttribute(data, normal, firstVertex, count, [&](char * out, size_t i) {
+            const vec3 value = normals ? normals[i] : vec3(0.0f);
+            std::memcpy(out, &value, sizeof(value));
+        });
+    }
+
+    if (uvCoord.componentType == VertexComponentType::UInt16) {
+        const vec2 & offset = quantization.uvCoordOffset;
+        const vec2 & scale = quantization.uvCoordScale;
+        writeAttribute(data, uvCoord, firstVertex, count, [&](char * out, size_t i) {
+            const vec2 value = uvCoords ? uvCoords[i] : vec2(0.0f);
+            const uint16 packed[2] = {
+                packUnorm16(value.s, offset.s, scale.s),
+                packUnorm16(value.t, offset.t, scale.t)
+            };
+            std::memcpy(out, packed, sizeof(packed));
+        });
+    } else if (uvCoord.componentType == VertexComponentType::Float16) {
+        writeAttribute(data, uvCoord, firstVertex, count, [&](char * out, size_t i) {
+            const vec2 value = uvCoords ? uvCoords[i] : vec2(0.0f);
+            const uint16 packed[2] = {packHalfFloat(value.s), packHalfFloat(value.t)};
+            std::memcpy(out, packed, sizeof(packed));
+        });
+    } else {
+        writeAttribute(data, uvCoord, firstVertex, count, [&](char * out, size_t i) {
+            const vec2 value = uvCoords ? uvCoords[i] : vec2(0.0f);
+            std::memcpy(out, &value, sizeof(value));
+        });
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return IEEE 754 half precision bits of 'value', rounded to nearest even.
+ * Values too large for half precision become infinity.
+ */
+uint16 VertexLayout::packHalfFloat(float value) {
+    uint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const uint32 sign = (bits >> 16) & 0x8000;
+    const uint32 magnitude = bits & 0x7FFFFFFF;
+
+    if (magnitude >= 0x7F800000) {
+        // Infinity stays infinity, and NaN stays a quiet NaN.
+        return uint16(sign | 0x7C00 | ((magnitude > 0x7F800000) ? 0x200 : 0));
+    }
+    if (magnitude >= 0x477FF000) {
+        // Rounds to 65520 or more.
+        return uint16(sign | 0x7C00);
+    }
+    if (magnitude < 0x38800000) {
+        // Below the smallest normal half, 2^-14.  Scaling by 2^24 is exact, and
+        // leaves the subnormal mantissa to round.
+        float scaled;
+        std::memcpy(&scaled, &magnitude, sizeof(scaled));
+        return uint16(sign | uint32(std::nearbyint(scaled * 16777216.0f)));
+    }
+
+    // Rebias the exponent from 127 to 15, and round the 13 dropped mantissa bits.
+    uint32 half = (magnitude >> 13) - (112u << 10);
+    const uint32 remainder = magnitude & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+        ++half;
+    }
+    return uint16(sign | half);
+}
+
+//----------------------------------------------------------------------------------------
+float VertexLayout::unpackHalfFloat(uint16 value) {
+    const uint32 sign = uint32(value & 0x8000) << 16;
+    const uint32 exponent = (value >> 10) & 0x1F;
+    const uint32 mantissa = value & 0x3FF;
+
+    if (exponent == 0) {
+        const float magnitude = std::ldexp(float(mantissa), -24);
+        return sign ? -magnitude : magnitude;
+    }
+
+    uint32 bits;
+    if (exponent == 31) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return 'normal' as signed normalized 10-bit x, y and z in the layout of
+ * GL_INT_2_10_10_10_REV, with w zero.
+ */
+uint32 VertexLayout::packNormal(const vec3 & normal) {
+    uint32 packed = 0;
+    for(int i = 0; i < 3; ++i) {
+        const float clamped = std::min(std::max(normal[i], -1.0f), 1.0f);
+        const int component = int(std::lround(clamped * 511.0f));
+        packed |= (uint32(component) & 0x3FF) << (10 * i);
+    }
+    return packed;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the normal packed by packNormal(), decoded as OpenGL does.
+ */
+vec3 VertexLayout::unpackNormal(uint32 packedNormal) {
+    vec3 normal;
+    for(int i = 0; i < 3; ++i) {
+        // Sign extend the 10-bit component.
+        const int component = int32(packedNormal << (22 - 10 * i)) >> 22;
+        normal[i] = std::max(float(component) / 511.0f, -1.0f);
+    }
+    return normal;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Maps 'normal' onto the octahedron |x| + |y| + |z| = 1, unfolds the lower half
+ * over the upper, and stores the resulting x and y as signed normalized 16-bit
+ * integers, x in the low half.
+ *
+ * @see unpackOctahedralNormal()
+ */
+uint32 VertexLayout::packOctahedralNormal(const vec3 & normal) {
+    const float l1Norm = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (l1Norm == 0.0f) {
+        return 0;
+    }
+
+    float x = normal.x / l1Norm;
+    float y = normal.y / l1Norm;
+    if (normal.z < 0.0f) {
+        const float foldedX = (1.0f - std::abs(y)) * signNotZero(x);
+        y = (1.0f - std::abs(x)) * signNotZero(y);
+        x = foldedX;
+    }
+
+    const int16 packed[2] = {
+        int16(std::lround(std::min(std::max(x, -1.0f), 1.0f) * 32767.0f)),
+        int16(std::lround(std::min(std::max(y, -1.0f), 1.0f) * 32767.0f))
+    };
+    uint32 result;
+    std::memcpy(&result, packed, sizeof(result));
+    return result;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the unit normal packed by packOctahedralNormal(), decoded as the
+ * shaders in data/shaders do.
+ */
+vec3 VertexLayout::unpackOctahedralNormal(uint32 packedNormal) {
+    int16 packed[2];
+    std::memcpy(packed, &packedNormal, sizeof(packed));
+
+    float x = std::max(packed[0] / 32767.0f, -1.0f);
+    float y = std::max(packed[1] / 32767.0f, -1.0f);
+    const float z = 1.0f - std::abs(x) - std::abs(y);
+    if (z < 0.0f) {
+        const float unfoldedX = (1.0f - std::abs(y)) * signNotZero(x);
+        y = (1.0f - std::abs(x)) * signNotZero(y);
+        x = unfoldedX;
+    }
+    return glm::normalize(vec3(x, y, z));
+}
+
+}
@@ -0,0 +1,182 @@
+/**
+ * @brief VertexLayout
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_VERTEX_LAYOUT_HPP_
+#define RIGID3D_VERTEX_LAYOUT_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Collision/AABB.hpp>
+
+#include <cstddef>
+
+namespace Rigid3D {
+
+    /**
+     * How vertex attributes are arranged within a single vertex buffer.
+     */
+    enum class VertexLayoutType {
+        // One tightly packed block per attribute: all positions, then all
+        // normals, then all texture coordinates.
+        Separate,
+
+        // Position, normal and texture coordinate of each vertex stored
+        // together, as 32-bit floats.
+        Interleaved,
+
+        // Interleaved, with normals as signed normalized 10:10:10:2 integers and
+        // texture coordinates as 16-bit floats, for 20 bytes per vertex.
+        Packed,
+
+        // Interleaved, with positions and texture coordinates as unsigned
+        // normalized 16-bit integers relative to their bounds, and normals as
+        // octahedral signed normalized 16-bit pairs, for 16 bytes per vertex.
+        // Shaders decode them using the layout's VertexQuantization.
+        Quantized
+    };
+
+    /**
+     * Storage type of each component of a vertex attribute.  Maps directly to
+     * GL_FLOAT, GL_HALF_FLOAT, GL_INT_2_10_10_10_REV, GL_UNSIGNED_SHORT and
+     * GL_SHORT.
+     */
+    enum class VertexComponentType {
+        Float32,
+        Float16,
+        Int2_10_10_10,
+        UInt16,
+        Int16
+    };
+
+    /**
+     * Where one vertex attribute lives within a vertex buffer, in the terms of
+     * glVertexAttribPointer:
+     * \code{.cpp}
+     *  glVertexAttribPointer(location, attribute.numComponents, type,
+     *          attribute.normalized, attribute.stride, (const GLvoid *)attribute.offset);
+     * \endcode
+     */
+    struct VertexAttributeFormat {
+        // Zero if the attribute is not stored.
+        uint32 numComponents;
+        VertexComponentType componentType;
+        bool normalized;
+
+        // Byte offset of the first vertex's attribute from the start of the buffer.
+        uint32 offset;
+
+        // Bytes between consecutive vertices' attributes.
+        uint32 stride;
+
+        bool isEnabled() const {
+            return numComponents != 0;
+        }
+    };
+
+    /**
+     * Range of the positions and texture coordinates of a set of vertices, which
+     * quantized attributes are stored relative to.
+     */
+    struct VertexBounds {
+        AABB positions;
+        vec2 minUvCoord;
+        vec2 maxUvCoord;
+
+        VertexBounds();
+
+        bool isEmpty() const;
+
+        void extend(const AABB & positionBounds, const vec2 * uvCoords, size_t numUvCoords);
+    };
+
+    /**
+     * Maps the normalized values a shader reads from quantized attributes back
+     * to positions and texture coordinates:
+     * \code{.glsl}
+     *  vec3 position = PositionOffset + PositionScale * vertexPosition;
+     *  vec2 uvCoord = UvCoordOffset + UvCoordScale * vertexUvCoord;
+     * \endcode
+     *
+     * Unquantized layouts have zero offsets and unit scales.
+     */
+    struct VertexQuantization {
+        vec3 positionOffset;
+        vec3 positionScale;
+        vec2 uvCoordOffset;
+        vec2 uvCoordScale;
+    };
+
+    /**
+     * Largest difference between an attribute as given and as decoded on the GPU.
+     */
+    struct VertexDecodeError {
+        // Per axis, in mesh units.
+        vec3 position;
+
+        // Angle between the given and decoded normal directions, in radians.
+        float normalAngle;
+
+        vec2 uvCoord;
+    };
+
+    /**
+     * @brief Arrangement of positions, normals and texture coordinates for a
+     * given number of vertices within one vertex buffer.
+     *
+     * Attributes that no vertex has are disabled, taking no space.
+     */
+    class VertexLayout {
+    public:
+        VertexLayout();
+
+        VertexLayout(VertexLayoutType type, size_t numVertices, bool hasNormals,
+                bool hasUvCoords, const VertexBounds & bounds = VertexBounds());
+
+        VertexLayoutType getType() const;
+
+        size_t getNumVertices() const;
+
+        size_t getNumBytes() const;
+
+        const VertexAttributeFormat & getPositionFormat() const;
+        const VertexAttributeFormat & getNormalFormat() const;
+        const VertexAttributeFormat & getUvCoordFormat() const;
+
+        const VertexQuantization & getQuantization() const;
+
+        const VertexDecodeError & getDecodeError() const;
+
+        void writeVertices(void * vertexData,
+                           size_t firstVertex,
+                           size_t count,
+                           const vec3 * positions,
+                           const vec3 * normals,
+                           const vec2 * uvCoords) const;
+
+        static uint16 packHalfFloat(float value);
+        static float unpackHalfFloat(uint16 value);
+
+        static uint32 packNormal(const vec3 & normal);
+        static vec3 unpackNormal(uint32 packedNormal);
+
+        static uint32 packOctahedralNormal(const vec3 & normal);
+        static vec3 unpackOctahedralNormal(uint32 packedNormal);
+
+    private:
+        VertexLayoutType type;
+        size_t numVertices;
+        size_t numBytes;
+
+        VertexAttributeFormat position;
+        VertexAttributeFormat normal;
+        VertexAttributeFormat uvCoord;
+
+        VertexQuantization quantization;
+        VertexDecodeError decodeError;
+    };
+
+}
+
+#endif /* RIGID3D_VERTEX_LAYOUT_HPP_ */
@@ -0,0 +1,47 @@
+/**
+ * @brief BatchKernels
+ *
+ * Table of batch math kernel implementations for a single instruction set.
+ * Kernels operate on raw float arrays laid out exactly as glm lays out vec3
+ * {x,y,z}, quat {x,y,z,w}, column-major mat3/mat4, and Transform
+ * {position, pose}, so SIMD translation units
+ * never instantiate glm inline functions under different target options.
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_BATCHKERNELS_HPP_
+#define RIGID3D_BATCHKERNELS_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Math/SimdLevel.hpp>
+
+#include <cstddef>
+
+namespace Rigid3D {
+
+    struct BatchKernels {
+        void (*rotate)(const float * q, const float * v, float * out, size_t n);
+        void (*multiply)(const float * a, const float * b, float * out, size_t n);
+        void (*integrateLinear)(float * position, const float * velocity, float dt,
+                size_t n);
+        void (*integrateAngular)(float * orientation, const float * angularVelocity,
+                float dt, size_t n);
+        void (*rotateInertia)(const float * orientation, const float * localInertia,
+                float * worldInertia, size_t n);
+        void (*worldMatrices)(const float * transforms, const float * scales,
+                float * out, size_t n);
+        size_t (*cullBoxes)(const float * planes, const float * const * boxes,
+                uint32 * visibility, size_t n);
+    };
+
+    extern const BatchKernels scalarBatchKernels;
+
+#if defined(RIGID3D_SIMD_X86)
+    extern const BatchKernels sseBatchKernels;
+    extern const BatchKernels avx2BatchKernels;
+#endif
+
+}
+
+#endif /* RIGID3D_BATCHKERNELS_HPP_ */
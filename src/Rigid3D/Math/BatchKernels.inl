@@ -0,0 +1,451 @@
+/**
+ * @brief BatchKernels.inl
+ *
+ * SIMD batch math kernels written once against an 'Ops' abstraction of a
+ * vector register, and instantiated by BatchMath_SSE.cpp and
+ * BatchMath_AVX2.cpp.
+ *
+ * Everything in this file lives in an anonymous namespace, and must only call
+ * intrinsics or other functions within this file, so that code compiled for
+ * wider instruction sets is never shared with other translation units.
+ *
+ * Ops must provide:
+ * # typedef Reg, and enum { Width }
+ * # load, store (aligned), loadu, storeu (unaligned)
+ * # set1, add, sub, mul, fmadd(a, b, c) = a * b + c, div, sqrt
+ * # greaterEqualMask(a, b), with bit i set when lane i of a >= lane i of b
+ */
+
+namespace Rigid3D {
+namespace {
+
+    template <class Ops>
+    struct WideKernels {
+        typedef typename Ops::Reg Reg;
+        enum { Width = Ops::Width };
+
+        //-------------------------------------------------------------------------------
+        static size_t laneCount(size_t i, size_t n) {
+            return (n - i < size_t(Width)) ? (n - i) : size_t(Width);
+        }
+
+        //-------------------------------------------------------------------------------
+        // Unused lanes are filled with zero vectors.
+        static void gather(const float * src, size_t count, Vec3Wide<Width> & dst) {
+            for(size_t i = 0; i < size_t(Width); ++i) {
+                if (i < count) {
+                    dst.x[i] = src[3 * i + 0];
+                    dst.y[i] = src[3 * i + 1];
+                    dst.z[i] = src[3 * i + 2];
+                } else {
+                    dst.x[i] = dst.y[i] = dst.z[i] = 0.0f;
+                }
+            }
+        }
+
+        //-------------------------------------------------------------------------------
+        // Unused lanes are filled with identity quaternions.
+        static void gather(const float * src, size_t count, QuatWide<Width> & dst) {
+            for(size_t i = 0; i < size_t(Width); ++i) {
+                if (i < count) {
+                    dst.x[i] = src[4 * i + 0];
+                    dst.y[i] = src[4 * i + 1];
+                    dst.z[i] = src[4 * i + 2];
+                    dst.w[i] = src[4 * i + 3];
+                } else {
+                    dst.x[i] = dst.y[i] = dst.z[i] = 0.0f;
+                    dst.w[i] = 1.0f;
+                }
+            }
+        }
+
+        //-------------------------------------------------------------------------------
+        static void gather(const float * src, size_t count, Mat3Wide<Width> & dst) {
+            for(size_t i = 0; i < size_t(Width); ++i) {
+                for(int k = 0; k < 9; ++k) {
+                    dst.m[k][i] = (i < count) ? src[9 * i + k] : 0.0f;
+                }
+            }
+        }
+
+        //-------------------------------------------------------------------------------
+        // Transforms are packed as {position.xyz, pose.xyzw}.  Unused lanes are
+        // filled with identity transforms.
+        static void gatherTransforms(const float * src, size_t count,
+                Vec3Wide<Width> & position, QuatWide<Width> & pose) {
+            for(size_t i = 0; i < size_t(Width); ++i) {
+                if (i < count) {
+                    const float * t = src + 7 * i;
+                    position.x[i] = t[0];
+                    position.y[i] = t[1];
+                    position.z[i] = t[2];
+                    pose.x[i] = t[3];
+                    pose.y[i] = t[4];
+                    pose.z[i] = t[5];
+                    pose.w[i] = t[6];
+                } else {
+                    position.x[i] = position.y[i] = position.z[i] = 0.0f;
+                    pose.x[i] = pose.y[i] = pose.z[i] = 0.0f;
+                    pose.w[i] = 1.0f;
+                }
+            }
+        }
+
+        //-------------------------------------------------------------------------------
+        static void scatter(const Vec3Wide<Width> & src, size_t count, float * dst) {
+            for(size_t i = 0; i < count; ++i) {
+                dst[3 * i + 0] = src.x[i];
+                dst[3 * i + 1] = src.y[i];
+                dst[3 * i + 2] = src.z[i];
+            }
+        }
+
+        //-------------------------------------------------------------------------------
+        static void scatter(const QuatWide<Width> & src, size_t count, float * dst) {
+            for(size_t i = 0; i < count; ++i) {
+                dst[4 * i + 0] = src.x[i];
+                dst[4 * i + 1] = src.y[i];
+                dst[4 * i + 2] = src.z[i];
+                dst[4 * i + 3] = src.w[i];
+            }
+        }
+
+        //-------------------------------------------------------------------------------
+        static void scatter(const Mat3Wide<Width> & src, size_t count, float * dst) {
+            for(size_t i = 0; i < count; ++i) {
+                for(int k = 0; k < 9; ++k) {
+                    dst[9 * i + k] = src.m[k][i];
+                }
+            }
+        }
+
+        //-------------------------------------------------------------------------------
+        static void rotate(const float * q, const float * v, float * out, size_t n) {
+            for(size_t i = 0; i < n; i += Width) {
+                size_t count = laneCount(i, n);
+
+                QuatWide<Width> qw;
+                Vec3Wide<Width> vw;
+                gather(q + 4 * i, count, qw);
+                gather(v + 3 * i, count, vw);
+
+                Reg qx = Ops::load(qw.x), qy = Ops::load(qw.y);
+                Reg qz = Ops::load(qw.z), qs = Ops::load(qw.w);
+                Reg vx = Ops::load(vw.x), vy = Ops::load(vw.y), vz = Ops::load(vw.z);
+                Reg two = Ops::set1(2.0f);
+
+                // t = 2 * cross(q.xyz, v)
+                Reg tx = Ops::mul(two, Ops::sub(Ops::mul(qy, vz), Ops::mul(qz, vy)));
+                Reg ty = Ops::mul(two, Ops::sub(Ops::mul(qz, vx), Ops::mul(qx, vz)));
+                Reg tz = Ops::mul(two, Ops::sub(Ops::mul(qx, vy), Ops::mul(qy, vx)));
+
+                // v' = v + w * t + cross(q.xyz, t)
+                Vec3Wide<Width> result;
+                Ops::store(result.x, Ops::add(Ops::fmadd(qs, tx, vx),
+                        Ops::sub(Ops::mul(qy, tz), Ops::mul(qz, ty))));
+                Ops::store(result.y, Ops::add(Ops::fmadd(qs, ty, vy),
+                        Ops::sub(Ops::mul(qz, tx), Ops::mul(qx, tz))));
+                Ops::store(result.z, Ops::add(Ops::fmadd(qs, tz, vz),
+                        Ops::sub(Ops::mul(qx, ty), Ops::mul(qy, tx))));
+
+                scatter(result, count, out + 3 * i);
+            }
+        }
+
+        //-------------------------------------------------------------------------------
+        static void multiply(const float * a, const float * b, float * out, size_t n) {
+            for(size_t i = 0; i < n; i += Width) {
+                size_t count = laneCount(i, n);
+
+                QuatWide<Width> aw, bw;
+                gather(a + 4 * i, count, aw);
+                gather(b + 4 * i, count, bw);
+
+                Reg ax = Ops::load(aw.x), ay = Ops::load(aw.y);
+                Reg az = Ops::load(aw.z), as = Ops::load(aw.w);
+                Reg bx = Ops::load(bw.x), by = Ops::load(bw.y);
+                Reg bz = Ops::load(bw.z), bs = Ops::load(bw.w);
+
+                QuatWide<Width> result;
+                Ops::store(result.w, Ops::sub(Ops::sub(Ops::mul(as, bs), Ops::mul(ax, bx)),
+                        Ops::add(Ops::mul(ay, by), Ops::mul(az, bz))));
+                Ops::store(result.x, Ops::add(Ops::add(Ops::mul(as, bx), Ops::mul(ax, bs)),
+                        Ops::sub(Ops::mul(ay, bz), Ops::mul(az, by))));
+                Ops::store(result.y, Ops::add(Ops::add(Ops::mul(as, by), Ops::mul(ay, bs)),
+                        Ops::sub(Ops::mul(az, bx), Ops::mul(ax, bz))));
+                Ops::store(result.z, Ops::add(Ops::add(Ops::mul(as, bz), Ops::mul(az, bs)),
+                        Ops::sub(Ops::mul(ax, by), Ops::mul(ay, bx))));
+
+                scatter(result, count, out + 4 * i);
+            }
+        }
+
+        //-------------------------------------------------------------------------------
+        // Purely element-wise, so no transposition to structure of arrays is needed.
+        static void integrateLinear(float * position, const float * velocity, float dt,
+                size_t n) {
+            const size_t numFloats = 3 * n;
+            Reg step = Ops::set1(dt);
+
+            size_t i = 0;
+            for(; i + Width <= numFloats; i += Width) {
+                Reg p = Ops::loadu(position + i);
+                Reg v = Ops::loadu(velocity + i);
+                Ops::storeu(position + i, Ops::fmadd(v, step, p));
+            }
+            for(; i < numFloats; ++i) {
+                position[i] += velocity[i] * dt;
+            }
+        }
+
+        //-------------------------------------------------------------------------------
+        static void integrateAngular(float * orientation, const float * angularVelocity,
+                float dt, size_t n) {
+            Reg halfDt = Ops::set1(0.5f * dt);
+            Reg one = Ops::set1(1.0f);
+
+            for(size_t i = 0; i < n; i += Width) {
+                size_t count = laneCount(i, n);
+
+                QuatWide<Width> qw;
+                Vec3Wide<Width> ww;
+                gather(orientation + 4 * i, count, qw);
+                gather(angularVelocity + 3 * i, count, ww);
+
+                Reg qx = Ops::load(qw.x), qy = Ops::load(qw.y);
+                Reg qz = Ops::load(qw.z), qs = Ops::load(qw.w);
+                Reg wx = Ops::load(ww.x), wy = Ops::load(ww.y), wz = Ops::load(ww.z);
+
+                // dq = quat(0, w) * q
+                Reg ds = Ops::sub(Ops::set1(0.0f), Ops::add(Ops::mul(wx, qx),
+                        Ops::add(Ops::mul(wy, qy), Ops::mul(wz, qz))));
+                Reg dx = Ops::add(Ops::mul(wx, qs), Ops::sub(Ops::mul(wy, qz), Ops::mul(wz, qy)));
+                Reg dy = Ops::add(Ops::mul(wy, qs), Ops::sub(Ops::mul(wz, qx), Ops::mul(wx, qz)));
+                Reg dz = Ops::add(Ops::mul(wz, qs), Ops::sub(Ops::mul(wx, qy), Ops::mul(wy, qx)));
+
+                qs = Ops::fmadd(halfDt, ds, qs);
+                qx = Ops::fmadd(halfDt, dx, qx);
+                qy = Ops::fmadd(halfDt, dy, qy);
+                qz = Ops::fmadd(halfDt, dz, qz);
+
+                Reg lengthSquared = Ops::add(Ops::add(Ops::mul(qx, qx), Ops::mul(qy, qy)),
+                        Ops::add(Ops::mul(qz, qz), Ops::mul(qs, qs)));
+                Reg invLength = Ops::div(one, Ops::sqrt(lengthSquared));
+
+                Ops::store(qw.x, Ops::mul(qx, invLength));
+                Ops::store(qw.y, Ops::mul(qy, invLength));
+                Ops::store(qw.z, Ops::mul(qz, invLength));
+                Ops::store(qw.w, Ops::mul(qs, invLength));
+
+                scatter(qw, count, orientation + 4 * i);
+            }
+        }
+
+        //-------------------------------------------------------------------------------
+        static void rotateInertia(const float * orientation, const float * localInertia,
+                float * worldInertia, size_t n) {
+            Reg one = Ops::set1(1.0f);
+            Reg two = Ops::set1(2.0f);
+
+            for(size_t i = 0; i < n; i += Width) {
+                size_t count = laneCount(i, n);
+
+                QuatWide<Width> qw;
+                Mat3Wide<Width> iw;
+                gather(orientation + 4 * i, count, qw);
+                gather(localInertia + 9 * i, count, iw);
+
+                Reg x = Ops::load(qw.x), y = Ops::load(qw.y);
+                Reg z = Ops::load(qw.z), w = Ops::load(qw.w);
+
+                Reg xx = Ops::mul(x, x), yy = Ops::mul(y, y), zz = Ops::mul(z, z);
+                Reg xy = Ops::mul(x, y), xz = Ops::mul(x, z), yz = Ops::mul(y, z);
+                Reg wx = Ops::mul(w, x), wy = Ops::mul(w, y), wz = Ops::mul(w, z);
+
+                // Rotation matrix, R[col * 3 + row].
+                Reg R[9];
+                R[0] = Ops::sub(one, Ops::mul(two, Ops::add(yy, zz)));
+                R[1] = Ops::mul(two, Ops::add(xy, wz));
+                R[2] = Ops::mul(two, Ops::sub(xz, wy));
+                R[3] = Ops::mul(two, Ops::sub(xy, wz));
+                R[4] = Ops::sub(one, Ops::mul(two, Ops::add(xx, zz)));
+                R[5] = Ops::mul(two, Ops::add(yz, wx));
+                R[6] = Ops::mul(two, Ops::add(xz, wy));
+                R[7] = Ops::mul(two, Ops::sub(yz, wx));
+                R[8] = Ops::sub(one, Ops::mul(two, Ops::add(xx, yy)));
+
+                Reg I[9];
+                for(int k = 0; k < 9; ++k) {
+                    I[k] = Ops::load(iw.m[k]);
+                }
+
+                // T = R * I
+                Reg T[9];
+                for(int col = 0; col < 3; ++col) {
+                    for(int row = 0; row < 3; ++row) {
+                        Reg sum = Ops::mul(R[0 * 3 + row], I[col * 3 + 0]);
+                        sum = Ops::fmadd(R[1 * 3 + row], I[col * 3 + 1], sum);
+                        sum = Ops::fmadd(R[2 * 3 + row], I[col * 3 + 2], sum);
+                        T[col * 3 + row] = sum;
+                    }
+                }
+
+                // W = T * transpose(R)
+                Mat3Wide<Width> result;
+                for(int col = 0; col < 3; ++col) {
+                    for(int row = 0; row < 3; ++row) {
+                        Reg sum = Ops::mul(T[0 * 3 + row], R[0 * 3 + col]);
+                        sum = Ops::fmadd(T[1 * 3 + row], R[1 * 3 + col], sum);
+                        sum = Ops::fmadd(T[2 * 3 + row], R[2 * 3 + col], sum);
+                        Ops::store(result.m[col * 3 + row], sum);
+                    }
+                }
+
+                scatter(result, count, worldInertia + 9 * i);
+            }
+        }
+
+        //-------------------------------------------------------------------------------
+        // A null 'scales' array is treated as unit scale for every element.
+        static void worldMatrices(const float * transforms, const float * scales,
+                float * out, size_t n) {
+            Reg one = Ops::set1(1.0f);
+            Reg two = Ops::set1(2.0f);
+
+            for(size_t i = 0; i < n; i += Width) {
+                size_t count = laneCount(i, n);
+
+                Vec3Wide<Width> pw, sw;
+                QuatWide<Width> qw;
+                gatherTransforms(transforms + 7 * i, count, pw, qw);
+
+                Reg sx = one, sy = one, sz = one;
+                if (scales) {
+                    gather(scales + 3 * i, count, sw);
+                    sx = Ops::load(sw.x);
+                    sy = Ops::load(sw.y);
+                    sz = Ops::load(sw.z);
+                }
+
+                Reg x = Ops::load(qw.x), y = Ops::load(qw.y);
+                Reg z = Ops::load(qw.z), w = Ops::load(qw.w);
+
+                Reg xx = Ops::mul(x, x), yy = Ops::mul(y, y), zz = Ops::mul(z, z);
+                Reg xy = Ops::mul(x, y), xz = Ops::mul(x, z), yz = Ops::mul(y, z);
+                Reg wx = Ops::mul(w, x), wy = Ops::mul(w, y), wz = Ops::mul(w, z);
+
+                // Columns of the rotation matrix, each scaled by its axis scale.
+                Reg M[12];
+                M[0] = Ops::mul(sx, Ops::sub(one, Ops::mul(two, Ops::add(yy, zz))));
+                M[1] = Ops::mul(sx, Ops::mul(two, Ops::add(xy, wz)));
+                M[2] = Ops::mul(sx, Ops::mul(two, Ops::sub(xz, wy)));
+                M[3] = Ops::mul(sy, Ops::mul(two, Ops::sub(xy, wz)));
+                M[4] = Ops::mul(sy, Ops::sub(one, Ops::mul(two, Ops::add(xx, zz))));
+                M[5] = Ops::mul(sy, Ops::mul(two, Ops::add(yz, wx)));
+                M[6] = Ops::mul(sz, Ops::mul(two, Ops::add(xz, wy)));
+                M[7] = Ops::mul(sz, Ops::mul(two, Ops::sub(yz, wx)));
+                M[8] = Ops::mul(sz, Ops::sub(one, Ops::mul(two, Ops::add(xx, yy))));
+                M[9] = Ops::load(pw.x);
+                M[10] = Ops::load(pw.y);
+                M[11] = Ops::load(pw.z);
+
+                // Transpose back out to column-major mat4s.
+                alignas(Width * sizeof(float)) float columns[12][Width];
+                for(int k = 0; k < 12; ++k) {
+                    Ops::store(columns[k], M[k]);
+                }
+
+                float * dst = out + 16 * i;
+                for(size_t lane = 0; lane < count; ++lane, dst += 16) {
+                    for(int col = 0; col < 4; ++col) {
+                        dst[4 * col + 0] = columns[3 * col + 0][lane];
+                        dst[4 * col + 1] = columns[3 * col + 1][lane];
+                        dst[4 * col + 2] = columns[3 * col + 2][lane];
+                        dst[4 * col + 3] = (col == 3) ? 1.0f : 0.0f;
+                    }
+                }
+            }
+        }
+
+        //-------------------------------------------------------------------------------
+        static uint32 popCount(uint32 bits) {
+            bits = bits - ((bits >> 1) & 0x55555555u);
+            bits = (bits & 0x33333333u) + ((bits >> 2) & 0x33333333u);
+            bits = (bits + (bits >> 4)) & 0x0F0F0F0Fu;
+            return (bits * 0x01010101u) >> 24;
+        }
+
+        //-------------------------------------------------------------------------------
+        // Planes are packed as six {normal.xyz, distance}, and 'boxes' points to
+        // the arrays centerX, centerY, centerZ, halfExtentX, halfExtentY and
+        // halfExtentZ.  Boxes are tested 32 at a time, one visibility word each,
+        // with the last partial word read through zero padded copies.
+        static size_t cullBoxes(const float * planes, const float * const * boxes,
+                uint32 * visibility, size_t n) {
+            Reg nx[6], ny[6], nz[6], ax[6], ay[6], az[6], d[6];
+            for(int p = 0; p < 6; ++p) {
+                const float * plane = planes + 4 * p;
+                nx[p] = Ops::set1(plane[0]);
+                ny[p] = Ops::set1(plane[1]);
+                nz[p] = Ops::set1(plane[2]);
+                ax[p] = Ops::set1(plane[0] < 0.0f ? -plane[0] : plane[0]);
+                ay[p] = Ops::set1(plane[1] < 0.0f ? -plane[1] : plane[1]);
+                az[p] = Ops::set1(plane[2] < 0.0f ? -plane[2] : plane[2]);
+                d[p] = Ops::set1(plane[3]);
+            }
+            Reg zero = Ops::set1(0.0f);
+            const int allLanes = (1 << Width) - 1;
+
+            alignas(Width * sizeof(float)) float padded[6][32];
+            size_t numVisible = 0;
+
+            for(size_t first = 0; first < n; first += 32) {
+                const size_t count = (n - first < 32) ? (n - first) : 32;
+
+                const float * src[6];
+                for(int k = 0; k < 6; ++k) {
+                    if (count == 32) {
+                        src[k] = boxes[k] + first;
+                        continue;
+                    }
+                    for(size_t i = 0; i < 32; ++i) {
+                        padded[k][i] = (i < count) ? boxes[k][first + i] : 0.0f;
+                    }
+                    src[k] = padded[k];
+                }
+
+                uint32 bits = 0;
+                for(size_t lane = 0; lane < 32; lane += Width) {
+                    Reg cx = Ops::loadu(src[0] + lane);
+                    Reg cy = Ops::loadu(src[1] + lane);
+                    Reg cz = Ops::loadu(src[2] + lane);
+                    Reg ex = Ops::loadu(src[3] + lane);
+                    Reg ey = Ops::loadu(src[4] + lane);
+                    Reg ez = Ops::loadu(src[5] + lane);
+
+                    // A box is outside a plane when even its corner furthest
+                    // along the plane normal is behind it.
+                    int inside = allLanes;
+                    for(int p = 0; p < 6 && inside != 0; ++p) {
+                        Reg distance = Ops::fmadd(nx[p], cx,
+                                Ops::fmadd(ny[p], cy, Ops::fmadd(nz[p], cz, d[p])));
+                        Reg radius = Ops::fmadd(ax[p], ex,
+                                Ops::fmadd(ay[p], ey, Ops::mul(az[p], ez)));
+                        inside &= Ops::greaterEqualMask(Ops::add(distance, radius), zero);
+                    }
+                    bits |= uint32(inside) << lane;
+                }
+
+                if (count < 32) {
+                    bits &= (uint32(1) << count) - 1;
+                }
+                visibility[first / 32] = bits;
+                numVisible += popCount(bits);
+            }
+
+            return numVisible;
+        }
+    };
+
+}
+}
@@ -0,0 +1,191 @@
+#include "BatchMath.hpp"
+
+#include <Rigid3D/Math/BatchKernels.hpp>
+#include <Rigid3D/Math/Transform.hpp>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstddef>
+
+namespace Rigid3D {
+
+// Kernels reinterpret glm arrays as raw floats.
+static_assert(sizeof(vec3) == 3 * sizeof(float), "vec3 must be tightly packed");
+static_assert(sizeof(quat) == 4 * sizeof(float), "quat must be tightly packed");
+static_assert(sizeof(mat3) == 9 * sizeof(float), "mat3 must be tightly packed");
+static_assert(sizeof(mat4) == 16 * sizeof(float), "mat4 must be tightly packed");
+static_assert(sizeof(vec4) == 4 * sizeof(float), "vec4 must be tightly packed");
+static_assert(sizeof(Transform) == 7 * sizeof(float),
+        "Transform must be tightly packed");
+static_assert(offsetof(Transform, pose) == 3 * sizeof(float),
+        "Transform::pose must directly follow Transform::position");
+
+//----------------------------------------------------------------------------------------
+static void rotateScalar(const float * q, const float * v, float * out, size_t n) {
+    const quat * qs = reinterpret_cast<const quat *>(q);
+    const vec3 * vs = reinterpret_cast<const vec3 *>(v);
+    vec3 * outs = reinterpret_cast<vec3 *>(out);
+    for(size_t i = 0; i < n; ++i) {
+        outs[i] = qs[i] * vs[i];
+    }
+}
+
+//----------------------------------------------------------------------------------------
+static void multiplyScalar(const float * a, const float * b, float * out, size_t n) {
+    const quat * as = reinterpret_cast<const quat *>(a);
+    const quat * bs = reinterpret_cast<const quat *>(b);
+    quat * outs = reinterpret_cast<quat *>(out);
+    for(size_t i = 0; i < n; ++i) {
+        outs[i] = as[i] * bs[i];
+    }
+}
+
+//----------------------------------------------------------------------------------------
+static void integrateLinearScalar(float * position, const float * velocity, float dt,
+        size_t n) {
+    for(size_t i = 0; i < 3 * n; ++i) {
+        position[i] += velocity[i] * dt;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+static void integrateAngularScalar(float * orientation, const float * angularVelocity,
+        float dt, size_t n) {
+    quat * qs = reinterpret_cast<quat *>(orientation);
+    const vec3 * ws = reinterpret_cast<const vec3 *>(angularVelocity);
+    for(size_t i = 0; i < n; ++i) {
+        quat & q = qs[i];
+        const vec3 & w = ws[i];
+        quat dq = quat(0.0f, w.x, w.y, w.z) * q;
+        q.w += 0.5f * dt * dq.w;
+        q.x += 0.5f * dt * dq.x;
+        q.y += 0.5f * dt * dq.y;
+        q.z += 0.5f * dt * dq.z;
+        q = glm::normalize(q);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+static void rotateInertiaScalar(const float * orientation, const float * localInertia,
+        float * worldInertia, size_t n) {
+    const quat * qs = reinterpret_cast<const quat *>(orientation);
+    const mat3 * locals = reinterpret_cast<const mat3 *>(localInertia);
+    mat3 * worlds = reinterpret_cast<mat3 *>(worldInertia);
+    for(size_t i = 0; i < n; ++i) {
+        mat3 R = glm::mat3_cast(qs[i]);
+        worlds[i] = R * locals[i] * glm::transpose(R);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+static void worldMatricesScalar(const float * transforms, const float * scales,
+        float * out, size_t n) {
+    const Transform * ts = reinterpret_cast<const Transform *>(transforms);
+    const vec3 * ss = reinterpret_cast<const vec3 *>(scales);
+    mat4 * outs = reinterpret_cast<mat4 *>(out);
+    for(size_t i = 0; i < n; ++i) {
+        outs[i] = ss ? ts[i].getMatrix(ss[i]) : ts[i].getMatrix();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+static size_t cullBoxesScalar(const float * planes, const float * const * boxes,
+        uint32 * visibility, size_t n) {
+    const vec4 * ps = reinterpret_cast<const vec4 *>(planes);
+    size_t numVisible = 0;
+    for(size_t word = 0; word < (n + 31) / 32; ++word) {
+        visibility[word] = 0;
+    }
+    for(size_t i = 0; i < n; ++i) {
+        const vec3 center(boxes[0][i], boxes[1][i], boxes[2][i]);
+        const vec3 halfExtents(boxes[3][i], boxes[4][i], boxes[5][i]);
+
+        bool inside = true;
+        for(int p = 0; p < 6 && inside; ++p) {
+            const vec3 normal(ps[p]);
+            const float radius = glm::dot(glm::abs(normal), halfExtents);
+            inside = glm::dot(normal, center) + ps[p].w + radius >= 0.0f;
+        }
+        if (inside) {
+            visibility[i / 32] |= uint32(1) << (i % 32);
+            ++numVisible;
+        }
+    }
+    return numVisible;
+}
+
+const BatchKernels scalarBatchKernels = {
+    &rotateScalar,
+    &multiplyScalar,
+    &integrateLinearScalar,
+    &integrateAngularScalar,
+    &rotateInertiaScalar,
+    &worldMatricesScalar,
+    &cullBoxesScalar
+};
+
+//----------------------------------------------------------------------------------------
+static const BatchKernels & kernels() {
+#if defined(RIGID3D_SIMD_X86)
+    switch (getSimdLevel()) {
+    case SimdLevel::AVX2: return avx2BatchKernels;
+    case SimdLevel::SSE: return sseBatchKernels;
+    case SimdLevel::Scalar: return scalarBatchKernels;
+    }
+#endif
+    return scalarBatchKernels;
+}
+
+namespace batch {
+
+//----------------------------------------------------------------------------------------
+void rotate(const quat * q, const vec3 * v, vec3 * out, size_t n) {
+    if (n == 0) { return; }
+    kernels().rotate(&q->x, &v->x, &out->x, n);
+}
+
+//----------------------------------------------------------------------------------------
+void multiply(const quat * a, const quat * b, quat * out, size_t n) {
+    if (n == 0) { return; }
+    kernels().multiply(&a->x, &b->x, &out->x, n);
+}
+
+//----------------------------------------------------------------------------------------
+void integrateLinear(vec3 * position, const vec3 * velocity, float dt, size_t n) {
+    if (n == 0) { return; }
+    kernels().integrateLinear(&position->x, &velocity->x, dt, n);
+}
+
+//----------------------------------------------------------------------------------------
+void integrateAngular(quat * orientation, const vec3 * angularVelocity, float dt,
+        size_t n) {
+    if (n == 0) { return; }
+    kernels().integrateAngular(&orientation->x, &angularVelocity->x, dt, n);
+}
+
+//----------------------------------------------------------------------------------------
+void rotateInertia(const quat * orientation, const mat3 * localInertia,
+        mat3 * worldInertia, size_t n) {
+    if (n == 0) { return; }
+    kernels().rotateInertia(&orientation->x, &localInertia[0][0].x,
+            &worldInertia[0][0].x, n);
+}
+
+//----------------------------------------------------------------------------------------
+void computeWorldMatrices(const Transform * transforms, const vec3 * scales,
+        mat4 * worldMatrices, size_t n) {
+    if (n == 0) { return; }
+    kernels().worldMatrices(&transforms->position.x, scales ? &scales->x : nullptr,
+            &worldMatrices[0][0].x, n);
+}
+
+//----------------------------------------------------------------------------------------
+size_t cullBoxes(const vec4 * planes, const float * const boxes[6], uint32 * visibility,
+        size_t n) {
+    if (n == 0) { return 0; }
+    return kernels().cullBoxes(&planes->x, boxes, visibility, n);
+}
+
+} // end namespace batch
+
+} // end namespace Rigid3D
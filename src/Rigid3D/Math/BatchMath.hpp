@@ -0,0 +1,68 @@
+/**
+ * @brief BatchMath
+ *
+ * Array-at-a-time math kernels for hot loops such as integration, transform
+ * composition, and inertia rotation.  Each function processes 'n' elements
+ * using the instruction set given by getSimdLevel(): AVX2 kernels work on 8
+ * elements at a time, SSE kernels on 4, and the scalar kernels on one.
+ *
+ * Input and output arrays may alias each other exactly, but must not
+ * otherwise overlap.
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_BATCHMATH_HPP_
+#define RIGID3D_BATCHMATH_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Math/SimdLevel.hpp>
+
+#include <cstddef>
+
+// Forward Declarations.
+namespace Rigid3D {
+    class Transform;
+}
+
+namespace Rigid3D {
+namespace batch {
+
+    // out[i] = q[i] * v[i]
+    void rotate(const quat * q, const vec3 * v, vec3 * out, size_t n);
+
+    // out[i] = a[i] * b[i]
+    void multiply(const quat * a, const quat * b, quat * out, size_t n);
+
+    // position[i] += velocity[i] * dt
+    void integrateLinear(vec3 * position, const vec3 * velocity, float dt, size_t n);
+
+    // orientation[i] += 0.5 * dt * quat(0, angularVelocity[i]) * orientation[i],
+    // followed by normalization.
+    void integrateAngular(quat * orientation, const vec3 * angularVelocity, float dt,
+            size_t n);
+
+    // worldInertia[i] = R[i] * localInertia[i] * transpose(R[i]), with R[i] the
+    // rotation matrix of orientation[i].
+    void rotateInertia(const quat * orientation, const mat3 * localInertia,
+            mat3 * worldInertia, size_t n);
+
+    // worldMatrices[i] = transforms[i].getMatrix(scales[i]), producing the same
+    // matrices as ModelTransform::getModelMatrix() for many objects in one pass.
+    // 'scales' may be null, in which case unit scale is used for every element.
+    void computeWorldMatrices(const Transform * transforms, const vec3 * scales,
+            mat4 * worldMatrices, size_t n);
+
+    // Tests n boxes against six planes {normal, distance}, such as those from
+    // Frustum::extractPlanes().  'boxes' points to the structure of arrays
+    // centerX, centerY, centerZ, halfExtentX, halfExtentY, halfExtentZ.  Bit
+    // (i % 32) of visibility[i / 32] is set when box i is at least partly on
+    // the inner side of every plane, and cleared otherwise, overwriting all
+    // (n + 31) / 32 words.  Returns the number of visible boxes.
+    size_t cullBoxes(const vec4 * planes, const float * const boxes[6],
+            uint32 * visibility, size_t n);
+
+}
+}
+
+#endif /* RIGID3D_BATCHMATH_HPP_ */
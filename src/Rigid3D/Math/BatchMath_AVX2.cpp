@@ -0,0 +1,66 @@
+#include "BatchKernels.hpp"
+
+#if defined(RIGID3D_SIMD_X86)
+
+#include <Rigid3D/Math/WideTypes.hpp>
+
+#include <immintrin.h>
+
+// Only the code below is compiled for AVX2 and FMA.  It is called exclusively
+// through avx2BatchKernels, which is selected once the CPU reports support.
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+namespace Rigid3D {
+namespace {
+
+    struct Avx2Ops {
+        typedef __m256 Reg;
+        enum { Width = 8 };
+
+        static Reg load(const float * p) { return _mm256_load_ps(p); }
+        static void store(float * p, Reg a) { _mm256_store_ps(p, a); }
+        static Reg loadu(const float * p) { return _mm256_loadu_ps(p); }
+        static void storeu(float * p, Reg a) { _mm256_storeu_ps(p, a); }
+        static Reg set1(float f) { return _mm256_set1_ps(f); }
+        static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+        static Reg sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+        static Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+        static Reg fmadd(Reg a, Reg b, Reg c) { return _mm256_fmadd_ps(a, b, c); }
+        static Reg div(Reg a, Reg b) { return _mm256_div_ps(a, b); }
+        static Reg sqrt(Reg a) { return _mm256_sqrt_ps(a); }
+        static int greaterEqualMask(Reg a, Reg b) {
+            return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ));
+        }
+    };
+
+}
+}
+
+#include "BatchKernels.inl"
+
+namespace Rigid3D {
+
+    const BatchKernels avx2BatchKernels = {
+        &WideKernels<Avx2Ops>::rotate,
+        &WideKernels<Avx2Ops>::multiply,
+        &WideKernels<Avx2Ops>::integrateLinear,
+        &WideKernels<Avx2Ops>::integrateAngular,
+        &WideKernels<Avx2Ops>::rotateInertia,
+        &WideKernels<Avx2Ops>::worldMatrices,
+        &WideKernels<Avx2Ops>::cullBoxes
+    };
+
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // RIGID3D_SIMD_X86
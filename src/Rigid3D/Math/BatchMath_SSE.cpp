@@ -0,0 +1,51 @@
+#include "BatchKernels.hpp"
+
+#if defined(RIGID3D_SIMD_X86)
+
+#include <Rigid3D/Math/WideTypes.hpp>
+
+#include <emmintrin.h>
+
+namespace Rigid3D {
+namespace {
+
+    struct SseOps {
+        typedef __m128 Reg;
+        enum { Width = 4 };
+
+        static Reg load(const float * p) { return _mm_load_ps(p); }
+        static void store(float * p, Reg a) { _mm_store_ps(p, a); }
+        static Reg loadu(const float * p) { return _mm_loadu_ps(p); }
+        static void storeu(float * p, Reg a) { _mm_storeu_ps(p, a); }
+        static Reg set1(float f) { return _mm_set1_ps(f); }
+        static Reg add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+        static Reg sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+        static Reg mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+        static Reg fmadd(Reg a, Reg b, Reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+        static Reg div(Reg a, Reg b) { return _mm_div_ps(a, b); }
+        static Reg sqrt(Reg a) { return _mm_sqrt_ps(a); }
+        static int greaterEqualMask(Reg a, Reg b) {
+            return _mm_movemask_ps(_mm_cmpge_ps(a, b));
+        }
+    };
+
+}
+}
+
+#include "BatchKernels.inl"
+
+namespace Rigid3D {
+
+    const BatchKernels sseBatchKernels = {
+        &WideKernels<SseOps>::rotate,
+        &WideKernels<SseOps>::multiply,
+        &WideKernels<SseOps>::integrateLinear,
+        &WideKernels<SseOps>::integrateAngular,
+        &WideKernels<SseOps>::rotateInertia,
+        &WideKernels<SseOps>::worldMatrices,
+        &WideKernels<SseOps>::cullBoxes
+    };
+
+}
+
+#endif // RIGID3D_SIMD_X86
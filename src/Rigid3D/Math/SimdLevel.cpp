@@ -0,0 +1,88 @@
+#include "SimdLevel.hpp"
+
+#if defined(RIGID3D_SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+/**
+ * Queries the CPU, and operating system, for the widest instruction set the
+ * batch math kernels can use.
+ */
+SimdLevel detectSimdLevel() {
+#if defined(RIGID3D_SIMD_X86) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SimdLevel::AVX2;
+    }
+    return SimdLevel::SSE;
+
+#elif defined(RIGID3D_SIMD_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+
+    bool hasAvx2 = false;
+    if (maxLeaf >= 7) {
+        __cpuid(info, 1);
+        bool hasFma = (info[2] & (1 << 12)) != 0;
+        bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+        bool hasAvx = (info[2] & (1 << 28)) != 0;
+
+        // Operating system must save the YMM registers on context switches.
+        bool osSavesYmm = hasOsxsave && ((_xgetbv(0) & 0x6) == 0x6);
+
+        __cpuidex(info, 7, 0);
+        hasAvx2 = hasFma && hasAvx && osSavesYmm && ((info[1] & (1 << 5)) != 0);
+    }
+    return hasAvx2 ? SimdLevel::AVX2 : SimdLevel::SSE;
+
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+static SimdLevel & activeSimdLevel() {
+    static SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the instruction set currently used by the batch math kernels.
+ */
+SimdLevel getSimdLevel() {
+    return activeSimdLevel();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Overrides the instruction set used by the batch math kernels, which is
+ * useful for testing and benchmarking each implementation.
+ *
+ * @note Levels wider than the one supported by the CPU are clamped to
+ * detectSimdLevel().  Must not be called while batch kernels run on other
+ * threads.
+ *
+ * @param level
+ */
+void setSimdLevel(SimdLevel level) {
+    SimdLevel supported = detectSimdLevel();
+    activeSimdLevel() = (int(level) > int(supported)) ? supported : level;
+}
+
+//----------------------------------------------------------------------------------------
+const char * getSimdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Scalar: return "Scalar";
+    case SimdLevel::SSE: return "SSE";
+    case SimdLevel::AVX2: return "AVX2";
+    }
+    return "Unknown";
+}
+
+} // end namespace Rigid3D
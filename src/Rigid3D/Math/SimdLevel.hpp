@@ -0,0 +1,37 @@
+/**
+ * @brief SimdLevel
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_SIMDLEVEL_HPP_
+#define RIGID3D_SIMDLEVEL_HPP_
+
+// SSE2 is part of the x86-64 baseline, so SSE and AVX2 kernels are only built
+// for 64-bit x86 targets.  All other targets use the scalar kernels.
+#if defined(__x86_64__) || defined(_M_X64)
+#define RIGID3D_SIMD_X86 1
+#endif
+
+namespace Rigid3D {
+
+    /**
+     * Instruction set used by the batch math kernels.
+     */
+    enum class SimdLevel {
+        Scalar,
+        SSE,
+        AVX2
+    };
+
+    SimdLevel detectSimdLevel();
+
+    SimdLevel getSimdLevel();
+
+    void setSimdLevel(SimdLevel level);
+
+    const char * getSimdLevelName(SimdLevel level);
+
+}
+
+#endif /* RIGID3D_SIMDLEVEL_HPP_ */
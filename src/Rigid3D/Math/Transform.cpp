@@ -1,9 +1,16 @@
 #include "Transform.hpp"
 
+#include <glm/gtc/quaternion.hpp>
+
 namespace Rigid3D {
 
 //----------------------------------------------------------------------------------------
-Transform::Transform() {
+/**
+ * Constructs the identity transform.
+ */
+Transform::Transform()
+    : position(0.0f, 0.0f, 0.0f),
+      pose(1.0f, 0.0f, 0.0f, 0.0f) {
 
 }
 
@@ -19,4 +26,98 @@ Transform::~Transform() {
 
 }
 
+//----------------------------------------------------------------------------------------
+void Transform::setIdentity() {
+    position = vec3(0.0f, 0.0f, 0.0f);
+    pose = quat(1.0f, 0.0f, 0.0f, 0.0f);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the Transform T such that T * (*this) is the identity.
+ *
+ * @note Assumes \c pose is a unit quaternion.
+ */
+Transform Transform::inverse() const {
+    quat inversePose = glm::conjugate(pose);
+    return Transform(-(inversePose * position), inversePose);
+}
+
+//----------------------------------------------------------------------------------------
+vec3 Transform::applyToPoint(const vec3 & point) const {
+    return pose * point + position;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Rotates \a vector, ignoring the translation part of this Transform.
+ */
+vec3 Transform::applyToVector(const vec3 & vector) const {
+    return pose * vector;
+}
+
+//----------------------------------------------------------------------------------------
+vec3 Transform::applyInverseToPoint(const vec3 & point) const {
+    return glm::conjugate(pose) * (point - position);
+}
+
+//----------------------------------------------------------------------------------------
+vec3 Transform::applyInverseToVector(const vec3 & vector) const {
+    return glm::conjugate(pose) * vector;
+}
+
+//----------------------------------------------------------------------------------------
+mat4 Transform::getMatrix() const {
+    return getMatrix(vec3(1.0f, 1.0f, 1.0f));
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the matrix that scales along model space axes by \a scale, then rotates
+ * by \c pose, then translates by \c position.
+ */
+mat4 Transform::getMatrix(const vec3 & scale) const {
+    mat3 R = glm::mat3_cast(pose);
+
+    mat4 matrix;
+    for(int col = 0; col < 3; ++col) {
+        matrix[col] = vec4(R[col] * scale[col], 0.0f);
+    }
+    matrix[3] = vec4(position, 1.0f);
+
+    return matrix;
+}
+
+//----------------------------------------------------------------------------------------
+Transform Transform::operator * (const Transform & other) const {
+    return Transform(pose * other.position + position, pose * other.pose);
+}
+
+//----------------------------------------------------------------------------------------
+Transform & Transform::operator *= (const Transform & other) {
+    *this = *this * other;
+    return *this;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Interpolates between Transforms \a a and \a b, with \a t = 0 returning \a a and
+ * \a t = 1 returning \a b.
+ *
+ * Positions are interpolated linearly and poses are spherically interpolated
+ * along the shortest arc.
+ */
+Transform Transform::interpolate(const Transform & a, const Transform & b, float t) {
+    quat endPose = b.pose;
+    if (glm::dot(a.pose, endPose) < 0.0f) {
+        endPose = -endPose;
+    }
+
+    Transform result;
+    result.position = a.position + (b.position - a.position) * t;
+    result.pose = glm::normalize(glm::mix(a.pose, endPose, t));
+
+    return result;
+}
+
 }
@@ -1,3 +1,9 @@
+/**
+ * @brief Transform
+ *
+ * @author Dustin Biser
+ */
+
 #ifndef RIGID3D_TRANSFORM_HPP_
 #define RIGID3D_TRANSFORM_HPP_
 
@@ -5,6 +11,13 @@
 
 namespace Rigid3D {
 
+    /**
+     * Rigid transformation, consisting of a rotation given by \c pose followed
+     * by a translation given by \c position.
+     *
+     * Transforms compose right to left, so that (A * B).applyToPoint(p) equals
+     * A.applyToPoint(B.applyToPoint(p)).
+     */
     class Transform {
     public:
         vec3 position;
@@ -17,6 +30,26 @@ namespace Rigid3D {
         ~Transform();
 
         void setIdentity();
+
+        Transform inverse() const;
+
+        vec3 applyToPoint(const vec3 & point) const;
+
+        vec3 applyToVector(const vec3 & vector) const;
+
+        vec3 applyInverseToPoint(const vec3 & point) const;
+
+        vec3 applyInverseToVector(const vec3 & vector) const;
+
+        mat4 getMatrix() const;
+
+        mat4 getMatrix(const vec3 & scale) const;
+
+        Transform operator * (const Transform & other) const;
+
+        Transform & operator *= (const Transform & other);
+
+        static Transform interpolate(const Transform & a, const Transform & b, float t);
     };
 
 }
@@ -0,0 +1,126 @@
+/**
+ * @brief WideTypes
+ *
+ * Structure of arrays ("wide") versions of vec3, quat, and mat3 holding
+ * 'Width' values each, one per SIMD lane.  Convert to and from glm types at
+ * batch boundaries with loadWide() and storeWide().
+ *
+ * @author Dustin Biser
+ */
+
+#ifndef RIGID3D_WIDETYPES_HPP_
+#define RIGID3D_WIDETYPES_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+namespace Rigid3D {
+
+    template <int Width>
+    struct alignas(Width * sizeof(float)) Vec3Wide {
+        float x[Width];
+        float y[Width];
+        float z[Width];
+    };
+
+    template <int Width>
+    struct alignas(Width * sizeof(float)) QuatWide {
+        float x[Width];
+        float y[Width];
+        float z[Width];
+        float w[Width];
+    };
+
+    /**
+     * Column-major like glm, such that m[col * 3 + row] holds mat3[col][row]
+     * for each lane.
+     */
+    template <int Width>
+    struct alignas(Width * sizeof(float)) Mat3Wide {
+        float m[9][Width];
+    };
+
+    typedef Vec3Wide<4> vec3x4;
+    typedef Vec3Wide<8> vec3x8;
+    typedef QuatWide<4> quatx4;
+    typedef QuatWide<8> quatx8;
+    typedef Mat3Wide<4> mat3x4;
+    typedef Mat3Wide<8> mat3x8;
+
+    //-----------------------------------------------------------------------------------
+    template <int Width>
+    inline void loadWide(Vec3Wide<Width> & dst, const vec3 * src) {
+        for(int i = 0; i < Width; ++i) {
+            dst.x[i] = src[i].x;
+            dst.y[i] = src[i].y;
+            dst.z[i] = src[i].z;
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    template <int Width>
+    inline void storeWide(const Vec3Wide<Width> & src, vec3 * dst) {
+        for(int i = 0; i < Width; ++i) {
+            dst[i] = vec3(src.x[i], src.y[i], src.z[i]);
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    template <int Width>
+    inline void loadWide(QuatWide<Width> & dst, const quat * src) {
+        for(int i = 0; i < Width; ++i) {
+            dst.x[i] = src[i].x;
+            dst.y[i] = src[i].y;
+            dst.z[i] = src[i].z;
+            dst.w[i] = src[i].w;
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    template <int Width>
+    inline void storeWide(const QuatWide<Width> & src, quat * dst) {
+        for(int i = 0; i < Width; ++i) {
+            dst[i] = quat(src.w[i], src.x[i], src.y[i], src.z[i]);
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    template <int Width>
+    inline void loadWide(Mat3Wide<Width> & dst, const mat3 * src) {
+        for(int i = 0; i < Width; ++i) {
+            for(int col = 0; col < 3; ++col) {
+                for(int row = 0; row < 3; ++row) {
+                    dst.m[col * 3 + row][i] = src[i][col][row];
+                }
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    template <int Width>
+    inline void storeWide(const Mat3Wide<Width> & src, mat3 * dst) {
+        for(int i = 0; i < Width; ++i) {
+            for(int col = 0; col < 3; ++col) {
+                for(int row = 0; row < 3; ++row) {
+                    dst[i][col][row] = src.m[col * 3 + row][i];
+                }
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    template <int Width>
+    inline vec3 getLane(const Vec3Wide<Width> & v, int lane) {
+        return vec3(v.x[lane], v.y[lane], v.z[lane]);
+    }
+
+    //-----------------------------------------------------------------------------------
+    template <int Width>
+    inline void setLane(Vec3Wide<Width> & v, int lane, const vec3 & value) {
+        v.x[lane] = value.x;
+        v.y[lane] = value.y;
+        v.z[lane] = value.z;
+    }
+
+}
+
+#endif /* RIGID3D_WIDETYPES_HPP_ */
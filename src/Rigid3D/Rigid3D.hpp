@@ -10,24 +10,56 @@
 
 #include <Rigid3D/Common/Settings.hpp>
 #include <Rigid3D/Common/GlmOutStream.hpp>
+#include <Rigid3D/Common/MappedFile.hpp>
+#include <Rigid3D/Common/ParallelFor.hpp>
+#include <Rigid3D/Common/RangeAllocator.hpp>
 #include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/SpscRingBuffer.hpp>
 
 #include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Collision/BatchOverlapQuery.hpp>
+#include <Rigid3D/Collision/ContactEvent.hpp>
+#include <Rigid3D/Collision/ContactEventStream.hpp>
+#include <Rigid3D/Collision/DynamicAABBTree.hpp>
+#include <Rigid3D/Collision/VolumeContainment.hpp>
 
+#include <Rigid3D/Dynamics/Joint.hpp>
+#include <Rigid3D/Dynamics/JointSolver.hpp>
+#include <Rigid3D/Dynamics/SolverBody.hpp>
+
+#include <Rigid3D/Graphics/AssetLoader.hpp>
 #include <Rigid3D/Graphics/Camera.hpp>
+#include <Rigid3D/Graphics/CascadedShadowMap.hpp>
 #include <Rigid3D/Graphics/Frustum.hpp>
+#include <Rigid3D/Graphics/FrustumCuller.hpp>
 #include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/IndexBuffer.hpp>
 #include <Rigid3D/Graphics/MaterialProperties.hpp>
 #include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/MeshBvh.hpp>
+#include <Rigid3D/Graphics/MeshCache.hpp>
 #include <Rigid3D/Graphics/MeshConsolidator.hpp>
+#include <Rigid3D/Graphics/MeshOptimizer.hpp>
+#include <Rigid3D/Graphics/MeshSimplifier.hpp>
 #include <Rigid3D/Graphics/ModelTransform.hpp>
+#include <Rigid3D/Graphics/MultiDrawBuilder.hpp>
+#include <Rigid3D/Graphics/OcclusionBuffer.hpp>
 #include "OpenGLContext.hpp"
 #include <Rigid3D/Graphics/RenderableFrustum.hpp>
+#include <Rigid3D/Graphics/RenderQueue.hpp>
 #include <Rigid3D/Graphics/Renderable.hpp>
 #include <Rigid3D/Graphics/ShaderProgram.hpp>
 #include <Rigid3D/Graphics/Shader.hpp>
 #include <Rigid3D/Graphics/ShaderException.hpp>
+#include <Rigid3D/Graphics/Submesh.hpp>
+#include <Rigid3D/Graphics/UniformBlocks.hpp>
+#include <Rigid3D/Graphics/UniformRingBuffer.hpp>
+#include <Rigid3D/Graphics/VertexLayout.hpp>
 
+#include <Rigid3D/Math/BatchMath.hpp>
+#include <Rigid3D/Math/SimdLevel.hpp>
+#include <Rigid3D/Math/Transform.hpp>
 #include <Rigid3D/Math/Trigonometry.hpp>
+#include <Rigid3D/Math/WideTypes.hpp>
 
 #endif /* RIGID3D_HPP_ */
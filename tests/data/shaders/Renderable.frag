@@ -0,0 +1,10 @@
+#version 330
+
+smooth in vec4 passColor;
+
+out vec4 outputColor;
+
+void main()
+{
+	outputColor = passColor;
+}
@@ -0,0 +1,27 @@
+#version 330
+
+uniform mat4 ModelViewMatrix;
+uniform mat4 ProjectionMatrix;
+uniform mat3 NormalMatrix;
+
+struct MaterialProperties {
+    vec3 emission;
+    vec3 Ka;
+    vec3 Kd;
+    float Ks;
+    float shininessFactor;
+};
+uniform MaterialProperties material;
+
+const vec2 corners[3] = vec2[3](vec2(-1.0, -1.0), vec2(3.0, -1.0), vec2(-1.0, 3.0));
+
+smooth out vec4 passColor;
+
+void main()
+{
+    vec3 normal = NormalMatrix * vec3(0.0, 0.0, 1.0);
+    passColor = vec4(material.emission + material.Ka + material.Kd * normal.z,
+            material.Ks * material.shininessFactor);
+
+    gl_Position = ProjectionMatrix * ModelViewMatrix * vec4(corners[gl_VertexID], 0.0, 1.0);
+}
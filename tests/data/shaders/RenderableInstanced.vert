@@ -0,0 +1,29 @@
+#version 330
+
+layout (location = 8) in mat4 InstanceModelViewMatrix;
+layout (location = 12) in mat3 InstanceNormalMatrix;
+
+uniform mat4 ProjectionMatrix;
+
+struct MaterialProperties {
+    vec3 emission;
+    vec3 Ka;
+    vec3 Kd;
+    float Ks;
+    float shininessFactor;
+};
+uniform MaterialProperties material;
+
+const vec2 corners[3] = vec2[3](vec2(-1.0, -1.0), vec2(3.0, -1.0), vec2(-1.0, 3.0));
+
+smooth out vec4 passColor;
+
+void main()
+{
+    vec3 normal = InstanceNormalMatrix * vec3(0.0, 0.0, 1.0);
+    passColor = vec4(material.emission + material.Ka + material.Kd * normal.z,
+            material.Ks * material.shininessFactor);
+
+    gl_Position = ProjectionMatrix * InstanceModelViewMatrix *
+            vec4(corners[gl_VertexID], 0.0, 1.0);
+}
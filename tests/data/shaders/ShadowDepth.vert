@@ -0,0 +1,12 @@
+#version 330
+
+uniform mat4 ModelViewProjectionMatrix;
+
+// The square [-1, 1] x [-1, 1] of the model's xy plane, as two triangles.
+const vec2 corners[6] = vec2[6](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+        vec2(-1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0));
+
+void main()
+{
+    gl_Position = ModelViewProjectionMatrix * vec4(corners[gl_VertexID], 0.0, 1.0);
+}
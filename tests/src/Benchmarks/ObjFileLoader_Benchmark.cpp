@@ -0,0 +1,193 @@
+/**
+ * @brief ObjFileLoader_Benchmark
+ *
+ * Times ObjFileLoader::decode(), both on all hardware threads and on a single
+ * thread, against the stream based ObjFileLoader::decodeWithStreams(), and
+ * checks all produce identical output.  Then times loading through MeshCache,
+ * both when the cache file is written and when it is read back.
+ *
+ * Usage: ObjFileLoader_Benchmark [path/to/mesh.obj]
+ *
+ * Without a path, a synthetic grid mesh of about 200 MB is written to the
+ * current directory and used instead.
+ *
+ * @author Dustin Biser
+ */
+
+#include <Rigid3D/Graphics/ObjFileLoader.hpp>
+#include <Rigid3D/Common/MappedFile.hpp>
+#include <Rigid3D/Graphics/MeshCache.hpp>
+using namespace Rigid3D;
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+namespace {
+
+    const char * syntheticMeshPath = "ObjFileLoader_Benchmark.obj";
+
+    //------------------------------------------------------------------------------------
+    // Writes a height field of 'gridSize' x 'gridSize' vertices, with per-vertex
+    // normals and texture coordinates.
+    void writeSyntheticMesh(const char * path, int gridSize) {
+        std::ofstream out(path);
+        char line[128];
+
+        for(int i = 0; i < gridSize; ++i) {
+            for(int j = 0; j < gridSize; ++j) {
+                float x = i * 0.013f;
+                float z = j * 0.017f;
+                std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n",
+                        x, 0.25f * (x * x - z), z);
+                out << line;
+            }
+        }
+        for(int i = 0; i < gridSize; ++i) {
+            for(int j = 0; j < gridSize; ++j) {
+                std::snprintf(line, sizeof(line), "vt %.6f %.6f\n",
+                        float(i) / gridSize, float(j) / gridSize);
+                out << line;
+            }
+        }
+        for(int i = 0; i < gridSize; ++i) {
+            for(int j = 0; j < gridSize; ++j) {
+                std::snprintf(line, sizeof(line), "vn %.6f %.6f %.6f\n",
+                        -0.1f * i / gridSize, 0.98f, 0.1f * j / gridSize);
+                out << line;
+            }
+        }
+        for(int i = 0; i + 1 < gridSize; ++i) {
+            for(int j = 0; j + 1 < gridSize; ++j) {
+                int a = i * gridSize + j + 1;
+                int b = a + 1;
+                int c = a + gridSize;
+                int d = c + 1;
+                out << "f " << a << '/' << a << '/' << a << ' '
+                            << c << '/' << c << '/' << c << ' '
+                            << b << '/' << b << '/' << b << '\n';
+                out << "f " << b << '/' << b << '/' << b << ' '
+                            << c << '/' << c << '/' << c << ' '
+                            << d << '/' << d << '/' << d << '\n';
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    template <class T>
+    bool sameBytes(const vector<T> & a, const vector<T> & b) {
+        return a.size() == b.size() &&
+               (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+    }
+
+    //------------------------------------------------------------------------------------
+    template <class Decoder>
+    double timeDecode(const char * path, Decoder decoder, vector<vec3> & positions,
+            vector<vec3> & normals, vector<vec2> & uvCoords) {
+        positions.clear();
+        normals.clear();
+        uvCoords.clear();
+
+        auto start = std::chrono::steady_clock::now();
+        decoder(path, positions, normals, uvCoords);
+        auto finish = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double>(finish - start).count();
+    }
+
+}
+
+//----------------------------------------------------------------------------------------
+int main(int argc, char ** argv) {
+    string path;
+    if (argc > 1) {
+        path = argv[1];
+    } else {
+        cout << "Writing synthetic mesh " << syntheticMeshPath << endl;
+        writeSyntheticMesh(syntheticMeshPath, 1000);
+        path = syntheticMeshPath;
+    }
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    double megabytes = double(file.tellg()) / (1024.0 * 1024.0);
+    file.close();
+
+    vector<vec3> streamPositions, streamNormals;
+    vector<vec2> streamUvCoords;
+    double streamSeconds = timeDecode(path.c_str(), &ObjFileLoader::decodeWithStreams,
+            streamPositions, streamNormals, streamUvCoords);
+
+    vector<vec3> positions, normals;
+    vector<vec2> uvCoords;
+    double mappedSeconds = timeDecode(path.c_str(),
+            static_cast<void (*)(const char *, vector<vec3> &, vector<vec3> &,
+                    vector<vec2> &)>(&ObjFileLoader::decode),
+            positions, normals, uvCoords);
+
+    vector<vec3> serialPositions, serialNormals;
+    vector<vec2> serialUvCoords;
+    double serialSeconds = timeDecode(path.c_str(),
+            [](const char * objFilePath, vector<vec3> & p, vector<vec3> & n,
+                    vector<vec2> & uv) {
+                MappedFile mappedFile(objFilePath);
+                ObjFileLoader::decodeBuffer(mappedFile.getData(), mappedFile.getSize(),
+                        p, n, uv, 1);
+            },
+            serialPositions, serialNormals, serialUvCoords);
+
+    bool identical = sameBytes(streamPositions, positions) &&
+                     sameBytes(streamNormals, normals) &&
+                     sameBytes(streamUvCoords, uvCoords) &&
+                     sameBytes(serialPositions, positions) &&
+                     sameBytes(serialNormals, normals) &&
+                     sameBytes(serialUvCoords, uvCoords);
+
+    cout << path << ": " << megabytes << " MB, " << positions.size() / 3
+         << " triangles" << endl;
+    cout << "  decodeWithStreams: " << streamSeconds << " s ("
+         << megabytes / streamSeconds << " MB/s)" << endl;
+    cout << "  decode, 1 thread:  " << serialSeconds << " s ("
+         << megabytes / serialSeconds << " MB/s)" << endl;
+    cout << "  decode:            " << mappedSeconds << " s ("
+         << megabytes / mappedSeconds << " MB/s)" << endl;
+    cout << "  speedup:           " << streamSeconds / mappedSeconds << "x" << endl;
+    cout << "  output identical:  " << (identical ? "yes" : "NO") << endl;
+
+    // Load through the binary cache, first writing it, then reading it back.
+    const string cachePath = MeshCache::getCachePath(path.c_str(), MeshIndexing::Unindexed);
+    std::remove(cachePath.c_str());
+
+    MeshData written, read;
+    auto start = std::chrono::steady_clock::now();
+    MeshCache::load(path.c_str(), MeshIndexing::Unindexed, written);
+    auto middle = std::chrono::steady_clock::now();
+    bool cacheHit = MeshCache::load(path.c_str(), MeshIndexing::Unindexed, read);
+    auto finish = std::chrono::steady_clock::now();
+
+    double writeSeconds = std::chrono::duration<double>(middle - start).count();
+    double readSeconds = std::chrono::duration<double>(finish - middle).count();
+    bool cacheIdentical = cacheHit && sameBytes(positions, read.positions) &&
+                          sameBytes(normals, read.normals) &&
+                          sameBytes(uvCoords, read.uvCoords);
+    identical = identical && cacheIdentical;
+
+    cout << "  cache miss:        " << writeSeconds << " s (decode, BVH and write)" << endl;
+    cout << "  cache hit:         " << readSeconds << " s" << endl;
+    cout << "  cache identical:   " << (cacheIdentical ? "yes" : "NO") << endl;
+
+    std::remove(cachePath.c_str());
+    if (argc <= 1) {
+        std::remove(syntheticMeshPath);
+    }
+
+    return identical ? 0 : 1;
+}
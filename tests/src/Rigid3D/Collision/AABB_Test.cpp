@@ -258,3 +258,49 @@ TEST_F(AABB_Test, ray_cast_miss_y_hit_x_z) {
 
     EXPECT_FALSE(aabb.rayCast(rayCastIn, &rayCastOut));
 }
+
+//----------------------------------------------------------------------------------------
+TEST_F(AABB_Test, overlaps_touching_and_separated) {
+    AABB other;
+    other.minBounds = vec3(1.0f, -0.5f, -0.5f);
+    other.maxBounds = vec3(2.0f, 0.5f, 0.5f);
+    EXPECT_TRUE(aabb.overlaps(other));
+    EXPECT_TRUE(other.overlaps(aabb));
+
+    other.minBounds.x = 1.1f;
+    EXPECT_FALSE(aabb.overlaps(other));
+    EXPECT_FALSE(other.overlaps(aabb));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(AABB_Test, contains_and_combine) {
+    AABB other;
+    other.minBounds = vec3(0.5f, 0.5f, 0.5f);
+    other.maxBounds = vec3(3.0f, 0.75f, 0.75f);
+    EXPECT_FALSE(aabb.contains(other));
+
+    AABB combined = AABB::combine(aabb, other);
+    EXPECT_PRED2(vec3_eq, vec3(-1.0f), combined.minBounds);
+    EXPECT_PRED2(vec3_eq, vec3(3.0f, 1.0f, 1.0f), combined.maxBounds);
+    EXPECT_TRUE(combined.contains(aabb));
+    EXPECT_TRUE(combined.contains(other));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(AABB_Test, surface_area_and_half_extents) {
+    EXPECT_PRED2(float_eq, 24.0f, aabb.getSurfaceArea());
+    EXPECT_PRED2(vec3_eq, vec3(1.0f), aabb.getHalfExtents());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(AABB_Test, from_center_inverts_center_and_half_extents) {
+    AABB box = AABB::fromCenter(vec3(1.0f, 2.0f, 3.0f), vec3(0.5f, 1.0f, 2.0f));
+    EXPECT_PRED2(vec3_eq, vec3(0.5f, 1.0f, 1.0f), box.minBounds);
+    EXPECT_PRED2(vec3_eq, vec3(1.5f, 3.0f, 5.0f), box.maxBounds);
+    EXPECT_PRED2(vec3_eq, vec3(1.0f, 2.0f, 3.0f), box.getCenter());
+    EXPECT_PRED2(vec3_eq, vec3(0.5f, 1.0f, 2.0f), box.getHalfExtents());
+
+    AABB fromSelf = AABB::fromCenter(aabb.getCenter(), aabb.getHalfExtents());
+    EXPECT_PRED2(vec3_eq, aabb.minBounds, fromSelf.minBounds);
+    EXPECT_PRED2(vec3_eq, aabb.maxBounds, fromSelf.maxBounds);
+}
@@ -0,0 +1,191 @@
+// BatchOverlapQuery_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Collision/BatchOverlapQuery.hpp>
+#include <Rigid3D/Collision/DynamicAABBTree.hpp>
+using namespace Rigid3D;
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class BatchOverlapQuery_Test : public ::testing::Test {
+    protected:
+        BatchOverlapQuery_Test()
+            : tree(0.0f) { }
+
+        DynamicAABBTree tree;
+        vector<int32> proxies;
+
+        static float random(float low, float high) {
+            return low + (high - low) * (float(std::rand()) / float(RAND_MAX));
+        }
+
+        // Ran before each test.
+        virtual void SetUp() {
+            std::srand(5);
+
+            // Unit cubes on a grid with spacing 3.
+            for(int x = 0; x < 10; ++x) {
+                for(int y = 0; y < 10; ++y) {
+                    for(int z = 0; z < 10; ++z) {
+                        AABB aabb;
+                        aabb.minBounds = vec3(3.0f * x, 3.0f * y, 3.0f * z);
+                        aabb.maxBounds = aabb.minBounds + vec3(1.0f);
+                        proxies.push_back(tree.createProxy(aabb, uint32(proxies.size())));
+                    }
+                }
+            }
+        }
+
+        static vector<int32> sortedResults(const BatchOverlapQuery & batch, size_t i) {
+            const QueryResultRange & range = batch.getRange(i);
+            vector<int32> found(batch.getResults() + range.offset,
+                    batch.getResults() + range.offset + range.count);
+            std::sort(found.begin(), found.end());
+            return found;
+        }
+
+        vector<int32> bruteForceSphere(const SphereQuery & sphere) {
+            vector<int32> found;
+            for(int32 proxyId : proxies) {
+                const AABB & aabb = tree.getFatAABB(proxyId);
+                vec3 closest = glm::min(glm::max(sphere.center, aabb.minBounds),
+                        aabb.maxBounds);
+                vec3 d = closest - sphere.center;
+                if (glm::dot(d, d) <= sphere.radius * sphere.radius) {
+                    found.push_back(proxyId);
+                }
+            }
+            std::sort(found.begin(), found.end());
+            return found;
+        }
+
+        vector<int32> bruteForceAABB(const AABB & query) {
+            vector<int32> found;
+            for(int32 proxyId : proxies) {
+                if (tree.getFatAABB(proxyId).overlaps(query)) {
+                    found.push_back(proxyId);
+                }
+            }
+            std::sort(found.begin(), found.end());
+            return found;
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(BatchOverlapQuery_Test, sphere_queries_match_brute_force) {
+    vector<SphereQuery> spheres(300);
+    for(SphereQuery & sphere : spheres) {
+        sphere.center = vec3(random(-2.0f, 30.0f), random(-2.0f, 30.0f),
+                random(-2.0f, 30.0f));
+        sphere.radius = random(0.1f, 4.0f);
+    }
+
+    BatchOverlapQuery batch(4);
+    batch.setMinQueriesPerThread(1);
+    batch.querySpheres(tree, spheres.data(), spheres.size());
+
+    ASSERT_EQ(spheres.size(), batch.getNumQueries());
+    size_t totalResults = 0;
+    for(size_t i = 0; i < spheres.size(); ++i) {
+        EXPECT_EQ(bruteForceSphere(spheres[i]), sortedResults(batch, i));
+        totalResults += batch.getRange(i).count;
+    }
+    EXPECT_EQ(totalResults, batch.getNumResults());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(BatchOverlapQuery_Test, aabb_queries_match_brute_force) {
+    vector<AABB> queries(300);
+    for(AABB & query : queries) {
+        query.minBounds = vec3(random(-2.0f, 30.0f), random(-2.0f, 30.0f),
+                random(-2.0f, 30.0f));
+        query.maxBounds = query.minBounds + vec3(random(0.0f, 6.0f));
+    }
+
+    BatchOverlapQuery batch(3);
+    batch.setMinQueriesPerThread(1);
+    batch.queryAABBs(tree, queries.data(), queries.size());
+
+    for(size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(bruteForceAABB(queries[i]), sortedResults(batch, i));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(BatchOverlapQuery_Test, results_are_stored_in_query_order) {
+    vector<AABB> queries(100);
+    for(AABB & query : queries) {
+        query.minBounds = vec3(random(-2.0f, 30.0f), random(-2.0f, 30.0f),
+                random(-2.0f, 30.0f));
+        query.maxBounds = query.minBounds + vec3(4.0f);
+    }
+
+    BatchOverlapQuery batch(4);
+    batch.setMinQueriesPerThread(1);
+    batch.queryAABBs(tree, queries.data(), queries.size());
+
+    uint32 expectedOffset = 0;
+    for(size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(expectedOffset, batch.getRange(i).offset);
+        expectedOffset += batch.getRange(i).count;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(BatchOverlapQuery_Test, axis_aligned_box_matches_aabb_query) {
+    BoxQuery box;
+    box.center = vec3(10.0f, 10.0f, 10.0f);
+    box.halfExtents = vec3(4.0f, 2.0f, 3.0f);
+    box.orientation = quat();
+
+    AABB aabb;
+    aabb.minBounds = box.center - box.halfExtents;
+    aabb.maxBounds = box.center + box.halfExtents;
+
+    BatchOverlapQuery batch(1);
+    batch.queryBoxes(tree, &box, 1);
+    EXPECT_EQ(bruteForceAABB(aabb), sortedResults(batch, 0));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(BatchOverlapQuery_Test, rotated_box_is_tested_exactly) {
+    // Thin box along the line x + y = 2.5, passing between the cubes at the
+    // origin, (3,0,0) and (0,3,0), while its enclosing AABB overlaps all three.
+    BoxQuery box;
+    box.center = vec3(1.25f, 1.25f, 0.5f);
+    box.halfExtents = vec3(3.0f, 0.1f, 0.1f);
+    box.orientation = glm::angleAxis(-0.7853982f, vec3(0.0f, 0.0f, 1.0f));
+
+    AABB enclosing;
+    enclosing.minBounds = vec3(-0.9f, -0.9f, 0.4f);
+    enclosing.maxBounds = vec3(3.4f, 3.4f, 0.6f);
+    ASSERT_EQ(4u, bruteForceAABB(enclosing).size());
+
+    BatchOverlapQuery batch(1);
+    batch.queryBoxes(tree, &box, 1);
+    EXPECT_EQ(0u, batch.getRange(0).count);
+
+    // Shifting the box onto the line x + y = 4 touches the cubes at (3,0,0)
+    // and (0,3,0).
+    box.center = vec3(2.0f, 2.0f, 0.5f);
+    batch.queryBoxes(tree, &box, 1);
+    EXPECT_EQ(2u, batch.getRange(0).count);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(BatchOverlapQuery_Test, empty_batch) {
+    BatchOverlapQuery batch(2);
+    batch.querySpheres(tree, nullptr, 0);
+    EXPECT_EQ(0u, batch.getNumQueries());
+    EXPECT_EQ(0u, batch.getNumResults());
+}
@@ -0,0 +1,166 @@
+// ContactEventStream_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Collision/ContactEventStream.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+using namespace Rigid3D;
+
+#include <thread>
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class ContactEventStream_Test : public ::testing::Test {
+    protected:
+        ContactEventStream_Test()
+            : stream(2, 64) { }
+
+        ContactEventStream stream;
+
+        const ContactEvent * findEvent(uint32 shapeA, uint32 shapeB, bool isTrigger) {
+            for(const ContactEvent & event : stream) {
+                if (event.shapeA == shapeA && event.shapeB == shapeB &&
+                        event.isTrigger == isTrigger) {
+                    return &event;
+                }
+            }
+            return nullptr;
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ContactEventStream_Test, throws_without_threads) {
+    EXPECT_THROW(ContactEventStream(0, 16), Rigid3DException);
+    EXPECT_THROW(ContactEventStream(1, 0), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ContactEventStream_Test, begin_persist_end) {
+    stream.beginStep();
+    stream.reportContact(0, 7, 3);
+    stream.endStep();
+
+    ASSERT_EQ(1u, stream.getNumEvents());
+    EXPECT_EQ(3u, stream.getEvents()[0].shapeA);
+    EXPECT_EQ(7u, stream.getEvents()[0].shapeB);
+    EXPECT_EQ(ContactEventType::Begin, stream.getEvents()[0].type);
+    EXPECT_FALSE(stream.getEvents()[0].isTrigger);
+
+    stream.beginStep();
+    stream.reportContact(1, 3, 7);
+    stream.endStep();
+
+    ASSERT_EQ(1u, stream.getNumEvents());
+    EXPECT_EQ(ContactEventType::Persist, stream.getEvents()[0].type);
+
+    stream.beginStep();
+    stream.endStep();
+
+    ASSERT_EQ(1u, stream.getNumEvents());
+    EXPECT_EQ(ContactEventType::End, stream.getEvents()[0].type);
+    EXPECT_EQ(0u, stream.getNumTouchingPairs());
+
+    stream.beginStep();
+    stream.endStep();
+    EXPECT_EQ(0u, stream.getNumEvents());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ContactEventStream_Test, triggers_keep_shape_order_and_are_tracked_separately) {
+    stream.beginStep();
+    stream.reportTriggerOverlap(0, 9, 2);
+    stream.reportContact(1, 9, 2);
+    stream.endStep();
+
+    ASSERT_EQ(2u, stream.getNumEvents());
+
+    // Contact events sort before trigger events.
+    EXPECT_FALSE(stream.getEvents()[0].isTrigger);
+    EXPECT_EQ(2u, stream.getEvents()[0].shapeA);
+    EXPECT_TRUE(stream.getEvents()[1].isTrigger);
+    EXPECT_EQ(9u, stream.getEvents()[1].shapeA);
+    EXPECT_EQ(2u, stream.getEvents()[1].shapeB);
+
+    stream.beginStep();
+    stream.reportTriggerOverlap(0, 9, 2);
+    stream.endStep();
+
+    ASSERT_EQ(2u, stream.getNumEvents());
+    EXPECT_EQ(ContactEventType::End, findEvent(2, 9, false)->type);
+    EXPECT_EQ(ContactEventType::Persist, findEvent(9, 2, true)->type);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ContactEventStream_Test, duplicate_reports_produce_one_event) {
+    stream.beginStep();
+    stream.reportContact(0, 1, 2);
+    stream.reportContact(1, 2, 1);
+    stream.reportContact(1, 1, 2);
+    stream.endStep();
+
+    EXPECT_EQ(1u, stream.getNumEvents());
+    EXPECT_EQ(1u, stream.getNumTouchingPairs());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ContactEventStream_Test, full_ring_drops_pairs) {
+    ContactEventStream small(1, 4, 16);
+    small.beginStep();
+    for(uint32 i = 0; i < 4; ++i) {
+        EXPECT_TRUE(small.reportContact(0, i, 100));
+    }
+    EXPECT_FALSE(small.reportContact(0, 4, 100));
+
+    // Draining mid-step makes room again.
+    small.drain();
+    EXPECT_TRUE(small.reportContact(0, 5, 100));
+    small.endStep();
+
+    EXPECT_EQ(1u, small.getNumDroppedPairs());
+    EXPECT_EQ(5u, small.getNumEvents());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ContactEventStream_Test, invalid_thread_index_throws) {
+    ContactEventStream stream(2, 4);
+    stream.beginStep();
+    EXPECT_THROW(stream.reportContact(2, 0, 1), Rigid3DException);
+    EXPECT_THROW(stream.reportTriggerOverlap(2, 0, 1), Rigid3DException);
+    stream.endStep();
+
+    EXPECT_EQ(0u, stream.getNumEvents());
+    EXPECT_EQ(0u, stream.getNumDroppedPairs());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ContactEventStream_Test, events_are_sorted_regardless_of_reporting_thread) {
+    const uint32 numThreads = 4;
+    const uint32 pairsPerThread = 500;
+    ContactEventStream threaded(numThreads, pairsPerThread);
+
+    threaded.beginStep();
+    vector<std::thread> workers;
+    for(uint32 t = 0; t < numThreads; ++t) {
+        workers.push_back(std::thread([&threaded, t, numThreads, pairsPerThread]() {
+            // Interleave pairs across threads, in descending order.
+            for(uint32 i = pairsPerThread; i-- > 0;) {
+                threaded.reportContact(t, i * numThreads + t, 1000000);
+            }
+        }));
+    }
+    for(std::thread & worker : workers) {
+        worker.join();
+    }
+    threaded.endStep();
+
+    ASSERT_EQ(numThreads * pairsPerThread, threaded.getNumEvents());
+    EXPECT_EQ(0u, threaded.getNumDroppedPairs());
+    for(size_t i = 0; i < threaded.getNumEvents(); ++i) {
+        EXPECT_EQ(uint32(i), threaded.getEvents()[i].shapeA);
+        EXPECT_EQ(ContactEventType::Begin, threaded.getEvents()[i].type);
+    }
+}
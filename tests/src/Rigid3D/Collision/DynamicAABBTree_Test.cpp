@@ -0,0 +1,258 @@
+// DynamicAABBTree_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Collision/DynamicAABBTree.hpp>
+#include <Rigid3D/Collision/VolumeContainment.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+using namespace Rigid3D;
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class DynamicAABBTree_Test : public ::testing::Test {
+    protected:
+        DynamicAABBTree tree;
+        vector<int32> proxies;
+
+        static float random(float low, float high) {
+            return low + (high - low) * (float(std::rand()) / float(RAND_MAX));
+        }
+
+        static AABB randomAABB() {
+            vec3 center(random(-50.0f, 50.0f), random(-50.0f, 50.0f),
+                    random(-50.0f, 50.0f));
+            vec3 halfExtents(random(0.1f, 2.0f), random(0.1f, 2.0f), random(0.1f, 2.0f));
+            AABB aabb;
+            aabb.minBounds = center - halfExtents;
+            aabb.maxBounds = center + halfExtents;
+            return aabb;
+        }
+
+        // Ran before each test.
+        virtual void SetUp() {
+            std::srand(17);
+            for(uint32 i = 0; i < 500; ++i) {
+                proxies.push_back(tree.createProxy(randomAABB(), i));
+            }
+        }
+
+        vector<int32> treeQuery(const AABB & aabb) {
+            vector<int32> found;
+            tree.query(aabb, [&found](int32 proxyId) {
+                found.push_back(proxyId);
+                return true;
+            });
+            std::sort(found.begin(), found.end());
+            return found;
+        }
+
+        vector<int32> bruteForceQuery(const AABB & aabb) {
+            vector<int32> found;
+            for(int32 proxyId : proxies) {
+                if (tree.getFatAABB(proxyId).overlaps(aabb)) {
+                    found.push_back(proxyId);
+                }
+            }
+            std::sort(found.begin(), found.end());
+            return found;
+        }
+
+        template <class ContainmentTest>
+        vector<int32> treeQueryContainment(const ContainmentTest & test) {
+            vector<int32> found;
+            tree.queryContainment(test, [&found](int32 proxyId) {
+                found.push_back(proxyId);
+                return true;
+            });
+            std::sort(found.begin(), found.end());
+            return found;
+        }
+
+        template <class ContainmentTest>
+        vector<int32> bruteForceContainment(const ContainmentTest & test) {
+            vector<int32> found;
+            for(int32 proxyId : proxies) {
+                if (test(tree.getFatAABB(proxyId)) != Containment::Outside) {
+                    found.push_back(proxyId);
+                }
+            }
+            std::sort(found.begin(), found.end());
+            return found;
+        }
+
+        // Checks parent links, enclosing AABBs, and heights of every node.
+        void checkStructure(int32 nodeId) {
+            const DynamicTreeNode & node = tree.getNode(nodeId);
+            if (node.isLeaf()) {
+                EXPECT_EQ(0, node.height);
+                return;
+            }
+
+            const DynamicTreeNode & child1 = tree.getNode(node.child1);
+            const DynamicTreeNode & child2 = tree.getNode(node.child2);
+            EXPECT_EQ(nodeId, child1.parent);
+            EXPECT_EQ(nodeId, child2.parent);
+            EXPECT_TRUE(node.aabb.contains(child1.aabb));
+            EXPECT_TRUE(node.aabb.contains(child2.aabb));
+            EXPECT_EQ(1 + std::max(child1.height, child2.height), node.height);
+            EXPECT_LE(std::abs(child1.height - child2.height), 1);
+
+            checkStructure(node.child1);
+            checkStructure(node.child2);
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(DynamicAABBTree_Test, tree_is_balanced) {
+    EXPECT_EQ(500, tree.getProxyCount());
+    checkStructure(tree.getRoot());
+
+    // An AVL balanced tree with n leaves is at most 1.44 * log2(n) high.
+    EXPECT_LE(tree.getHeight(), int32(1.44f * std::log2(500.0f)) + 1);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(DynamicAABBTree_Test, fat_aabb_encloses_proxy_aabb) {
+    AABB aabb;
+    aabb.minBounds = vec3(1.0f, 2.0f, 3.0f);
+    aabb.maxBounds = vec3(2.0f, 3.0f, 4.0f);
+    int32 proxyId = tree.createProxy(aabb, 1234);
+
+    EXPECT_TRUE(tree.getFatAABB(proxyId).contains(aabb));
+    EXPECT_EQ(1234u, tree.getUserData(proxyId));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(DynamicAABBTree_Test, query_matches_brute_force) {
+    for(int i = 0; i < 50; ++i) {
+        AABB query = randomAABB();
+        query.maxBounds += vec3(5.0f);
+        EXPECT_EQ(bruteForceQuery(query), treeQuery(query));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(DynamicAABBTree_Test, query_stops_when_callback_returns_false) {
+    AABB everything;
+    everything.minBounds = vec3(-100.0f);
+    everything.maxBounds = vec3(100.0f);
+
+    int count = 0;
+    tree.query(everything, [&count](int32) {
+        ++count;
+        return count < 10;
+    });
+    EXPECT_EQ(10, count);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(DynamicAABBTree_Test, small_moves_do_not_reinsert) {
+    AABB aabb = tree.getFatAABB(proxies[0]);
+    aabb.minBounds += vec3(0.15f);
+    aabb.maxBounds -= vec3(0.15f);
+    EXPECT_FALSE(tree.moveProxy(proxies[0], aabb, vec3(0.0f)));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(DynamicAABBTree_Test, move_and_destroy_keep_queries_correct) {
+    for(size_t i = 0; i < proxies.size(); i += 2) {
+        AABB aabb = randomAABB();
+        EXPECT_TRUE(tree.moveProxy(proxies[i], aabb, vec3(1.0f, 0.0f, -1.0f)));
+        EXPECT_TRUE(tree.getFatAABB(proxies[i]).contains(aabb));
+    }
+    for(size_t i = 1; i < proxies.size(); i += 4) {
+        tree.destroyProxy(proxies[i]);
+        proxies[i] = nullNode;
+    }
+    proxies.erase(std::remove(proxies.begin(), proxies.end(), nullNode), proxies.end());
+
+    EXPECT_EQ(int32(proxies.size()), tree.getProxyCount());
+    checkStructure(tree.getRoot());
+
+    for(int i = 0; i < 50; ++i) {
+        AABB query = randomAABB();
+        query.maxBounds += vec3(5.0f);
+        EXPECT_EQ(bruteForceQuery(query), treeQuery(query));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(DynamicAABBTree_Test, destroy_invalid_proxy_throws) {
+    EXPECT_THROW(tree.destroyProxy(tree.getRoot()), Rigid3DException);
+    EXPECT_THROW(tree.destroyProxy(-1), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(DynamicAABBTree_Test, move_invalid_proxy_throws) {
+    const AABB aabb = randomAABB();
+    const int32 proxy = tree.createProxy(aabb, 0);
+    const int32 destroyed = tree.createProxy(aabb, 1);
+    tree.destroyProxy(destroyed);
+
+    EXPECT_THROW(tree.moveProxy(tree.getRoot(), aabb, vec3(0.0f)), Rigid3DException);
+    EXPECT_THROW(tree.moveProxy(-1, aabb, vec3(0.0f)), Rigid3DException);
+    EXPECT_THROW(tree.moveProxy(destroyed, aabb, vec3(0.0f)), Rigid3DException);
+    EXPECT_THROW(tree.moveProxy(1 << 20, aabb, vec3(0.0f)), Rigid3DException);
+    EXPECT_FALSE(tree.moveProxy(proxy, aabb, vec3(0.0f)));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(DynamicAABBTree_Test, query_containment_matches_brute_force) {
+    for(int i = 0; i < 20; ++i) {
+        SphereContainment sphere(randomAABB().getCenter(), random(5.0f, 40.0f));
+        EXPECT_EQ(bruteForceContainment(sphere), treeQueryContainment(sphere));
+
+        // A box shaped frustum, [-s, s]^3 about a random center.
+        const vec3 c = randomAABB().getCenter();
+        const float s = random(5.0f, 40.0f);
+        const vec4 planes[6] = {
+            vec4(1.0f, 0.0f, 0.0f, s - c.x), vec4(-1.0f, 0.0f, 0.0f, s + c.x),
+            vec4(0.0f, 1.0f, 0.0f, s - c.y), vec4(0.0f, -1.0f, 0.0f, s + c.y),
+            vec4(0.0f, 0.0f, 1.0f, s - c.z), vec4(0.0f, 0.0f, -1.0f, s + c.z)
+        };
+        FrustumContainment frustum(planes);
+        EXPECT_EQ(bruteForceContainment(frustum), treeQueryContainment(frustum));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(DynamicAABBTree_Test, inside_subtrees_are_not_tested_further) {
+    int numTests = 0;
+    auto everything = [&numTests](const AABB &) {
+        ++numTests;
+        return Containment::Inside;
+    };
+    vector<int32> found = treeQueryContainment(everything);
+    EXPECT_EQ(1, numTests);
+    EXPECT_EQ(proxies.size(), found.size());
+
+    // A cone opening along +x from the origin reports each proxy at most once,
+    // and never one it classifies as Outside.
+    ConeContainment cone(vec3(0.0f), vec3(1.0f, 0.0f, 0.0f), 0.5f, 40.0f);
+    found = treeQueryContainment(cone);
+    EXPECT_FALSE(found.empty());
+    EXPECT_TRUE(std::adjacent_find(found.begin(), found.end()) == found.end());
+    for(int32 proxyId : found) {
+        EXPECT_NE(Containment::Outside, cone(tree.getFatAABB(proxyId)));
+    }
+    for(int32 proxyId : proxies) {
+        if (cone(tree.getFatAABB(proxyId)) == Containment::Inside) {
+            EXPECT_TRUE(std::binary_search(found.begin(), found.end(), proxyId));
+        }
+    }
+
+    int count = 0;
+    tree.queryContainment(everything, [&count](int32) {
+        ++count;
+        return count < 10;
+    });
+    EXPECT_EQ(10, count);
+}
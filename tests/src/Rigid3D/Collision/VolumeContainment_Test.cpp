@@ -0,0 +1,78 @@
+// VolumeContainment_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Collision/VolumeContainment.hpp>
+using namespace Rigid3D;
+
+namespace {  // limit class visibility to this file.
+
+    class VolumeContainment_Test : public ::testing::Test { };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VolumeContainment_Test, frustum_classifies_by_plane_distances) {
+    // The half space x >= -1, cut by z in [-10, -1] and |y| <= 5.
+    const vec4 planes[6] = {
+        vec4(1.0f, 0.0f, 0.0f, 1.0f), vec4(-1.0f, 0.0f, 0.0f, 100.0f),
+        vec4(0.0f, 1.0f, 0.0f, 5.0f), vec4(0.0f, -1.0f, 0.0f, 5.0f),
+        vec4(0.0f, 0.0f, -1.0f, -1.0f), vec4(0.0f, 0.0f, 1.0f, 10.0f)
+    };
+    FrustumContainment frustum(planes);
+
+    EXPECT_EQ(Containment::Inside,
+            frustum(AABB::fromCenter(vec3(0.0f, 0.0f, -5.0f), vec3(1.0f))));
+    EXPECT_EQ(Containment::Partial,
+            frustum(AABB::fromCenter(vec3(-1.0f, 0.0f, -5.0f), vec3(1.0f))));
+    EXPECT_EQ(Containment::Partial,
+            frustum(AABB::fromCenter(vec3(0.0f, 0.0f, -10.0f), vec3(1.0f))));
+    EXPECT_EQ(Containment::Outside,
+            frustum(AABB::fromCenter(vec3(-3.0f, 0.0f, -5.0f), vec3(1.0f))));
+    EXPECT_EQ(Containment::Outside,
+            frustum(AABB::fromCenter(vec3(0.0f, 0.0f, 5.0f), vec3(1.0f))));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VolumeContainment_Test, sphere_classifies_by_nearest_and_furthest_points) {
+    SphereContainment sphere(vec3(1.0f, 2.0f, 3.0f), 4.0f);
+
+    EXPECT_EQ(Containment::Inside,
+            sphere(AABB::fromCenter(vec3(1.0f, 2.0f, 3.0f), vec3(2.0f))));
+    EXPECT_EQ(Containment::Partial,
+            sphere(AABB::fromCenter(vec3(1.0f, 2.0f, 3.0f), vec3(3.0f))));
+    EXPECT_EQ(Containment::Partial,
+            sphere(AABB::fromCenter(vec3(6.0f, 2.0f, 3.0f), vec3(1.5f))));
+    EXPECT_EQ(Containment::Outside,
+            sphere(AABB::fromCenter(vec3(8.0f, 2.0f, 3.0f), vec3(1.5f))));
+
+    // Outside along a diagonal, though within the radius along each axis.
+    EXPECT_EQ(Containment::Outside,
+            sphere(AABB::fromCenter(vec3(5.0f, 6.0f, 7.0f), vec3(0.5f))));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VolumeContainment_Test, cone_classifies_by_sides_cap_and_apex) {
+    // Opens along -z with a 45 degree half angle, out to 10 units.
+    ConeContainment cone(vec3(0.0f), vec3(0.0f, 0.0f, -1.0f), 0.785398f, 10.0f);
+
+    EXPECT_TRUE(cone.contains(vec3(0.0f, 0.0f, -5.0f)));
+    EXPECT_TRUE(cone.contains(vec3(4.0f, 0.0f, -5.0f)));
+    EXPECT_FALSE(cone.contains(vec3(6.0f, 0.0f, -5.0f)));
+    EXPECT_FALSE(cone.contains(vec3(0.0f, 0.0f, -11.0f)));
+    EXPECT_FALSE(cone.contains(vec3(0.0f, 0.0f, 1.0f)));
+
+    EXPECT_EQ(Containment::Inside,
+            cone(AABB::fromCenter(vec3(0.0f, 0.0f, -5.0f), vec3(1.0f))));
+    EXPECT_EQ(Containment::Partial,
+            cone(AABB::fromCenter(vec3(5.0f, 0.0f, -5.0f), vec3(1.0f))));
+    EXPECT_EQ(Containment::Partial,
+            cone(AABB::fromCenter(vec3(0.0f, 0.0f, -10.0f), vec3(1.0f))));
+    EXPECT_EQ(Containment::Partial, cone(AABB::fromCenter(vec3(0.0f), vec3(1.0f))));
+    EXPECT_EQ(Containment::Outside,
+            cone(AABB::fromCenter(vec3(9.0f, 0.0f, -5.0f), vec3(1.0f))));
+    EXPECT_EQ(Containment::Outside,
+            cone(AABB::fromCenter(vec3(0.0f, 0.0f, -13.0f), vec3(1.0f))));
+    EXPECT_EQ(Containment::Outside,
+            cone(AABB::fromCenter(vec3(0.0f, 0.0f, 3.0f), vec3(1.0f))));
+}
@@ -0,0 +1,143 @@
+// RangeAllocator_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Common/RangeAllocator.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+using namespace Rigid3D;
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class RangeAllocator_Test : public ::testing::Test {
+    protected:
+        typedef std::pair<uint32, uint32> Range;
+
+        // @return false if any two of 'ranges' overlap, or any exceeds 'capacity'.
+        static bool areDisjoint(vector<Range> ranges, uint32 capacity) {
+            std::sort(ranges.begin(), ranges.end());
+            for(size_t i = 0; i < ranges.size(); ++i) {
+                const uint32 end = ranges[i].first + ranges[i].second;
+                if (end > capacity || (i + 1 < ranges.size() && end > ranges[i + 1].first)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(RangeAllocator_Test, fresh_allocator_hands_out_consecutive_ranges) {
+    RangeAllocator allocator(100);
+    EXPECT_EQ(0u, allocator.allocate(10));
+    EXPECT_EQ(10u, allocator.allocate(1));
+    EXPECT_EQ(11u, allocator.allocate(40));
+    EXPECT_EQ(49u, allocator.getNumFreeUnits());
+    EXPECT_EQ(49u, allocator.getLargestFreeRange());
+    EXPECT_EQ(3u, allocator.getNumAllocations());
+
+    EXPECT_EQ(RangeAllocator::invalidOffset, allocator.allocate(50));
+    EXPECT_EQ(51u, allocator.allocate(49));
+    EXPECT_EQ(0u, allocator.getNumFreeUnits());
+    EXPECT_EQ(0u, allocator.getLargestFreeRange());
+    EXPECT_EQ(RangeAllocator::invalidOffset, allocator.allocate(1));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(RangeAllocator_Test, freed_ranges_merge_with_free_neighbours) {
+    RangeAllocator allocator(30);
+    const uint32 a = allocator.allocate(10);
+    const uint32 b = allocator.allocate(10);
+    const uint32 c = allocator.allocate(10);
+
+    allocator.free(a);
+    allocator.free(c);
+    EXPECT_EQ(20u, allocator.getNumFreeUnits());
+    EXPECT_EQ(10u, allocator.getLargestFreeRange());
+    EXPECT_EQ(RangeAllocator::invalidOffset, allocator.allocate(11));
+
+    allocator.free(b);
+    EXPECT_EQ(30u, allocator.getLargestFreeRange());
+    EXPECT_EQ(0u, allocator.allocate(30));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(RangeAllocator_Test, freed_range_is_reused) {
+    RangeAllocator allocator(1000);
+    allocator.allocate(100);
+    const uint32 hole = allocator.allocate(300);
+    allocator.allocate(100);
+
+    // The hole is a tighter fit than the free space after the last range.
+    allocator.free(hole);
+    EXPECT_EQ(hole, allocator.allocate(200));
+    EXPECT_EQ(hole + 200, allocator.allocate(100));
+    EXPECT_EQ(500u, allocator.getLargestFreeRange());
+    EXPECT_THROW(allocator.free(hole + 1), Rigid3DException);
+    EXPECT_THROW(allocator.allocate(0), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(RangeAllocator_Test, grow_extends_last_free_range) {
+    RangeAllocator allocator;
+    EXPECT_EQ(RangeAllocator::invalidOffset, allocator.allocate(1));
+
+    allocator.grow(10);
+    EXPECT_EQ(0u, allocator.allocate(6));
+    allocator.grow(20);
+    EXPECT_EQ(14u, allocator.getLargestFreeRange());
+    EXPECT_EQ(6u, allocator.allocate(14));
+
+    allocator.grow(25);
+    EXPECT_EQ(20u, allocator.allocate(5));
+    EXPECT_EQ(25u, allocator.getCapacity());
+    EXPECT_THROW(allocator.grow(24), Rigid3DException);
+
+    allocator.reset(8);
+    EXPECT_EQ(0u, allocator.getNumAllocations());
+    EXPECT_EQ(8u, allocator.getNumFreeUnits());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(RangeAllocator_Test, random_allocations_never_overlap) {
+    const uint32 capacity = 1 << 16;
+    RangeAllocator allocator(capacity);
+    vector<Range> live;
+
+    std::srand(3);
+    for(int step = 0; step < 20000; ++step) {
+        if (live.empty() || std::rand() % 3 != 0) {
+            const uint32 size = 1 + uint32(std::rand() % 700);
+            const uint32 offset = allocator.allocate(size);
+            if (offset != RangeAllocator::invalidOffset) {
+                live.push_back(Range(offset, size));
+            }
+        } else {
+            const size_t i = size_t(std::rand()) % live.size();
+            allocator.free(live[i].first);
+            live[i] = live.back();
+            live.pop_back();
+        }
+    }
+    ASSERT_TRUE(areDisjoint(live, capacity));
+
+    uint32 numUsed = 0;
+    for(const Range & range : live) {
+        numUsed += range.second;
+    }
+    EXPECT_EQ(capacity - numUsed, allocator.getNumFreeUnits());
+    EXPECT_EQ(live.size(), allocator.getNumAllocations());
+
+    // Freeing everything leaves a single range again.
+    for(const Range & range : live) {
+        allocator.free(range.first);
+    }
+    EXPECT_EQ(capacity, allocator.getLargestFreeRange());
+}
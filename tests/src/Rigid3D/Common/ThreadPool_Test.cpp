@@ -0,0 +1,167 @@
+// ThreadPool_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Common/ThreadPool.hpp>
+#include <Rigid3D/Common/ParallelFor.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+using namespace Rigid3D;
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class ThreadPool_Test : public ::testing::Test {
+    protected:
+        // Counts, per task, how many times each task ran, and which threads
+        // ran them.
+        struct TaskLog {
+            vector<std::atomic<uint32> > numRuns;
+            std::mutex mutex;
+            std::set<std::thread::id> threads;
+            std::thread::id firstTaskThread;
+
+            explicit TaskLog(uint32 numTasks)
+                : numRuns(numTasks) {
+                for(std::atomic<uint32> & n : numRuns) {
+                    n = 0;
+                }
+            }
+        };
+
+        static void logTask(void * context, uint32 taskIndex) {
+            TaskLog & log = *static_cast<TaskLog *>(context);
+            ++log.numRuns[taskIndex];
+
+            std::lock_guard<std::mutex> lock(log.mutex);
+            log.threads.insert(std::this_thread::get_id());
+            if (taskIndex == 0) {
+                log.firstTaskThread = std::this_thread::get_id();
+            }
+        }
+
+        static void expectEachRanOnce(const TaskLog & log) {
+            for(size_t i = 0; i < log.numRuns.size(); ++i) {
+                EXPECT_EQ(1u, log.numRuns[i].load()) << "task " << i;
+            }
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ThreadPool_Test, runs_every_task_once_with_task_zero_on_the_caller) {
+    ThreadPool pool(3);
+    EXPECT_EQ(3u, pool.getNumWorkers());
+
+    TaskLog log(100);
+    pool.run(100, &logTask, &log);
+    expectEachRanOnce(log);
+    EXPECT_EQ(std::this_thread::get_id(), log.firstTaskThread);
+    EXPECT_LE(log.threads.size(), 4u);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ThreadPool_Test, workers_are_reused_across_runs) {
+    ThreadPool pool(2);
+
+    std::set<std::thread::id> threads;
+    for(int i = 0; i < 50; ++i) {
+        TaskLog batchLog(3);
+        pool.run(3, &logTask, &batchLog);
+        expectEachRanOnce(batchLog);
+        threads.insert(batchLog.threads.begin(), batchLog.threads.end());
+    }
+    EXPECT_LE(threads.size(), 3u);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ThreadPool_Test, without_workers_the_caller_runs_every_task) {
+    ThreadPool pool(0);
+
+    TaskLog log(10);
+    pool.run(10, &logTask, &log);
+    expectEachRanOnce(log);
+    ASSERT_EQ(1u, log.threads.size());
+    EXPECT_EQ(std::this_thread::get_id(), *log.threads.begin());
+
+    pool.run(0, &logTask, &log);
+    expectEachRanOnce(log);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ThreadPool_Test, tasks_may_run_batches_of_their_own) {
+    struct Nested {
+        ThreadPool * pool;
+        std::atomic<uint32> numInnerTasks;
+
+        static void outer(void * context, uint32) {
+            Nested & nested = *static_cast<Nested *>(context);
+            nested.pool->run(8, &inner, context);
+        }
+
+        static void inner(void * context, uint32) {
+            ++static_cast<Nested *>(context)->numInnerTasks;
+        }
+    };
+
+    // Fewer workers than outer tasks, so every worker ends up waiting on an
+    // inner batch.
+    ThreadPool pool(2);
+    Nested nested;
+    nested.pool = &pool;
+    nested.numInnerTasks = 0;
+    pool.run(8, &Nested::outer, &nested);
+    EXPECT_EQ(64u, nested.numInnerTasks.load());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ThreadPool_Test, exceptions_are_rethrown_once_every_task_is_done) {
+    struct Throwing {
+        static void run(void * context, uint32 taskIndex) {
+            logTask(context, taskIndex);
+            if (taskIndex == 0 || taskIndex == 5) {
+                throw Rigid3DException("Task failed.");
+            }
+        }
+    };
+
+    ThreadPool pool(3);
+    TaskLog log(20);
+    EXPECT_THROW(pool.run(20, &Throwing::run, &log), Rigid3DException);
+    expectEachRanOnce(log);
+
+    // The pool still works afterwards.
+    TaskLog nextLog(20);
+    pool.run(20, &logTask, &nextLog);
+    expectEachRanOnce(nextLog);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ThreadPool_Test, parallel_for_covers_the_range_in_chunk_order) {
+    const size_t count = 1000;
+    const uint32 numThreads = 7;
+    vector<uint32> chunkOf(count, numThreads);
+    std::atomic<uint32> numChunks(0);
+
+    parallelFor(count, numThreads, [&](size_t begin, size_t end, uint32 threadIndex) {
+        EXPECT_EQ(chunkBegin(count, numThreads, threadIndex), begin);
+        EXPECT_EQ(chunkBegin(count, numThreads, threadIndex + 1), end);
+        for(size_t i = begin; i < end; ++i) {
+            chunkOf[i] = threadIndex;
+        }
+        ++numChunks;
+    });
+
+    EXPECT_EQ(numThreads, numChunks.load());
+    for(size_t i = 1; i < count; ++i) {
+        ASSERT_LE(chunkOf[i - 1], chunkOf[i]);
+    }
+    EXPECT_EQ(0u, chunkOf.front());
+    EXPECT_EQ(numThreads - 1, chunkOf.back());
+}
@@ -0,0 +1,249 @@
+// JointSolver_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Dynamics/JointSolver.hpp>
+#include <Rigid3D/Dynamics/SolverBody.hpp>
+using namespace Rigid3D;
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+using glm::length;
+using glm::dot;
+
+#include <cmath>
+
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class JointSolver_Test : public ::testing::Test {
+    protected:
+        static const float dt;
+        static const vec3 gravity;
+
+        vector<SolverBody> bodies;
+        JointSolver solver;
+
+        // Ran before each test.
+        virtual void SetUp() {
+            // Body 0 is static ground located at the world origin.
+            bodies.resize(1);
+            bodies[0].setStatic();
+        }
+
+        int32 addDynamicBody(const vec3 & position) {
+            SolverBody body;
+            body.position = position;
+            body.setMass(1.0f, vec3(0.1f));
+            bodies.push_back(body);
+            return int32(bodies.size() - 1);
+        }
+
+        JointID addJoint(JointType type, int32 bodyA, int32 bodyB, const vec3 & anchor,
+                const vec3 & axis = vec3(1.0f, 0.0f, 0.0f)) {
+            JointDef def;
+            def.initialize(type, bodies.data(), bodyA, bodyB, anchor, axis);
+            return solver.createJoint(def);
+        }
+
+        void step(int numSteps, const vec3 & g = gravity) {
+            int32 numBodies = int32(bodies.size());
+            for(int i = 0; i < numSteps; ++i) {
+                integrateVelocities(bodies.data(), numBodies, g, dt);
+                solver.solveVelocities(bodies.data(), dt);
+                integratePositions(bodies.data(), numBodies, dt);
+            }
+        }
+
+        vec3 worldAxis(int32 body, const vec3 & localAxis) {
+            return bodies[body].orientation * localAxis;
+        }
+    };
+
+    const float JointSolver_Test::dt = 1.0f / 60.0f;
+    const vec3 JointSolver_Test::gravity = vec3(0.0f, -10.0f, 0.0f);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(JointSolver_Test, create_joint_with_same_body_throws) {
+    int32 body = addDynamicBody(vec3(1.0f, 0.0f, 0.0f));
+    JointDef def;
+    def.initialize(JointType::Ball, bodies.data(), body, body, vec3(0.0f));
+
+    EXPECT_THROW(solver.createJoint(def), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(JointSolver_Test, get_joint_with_invalid_id_throws) {
+    EXPECT_THROW(solver.getJoint(0), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(JointSolver_Test, ball_joint_pendulum_keeps_length) {
+    int32 bob = addDynamicBody(vec3(1.0f, 0.0f, 0.0f));
+    addJoint(JointType::Ball, 0, bob, vec3(0.0f));
+
+    step(120);
+
+    // Bob has swung down, but remains one unit from the pivot.
+    EXPECT_LT(bodies[bob].position.y, -0.1f);
+    EXPECT_NEAR(1.0f, length(bodies[bob].position), 0.02f);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(JointSolver_Test, ball_joint_chain_stays_connected) {
+    const int numLinks = 10;
+    int32 previous = 0;
+    for(int i = 1; i <= numLinks; ++i) {
+        int32 link = addDynamicBody(vec3(float(i), 0.0f, 0.0f));
+        addJoint(JointType::Ball, previous, link, vec3(float(i) - 0.5f, 0.0f, 0.0f));
+        previous = link;
+    }
+
+    step(120);
+
+    // Consecutive links keep their unit spacing.
+    for(int i = 1; i < numLinks; ++i) {
+        float spacing = length(bodies[i + 1].position - bodies[i].position);
+        EXPECT_NEAR(1.0f, spacing, 0.05f);
+    }
+    EXPECT_NEAR(0.5f, length(bodies[1].position), 0.05f);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(JointSolver_Test, hinge_joint_only_rotates_about_axis) {
+    int32 door = addDynamicBody(vec3(1.0f, 0.0f, 0.0f));
+    addJoint(JointType::Hinge, 0, door, vec3(0.0f), vec3(0.0f, 0.0f, 1.0f));
+
+    // Spin the door about an axis that is not the hinge axis.
+    bodies[door].angularVelocity = vec3(3.0f, 2.0f, 1.0f);
+    step(60);
+
+    vec3 hingeAxis = worldAxis(door, vec3(0.0f, 0.0f, 1.0f));
+    EXPECT_GT(dot(hingeAxis, vec3(0.0f, 0.0f, 1.0f)), 0.99f);
+    EXPECT_NEAR(0.0f, bodies[door].position.z, 0.02f);
+    EXPECT_NEAR(1.0f, length(bodies[door].position), 0.02f);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(JointSolver_Test, hinge_joint_limit_stops_rotation) {
+    int32 door = addDynamicBody(vec3(1.0f, 0.0f, 0.0f));
+    JointID hinge = addJoint(JointType::Hinge, 0, door, vec3(0.0f), vec3(0.0f, 0.0f, 1.0f));
+
+    DofConfig & dof = solver.getJoint(hinge).angular[0];
+    dof.mode = DofMode::Limited;
+    dof.lowerLimit = -0.25f;
+    dof.upperLimit = 0.25f;
+
+    // Gravity swings the door downwards, which is a negative rotation about +z.
+    step(120);
+
+    float angle = std::atan2(bodies[door].position.y, bodies[door].position.x);
+    EXPECT_GT(angle, -0.25f - 0.05f);
+    EXPECT_LT(angle, -0.25f + 0.05f);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(JointSolver_Test, hinge_joint_motor_reaches_target_speed) {
+    int32 wheel = addDynamicBody(vec3(0.0f));
+    JointID hinge = addJoint(JointType::Hinge, 0, wheel, vec3(0.0f), vec3(0.0f, 1.0f, 0.0f));
+
+    DofConfig & dof = solver.getJoint(hinge).angular[0];
+    dof.enableMotor = true;
+    dof.motorSpeed = 2.0f;
+    dof.maxMotorForce = 100.0f;
+
+    step(30, vec3(0.0f));
+
+    EXPECT_NEAR(2.0f, bodies[wheel].angularVelocity.y, 0.01f);
+    EXPECT_NEAR(0.0f, bodies[wheel].angularVelocity.x, 0.01f);
+    EXPECT_NEAR(0.0f, bodies[wheel].angularVelocity.z, 0.01f);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(JointSolver_Test, slider_joint_only_translates_along_axis) {
+    int32 block = addDynamicBody(vec3(0.0f));
+    addJoint(JointType::Slider, 0, block, vec3(0.0f), vec3(1.0f, -1.0f, 0.0f));
+
+    bodies[block].angularVelocity = vec3(1.0f, 2.0f, 3.0f);
+    step(60);
+
+    // Block slides down the incline without leaving it or rotating.
+    vec3 p = bodies[block].position;
+    EXPECT_GT(p.x, 0.5f);
+    EXPECT_NEAR(-p.x, p.y, 0.02f);
+    EXPECT_NEAR(0.0f, p.z, 0.02f);
+    EXPECT_GT(bodies[block].orientation.w, 0.999f);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(JointSolver_Test, slider_joint_limit_stops_translation) {
+    int32 block = addDynamicBody(vec3(0.0f));
+    JointID slider = addJoint(JointType::Slider, 0, block, vec3(0.0f), vec3(0.0f, 1.0f, 0.0f));
+
+    DofConfig & dof = solver.getJoint(slider).linear[0];
+    dof.mode = DofMode::Limited;
+    dof.lowerLimit = -1.0f;
+    dof.upperLimit = 1.0f;
+
+    step(120);
+
+    EXPECT_NEAR(-1.0f, bodies[block].position.y, 0.05f);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(JointSolver_Test, fixed_joint_holds_relative_transform) {
+    int32 arm = addDynamicBody(vec3(1.0f, 0.0f, 0.0f));
+    int32 hand = addDynamicBody(vec3(2.0f, 0.0f, 0.0f));
+    addJoint(JointType::Ball, 0, arm, vec3(0.0f));
+    addJoint(JointType::Fixed, arm, hand, vec3(1.5f, 0.0f, 0.0f));
+
+    step(120);
+
+    // Hand stays one unit out along the arm's x-axis, and shares its orientation.
+    vec3 expected = bodies[arm].position + worldAxis(arm, vec3(1.0f, 0.0f, 0.0f));
+    EXPECT_NEAR(0.0f, length(bodies[hand].position - expected), 0.05f);
+    EXPECT_GT(std::fabs(dot(bodies[arm].orientation, bodies[hand].orientation)), 0.999f);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(JointSolver_Test, generic_6dof_all_locked_behaves_as_fixed) {
+    int32 body = addDynamicBody(vec3(1.0f, 1.0f, 0.0f));
+    JointID joint = addJoint(JointType::Generic6Dof, 0, body, vec3(1.0f, 1.0f, 0.0f));
+
+    JointDef & def = solver.getJoint(joint);
+    for(int i = 0; i < 3; ++i) {
+        def.linear[i].mode = DofMode::Locked;
+        def.angular[i].mode = DofMode::Locked;
+    }
+
+    step(60);
+
+    EXPECT_NEAR(0.0f, length(bodies[body].position - vec3(1.0f, 1.0f, 0.0f)), 0.01f);
+    EXPECT_GT(bodies[body].orientation.w, 0.999f);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(JointSolver_Test, generic_6dof_free_linear_axis_with_limit) {
+    int32 body = addDynamicBody(vec3(0.0f));
+    JointID joint = addJoint(JointType::Generic6Dof, 0, body, vec3(0.0f),
+            vec3(0.0f, 1.0f, 0.0f));
+
+    JointDef & def = solver.getJoint(joint);
+    for(int i = 0; i < 3; ++i) {
+        def.linear[i].mode = DofMode::Locked;
+        def.angular[i].mode = DofMode::Locked;
+    }
+    def.linear[0].mode = DofMode::Limited;
+    def.linear[0].lowerLimit = -0.5f;
+    def.linear[0].upperLimit = 0.5f;
+
+    step(120);
+
+    EXPECT_NEAR(-0.5f, bodies[body].position.y, 0.05f);
+    EXPECT_NEAR(0.0f, bodies[body].position.x, 0.01f);
+    EXPECT_NEAR(0.0f, bodies[body].position.z, 0.01f);
+}
@@ -0,0 +1,139 @@
+// AssetLoader_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/AssetLoader.hpp>
+#include <Rigid3D/Graphics/MeshCache.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+using namespace Rigid3D;
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+using std::string;
+
+#include <thread>
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    const char * cubePath = "../data/meshes/cube.obj";
+    const char * smoothCubePath = "../data/meshes/cube_smooth.obj";
+    const char * texturedCubePath = "../data/meshes/cube_textured.obj";
+
+    class AssetLoader_Test : public ::testing::Test {
+    protected:
+        virtual void TearDown() {
+            const char * paths[] = {cubePath, smoothCubePath, texturedCubePath};
+            for(const char * path : paths) {
+                std::remove(MeshCache::getCachePath(path, MeshIndexing::Unindexed).c_str());
+                std::remove(MeshCache::getCachePath(path, MeshIndexing::Indexed).c_str());
+            }
+        }
+
+        // Hands over finished assets until one arrives, without blocking on the
+        // futures themselves.
+        static uint32 updateUntilHandedOver(AssetLoader & loader, size_t maxBytes) {
+            for(int i = 0; i < 10000; ++i) {
+                uint32 numHandedOver = loader.update(maxBytes);
+                if (numHandedOver != 0) {
+                    return numHandedOver;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return 0;
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(AssetLoader_Test, loaded_mesh_matches_synchronous_load) {
+    AssetLoader loader(2);
+    EXPECT_EQ(2u, loader.getNumThreads());
+
+    AssetLoader::MeshFuture future = loader.loadMesh(cubePath, MeshIndexing::Indexed);
+    EXPECT_EQ(1u, loader.getNumPending());
+    loader.finish();
+    EXPECT_EQ(0u, loader.getNumPending());
+
+    ASSERT_TRUE(AssetLoader::isReady(future));
+    const Mesh & loaded = *future.get();
+    Mesh expected(cubePath, MeshIndexing::Indexed);
+
+    EXPECT_EQ(*expected.getVertexPositionVector(), *loaded.getVertexPositionVector());
+    EXPECT_EQ(*expected.getVertexNormalVector(), *loaded.getVertexNormalVector());
+    EXPECT_EQ(expected.getNumIndices(), loaded.getNumIndices());
+    EXPECT_TRUE(loaded.isIndexed());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(AssetLoader_Test, futures_become_ready_only_through_update) {
+    AssetLoader loader(1);
+    AssetLoader::FileFuture future = loader.loadFile(cubePath);
+
+    // Give the worker ample time to finish, without handing anything over.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(AssetLoader::isReady(future));
+
+    EXPECT_EQ(1u, updateUntilHandedOver(loader, 0));
+    ASSERT_TRUE(AssetLoader::isReady(future));
+    EXPECT_FALSE(future.get()->empty());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(AssetLoader_Test, update_respects_byte_budget) {
+    AssetLoader loader(1);
+    vector<AssetLoader::MeshFuture> futures;
+    futures.push_back(loader.loadMesh(cubePath));
+    futures.push_back(loader.loadMesh(smoothCubePath));
+    futures.push_back(loader.loadMesh(texturedCubePath));
+
+    // A budget smaller than any one mesh hands over exactly one per update.
+    uint32 numHandedOver = 0;
+    for(int frame = 0; frame < 3; ++frame) {
+        EXPECT_EQ(1u, updateUntilHandedOver(loader, 1));
+        ++numHandedOver;
+        uint32 numReady = 0;
+        for(const AssetLoader::MeshFuture & future : futures) {
+            numReady += AssetLoader::isReady(future) ? 1 : 0;
+        }
+        EXPECT_EQ(numHandedOver, numReady);
+    }
+    EXPECT_EQ(0u, loader.getNumPending());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(AssetLoader_Test, loading_pending_asset_shares_future) {
+    AssetLoader loader(2);
+    AssetLoader::MeshFuture first = loader.loadMesh(cubePath);
+    AssetLoader::MeshFuture second = loader.loadMesh(cubePath);
+    AssetLoader::MeshFuture indexed = loader.loadMesh(cubePath, MeshIndexing::Indexed);
+    EXPECT_EQ(2u, loader.getNumPending());
+
+    loader.finish();
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_NE(first.get(), indexed.get());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(AssetLoader_Test, failed_load_throws_from_future) {
+    AssetLoader loader(1);
+    AssetLoader::MeshFuture mesh = loader.loadMesh("does_not_exist.obj");
+    AssetLoader::FileFuture file = loader.loadFile("does_not_exist.glsl");
+    loader.finish();
+
+    EXPECT_THROW(mesh.get(), Rigid3DException);
+    EXPECT_THROW(file.get(), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(AssetLoader_Test, destroying_loader_abandons_pending_loads) {
+    AssetLoader::MeshFuture future;
+    {
+        AssetLoader loader(1);
+        future = loader.loadMesh(cubePath);
+    }
+    EXPECT_THROW(future.get(), std::future_error);
+}
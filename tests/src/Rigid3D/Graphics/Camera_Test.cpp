@@ -384,3 +384,33 @@ TEST_F(Camera_Test, yaw_does_not_modify_up_vector) {
     expect_orthonormal_view_matrix();
     EXPECT_PRED2(vec3_eq, up_default, camera.getUpDirection());
 }
+
+//----------------------------------------------------------------------------------------
+TEST_F(Camera_Test, planes_bound_the_view_volume) {
+    camera.setPosition(1.0f, 2.0f, 3.0f);
+
+    vec4 planes[Rigid3D::numFrustumPlanes];
+    camera.getPlanes(planes);
+
+    // Near and far planes face along the view direction, at 1 and 10 units.
+    vec4 nearPlane = planes[int(Rigid3D::FrustumPlane::Near)];
+    vec4 farPlane = planes[int(Rigid3D::FrustumPlane::Far)];
+    EXPECT_NEAR(-1.0f, nearPlane.z, 1.0e-5f);
+    EXPECT_NEAR(1.0f, farPlane.z, 1.0e-5f);
+    EXPECT_NEAR(0.0f, dot(vec3(nearPlane), vec3(1.0f, 2.0f, 2.0f)) + nearPlane.w, 1.0e-4f);
+    EXPECT_NEAR(0.0f, dot(vec3(farPlane), vec3(1.0f, 2.0f, -7.0f)) + farPlane.w, 1.0e-4f);
+
+    const vec3 inside(1.0f, 2.0f, -2.0f);
+    const vec3 behind(1.0f, 2.0f, 4.0f);
+    const vec3 beside(30.0f, 2.0f, -2.0f);
+    bool behindCulled = false;
+    bool besideCulled = false;
+    for(const vec4 & plane : planes) {
+        EXPECT_NEAR(1.0f, length(vec3(plane)), epsilon * 10.0f);
+        EXPECT_LT(0.0f, dot(vec3(plane), inside) + plane.w);
+        behindCulled = behindCulled || dot(vec3(plane), behind) + plane.w < 0.0f;
+        besideCulled = besideCulled || dot(vec3(plane), beside) + plane.w < 0.0f;
+    }
+    EXPECT_TRUE(behindCulled);
+    EXPECT_TRUE(besideCulled);
+}
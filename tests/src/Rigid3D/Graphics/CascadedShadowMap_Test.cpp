@@ -0,0 +1,349 @@
+// CascadedShadowMap_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/CascadedShadowMap.hpp>
+#include <Rigid3D/Graphics/Camera.hpp>
+#include <Rigid3D/Graphics/MeshConsolidator.hpp>
+#include <Rigid3D/Graphics/Renderable.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <cmath>
+#include <memory>
+#include <vector>
+using std::shared_ptr;
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class CascadedShadowMap_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+        static shared_ptr<ShaderProgram> depthProgram;
+
+        GLuint vao;
+        BatchInfo square;
+        Camera camera;
+
+        CascadedShadowMap_Test()
+            : square(0, 6),
+              camera(1.0f, 1.0f, 1.0f, 100.0f) {
+            glGenVertexArrays(1, &vao);
+        }
+
+        ~CascadedShadowMap_Test() {
+            glDeleteVertexArrays(1, &vao);
+        }
+
+        // glCopyImageSubData is core from OpenGL 4.3.
+        static void SetUpTestCase() {
+            glContext = std::make_shared<OpenGLContext>(4, 3);
+            glContext->init();
+
+            depthProgram = std::make_shared<ShaderProgram>();
+            depthProgram->generateProgramObject();
+            depthProgram->attachVertexShader("../data/shaders/ShadowDepth.vert");
+            depthProgram->attachFragmentShader("../data/shaders/ShadowDepth.frag");
+            depthProgram->link();
+        }
+
+        static void TearDownTestCase() {
+            depthProgram.reset();
+            glContext.reset();
+        }
+
+        // A caster covering the square of half size 'halfSize' about 'center',
+        // facing the z-axis.
+        Renderable makeCaster(const vec3 & center, float halfSize) {
+            Renderable renderable(&vao, depthProgram.get(), &square);
+            renderable.setPosition(center);
+            renderable.setScale(vec3(halfSize, halfSize, 1.0f));
+            return renderable;
+        }
+
+        // Depth of the texel of 'cascade' that 'position' falls in.
+        static float readDepth(const CascadedShadowMap & shadowMap, uint32 cascade,
+                const vec3 & position) {
+            const uint32 resolution = shadowMap.getResolution();
+            vector<float> depths(resolution * resolution * shadowMap.getNumCascades());
+            glBindTexture(GL_TEXTURE_2D_ARRAY, shadowMap.getDepthTexture());
+            glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT, GL_FLOAT, depths.data());
+            glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+            const vec4 texCoord = shadowMap.getShadowMatrix(cascade) * vec4(position, 1.0f);
+            const uint32 x = uint32(texCoord.x * resolution);
+            const uint32 y = uint32(texCoord.y * resolution);
+            return depths[(cascade * resolution + y) * resolution + x];
+        }
+    };
+
+    shared_ptr<OpenGLContext> CascadedShadowMap_Test::glContext;
+    shared_ptr<ShaderProgram> CascadedShadowMap_Test::depthProgram;
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(CascadedShadowMap_Test, splits_blend_uniform_and_logarithmic_distances) {
+    EXPECT_THROW(CascadedShadowMap(0), Rigid3DException);
+    EXPECT_THROW(CascadedShadowMap(CascadedShadowMap::maxCascades + 1), Rigid3DException);
+    EXPECT_THROW(CascadedShadowMap(4, 0), Rigid3DException);
+
+    CascadedShadowMap shadowMap(4, 256);
+    shadowMap.setSplitLambda(0.0f);
+    shadowMap.update(camera);
+    EXPECT_NEAR(25.75f, shadowMap.getSplitDistance(0), 1e-4f);
+    EXPECT_NEAR(50.5f, shadowMap.getSplitDistance(1), 1e-4f);
+    EXPECT_NEAR(75.25f, shadowMap.getSplitDistance(2), 1e-4f);
+    EXPECT_NEAR(100.0f, shadowMap.getSplitDistance(3), 1e-3f);
+
+    // The camera's far plane limits the shadow distance.
+    shadowMap.setSplitLambda(1.0f);
+    shadowMap.setShadowDistance(1000.0f);
+    shadowMap.update(camera);
+    EXPECT_NEAR(std::sqrt(10.0f), shadowMap.getSplitDistance(0), 1e-4f);
+    EXPECT_NEAR(10.0f, shadowMap.getSplitDistance(1), 1e-4f);
+    EXPECT_NEAR(std::sqrt(1000.0f), shadowMap.getSplitDistance(2), 1e-3f);
+    EXPECT_NEAR(100.0f, shadowMap.getSplitDistance(3), 1e-3f);
+
+    Camera orthographic(-1.0f, 1.0f, -1.0f, 1.0f, 1.0f, 100.0f);
+    EXPECT_THROW(shadowMap.update(orthographic), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(CascadedShadowMap_Test, cascades_contain_their_camera_slice) {
+    camera.setPosition(vec3(3.0f, 2.0f, 1.0f));
+    camera.lookAt(vec3(-4.0f, 0.0f, -20.0f));
+
+    CascadedShadowMap shadowMap(4, 512);
+    shadowMap.setLightDirection(vec3(-1.0f, -2.0f, -1.0f));
+    shadowMap.update(camera);
+
+    const mat4 projection = camera.getProjectionMatrix();
+    const float tanHalfX = 1.0f / projection[0][0];
+    const float tanHalfY = 1.0f / projection[1][1];
+
+    float sliceNear = 1.0f;
+    for(uint32 i = 0; i < shadowMap.getNumCascades(); ++i) {
+        const float sliceFar = shadowMap.getSplitDistance(i);
+        EXPECT_LT(sliceNear, sliceFar);
+
+        for(float depth : {sliceNear, sliceFar}) {
+            for(float sx : {-1.0f, 1.0f}) {
+                for(float sy : {-1.0f, 1.0f}) {
+                    const vec3 corner = camera.getPosition() +
+                            camera.getForwardDirection() * depth -
+                            camera.getLeftDirection() * (sx * depth * tanHalfX) +
+                            camera.getUpDirection() * (sy * depth * tanHalfY);
+                    const vec4 clip = shadowMap.getViewProjectionMatrix(i) *
+                            vec4(corner, 1.0f);
+                    EXPECT_LE(std::abs(clip.x), 1.0f) << "cascade " << i;
+                    EXPECT_LE(std::abs(clip.y), 1.0f) << "cascade " << i;
+                    EXPECT_LE(std::abs(clip.z), 1.0f) << "cascade " << i;
+                }
+            }
+        }
+        sliceNear = sliceFar;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(CascadedShadowMap_Test, casters_are_culled_per_cascade) {
+    CascadedShadowMap shadowMap(4, 256);
+    shadowMap.setLightDirection(vec3(0.0f, 0.0f, -1.0f));
+
+    const vec3 centers[4] = {
+        vec3(0.0f, 0.0f, -5.0f),    // Nearest cascade, and shadows the rest.
+        vec3(0.0f, 0.0f, -95.0f),   // Beyond all but the farthest cascade.
+        vec3(500.0f, 0.0f, -50.0f), // Outside every cascade.
+        vec3(0.0f, 0.0f, 50.0f)     // Behind the camera, towards the light.
+    };
+    vector<Renderable> renderables;
+    for(const vec3 & center : centers) {
+        renderables.push_back(makeCaster(center, 1.0f));
+    }
+    const vec3 halfExtents(1.0f, 1.0f, 0.1f);
+    for(uint32 i = 0; i < 4; ++i) {
+        EXPECT_EQ(i, shadowMap.addCaster(renderables[i],
+                AABB::fromCenter(centers[i], halfExtents), false));
+    }
+    EXPECT_EQ(4u, shadowMap.getNumCasters());
+    EXPECT_THROW(shadowMap.setCasterBounds(4, AABB::fromCenter(centers[0], halfExtents)),
+            Rigid3DException);
+
+    shadowMap.update(camera);
+    for(uint32 cascade = 0; cascade < 4; ++cascade) {
+        EXPECT_TRUE(shadowMap.isCasterInCascade(0, cascade));
+        EXPECT_EQ(cascade == 3, shadowMap.isCasterInCascade(1, cascade));
+        EXPECT_FALSE(shadowMap.isCasterInCascade(2, cascade));
+        EXPECT_TRUE(shadowMap.isCasterInCascade(3, cascade));
+    }
+    EXPECT_EQ(7u, shadowMap.getStats().numCastersCulled);
+
+    shadowMap.render(*depthProgram);
+    EXPECT_EQ(4u, shadowMap.getStats().numCascadesRendered);
+    EXPECT_EQ(9u, shadowMap.getStats().numCastersDrawn);
+    EXPECT_EQ(GLenum(GL_NO_ERROR), glGetError());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(CascadedShadowMap_Test, only_cascades_with_moved_casters_are_redrawn) {
+    CascadedShadowMap shadowMap(4, 128);
+    shadowMap.setLightDirection(vec3(0.0f, 0.0f, -1.0f));
+
+    const vec3 groundCenter(-30.0f, 0.0f, -60.0f);
+    vec3 movingCenter(0.0f, 0.0f, -95.0f);
+    Renderable ground = makeCaster(groundCenter, 20.0f);
+    Renderable moving = makeCaster(movingCenter, 3.0f);
+    const vec3 groundHalfExtents(20.0f, 20.0f, 0.1f);
+    const vec3 movingHalfExtents(3.0f, 3.0f, 0.1f);
+    const uint32 groundId = shadowMap.addCaster(ground,
+            AABB::fromCenter(groundCenter, groundHalfExtents), true);
+    const uint32 movingId = shadowMap.addCaster(moving,
+            AABB::fromCenter(movingCenter, movingHalfExtents), false);
+
+    shadowMap.update(camera);
+    shadowMap.render(*depthProgram);
+    EXPECT_EQ(4u, shadowMap.getStats().numCascadesRendered);
+    EXPECT_EQ(4u, shadowMap.getStats().numStaticCascadesRendered);
+    ASSERT_TRUE(shadowMap.isCasterInCascade(movingId, 3));
+    for(uint32 cascade = 0; cascade < 3; ++cascade) {
+        ASSERT_FALSE(shadowMap.isCasterInCascade(movingId, cascade));
+    }
+
+    uint32 numGroundCascades = 0;
+    for(uint32 cascade = 0; cascade < 4; ++cascade) {
+        numGroundCascades += shadowMap.isCasterInCascade(groundId, cascade) ? 1 : 0;
+    }
+    ASSERT_TRUE(shadowMap.isCasterInCascade(groundId, 3));
+
+    const float groundDepth = readDepth(shadowMap, 3, groundCenter);
+    EXPECT_LT(groundDepth, 1.0f);
+    EXPECT_LT(readDepth(shadowMap, 3, movingCenter), 1.0f);
+
+    // Nothing moved.
+    shadowMap.update(camera);
+    shadowMap.render(*depthProgram);
+    EXPECT_EQ(0u, shadowMap.getStats().numCascadesRendered);
+    EXPECT_EQ(0u, shadowMap.getStats().numCastersDrawn);
+
+    // The dynamic caster moves within the farthest cascade, which is redrawn
+    // from its static cache.
+    const vec3 oldCenter = movingCenter;
+    movingCenter = vec3(10.0f, 0.0f, -95.0f);
+    moving.setPosition(movingCenter);
+    shadowMap.setCasterBounds(movingId, AABB::fromCenter(movingCenter, movingHalfExtents));
+    shadowMap.update(camera);
+    shadowMap.render(*depthProgram);
+    EXPECT_EQ(1u, shadowMap.getStats().numCascadesRendered);
+    EXPECT_EQ(0u, shadowMap.getStats().numStaticCascadesRendered);
+    EXPECT_EQ(1u, shadowMap.getStats().numCastersDrawn);
+
+    EXPECT_FLOAT_EQ(groundDepth, readDepth(shadowMap, 3, groundCenter));
+    EXPECT_LT(readDepth(shadowMap, 3, movingCenter), 1.0f);
+    EXPECT_EQ(1.0f, readDepth(shadowMap, 3, oldCenter));
+
+    // A small camera move keeps every slice inside its cascade.
+    camera.translate(0.01f, 0.0f, 0.0f);
+    shadowMap.update(camera);
+    shadowMap.render(*depthProgram);
+    EXPECT_EQ(0u, shadowMap.getStats().numCascadesRendered);
+
+    // Moving the static caster redraws the caches of its cascades.
+    const vec3 groundMoved = groundCenter + vec3(0.0f, 1.0f, 0.0f);
+    ground.setPosition(groundMoved);
+    shadowMap.setCasterBounds(groundId, AABB::fromCenter(groundMoved, groundHalfExtents));
+    shadowMap.update(camera);
+    shadowMap.render(*depthProgram);
+    EXPECT_EQ(numGroundCascades, shadowMap.getStats().numCascadesRendered);
+    EXPECT_EQ(numGroundCascades, shadowMap.getStats().numStaticCascadesRendered);
+
+    // As does turning the light.
+    shadowMap.setLightDirection(vec3(0.0f, -1.0f, -1.0f));
+    shadowMap.update(camera);
+    shadowMap.render(*depthProgram);
+    EXPECT_EQ(4u, shadowMap.getStats().numCascadesRendered);
+    EXPECT_EQ(4u, shadowMap.getStats().numStaticCascadesRendered);
+    EXPECT_EQ(GLenum(GL_NO_ERROR), glGetError());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(CascadedShadowMap_Test, render_restores_the_callers_state) {
+    CascadedShadowMap shadowMap(2, 128);
+    Renderable caster = makeCaster(vec3(0.0f, 0.0f, -5.0f), 1.0f);
+    shadowMap.addCaster(caster, AABB::fromCenter(vec3(0.0f, 0.0f, -5.0f), vec3(1.0f)),
+            false);
+
+    GLint contextFramebuffer;
+    GLint contextViewport[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &contextFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, contextViewport);
+    GLuint framebuffer;
+    GLuint renderbuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(1, &renderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 32, 32);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+            renderbuffer);
+
+    glViewport(1, 2, 30, 20);
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+    glEnable(GL_DEPTH_CLAMP);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(0.5f, 1.5f);
+
+    // The first render creates the shadow map's textures and framebuffer.
+    for(int frame = 0; frame < 2; ++frame) {
+        shadowMap.setLightDirection(vec3(0.0f, -1.0f, -1.0f - float(frame)));
+        shadowMap.update(camera);
+        shadowMap.render(*depthProgram);
+        EXPECT_EQ(2u, shadowMap.getStats().numCascadesRendered);
+
+        GLint drawFramebuffer;
+        GLint readFramebuffer;
+        GLint readBuffer;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+        glGetIntegerv(GL_READ_BUFFER, &readBuffer);
+        EXPECT_EQ(GLint(framebuffer), drawFramebuffer) << "in frame " << frame;
+        EXPECT_EQ(GLint(framebuffer), readFramebuffer) << "in frame " << frame;
+        EXPECT_EQ(GL_COLOR_ATTACHMENT0, readBuffer) << "in frame " << frame;
+
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        EXPECT_EQ(1, viewport[0]);
+        EXPECT_EQ(2, viewport[1]);
+        EXPECT_EQ(30, viewport[2]);
+        EXPECT_EQ(20, viewport[3]);
+
+        GLboolean depthMask;
+        GLfloat polygonOffset[2];
+        glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+        glGetFloatv(GL_POLYGON_OFFSET_FACTOR, &polygonOffset[0]);
+        glGetFloatv(GL_POLYGON_OFFSET_UNITS, &polygonOffset[1]);
+        EXPECT_FALSE(glIsEnabled(GL_DEPTH_TEST));
+        EXPECT_EQ(GL_FALSE, depthMask);
+        EXPECT_TRUE(glIsEnabled(GL_DEPTH_CLAMP));
+        EXPECT_TRUE(glIsEnabled(GL_POLYGON_OFFSET_FILL));
+        EXPECT_EQ(0.5f, polygonOffset[0]);
+        EXPECT_EQ(1.5f, polygonOffset[1]);
+    }
+    EXPECT_EQ(GLenum(GL_NO_ERROR), glGetError());
+
+    // Back to the context's own framebuffer and defaults for the other tests.
+    glBindFramebuffer(GL_FRAMEBUFFER, contextFramebuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &renderbuffer);
+    glViewport(contextViewport[0], contextViewport[1], contextViewport[2],
+            contextViewport[3]);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_DEPTH_CLAMP);
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(0.0f, 0.0f);
+}
@@ -0,0 +1,116 @@
+// FrustumCuller_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/FrustumCuller.hpp>
+#include <Rigid3D/Graphics/Camera.hpp>
+#include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+using namespace Rigid3D;
+
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class FrustumCuller_Test : public ::testing::Test {
+    protected:
+        Camera camera;
+
+        // Ran before each test.
+        virtual void SetUp() {
+            camera = Camera(45.0f, 1.0f, 1.0f, 100.0f);
+        }
+
+        // A row of boxes along z, half in front of the camera and half behind.
+        static void addRow(FrustumCuller & culler, uint32 numBoxes) {
+            for(uint32 i = 0; i < numBoxes; ++i) {
+                float z = (i % 2 == 0) ? -2.0f - float(i % 90) : 2.0f + float(i % 90);
+                culler.addBox(AABB::fromCenter(vec3(0.0f, 0.0f, z), vec3(0.5f)));
+            }
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(FrustumCuller_Test, boxes_outside_the_view_volume_are_culled) {
+    FrustumCuller culler(1);
+    const vec3 halfExtents(1.0f);
+    const uint32 inFront =
+            culler.addBox(AABB::fromCenter(vec3(0.0f, 0.0f, -10.0f), halfExtents));
+    const uint32 behind =
+            culler.addBox(AABB::fromCenter(vec3(0.0f, 0.0f, 10.0f), halfExtents));
+    const uint32 beyondFar =
+            culler.addBox(AABB::fromCenter(vec3(0.0f, 0.0f, -200.0f), halfExtents));
+    const uint32 toTheSide =
+            culler.addBox(AABB::fromCenter(vec3(100.0f, 0.0f, -10.0f), halfExtents));
+    const uint32 straddlingNear = culler.addBox(AABB::fromCenter(vec3(0.0f), vec3(2.0f)));
+
+    culler.cull(camera);
+    EXPECT_TRUE(culler.isVisible(inFront));
+    EXPECT_FALSE(culler.isVisible(behind));
+    EXPECT_FALSE(culler.isVisible(beyondFar));
+    EXPECT_FALSE(culler.isVisible(toTheSide));
+    EXPECT_TRUE(culler.isVisible(straddlingNear));
+    EXPECT_EQ(2u, culler.getNumVisible());
+    EXPECT_EQ(3u, culler.getNumCulled());
+
+    // Moving a box takes effect at the next cull.
+    culler.setBox(behind, AABB::fromCenter(vec3(0.0f, 0.0f, -20.0f), halfExtents));
+    culler.cull(camera);
+    EXPECT_TRUE(culler.isVisible(behind));
+    EXPECT_EQ(3u, culler.getNumVisible());
+
+    EXPECT_THROW(culler.setBox(5, AABB::fromCenter(vec3(0.0f), halfExtents)),
+            Rigid3DException);
+
+    culler.clear();
+    EXPECT_EQ(0u, culler.getNumBoxes());
+    culler.cull(camera);
+    EXPECT_EQ(0u, culler.getNumVisible());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(FrustumCuller_Test, threaded_culling_matches_single_threaded) {
+    FrustumCuller serial(1);
+    FrustumCuller threaded(4);
+    threaded.setMinBoxesPerThread(1);
+
+    // Not a multiple of 32 words per thread, so chunks split unevenly.
+    const uint32 numBoxes = 10001;
+    addRow(serial, numBoxes);
+    addRow(threaded, numBoxes);
+
+    camera.lookAt(vec3(0.5f, 0.0f, -1.0f));
+    serial.cull(camera);
+    threaded.cull(camera);
+
+    EXPECT_EQ(serial.getVisibility(), threaded.getVisibility());
+    EXPECT_EQ(serial.getNumVisible(), threaded.getNumVisible());
+    EXPECT_EQ(numBoxes, threaded.getNumVisible() + threaded.getNumCulled());
+    EXPECT_LT(0u, threaded.getNumVisible());
+    EXPECT_LT(0u, threaded.getNumCulled());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(FrustumCuller_Test, small_cull_after_large_one_counts_only_its_boxes) {
+    FrustumCuller culler(8);
+    culler.setMinBoxesPerThread(1);
+    addRow(culler, 10000);
+    culler.cull(camera);
+
+    // 20 boxes fit in one visibility word, so only one chunk runs.
+    culler.clear();
+    addRow(culler, 20);
+    culler.cull(camera);
+    EXPECT_EQ(10u, culler.getNumVisible());
+    EXPECT_EQ(10u, culler.getNumCulled());
+
+    // As do 40 boxes split over two words and threads.
+    culler.clear();
+    addRow(culler, 40);
+    culler.cull(camera);
+    EXPECT_EQ(20u, culler.getNumVisible());
+    EXPECT_EQ(20u, culler.getNumCulled());
+}
@@ -0,0 +1,131 @@
+// MeshBvh_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/MeshBvh.hpp>
+#include <Rigid3D/Graphics/IndexBuffer.hpp>
+using namespace Rigid3D;
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class MeshBvh_Test : public ::testing::Test {
+    protected:
+        vector<vec3> positions;
+        IndexBuffer noIndices;
+
+        // Random small triangles scattered through a 10 x 10 x 10 box.
+        void buildTriangleSoup(int numTriangles) {
+            std::srand(11);
+            for(int t = 0; t < numTriangles; ++t) {
+                vec3 corner(randomFloat(0.0f, 10.0f), randomFloat(0.0f, 10.0f),
+                        randomFloat(0.0f, 10.0f));
+                positions.push_back(corner);
+                positions.push_back(corner + vec3(randomFloat(0.0f, 0.5f), 0.0f, 0.0f));
+                positions.push_back(corner + vec3(0.0f, randomFloat(0.0f, 0.5f), 0.1f));
+            }
+        }
+
+        static float randomFloat(float min, float max) {
+            return min + (max - min) * (std::rand() / float(RAND_MAX));
+        }
+
+        AABB triangleAABB(uint32 t) const {
+            AABB aabb;
+            aabb.minBounds = glm::min(positions[3 * t], glm::min(positions[3 * t + 1],
+                    positions[3 * t + 2]));
+            aabb.maxBounds = glm::max(positions[3 * t], glm::max(positions[3 * t + 1],
+                    positions[3 * t + 2]));
+            return aabb;
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshBvh_Test, empty_mesh_has_empty_bvh) {
+    MeshBvh bvh;
+    bvh.build(positions, noIndices);
+    EXPECT_TRUE(bvh.empty());
+
+    int numHits = 0;
+    bvh.query(AABB{vec3(-1.0f), vec3(1.0f)}, [&numHits](uint32) { ++numHits; });
+    EXPECT_EQ(0, numHits);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshBvh_Test, leaves_hold_every_triangle_once) {
+    buildTriangleSoup(1000);
+    MeshBvh bvh;
+    bvh.build(positions, noIndices);
+
+    vector<int> counts(1000, 0);
+    for(const MeshBvhNode & node : bvh.getNodes()) {
+        if (node.isLeaf()) {
+            EXPECT_LE(node.count, MeshBvh::maxTrianglesPerLeaf);
+            for(uint32 i = node.first; i < node.first + node.count; ++i) {
+                uint32 t = bvh.getTriangles()[i];
+                ++counts[t];
+                EXPECT_TRUE(node.aabb.contains(triangleAABB(t)));
+            }
+        } else {
+            EXPECT_TRUE(node.aabb.contains(bvh.getNodes()[node.first].aabb));
+            EXPECT_TRUE(node.aabb.contains(bvh.getNodes()[node.first + 1].aabb));
+        }
+    }
+
+    EXPECT_EQ(1000, std::count(counts.begin(), counts.end(), 1));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshBvh_Test, query_finds_every_overlapping_triangle) {
+    buildTriangleSoup(2000);
+    MeshBvh bvh;
+    bvh.build(positions, noIndices);
+
+    for(int q = 0; q < 50; ++q) {
+        vec3 center(randomFloat(0.0f, 10.0f), randomFloat(0.0f, 10.0f),
+                randomFloat(0.0f, 10.0f));
+        AABB query = {center - vec3(1.0f), center + vec3(1.0f)};
+
+        vector<uint32> expected;
+        for(uint32 t = 0; t < 2000; ++t) {
+            if (triangleAABB(t).overlaps(query)) {
+                expected.push_back(t);
+            }
+        }
+
+        vector<uint32> found;
+        bvh.query(query, [&found](uint32 t) { found.push_back(t); });
+        std::sort(found.begin(), found.end());
+
+        // Queries are resolved to leaves, so nearby triangles may also be found,
+        // but never twice.
+        EXPECT_TRUE(std::adjacent_find(found.begin(), found.end()) == found.end());
+        EXPECT_TRUE(std::includes(found.begin(), found.end(),
+                expected.begin(), expected.end()));
+        EXPECT_LT(found.size(), expected.size() + 100);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshBvh_Test, indexed_triangles_use_indices) {
+    positions.push_back(vec3(0.0f));
+    positions.push_back(vec3(1.0f, 0.0f, 0.0f));
+    positions.push_back(vec3(0.0f, 1.0f, 0.0f));
+    positions.push_back(vec3(10.0f));
+
+    vector<uint32> indexVector = {0, 1, 2, 1, 2, 3};
+    IndexBuffer indices;
+    indices.assign(indexVector, 4);
+
+    MeshBvh bvh;
+    bvh.build(positions, indices);
+    ASSERT_EQ(1u, bvh.getNodes().size());
+    EXPECT_EQ(vec3(0.0f), bvh.getNodes()[0].aabb.minBounds);
+    EXPECT_EQ(vec3(10.0f), bvh.getNodes()[0].aabb.maxBounds);
+}
@@ -0,0 +1,351 @@
+// MeshCache_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/MeshCache.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+using namespace Rigid3D;
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+namespace {  // limit class visibility to this file.
+
+    const char * objFilePath = "MeshCache_Test.obj";
+
+    const char * objContents =
+            "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 0 0 2\n"
+            "vn 0 0 1\nvn 1 0 0\n"
+            "f 1//1 2//1 3//1\n"
+            "f 1//2 2//2 4//2\n";
+
+    class MeshCache_Test : public ::testing::Test {
+    protected:
+        virtual void SetUp() {
+            writeFile(objFilePath, objContents);
+            removeCaches();
+        }
+
+        virtual void TearDown() {
+            std::remove(objFilePath);
+            removeCaches();
+        }
+
+        static void removeCaches() {
+            std::remove(MeshCache::getCachePath(objFilePath, MeshIndexing::Unindexed).c_str());
+            std::remove(MeshCache::getCachePath(objFilePath, MeshIndexing::Indexed).c_str());
+        }
+
+        static void writeFile(const char * path, const string & contents) {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out << contents;
+        }
+
+        static void setModifiedTime(const char * path, time_t modifiedTime) {
+            struct utimbuf times;
+            times.actime = modifiedTime;
+            times.modtime = modifiedTime;
+            utime(path, &times);
+        }
+
+        static bool fileExists(const string & path) {
+            struct stat fileStatus;
+            return stat(path.c_str(), &fileStatus) == 0;
+        }
+
+        // Writes 'data' as the cache file of the current source file.
+        static void writeCache(MeshIndexing indexing, const MeshData & data) {
+            MeshSourceInfo source;
+            ASSERT_TRUE(MeshCache::getSourceInfo(objFilePath, source));
+            const string cachePath = MeshCache::getCachePath(objFilePath, indexing);
+            ASSERT_TRUE(MeshCache::write(cachePath.c_str(), objFilePath, source,
+                    MeshCache::hashFile(objFilePath), indexing, data));
+        }
+
+        static time_t getModifiedTime(const char * path) {
+            struct stat fileStatus;
+            stat(path, &fileStatus);
+            return fileStatus.st_mtime;
+        }
+
+        static void expectSameData(const MeshData & expected, const MeshData & actual) {
+            EXPECT_EQ(expected.positions, actual.positions);
+            EXPECT_EQ(expected.normals, actual.normals);
+            EXPECT_EQ(expected.uvCoords, actual.uvCoords);
+
+            ASSERT_EQ(expected.indices.getNumIndices(), actual.indices.getNumIndices());
+            if (!expected.indices.empty()) {
+                EXPECT_EQ(expected.indices.getIndexSize(), actual.indices.getIndexSize());
+                EXPECT_EQ(0, std::memcmp(expected.indices.getDataPtr(),
+                        actual.indices.getDataPtr(), expected.indices.getNumBytes()));
+            }
+
+            EXPECT_EQ(expected.aabb.minBounds, actual.aabb.minBounds);
+            EXPECT_EQ(expected.aabb.maxBounds, actual.aabb.maxBounds);
+
+            ASSERT_EQ(expected.bvh.getNodes().size(), actual.bvh.getNodes().size());
+            EXPECT_EQ(expected.bvh.getTriangles(), actual.bvh.getTriangles());
+
+            ASSERT_EQ(expected.lodIndices.getNumIndices(), actual.lodIndices.getNumIndices());
+            if (!expected.lodIndices.empty()) {
+                EXPECT_EQ(0, std::memcmp(expected.lodIndices.getDataPtr(),
+                        actual.lodIndices.getDataPtr(), expected.lodIndices.getNumBytes()));
+            }
+            EXPECT_EQ(expected.lodRatios, actual.lodRatios);
+            ASSERT_EQ(expected.lods.size(), actual.lods.size());
+            for(size_t k = 0; k < expected.lods.size(); ++k) {
+                EXPECT_EQ(expected.lods[k].error, actual.lods[k].error);
+                EXPECT_EQ(expected.lods[k].startIndex, actual.lods[k].startIndex);
+                EXPECT_EQ(expected.lods[k].numIndices, actual.lods[k].numIndices);
+                EXPECT_EQ(expected.lods[k].submeshes.size(), actual.lods[k].submeshes.size());
+            }
+        }
+
+        // A bumpy grid of 'size' x 'size' quads, which simplifies well.
+        static string buildGridObj(int size) {
+            std::ostringstream obj;
+            for(int y = 0; y <= size; ++y) {
+                for(int x = 0; x <= size; ++x) {
+                    obj << "v " << x << " " << y << " " << ((x * y) % 3) * 0.01f << "\n";
+                }
+            }
+            for(int y = 0; y < size; ++y) {
+                for(int x = 0; x < size; ++x) {
+                    const int v = y * (size + 1) + x + 1;
+                    obj << "f " << v << " " << v + 1 << " " << v + size + 2 << "\n";
+                    obj << "f " << v << " " << v + size + 2 << " " << v + size + 1 << "\n";
+                }
+            }
+            return obj.str();
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshCache_Test, first_load_writes_cache_and_second_load_reads_it) {
+    MeshData decoded;
+    EXPECT_FALSE(MeshCache::load(objFilePath, MeshIndexing::Unindexed, decoded));
+    EXPECT_EQ(6u, decoded.positions.size());
+    EXPECT_EQ(vec3(0.0f), decoded.aabb.minBounds);
+    EXPECT_EQ(vec3(1.0f, 1.0f, 2.0f), decoded.aabb.maxBounds);
+    EXPECT_FALSE(decoded.bvh.empty());
+
+    MeshData cached;
+    EXPECT_TRUE(MeshCache::load(objFilePath, MeshIndexing::Unindexed, cached));
+    expectSameData(decoded, cached);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshCache_Test, indexed_meshes_are_cached_separately) {
+    MeshData unindexed, indexed;
+    EXPECT_FALSE(MeshCache::load(objFilePath, MeshIndexing::Unindexed, unindexed));
+    EXPECT_FALSE(MeshCache::load(objFilePath, MeshIndexing::Indexed, indexed));
+    EXPECT_EQ(6u, indexed.indices.getNumIndices());
+    EXPECT_EQ(6u, indexed.positions.size());
+
+    MeshData cached;
+    EXPECT_TRUE(MeshCache::load(objFilePath, MeshIndexing::Indexed, cached));
+    expectSameData(indexed, cached);
+
+    EXPECT_TRUE(MeshCache::load(objFilePath, MeshIndexing::Unindexed, cached));
+    expectSameData(unindexed, cached);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshCache_Test, changed_source_invalidates_cache) {
+    MeshData data;
+    MeshCache::load(objFilePath, MeshIndexing::Unindexed, data);
+
+    // Same size, different contents and modification time.
+    string changed(objContents);
+    changed.replace(changed.find("v 1 0 0"), 7, "v 5 0 0");
+    writeFile(objFilePath, changed);
+    setModifiedTime(objFilePath, getModifiedTime(objFilePath) + 10);
+
+    EXPECT_FALSE(MeshCache::load(objFilePath, MeshIndexing::Unindexed, data));
+    EXPECT_EQ(vec3(5.0f, 0.0f, 0.0f), data.positions[1]);
+
+    EXPECT_TRUE(MeshCache::load(objFilePath, MeshIndexing::Unindexed, data));
+    EXPECT_EQ(vec3(5.0f, 0.0f, 0.0f), data.positions[1]);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshCache_Test, touched_source_with_same_contents_uses_cache) {
+    MeshData data;
+    MeshCache::load(objFilePath, MeshIndexing::Unindexed, data);
+
+    setModifiedTime(objFilePath, getModifiedTime(objFilePath) + 10);
+    EXPECT_TRUE(MeshCache::load(objFilePath, MeshIndexing::Unindexed, data));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshCache_Test, truncated_cache_is_rebuilt) {
+    MeshData decoded;
+    MeshCache::load(objFilePath, MeshIndexing::Unindexed, decoded);
+
+    const string cachePath = MeshCache::getCachePath(objFilePath, MeshIndexing::Unindexed);
+    writeFile(cachePath.c_str(), "R3DMESH");
+
+    MeshData data;
+    EXPECT_FALSE(MeshCache::load(objFilePath, MeshIndexing::Unindexed, data));
+    expectSameData(decoded, data);
+    EXPECT_TRUE(MeshCache::load(objFilePath, MeshIndexing::Unindexed, data));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshCache_Test, mesh_loads_through_cache) {
+    const char * texturedCube = "../data/meshes/cube_textured.obj";
+    const string cachePath = MeshCache::getCachePath(texturedCube, MeshIndexing::Indexed);
+    std::remove(cachePath.c_str());
+
+    Mesh decoded(texturedCube, MeshIndexing::Indexed);
+    Mesh cached(texturedCube, MeshIndexing::Indexed);
+    std::remove(cachePath.c_str());
+
+    EXPECT_EQ(*decoded.getVertexPositionVector(), *cached.getVertexPositionVector());
+    EXPECT_EQ(*decoded.getTextureCoordVector(), *cached.getTextureCoordVector());
+    EXPECT_EQ(decoded.getNumIndices(), cached.getNumIndices());
+    EXPECT_EQ(decoded.getAABB().minBounds, cached.getAABB().minBounds);
+    EXPECT_EQ(decoded.getAABB().maxBounds, cached.getAABB().maxBounds);
+
+    for(const vec3 & position : *cached.getVertexPositionVector()) {
+        EXPECT_EQ(position, glm::max(position, cached.getAABB().minBounds));
+        EXPECT_EQ(position, glm::min(position, cached.getAABB().maxBounds));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshCache_Test, caches_submeshes_and_materials) {
+    const char * mtlFilePath = "MeshCache_Test.mtl";
+    writeFile(objFilePath, string("mtllib MeshCache_Test.mtl\nusemtl red\n") + objContents);
+    writeFile(mtlFilePath, "newmtl red\nKd 1 0 0\n");
+
+    MeshData decoded, cached;
+    EXPECT_FALSE(MeshCache::load(objFilePath, MeshIndexing::Indexed, decoded));
+    EXPECT_TRUE(MeshCache::load(objFilePath, MeshIndexing::Indexed, cached));
+
+    ASSERT_EQ(1u, cached.submeshes.size());
+    EXPECT_EQ("red", cached.submeshes[0].materialName);
+    EXPECT_EQ(0, cached.submeshes[0].materialIndex);
+    EXPECT_EQ(6u, cached.submeshes[0].numIndices);
+    ASSERT_EQ(1u, cached.materials.size());
+    EXPECT_EQ("red", cached.materials[0].name);
+    EXPECT_EQ(vec3(1.0f, 0.0f, 0.0f), cached.materials[0].properties.Kd);
+
+    // Editing the .mtl file invalidates the cache.
+    writeFile(mtlFilePath, "newmtl red\nKd 0 1 0\n");
+    setModifiedTime(mtlFilePath, getModifiedTime(mtlFilePath) + 10);
+    EXPECT_FALSE(MeshCache::load(objFilePath, MeshIndexing::Indexed, cached));
+    EXPECT_EQ(vec3(0.0f, 1.0f, 0.0f), cached.materials[0].properties.Kd);
+    std::remove(mtlFilePath);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshCache_Test, caches_lods_for_their_ratios) {
+    writeFile(objFilePath, buildGridObj(16));
+
+    MeshData decoded, cached;
+    EXPECT_FALSE(MeshCache::load(objFilePath, MeshIndexing::Indexed, decoded));
+    EXPECT_EQ(MeshCache::getDefaultLodRatios(), decoded.lodRatios);
+    ASSERT_EQ(3u, decoded.lods.size());
+    EXPECT_EQ(decoded.lodIndices.getIndexSize(), decoded.indices.getIndexSize());
+
+    EXPECT_TRUE(MeshCache::load(objFilePath, MeshIndexing::Indexed, cached));
+    expectSameData(decoded, cached);
+
+    // Asking for other levels of detail rebuilds the cache.
+    const vector<float> ratios = {0.3f};
+    EXPECT_FALSE(MeshCache::load(objFilePath, MeshIndexing::Indexed, cached, ratios));
+    EXPECT_EQ(ratios, cached.lodRatios);
+    EXPECT_EQ(1u, cached.lods.size());
+    EXPECT_TRUE(MeshCache::load(objFilePath, MeshIndexing::Indexed, cached, ratios));
+
+    // Unindexed meshes have none.
+    MeshCache::load(objFilePath, MeshIndexing::Unindexed, decoded);
+    EXPECT_TRUE(decoded.lods.empty());
+    EXPECT_TRUE(decoded.lodIndices.empty());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshCache_Test, out_of_range_indices_invalidate_cache) {
+    MeshData decoded;
+    MeshCache::load(objFilePath, MeshIndexing::Indexed, decoded);
+
+    MeshData corrupt = decoded;
+    corrupt.indices.set(1, uint32(decoded.positions.size()));
+    writeCache(MeshIndexing::Indexed, corrupt);
+
+    MeshData data;
+    EXPECT_FALSE(MeshCache::load(objFilePath, MeshIndexing::Indexed, data));
+    expectSameData(decoded, data);
+
+    // Likewise for BVH leaves referring past the last triangle.
+    corrupt = decoded;
+    vector<MeshBvhNode> nodes = decoded.bvh.getNodes();
+    vector<uint32> triangles = decoded.bvh.getTriangles();
+    triangles.back() = uint32(decoded.indices.getNumIndices() / 3);
+    corrupt.bvh.assign(std::move(nodes), std::move(triangles));
+    writeCache(MeshIndexing::Indexed, corrupt);
+
+    EXPECT_FALSE(MeshCache::load(objFilePath, MeshIndexing::Indexed, data));
+    expectSameData(decoded, data);
+    EXPECT_TRUE(MeshCache::load(objFilePath, MeshIndexing::Indexed, data));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshCache_Test, cache_files_go_to_the_cache_directory) {
+    const string previousDirectory = MeshCache::getCacheDirectory();
+    const char * directory = "MeshCache_Test_cache";
+    mkdir(directory, 0755);
+    MeshCache::setCacheDirectory(directory);
+
+    const string cachePath = MeshCache::getCachePath(objFilePath, MeshIndexing::Unindexed);
+    EXPECT_EQ(0u, cachePath.find(string(directory) + "/MeshCache_Test.obj."));
+    EXPECT_NE(cachePath, MeshCache::getCachePath("other/MeshCache_Test.obj",
+            MeshIndexing::Unindexed));
+    EXPECT_NE(cachePath, MeshCache::getCachePath(objFilePath, MeshIndexing::Indexed));
+
+    MeshData decoded, cached;
+    EXPECT_FALSE(MeshCache::load(objFilePath, MeshIndexing::Unindexed, decoded));
+    EXPECT_TRUE(fileExists(cachePath));
+    EXPECT_FALSE(fileExists(string(objFilePath) + ".r3dmesh"));
+    EXPECT_TRUE(MeshCache::load(objFilePath, MeshIndexing::Unindexed, cached));
+    expectSameData(decoded, cached);
+
+    std::remove(cachePath.c_str());
+    rmdir(directory);
+    MeshCache::setCacheDirectory(previousDirectory);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshCache_Test, disabled_cache_always_decodes) {
+    MeshCache::setEnabled(false);
+    MeshData data;
+    EXPECT_FALSE(MeshCache::load(objFilePath, MeshIndexing::Indexed, data));
+    EXPECT_EQ(6u, data.indices.getNumIndices());
+    EXPECT_FALSE(MeshCache::load(objFilePath, MeshIndexing::Indexed, data));
+    EXPECT_FALSE(fileExists(MeshCache::getCachePath(objFilePath, MeshIndexing::Indexed)));
+    MeshCache::setEnabled(true);
+
+    EXPECT_FALSE(MeshCache::load(objFilePath, MeshIndexing::Indexed, data));
+    EXPECT_TRUE(MeshCache::load(objFilePath, MeshIndexing::Indexed, data));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshCache_Test, missing_source_throws) {
+    MeshData data;
+    EXPECT_THROW(MeshCache::load("does_not_exist.obj", MeshIndexing::Unindexed, data),
+            Rigid3DException);
+}
@@ -5,15 +5,23 @@
  */
 
 #include <Rigid3D/Graphics/MeshConsolidator.hpp>
+#include <Rigid3D/Graphics/MeshCache.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
 #include <gtest/gtest.h>
 #include <glm/glm.hpp>
 
+#include <cstring>
+
 #include <memory>
 using std::shared_ptr;
 
 #include <unordered_map>
 using std::unordered_map;
 
+#include <utility>
+#include <vector>
+using std::vector;
+
 #include <iostream>
 using std::ostream;
 
@@ -158,7 +166,8 @@ bool containsValue(const unordered_map<const char *, BatchInfo> batchInfoMap,
   }
 
   return ::testing::AssertionFailure()
-      << "The mapped-value " << batchInfo << "is not contained in unordered_map";
+      << "The mapped-value " << n_expr << " = " << batchInfo
+      << " is not contained in " << m_expr;
 }
 
 ::testing::AssertionResult assertContainsKey(const char* m_expr,
@@ -170,7 +179,8 @@ bool containsValue(const unordered_map<const char *, BatchInfo> batchInfoMap,
   }
 
   return ::testing::AssertionFailure()
-      << "The key-value " << key << "is not contained in unordered_map";
+      << "The key-value " << n_expr << " = " << key
+      << " is not contained in " << m_expr;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -335,3 +345,350 @@ TEST_F(MeshConsolidator_WithMeshes_Test, test_normalDataPtr) {
 
     ASSERT_TRUE(true);
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Test with indexed Meshes
+//////////////////////////////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------------------------------
+/*
+ * Mixes indexed and unindexed meshes, and checks that every batch's index range
+ * resolves to the same triangles as the unindexed mesh.
+ */
+TEST_F(MeshConsolidator_Test, test_indexed_meshes) {
+    Mesh unindexed("../data/meshes/cube.obj");
+    Mesh unindexedSmooth("../data/meshes/cube_smooth.obj");
+    Mesh indexedFlat("../data/meshes/cube.obj", MeshIndexing::Indexed);
+    Mesh indexedSmooth("../data/meshes/cube_smooth.obj", MeshIndexing::Indexed);
+
+    MeshConsolidator consolidator = {
+            {"unindexed", &unindexed},
+            {"indexedFlat", &indexedFlat},
+            {"indexedSmooth", &indexedSmooth}
+    };
+
+    ASSERT_TRUE(consolidator.isIndexed());
+    const IndexBuffer & indices = consolidator.getIndexBuffer();
+    EXPECT_EQ(3u * 36u, indices.getNumIndices());
+    EXPECT_EQ(2u, indices.getIndexSize());
+
+    unordered_map<const char *, BatchInfo> batches;
+    consolidator.getBatchInfo(batches);
+    ASSERT_EQ(3u, batches.size());
+
+    const vec3 * positions = reinterpret_cast<const vec3 *>(
+            consolidator.getVertexPositionDataPtr());
+    unsigned numVertices = (unsigned)(consolidator.getNumVertexPositionBytes() / sizeof(vec3));
+    EXPECT_EQ(36u + 24u + 8u, numVertices);
+
+    // Each batch, and the unindexed mesh with the same triangles, though indexed
+    // meshes have their triangles reordered for the vertex cache.
+    const std::pair<const char *, const Mesh *> expectations[] = {
+            {"unindexed", &unindexed},
+            {"indexedFlat", &unindexed},
+            {"indexedSmooth", &unindexedSmooth}
+    };
+
+    for(const auto & expectation : expectations) {
+        const BatchInfo & batch = batches.at(expectation.first);
+        EXPECT_TRUE(batch.isIndexed());
+        ASSERT_EQ(36u, batch.numIndices);
+
+        const vector<vec3> & expected = *expectation.second->getVertexPositionVector();
+        vector<bool> matched(expected.size() / 3, false);
+        for(unsigned i = 0; i < batch.numIndices; i += 3) {
+            uint32 triangle[3];
+            for(unsigned c = 0; c < 3; ++c) {
+                triangle[c] = indices[batch.startIndex + i + c];
+                ASSERT_LT(triangle[c], numVertices);
+            }
+
+            bool found = false;
+            for(size_t t = 0; t < matched.size() && !found; ++t) {
+                found = !matched[t] &&
+                        expected[t * 3] == positions[triangle[0]] &&
+                        expected[t * 3 + 1] == positions[triangle[1]] &&
+                        expected[t * 3 + 2] == positions[triangle[2]];
+                matched[t] = matched[t] || found;
+            }
+            EXPECT_TRUE(found) << expectation.first << " triangle " << i / 3;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(MeshConsolidator_WithObjFiles_Test, test_not_indexed) {
+    EXPECT_FALSE(meshConsolidator.isIndexed());
+
+    for(const auto & key_value : batchInfoMap) {
+        EXPECT_FALSE(key_value.second.isIndexed());
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Test vertex layouts
+//////////////////////////////////////////////////////////////////////////////////////////
+//---------------------------------------------------------------------------------------
+/*
+ * Consolidates a textured and an untextured mesh with each layout, and reads
+ * every attribute back through the layout's offsets and strides.
+ */
+TEST_F(MeshConsolidator_Test, test_vertex_layouts) {
+    Mesh textured("../data/meshes/cube_textured.obj");
+    Mesh untextured("../data/meshes/cube.obj");
+
+    const VertexLayoutType layoutTypes[] = {
+            VertexLayoutType::Separate,
+            VertexLayoutType::Interleaved,
+            VertexLayoutType::Packed,
+            VertexLayoutType::Quantized
+    };
+
+    for(VertexLayoutType layoutType : layoutTypes) {
+        SCOPED_TRACE(int(layoutType));
+        MeshConsolidator consolidator({{"textured", &textured}, {"untextured", &untextured}},
+                layoutType);
+
+        const VertexLayout & layout = consolidator.getVertexLayout();
+        ASSERT_EQ(72u, layout.getNumVertices());
+        ASSERT_EQ(layout.getNumBytes(), consolidator.getNumVertexBytes());
+        ASSERT_TRUE(layout.getUvCoordFormat().isEnabled());
+
+        unordered_map<const char *, BatchInfo> batches;
+        consolidator.getBatchInfo(batches);
+
+        const ubyte * data = static_cast<const ubyte *>(consolidator.getVertexDataPtr());
+        const VertexAttributeFormat & position = layout.getPositionFormat();
+        const VertexAttributeFormat & normal = layout.getNormalFormat();
+        const VertexAttributeFormat & uvCoord = layout.getUvCoordFormat();
+
+        const std::pair<const char *, const Mesh *> meshes[] = {
+                {"textured", &textured},
+                {"untextured", &untextured}
+        };
+        for(const auto & entry : meshes) {
+            const Mesh & mesh = *entry.second;
+            const BatchInfo & batch = batches.at(entry.first);
+            for(unsigned i = 0; i < batch.numIndices; ++i) {
+                const size_t v = batch.startIndex + i;
+
+                const vec3 expectedPosition = (*mesh.getVertexPositionVector())[i];
+                const vec3 expectedNormal = (*mesh.getVertexNormalVector())[i];
+                const vec2 expectedUv = mesh.getNumTextureCoords() ?
+                        (*mesh.getTextureCoordVector())[i] : vec2(0.0f);
+
+                if (layoutType == VertexLayoutType::Quantized) {
+                    const VertexQuantization & quantization = layout.getQuantization();
+                    const VertexDecodeError & error = layout.getDecodeError();
+
+                    uint16 packedPosition[3];
+                    std::memcpy(packedPosition, data + position.offset + v * position.stride, 6);
+                    const vec3 p = quantization.positionOffset + quantization.positionScale *
+                            vec3(packedPosition[0], packedPosition[1], packedPosition[2]) /
+                            65535.0f;
+                    ASSERT_NEAR(expectedPosition.x, p.x, error.position.x + 1e-6f);
+                    ASSERT_NEAR(expectedPosition.y, p.y, error.position.y + 1e-6f);
+                    ASSERT_NEAR(expectedPosition.z, p.z, error.position.z + 1e-6f);
+
+                    uint32 packedNormal;
+                    std::memcpy(&packedNormal, data + normal.offset + v * normal.stride, 4);
+                    const vec3 n = VertexLayout::unpackOctahedralNormal(packedNormal);
+                    ASSERT_GT(glm::dot(expectedNormal, n), 0.9999f);
+
+                    // Missing texture coordinates need not lie within the bounds.
+                    if (mesh.getNumTextureCoords() == 0) {
+                        continue;
+                    }
+                    uint16 packedUv[2];
+                    std::memcpy(packedUv, data + uvCoord.offset + v * uvCoord.stride, 4);
+                    const vec2 uv = quantization.uvCoordOffset + quantization.uvCoordScale *
+                            vec2(packedUv[0], packedUv[1]) / 65535.0f;
+                    ASSERT_NEAR(expectedUv.s, uv.s, error.uvCoord.s + 1e-6f);
+                    ASSERT_NEAR(expectedUv.t, uv.t, error.uvCoord.t + 1e-6f);
+                    continue;
+                }
+
+                vec3 p;
+                std::memcpy(&p, data + position.offset + v * position.stride, sizeof(p));
+                ASSERT_EQ(expectedPosition, p);
+
+                if (layoutType == VertexLayoutType::Packed) {
+                    uint32 packedNormal;
+                    std::memcpy(&packedNormal, data + normal.offset + v * normal.stride, 4);
+                    const vec3 n = VertexLayout::unpackNormal(packedNormal);
+                    ASSERT_NEAR(expectedNormal.x, n.x, 1.0f / 511.0f);
+                    ASSERT_NEAR(expectedNormal.y, n.y, 1.0f / 511.0f);
+                    ASSERT_NEAR(expectedNormal.z, n.z, 1.0f / 511.0f);
+
+                    uint16 packedUv[2];
+                    std::memcpy(packedUv, data + uvCoord.offset + v * uvCoord.stride, 4);
+                    ASSERT_NEAR(expectedUv.s, VertexLayout::unpackHalfFloat(packedUv[0]), 1e-3f);
+                    ASSERT_NEAR(expectedUv.t, VertexLayout::unpackHalfFloat(packedUv[1]), 1e-3f);
+                } else {
+                    vec3 n;
+                    std::memcpy(&n, data + normal.offset + v * normal.stride, sizeof(n));
+                    ASSERT_EQ(expectedNormal, n);
+
+                    vec2 uv;
+                    std::memcpy(&uv, data + uvCoord.offset + v * uvCoord.stride, sizeof(uv));
+                    ASSERT_EQ(expectedUv, uv);
+                }
+            }
+        }
+
+        // Only the separate layout has tightly packed per-attribute blocks.
+        if (layoutType == VertexLayoutType::Separate) {
+            EXPECT_EQ(72u * sizeof(vec2), consolidator.getNumTextureCoordBytes());
+            EXPECT_EQ(reinterpret_cast<const float *>(data + uvCoord.offset),
+                    consolidator.getTextureCoordDataPtr());
+        } else {
+            EXPECT_EQ(nullptr, consolidator.getVertexPositionDataPtr());
+            EXPECT_EQ(0u, consolidator.getNumVertexPositionBytes());
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Test adding and removing meshes
+//////////////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // A flat indexed grid of 'size' x 'size' quads at height 'z'.
+    void makeGridMesh(uint32 size, float z, Mesh & mesh) {
+        MeshData data;
+        vector<uint32> gridIndices;
+        for(uint32 y = 0; y <= size; ++y) {
+            for(uint32 x = 0; x <= size; ++x) {
+                data.positions.push_back(vec3(float(x), float(y), z));
+                data.normals.push_back(vec3(0.0f, 0.0f, 1.0f));
+            }
+        }
+        for(uint32 y = 0; y < size; ++y) {
+            for(uint32 x = 0; x < size; ++x) {
+                const uint32 v = y * (size + 1) + x;
+                const uint32 quad[] = {v, v + 1, v + size + 2, v, v + size + 2, v + size + 1};
+                gridIndices.insert(gridIndices.end(), quad, quad + 6);
+            }
+        }
+        data.indices.assign(gridIndices, uint32(data.positions.size()));
+        data.aabb.minBounds = vec3(0.0f, 0.0f, z);
+        data.aabb.maxBounds = vec3(float(size), float(size), z);
+        mesh = Mesh(std::move(data));
+    }
+
+    // Expects every index of 'batch' to resolve to the same position as in 'mesh'.
+    void expectBatchMatches(const MeshConsolidator & consolidator, const BatchInfo & batch,
+            const Mesh & mesh) {
+        const VertexAttributeFormat & position = consolidator.getVertexLayout().getPositionFormat();
+        const ubyte * data = static_cast<const ubyte *>(consolidator.getVertexDataPtr());
+        const IndexBuffer & indices = consolidator.getIndexBuffer();
+
+        ASSERT_EQ(indices.getIndexSize(), batch.indexSize);
+        ASSERT_EQ(mesh.getNumIndices(), batch.numIndices);
+        ASSERT_LE(batch.startIndex + batch.numIndices, indices.getNumIndices());
+        for(uint32 i = 0; i < batch.numIndices; ++i) {
+            const uint32 v = indices[batch.startIndex + i];
+            ASSERT_LT(v, consolidator.getVertexCapacity());
+            vec3 p;
+            std::memcpy(&p, data + position.offset + v * position.stride, sizeof(p));
+            ASSERT_EQ((*mesh.getVertexPositionVector())[mesh.getIndexBuffer()[i]], p);
+        }
+    }
+
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(MeshConsolidator_Test, test_add_and_remove_meshes) {
+    Mesh small, medium, large;
+    makeGridMesh(2, 1.0f, small);
+    makeGridMesh(4, 2.0f, medium);
+    makeGridMesh(8, 3.0f, large);
+
+    const VertexLayoutType layoutTypes[] = {
+            VertexLayoutType::Separate,
+            VertexLayoutType::Interleaved
+    };
+    for(VertexLayoutType layoutType : layoutTypes) {
+        SCOPED_TRACE(int(layoutType));
+        MeshConsolidator consolidator(layoutType, MeshIndexing::Indexed, true, false);
+        EXPECT_TRUE(consolidator.isIndexed());
+        consolidator.reserve(25 + 81 + 25, (16 + 64 + 16) * 6);
+
+        const BatchInfo * first = consolidator.addMesh("first", medium);
+        const BatchInfo * second = consolidator.addMesh("second", large);
+        const BatchInfo * third = consolidator.addMesh("third", medium);
+        EXPECT_EQ(first, consolidator.getBatchInfo("first"));
+        EXPECT_EQ(25u + 81u + 25u, consolidator.getNumVertices());
+        EXPECT_THROW(consolidator.addMesh("first", small), Rigid3DException);
+
+        expectBatchMatches(consolidator, *first, medium);
+        expectBatchMatches(consolidator, *second, large);
+        expectBatchMatches(consolidator, *third, medium);
+
+        // A smaller mesh fits in the hole left by a removed one, without growing.
+        const size_t capacity = consolidator.getVertexCapacity();
+        EXPECT_TRUE(consolidator.removeMesh("second"));
+        EXPECT_FALSE(consolidator.removeMesh("second"));
+        EXPECT_EQ(nullptr, consolidator.getBatchInfo("second"));
+
+        const BatchInfo * fourth = consolidator.addMesh("fourth", small);
+        EXPECT_EQ(capacity, consolidator.getVertexCapacity());
+        EXPECT_GT(fourth->startIndex, first->startIndex);
+        EXPECT_LT(fourth->startIndex, third->startIndex);
+        expectBatchMatches(consolidator, *fourth, small);
+
+        // Compacting moves meshes into the hole, updating their batches in place.
+        const BatchInfo thirdBefore = *third;
+        consolidator.compact();
+        EXPECT_LT(third->startIndex, thirdBefore.startIndex);
+        EXPECT_EQ(first->startIndex + first->numIndices, fourth->startIndex);
+        EXPECT_EQ(fourth->startIndex + fourth->numIndices, third->startIndex);
+        expectBatchMatches(consolidator, *first, medium);
+        expectBatchMatches(consolidator, *fourth, small);
+        expectBatchMatches(consolidator, *third, medium);
+
+        unordered_map<const char *, BatchInfo> batches;
+        consolidator.getBatchInfo(batches);
+        EXPECT_EQ(3u, batches.size());
+        EXPECT_EQ(third->startIndex, batches.at("third").startIndex);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(MeshConsolidator_Test, test_growing_widens_indices) {
+    Mesh grid;
+    makeGridMesh(150, 0.0f, grid);
+    MeshConsolidator consolidator(VertexLayoutType::Interleaved, MeshIndexing::Indexed);
+
+    const BatchInfo * first = consolidator.addMesh("first", grid);
+    EXPECT_EQ(2u, first->indexSize);
+
+    // Three grids of 151 x 151 vertices no longer fit 16-bit indices.
+    const BatchInfo * second = consolidator.addMesh("second", grid);
+    const BatchInfo * third = consolidator.addMesh("third", grid);
+    EXPECT_GT(consolidator.getVertexCapacity(), 0x10000u);
+    EXPECT_EQ(4u, first->indexSize);
+    expectBatchMatches(consolidator, *first, grid);
+    expectBatchMatches(consolidator, *second, grid);
+    expectBatchMatches(consolidator, *third, grid);
+
+    // Unindexed meshes need an indexed consolidator to join.
+    MeshConsolidator unindexed(VertexLayoutType::Separate, MeshIndexing::Unindexed);
+    EXPECT_FALSE(unindexed.isIndexed());
+    EXPECT_THROW(unindexed.addMesh("grid", grid), Rigid3DException);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(MeshConsolidator_Test, test_quantized_meshes_must_fit_bounds) {
+    Mesh low, high;
+    makeGridMesh(2, 0.0f, low);
+    makeGridMesh(2, 5.0f, high);
+
+    VertexBounds bounds;
+    bounds.extend(low.getAABB(), nullptr, 0);
+    MeshConsolidator consolidator(VertexLayoutType::Quantized, MeshIndexing::Indexed, true,
+            false, bounds);
+
+    EXPECT_NE(nullptr, consolidator.addMesh("low", low));
+    EXPECT_THROW(consolidator.addMesh("high", high), Rigid3DException);
+    EXPECT_EQ(nullptr, consolidator.getBatchInfo("high"));
+}
@@ -0,0 +1,178 @@
+// MeshOptimizer_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/MeshOptimizer.hpp>
+#include <Rigid3D/Graphics/ObjFileLoader.hpp>
+using namespace Rigid3D;
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    typedef std::array<float, 9> TriangleCorners;
+
+    class MeshOptimizer_Test : public ::testing::Test {
+    protected:
+        vector<vec3> positions;
+        vector<vec3> normals;
+        vector<vec2> uvCoords;
+        vector<uint32> indices;
+
+        // A flat grid of 'size' x 'size' quads, with its triangles shuffled.
+        void buildShuffledGrid(uint32 size) {
+            for(uint32 y = 0; y <= size; ++y) {
+                for(uint32 x = 0; x <= size; ++x) {
+                    positions.push_back(vec3(float(x), float(y), 0.0f));
+                    normals.push_back(vec3(0.0f, 0.0f, 1.0f));
+                    uvCoords.push_back(vec2(float(x), float(y)) / float(size));
+                }
+            }
+            vector<std::array<uint32, 3> > triangles;
+            for(uint32 y = 0; y < size; ++y) {
+                for(uint32 x = 0; x < size; ++x) {
+                    const uint32 v = y * (size + 1) + x;
+                    triangles.push_back({{v, v + 1, v + size + 2}});
+                    triangles.push_back({{v, v + size + 2, v + size + 1}});
+                }
+            }
+            std::srand(7);
+            std::random_shuffle(triangles.begin(), triangles.end(),
+                    [](int n) { return std::rand() % n; });
+            for(const auto & triangle : triangles) {
+                indices.insert(indices.end(), triangle.begin(), triangle.end());
+            }
+        }
+
+        // Triangles as positions, independent of vertex numbering and order.
+        vector<TriangleCorners> getSortedTriangles(size_t begin, size_t end) const {
+            vector<TriangleCorners> triangles;
+            for(size_t i = begin; i < end; i += 3) {
+                TriangleCorners corners;
+                for(int c = 0; c < 3; ++c) {
+                    const vec3 & p = positions[indices[i + c]];
+                    corners[c * 3] = p.x;
+                    corners[c * 3 + 1] = p.y;
+                    corners[c * 3 + 2] = p.z;
+                }
+                triangles.push_back(corners);
+            }
+            std::sort(triangles.begin(), triangles.end());
+            return triangles;
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshOptimizer_Test, acmr_simulates_fifo_cache) {
+    const uint32 triangle[] = {0, 1, 2};
+    EXPECT_EQ(3.0f, MeshOptimizer::getAcmr(triangle, 3, 3));
+
+    const uint32 quad[] = {0, 1, 2, 2, 1, 3};
+    EXPECT_EQ(2.0f, MeshOptimizer::getAcmr(quad, 6, 0));
+
+    // With room for only three vertices, vertex 0 is evicted by vertex 3.
+    const uint32 fan[] = {0, 1, 2, 2, 1, 3, 3, 1, 0};
+    EXPECT_FLOAT_EQ(5.0f / 3.0f, MeshOptimizer::getAcmr(fan, 9, 4, 3));
+    EXPECT_FLOAT_EQ(4.0f / 3.0f, MeshOptimizer::getAcmr(fan, 9, 4, 4));
+
+    EXPECT_EQ(0.0f, MeshOptimizer::getAcmr(nullptr, 0, 0));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshOptimizer_Test, vertex_cache_order_lowers_acmr) {
+    buildShuffledGrid(32);
+    const vector<TriangleCorners> triangles = getSortedTriangles(0, indices.size());
+    const uint32 numVertices = uint32(positions.size());
+
+    const float acmrBefore = MeshOptimizer::getAcmr(indices.data(), indices.size(), numVertices);
+    MeshOptimizer::optimizeVertexCache(indices.data(), indices.size(), numVertices);
+    const float acmrAfter = MeshOptimizer::getAcmr(indices.data(), indices.size(), numVertices);
+
+    // A shuffled grid misses nearly every vertex, while a grid can approach
+    // half a vertex per triangle.
+    EXPECT_GT(acmrBefore, 2.0f);
+    EXPECT_LT(acmrAfter, 0.8f);
+    EXPECT_EQ(triangles, getSortedTriangles(0, indices.size()));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshOptimizer_Test, overdraw_order_stays_within_threshold) {
+    ObjModel model;
+    ObjFileLoader::decodeModel("../../data/meshes/sphere_smooth.obj", MeshIndexing::Indexed,
+            model);
+    positions = model.positions;
+    indices = model.indices;
+    const vector<TriangleCorners> triangles = getSortedTriangles(0, indices.size());
+    const uint32 numVertices = uint32(positions.size());
+
+    MeshOptimizer::optimizeVertexCache(indices.data(), indices.size(), numVertices);
+    const float acmrBefore = MeshOptimizer::getAcmr(indices.data(), indices.size(), numVertices);
+    const vector<uint32> cacheOrder = indices;
+
+    MeshOptimizer::optimizeOverdraw(indices.data(), indices.size(), positions, 1.05f);
+    const float acmrAfter = MeshOptimizer::getAcmr(indices.data(), indices.size(), numVertices);
+
+    EXPECT_NE(cacheOrder, indices);
+    EXPECT_LE(acmrAfter, acmrBefore * 1.05f + 0.05f);
+    EXPECT_EQ(triangles, getSortedTriangles(0, indices.size()));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshOptimizer_Test, vertex_fetch_order_follows_first_use) {
+    buildShuffledGrid(4);
+    positions.push_back(vec3(-1.0f));  // Unused vertex.
+    normals.push_back(vec3(1.0f, 0.0f, 0.0f));
+    uvCoords.push_back(vec2(-1.0f));
+
+    const vector<uint32> oldIndices = indices;
+    const vector<vec3> oldPositions = positions;
+    const vector<vec2> oldUvCoords = uvCoords;
+    MeshOptimizer::optimizeVertexFetch(indices, positions, normals, uvCoords);
+
+    uint32 nextNew = 0;
+    for(size_t i = 0; i < indices.size(); ++i) {
+        ASSERT_LE(indices[i], nextNew);
+        if (indices[i] == nextNew) {
+            ++nextNew;
+        }
+        EXPECT_EQ(oldPositions[oldIndices[i]], positions[indices[i]]);
+        EXPECT_EQ(oldUvCoords[oldIndices[i]], uvCoords[indices[i]]);
+    }
+    EXPECT_EQ(positions.size() - 1, nextNew);
+    EXPECT_EQ(vec3(-1.0f), positions.back());
+    EXPECT_EQ(vec3(1.0f, 0.0f, 0.0f), normals.back());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshOptimizer_Test, optimize_keeps_submesh_triangles) {
+    buildShuffledGrid(16);
+    vector<Submesh> submeshes(2);
+    submeshes[0].startIndex = 0;
+    submeshes[0].numIndices = 3 * 200;
+    submeshes[1].startIndex = submeshes[0].numIndices;
+    submeshes[1].numIndices = uint32(indices.size()) - submeshes[0].numIndices;
+
+    const vector<TriangleCorners> first = getSortedTriangles(0, submeshes[1].startIndex);
+    const vector<TriangleCorners> second =
+            getSortedTriangles(submeshes[1].startIndex, indices.size());
+
+    MeshOptimizationStats stats = MeshOptimizer::optimize(indices, positions, normals,
+            uvCoords, submeshes);
+
+    EXPECT_EQ(first, getSortedTriangles(0, submeshes[1].startIndex));
+    EXPECT_EQ(second, getSortedTriangles(submeshes[1].startIndex, indices.size()));
+    EXPECT_EQ(stats.acmrAfter, MeshOptimizer::getAcmr(indices.data(), indices.size(),
+            uint32(positions.size())));
+    EXPECT_LT(stats.acmrAfter, stats.acmrBefore / 2.0f);
+
+    for(size_t i = 0; i < indices.size(); ++i) {
+        const vec3 & p = positions[indices[i]];
+        EXPECT_EQ(vec2(p.x, p.y) / 16.0f, uvCoords[indices[i]]);
+    }
+}
@@ -0,0 +1,209 @@
+// MeshSimplifier_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/MeshSimplifier.hpp>
+#include <Rigid3D/Graphics/ObjFileLoader.hpp>
+using namespace Rigid3D;
+
+#include <algorithm>
+#include <set>
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class MeshSimplifier_Test : public ::testing::Test {
+    protected:
+        vector<vec3> positions;
+        vector<uint32> indices;
+
+        // A flat grid of 'size' x 'size' unit quads in the xy-plane.  If
+        // 'seamColumn' is within the grid, vertices in that column are
+        // duplicated, with the copy used by quads to its right.
+        void buildGrid(uint32 size, uint32 seamColumn = ~0u) {
+            const uint32 rowLength = size + 1;
+            for(uint32 y = 0; y <= size; ++y) {
+                for(uint32 x = 0; x <= size; ++x) {
+                    positions.push_back(vec3(float(x), float(y), 0.0f));
+                }
+            }
+            for(uint32 y = 0; y <= size && seamColumn < size; ++y) {
+                positions.push_back(vec3(float(seamColumn), float(y), 0.0f));
+            }
+
+            auto vertex = [&](uint32 x, uint32 y, uint32 quadX) {
+                if (x == seamColumn && quadX == seamColumn) {
+                    return rowLength * rowLength + y;
+                }
+                return y * rowLength + x;
+            };
+            for(uint32 y = 0; y < size; ++y) {
+                for(uint32 x = 0; x < size; ++x) {
+                    const uint32 quad[] = {vertex(x, y, x), vertex(x + 1, y, x),
+                            vertex(x + 1, y + 1, x), vertex(x, y + 1, x)};
+                    const uint32 triangles[] = {quad[0], quad[1], quad[2],
+                            quad[0], quad[2], quad[3]};
+                    indices.insert(indices.end(), triangles, triangles + 6);
+                }
+            }
+        }
+
+        // Sum of signed triangle areas facing +z.
+        float getArea(const uint32 * triangles, size_t numIndices) const {
+            float area = 0.0f;
+            for(size_t i = 0; i < numIndices; i += 3) {
+                const vec3 & a = positions[triangles[i]];
+                const vec3 & b = positions[triangles[i + 1]];
+                const vec3 & c = positions[triangles[i + 2]];
+                area += 0.5f * glm::cross(b - a, c - a).z;
+            }
+            return area;
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshSimplifier_Test, simplify_flat_grid_keeps_its_outline) {
+    buildGrid(16);
+    vector<uint32> result;
+    const float error = MeshSimplifier::simplify(positions, indices.data(), indices.size(),
+            indices.size() / 4, result);
+
+    EXPECT_LE(result.size(), indices.size() / 4);
+    EXPECT_EQ(0u, result.size() % 3);
+    EXPECT_NEAR(0.0f, error, 1e-4f);
+    EXPECT_FLOAT_EQ(256.0f, getArea(result.data(), result.size()));
+    for(size_t i = 0; i < result.size(); i += 3) {
+        EXPECT_GT(getArea(&result[i], 3), 0.0f);
+    }
+
+    // Border vertices only slide along the border, so every corner survives.
+    std::set<uint32> used(result.begin(), result.end());
+    EXPECT_EQ(1u, used.count(0));
+    EXPECT_EQ(1u, used.count(16));
+    EXPECT_EQ(1u, used.count(16 * 17));
+    EXPECT_EQ(1u, used.count(16 * 17 + 16));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshSimplifier_Test, simplify_keeps_seam_vertices_on_their_side) {
+    const uint32 seamColumn = 8;
+    buildGrid(16, seamColumn);
+    const uint32 firstSeamCopy = 17 * 17;
+
+    vector<uint32> result;
+    MeshSimplifier::simplify(positions, indices.data(), indices.size(), indices.size() / 4,
+            result);
+    ASSERT_LT(result.size(), indices.size() / 2);
+    EXPECT_FLOAT_EQ(256.0f, getArea(result.data(), result.size()));
+
+    std::set<float> leftSeam, rightSeam;
+    for(size_t i = 0; i < result.size(); i += 3) {
+        const float centerX = (positions[result[i]].x + positions[result[i + 1]].x +
+                positions[result[i + 2]].x) / 3.0f;
+        for(int c = 0; c < 3; ++c) {
+            const uint32 v = result[i + c];
+            if (positions[v].x != float(seamColumn)) {
+                continue;
+            }
+            // Triangles left of the seam use the original vertices, and those
+            // right of it the copies.
+            if (centerX < float(seamColumn)) {
+                EXPECT_LT(v, firstSeamCopy);
+                leftSeam.insert(positions[v].y);
+            } else {
+                EXPECT_GE(v, firstSeamCopy);
+                rightSeam.insert(positions[v].y);
+            }
+        }
+    }
+
+    // Both sides of the seam collapse together, so they still meet.
+    EXPECT_EQ(leftSeam, rightSeam);
+    EXPECT_LT(leftSeam.size(), 17u);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshSimplifier_Test, lods_shrink_and_grow_in_error) {
+    ObjModel model;
+    ObjFileLoader::decodeModel("../../data/meshes/sphere_smooth.obj", MeshIndexing::Indexed,
+            model);
+    positions = model.positions;
+
+    const vector<float> ratios = {0.5f, 0.25f, 0.125f};
+    vector<uint32> lodIndices;
+    vector<MeshLod> lods;
+    MeshSimplifier::generateLods(positions, model.indices, vector<Submesh>(), ratios,
+            lodIndices, lods);
+    ASSERT_EQ(ratios.size(), lods.size());
+
+    uint32 startIndex = 0;
+    for(size_t k = 0; k < lods.size(); ++k) {
+        EXPECT_EQ(startIndex, lods[k].startIndex);
+        EXPECT_LE(lods[k].numIndices, model.indices.size() * ratios[k]);
+        EXPECT_GT(lods[k].numIndices, 0u);
+        EXPECT_TRUE(lods[k].submeshes.empty());
+        if (k > 0) {
+            EXPECT_LT(lods[k].numIndices, lods[k - 1].numIndices);
+            EXPECT_GE(lods[k].error, lods[k - 1].error);
+        }
+        startIndex += lods[k].numIndices;
+    }
+    EXPECT_EQ(size_t(startIndex), lodIndices.size());
+    EXPECT_GT(lods[0].error, 0.0f);
+
+    for(uint32 index : lodIndices) {
+        ASSERT_LT(index, positions.size());
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshSimplifier_Test, lods_keep_submeshes_apart) {
+    buildGrid(16);
+    vector<Submesh> submeshes(2);
+    submeshes[0].name = "bottom";
+    submeshes[0].startIndex = 0;
+    submeshes[0].numIndices = uint32(indices.size()) / 2;
+    submeshes[1].name = "top";
+    submeshes[1].startIndex = submeshes[0].numIndices;
+    submeshes[1].numIndices = submeshes[0].numIndices;
+
+    vector<uint32> lodIndices;
+    vector<MeshLod> lods;
+    MeshSimplifier::generateLods(positions, indices, submeshes, {0.5f, 0.25f}, lodIndices,
+            lods);
+    ASSERT_EQ(2u, lods.size());
+
+    for(const MeshLod & lod : lods) {
+        ASSERT_EQ(2u, lod.submeshes.size());
+        EXPECT_EQ("bottom", lod.submeshes[0].name);
+        EXPECT_EQ("top", lod.submeshes[1].name);
+        EXPECT_EQ(lod.startIndex, lod.submeshes[0].startIndex);
+        EXPECT_EQ(lod.submeshes[0].startIndex + lod.submeshes[0].numIndices,
+                lod.submeshes[1].startIndex);
+        EXPECT_EQ(lod.startIndex + lod.numIndices,
+                lod.submeshes[1].startIndex + lod.submeshes[1].numIndices);
+
+        // Each half still covers exactly its own half of the grid.
+        for(const Submesh & submesh : lod.submeshes) {
+            const uint32 * triangles = lodIndices.data() + submesh.startIndex;
+            EXPECT_FLOAT_EQ(128.0f, getArea(triangles, submesh.numIndices));
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MeshSimplifier_Test, cube_with_hard_edges_has_no_lods) {
+    ObjModel model;
+    ObjFileLoader::decodeModel("../../data/meshes/cube.obj", MeshIndexing::Indexed, model);
+
+    vector<uint32> lodIndices;
+    vector<MeshLod> lods;
+    MeshSimplifier::generateLods(model.positions, model.indices, model.submeshes,
+            {0.5f}, lodIndices, lods);
+
+    EXPECT_TRUE(lods.empty());
+    EXPECT_TRUE(lodIndices.empty());
+}
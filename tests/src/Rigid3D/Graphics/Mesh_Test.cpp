@@ -7,7 +7,11 @@
 #include <gtest/gtest.h>
 
 #include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/MeshCache.hpp>
 using Rigid3D::Mesh;
+using Rigid3D::MeshCache;
+using Rigid3D::MeshData;
+using Rigid3D::MeshIndexing;
 
 #include <TestUtils.hpp>
 using namespace TestUtils::predicates;
@@ -205,3 +209,65 @@ TEST_F(Mesh_Textured_Cube_Test, test_number_of_textureCoords){
 TEST_F(Mesh_Textured_Cube_Test, test_textureCoord_data_bytes){
     EXPECT_EQ(expectedTextureCoordDataBytesSize, texturedMesh->getNumTextureCoordBytes());
 }
+
+//---------------------------------------------------------------------------------------
+TEST_F(Mesh_Cube_Test, test_unindexed_by_default){
+    EXPECT_FALSE(mesh->isIndexed());
+    EXPECT_EQ(0u, mesh->getNumIndices());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(Mesh_Cube_Test, test_indexed_mesh){
+    Mesh indexedMesh("../data/meshes/cube.obj", MeshIndexing::Indexed);
+
+    ASSERT_TRUE(indexedMesh.isIndexed());
+    EXPECT_EQ(expectedTotalVertices, indexedMesh.getNumIndices());
+    EXPECT_EQ(24u, indexedMesh.getNumVertexPositions());
+    EXPECT_EQ(24u, indexedMesh.getNumVertexNormals());
+
+    // Few enough vertices for 16-bit indices.
+    EXPECT_EQ(2u, indexedMesh.getIndexBuffer().getIndexSize());
+    EXPECT_EQ(expectedTotalVertices * 2, indexedMesh.getIndexBuffer().getNumBytes());
+
+    // Each triangle's corners resolve to the positions of one of the unindexed
+    // mesh's triangles, though triangles are reordered for the vertex cache.
+    vector<vec3> soupPositions = buildVector(mesh->getVertexPositionDataPtr(),
+            mesh->getNumVertexPositions());
+    const vector<vec3> & positions = *indexedMesh.getVertexPositionVector();
+    vector<bool> matched(soupPositions.size() / 3, false);
+    for(size_t i = 0; i < indexedMesh.getNumIndices(); i += 3) {
+        bool found = false;
+        for(size_t t = 0; t < matched.size() && !found; ++t) {
+            found = !matched[t] &&
+                    soupPositions[t * 3] == positions[indexedMesh.getIndexBuffer()[i]] &&
+                    soupPositions[t * 3 + 1] == positions[indexedMesh.getIndexBuffer()[i + 1]] &&
+                    soupPositions[t * 3 + 2] == positions[indexedMesh.getIndexBuffer()[i + 2]];
+            matched[t] = matched[t] || found;
+        }
+        EXPECT_TRUE(found) << "triangle " << i / 3;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(Mesh_Test, test_lod_selection_by_screen_size){
+    MeshData data;
+    MeshCache::decodeObj("../../data/meshes/sphere_smooth.obj", MeshIndexing::Indexed, data);
+    Mesh mesh(std::move(data));
+
+    const vector<Rigid3D::MeshLod> & lods = mesh.getLods();
+    ASSERT_EQ(3u, lods.size());
+    EXPECT_GT(mesh.getLodIndexBuffer().getNumIndices(), 0u);
+
+    // Large on screen, nothing may be simplified away; tiny, the coarsest level will do.
+    EXPECT_EQ(0u, mesh.selectLod(10.0f / lods[0].error));
+    EXPECT_EQ(3u, mesh.selectLod(0.1f / lods[2].error));
+
+    // Up to a pixel of error is acceptable, unless a larger error is allowed.
+    ASSERT_LT(lods[0].error, lods[1].error);
+    ASSERT_LT(lods[1].error, lods[2].error);
+    const float pixelsPerUnit = 2.0f / (lods[1].error + lods[2].error);
+    EXPECT_EQ(2u, mesh.selectLod(pixelsPerUnit));
+    EXPECT_EQ(3u, mesh.selectLod(pixelsPerUnit, 2.0f));
+    EXPECT_EQ(1u, mesh.selectLod(pixelsPerUnit,
+            0.5f * (lods[0].error + lods[1].error) * pixelsPerUnit));
+}
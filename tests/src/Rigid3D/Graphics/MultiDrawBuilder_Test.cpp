@@ -0,0 +1,91 @@
+// MultiDrawBuilder_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/MultiDrawBuilder.hpp>
+#include <Rigid3D/Graphics/MeshConsolidator.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <memory>
+#include <vector>
+using std::shared_ptr;
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class MultiDrawBuilder_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+
+        // glMultiDraw*Indirect is core from OpenGL 4.3.
+        static void SetUpTestCase() {
+            glContext = std::make_shared<OpenGLContext>(4, 3);
+            glContext->init();
+        }
+
+        static void TearDownTestCase() {
+            glContext.reset();
+        }
+    };
+
+    shared_ptr<OpenGLContext> MultiDrawBuilder_Test::glContext;
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MultiDrawBuilder_Test, commands_match_batch_ranges) {
+    BatchInfo unindexed(6, 3);
+    BatchInfo indexed(12, 36, 2);
+
+    MultiDrawBuilder builder;
+    EXPECT_EQ(0u, builder.addCommand(unindexed, 1, 4));
+    EXPECT_EQ(1u, builder.addCommand(indexed, 5, 7));
+
+    const vector<DrawCommand> & commands = builder.getCommands();
+    ASSERT_EQ(2u, commands.size());
+
+    EXPECT_EQ(3u, commands[0].count);
+    EXPECT_EQ(1u, commands[0].instanceCount);
+    EXPECT_EQ(6u, commands[0].first);
+    EXPECT_EQ(4u, commands[0].params[0]);
+
+    // Indexed commands have a zero base vertex before the base instance.
+    EXPECT_EQ(36u, commands[1].count);
+    EXPECT_EQ(5u, commands[1].instanceCount);
+    EXPECT_EQ(12u, commands[1].first);
+    EXPECT_EQ(0u, commands[1].params[0]);
+    EXPECT_EQ(7u, commands[1].params[1]);
+
+    builder.clear();
+    EXPECT_TRUE(builder.getCommands().empty());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MultiDrawBuilder_Test, uploaded_commands_are_drawn) {
+    ASSERT_TRUE(MultiDrawBuilder::isSupported());
+
+    GLuint vao;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    MultiDrawBuilder builder;
+    for(uint32 i = 0; i < 100; ++i) {
+        builder.addCommand(BatchInfo(3 * i, 3), 1, i);
+    }
+    builder.upload();
+
+    GLint boundBuffer = 0;
+    glGetIntegerv(GL_DRAW_INDIRECT_BUFFER_BINDING, &boundBuffer);
+    EXPECT_NE(0, boundBuffer);
+
+    builder.draw(0, 100, 0);
+    builder.draw(50, 50, 0);
+    EXPECT_EQ(GLenum(GL_NO_ERROR), glGetError());
+
+    EXPECT_THROW(builder.draw(50, 51, 0), Rigid3DException);
+
+    glBindVertexArray(0);
+    glDeleteVertexArrays(1, &vao);
+}
@@ -0,0 +1,553 @@
+// ObjFileLoader_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/ObjFileLoader.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+using namespace Rigid3D;
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class ObjFileLoader_Test : public ::testing::Test {
+    protected:
+        vector<vec3> positions;
+        vector<vec3> normals;
+        vector<vec2> uvCoords;
+
+        void decodeString(const string & contents, uint32 numThreads = 0) {
+            ObjFileLoader::decodeBuffer(contents.data(), contents.size(), positions,
+                    normals, uvCoords, numThreads);
+        }
+
+        // Compares bit patterns, so that any rounding difference is caught.
+        static void expectIdentical(const vector<vec3> & expected,
+                const vector<vec3> & actual) {
+            ASSERT_EQ(expected.size(), actual.size());
+            for(size_t i = 0; i < expected.size(); ++i) {
+                ASSERT_EQ(expected[i].x, actual[i].x) << "at index " << i;
+                ASSERT_EQ(expected[i].y, actual[i].y) << "at index " << i;
+                ASSERT_EQ(expected[i].z, actual[i].z) << "at index " << i;
+            }
+        }
+
+        static void expectIdentical(const vector<vec2> & expected,
+                const vector<vec2> & actual) {
+            ASSERT_EQ(expected.size(), actual.size());
+            for(size_t i = 0; i < expected.size(); ++i) {
+                ASSERT_EQ(expected[i].s, actual[i].s) << "at index " << i;
+                ASSERT_EQ(expected[i].t, actual[i].t) << "at index " << i;
+            }
+        }
+
+        void expectSameAsStreamDecoder(const char * objFilePath) {
+            SCOPED_TRACE(objFilePath);
+            vector<vec3> expectedPositions, expectedNormals;
+            vector<vec2> expectedUvCoords;
+            ObjFileLoader::decodeWithStreams(objFilePath, expectedPositions,
+                    expectedNormals, expectedUvCoords);
+
+            positions.clear();
+            normals.clear();
+            uvCoords.clear();
+            ObjFileLoader::decode(objFilePath, positions, normals, uvCoords);
+
+            expectIdentical(expectedPositions, positions);
+            expectIdentical(expectedNormals, normals);
+            expectIdentical(expectedUvCoords, uvCoords);
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, matches_stream_decoder_on_test_meshes) {
+    expectSameAsStreamDecoder("../data/meshes/cube.obj");
+    expectSameAsStreamDecoder("../data/meshes/cube_smooth.obj");
+    expectSameAsStreamDecoder("../data/meshes/cube_textured.obj");
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, matches_stream_decoder_on_large_meshes) {
+    expectSameAsStreamDecoder("../../data/meshes/bunny_smooth.obj");
+    expectSameAsStreamDecoder("../../data/meshes/tyrannosaurus_smooth.obj");
+    expectSameAsStreamDecoder("../../data/meshes/wall_textured.obj");
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, floats_round_the_same_as_streams) {
+    std::srand(3);
+    const char * formats[] = {"%.6f", "%.9g", "%.17g", "%.3e", "%.12f", "%g"};
+    const int numValues = 20000;
+
+    std::stringstream obj;
+    vector<float> expected;
+    for(int i = 0; i < numValues; ++i) {
+        double value = (std::rand() / double(RAND_MAX) - 0.5) *
+                std::pow(10.0, (std::rand() % 24) - 12);
+        char text[64];
+        std::snprintf(text, sizeof(text), formats[i % 6], value);
+
+        std::istringstream in(text);
+        float streamValue = 0.0f;
+        in >> streamValue;
+        expected.push_back(streamValue);
+
+        obj << "v " << text << " 0 0\n";
+    }
+
+    // One face per vertex, so positions[3 * i] is vertex i.
+    obj << "vn 0 0 1\n";
+    for(int i = 1; i <= numValues; ++i) {
+        obj << "f " << i << "//1 " << i << "//1 " << i << "//1\n";
+    }
+    decodeString(obj.str());
+
+    ASSERT_EQ(3u * numValues, positions.size());
+    for(int i = 0; i < numValues; ++i) {
+        ASSERT_EQ(expected[i], positions[3 * i].x) << "parsing value " << i;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, output_is_independent_of_thread_count) {
+    // Faces reference vertices from the start and end of the file, so that with
+    // several chunks most faces span chunk boundaries.
+    std::stringstream obj;
+    const int numVertices = 3000;
+    for(int i = 0; i < numVertices; ++i) {
+        obj << "v " << i << " " << 0.5f * i << " " << -0.25f * i << "\n";
+        obj << "vt " << 0.001f * i << " " << 1.0f - 0.001f * i << "\n";
+        obj << "vn 0 " << (i % 2) << " 1\n";
+        obj << "f " << (i + 1) << "/" << (i + 1) << "/" << (i + 1) << " "
+            << (i / 2 + 1) << "/1/1 1/" << (i + 1) << "/" << (i / 3 + 1) << "\n";
+        obj << "f " << (i + 1) << " " << (i + 1) << " 1\n";
+    }
+    const string contents = obj.str();
+
+    decodeString(contents, 1);
+    const vector<vec3> expectedPositions = positions;
+    const vector<vec3> expectedNormals = normals;
+    const vector<vec2> expectedUvCoords = uvCoords;
+    ASSERT_EQ(6u * numVertices, expectedPositions.size());
+    ASSERT_EQ(6u * numVertices, expectedNormals.size());
+
+    const uint32 threadCounts[] = {2, 3, 7, 64};
+    for(uint32 numThreads : threadCounts) {
+        SCOPED_TRACE(numThreads);
+        positions.clear();
+        normals.clear();
+        uvCoords.clear();
+        decodeString(contents, numThreads);
+
+        expectIdentical(expectedPositions, positions);
+        expectIdentical(expectedNormals, normals);
+        expectIdentical(expectedUvCoords, uvCoords);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, appends_to_existing_output) {
+    positions.push_back(vec3(7.0f));
+    decodeString("v 1 2 3\nf 1 1 1\n", 4);
+
+    ASSERT_EQ(4u, positions.size());
+    EXPECT_EQ(vec3(7.0f), positions[0]);
+    EXPECT_EQ(vec3(1.0f, 2.0f, 3.0f), positions[3]);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, indexed_decode_matches_unindexed_decode) {
+    const char * objFilePaths[] = {
+        "../data/meshes/cube.obj",
+        "../data/meshes/cube_textured.obj",
+        "../../data/meshes/bunny_smooth.obj"
+    };
+
+    for(const char * objFilePath : objFilePaths) {
+        SCOPED_TRACE(objFilePath);
+        vector<vec3> soupPositions, soupNormals;
+        vector<vec2> soupUvCoords;
+        ObjFileLoader::decode(objFilePath, soupPositions, soupNormals, soupUvCoords);
+
+        positions.clear();
+        normals.clear();
+        uvCoords.clear();
+        vector<uint32> indices;
+        ObjFileLoader::decodeIndexed(objFilePath, positions, normals, uvCoords, indices);
+
+        ASSERT_EQ(soupPositions.size(), indices.size());
+        EXPECT_LT(positions.size(), soupPositions.size());
+        EXPECT_EQ(positions.size(), normals.size());
+
+        // Expanding the indices reproduces the unindexed output.
+        for(size_t i = 0; i < indices.size(); ++i) {
+            ASSERT_LT(indices[i], positions.size());
+            ASSERT_EQ(soupPositions[i], positions[indices[i]]) << "at index " << i;
+            ASSERT_EQ(soupNormals[i], normals[indices[i]]) << "at index " << i;
+            if (!soupUvCoords.empty()) {
+                ASSERT_EQ(soupUvCoords[i], uvCoords[indices[i]]) << "at index " << i;
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, indexed_decode_shares_identical_corners) {
+    vector<uint32> indices;
+
+    // Flat cube: each of the 8 positions is used with 3 different face normals.
+    ObjFileLoader::decodeIndexed("../data/meshes/cube.obj", positions, normals,
+            uvCoords, indices);
+    EXPECT_EQ(36u, indices.size());
+    EXPECT_EQ(24u, positions.size());
+
+    // Smooth cube: one normal per position.
+    positions.clear();
+    normals.clear();
+    indices.clear();
+    ObjFileLoader::decodeIndexed("../data/meshes/cube_smooth.obj", positions, normals,
+            uvCoords, indices);
+    EXPECT_EQ(36u, indices.size());
+    EXPECT_EQ(8u, positions.size());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, indexed_decode_keeps_attributes_parallel) {
+    const string contents = "v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\n"
+                            "f 1//1 2//1 3//1\nf 1 2 3\n";
+    vector<uint32> indices;
+    ObjFileLoader::decodeBufferIndexed(contents.data(), contents.size(), positions,
+            normals, uvCoords, indices);
+
+    // Corners without normals are distinct vertices, with zero normals.
+    ASSERT_EQ(6u, positions.size());
+    ASSERT_EQ(6u, normals.size());
+    EXPECT_EQ(0u, uvCoords.size());
+    EXPECT_EQ(vec3(0.0f, 0.0f, 1.0f), normals[indices[0]]);
+    EXPECT_EQ(vec3(0.0f), normals[indices[3]]);
+    EXPECT_EQ(positions[indices[0]], positions[indices[3]]);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, handles_crlf_tabs_and_missing_trailing_newline) {
+    decodeString("# comment\r\nv\t1.5\t-2\t3e1\r\nvn 0 1 0\r\nvt 0.25 0.75\r\n"
+                 "f 1/1/1 1/1/1 1/1/1");
+
+    ASSERT_EQ(3u, positions.size());
+    EXPECT_EQ(vec3(1.5f, -2.0f, 30.0f), positions[0]);
+    EXPECT_EQ(vec3(0.0f, 1.0f, 0.0f), normals[2]);
+    ASSERT_EQ(3u, uvCoords.size());
+    EXPECT_EQ(vec2(0.25f, 0.75f), uvCoords[1]);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, faces_without_normals_only_add_positions) {
+    decodeString("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n");
+
+    EXPECT_EQ(3u, positions.size());
+    EXPECT_EQ(0u, normals.size());
+    EXPECT_EQ(0u, uvCoords.size());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, faces_with_normals_keep_attributes_parallel) {
+    decodeString("v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\nvt 0.5 0.5\n"
+                 "f 1 2 3\nf 1//1 2//1 3//1\nf 1/1 2/1 3/1\n");
+
+    ASSERT_EQ(9u, positions.size());
+    ASSERT_EQ(9u, normals.size());
+    ASSERT_EQ(9u, uvCoords.size());
+    EXPECT_EQ(vec3(0.0f), normals[0]);
+    EXPECT_EQ(vec3(0.0f, 0.0f, 1.0f), normals[3]);
+    EXPECT_EQ(vec3(0.0f), normals[6]);
+    EXPECT_EQ(vec2(0.0f), uvCoords[3]);
+    EXPECT_EQ(vec2(0.5f, 0.5f), uvCoords[6]);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, files_without_faces_decode_to_nothing) {
+    decodeString("");
+    decodeString("# only vertices\nv 0 0 0\nv 1 0 0\nvn 0 0 1\ng empty\nusemtl a\n");
+    EXPECT_EQ(0u, positions.size());
+    EXPECT_EQ(0u, normals.size());
+    EXPECT_EQ(0u, uvCoords.size());
+
+    vector<uint32> indices;
+    const string contents = "v 0 0 0\nv 1 0 0\nv 0 1 0\n";
+    ObjFileLoader::decodeBufferIndexed(contents.data(), contents.size(), positions,
+            normals, uvCoords, indices);
+    EXPECT_EQ(0u, positions.size());
+    EXPECT_EQ(0u, indices.size());
+
+    ObjModel model;
+    ObjFileLoader::decodeModelBuffer(contents.data(), contents.size(),
+            MeshIndexing::Indexed, model);
+    EXPECT_EQ(0u, model.submeshes.size());
+
+    // Groups without faces between ones with faces get no submesh.
+    decodeString("v 0 0 0\nv 1 0 0\nv 0 1 0\ng a\nf 1 2 3\ng b\ng c\nf 1 2 3\n");
+    EXPECT_EQ(6u, positions.size());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, polygons_are_fan_triangulated) {
+    decodeString("v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv -1 1 0\n"
+                 "f 1 2 3 4\nf 1 2 3 4 5\n");
+
+    const vec3 expected[] = {
+        vec3(0, 0, 0), vec3(1, 0, 0), vec3(1, 1, 0),
+        vec3(0, 0, 0), vec3(1, 1, 0), vec3(0, 1, 0),
+        vec3(0, 0, 0), vec3(1, 0, 0), vec3(1, 1, 0),
+        vec3(0, 0, 0), vec3(1, 1, 0), vec3(0, 1, 0),
+        vec3(0, 0, 0), vec3(0, 1, 0), vec3(-1, 1, 0)
+    };
+    ASSERT_EQ(15u, positions.size());
+    for(size_t i = 0; i < positions.size(); ++i) {
+        EXPECT_EQ(expected[i], positions[i]) << "at index " << i;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, negative_indices_count_back_from_last_vertex) {
+    decodeString("v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0.25 0.75\nvn 0 0 1\n"
+                 "f -3/-1/-1 -2/-1/-1 -1/-1/-1\n"
+                 "v 5 5 5\nf -4 -3 -1\n");
+
+    ASSERT_EQ(6u, positions.size());
+    EXPECT_EQ(vec3(0, 0, 0), positions[0]);
+    EXPECT_EQ(vec3(1, 0, 0), positions[1]);
+    EXPECT_EQ(vec3(0, 1, 0), positions[2]);
+    EXPECT_EQ(vec2(0.25f, 0.75f), uvCoords[1]);
+    EXPECT_EQ(vec3(0, 0, 1), normals[2]);
+    EXPECT_EQ(vec3(0, 0, 0), positions[3]);
+    EXPECT_EQ(vec3(1, 0, 0), positions[4]);
+    EXPECT_EQ(vec3(5, 5, 5), positions[5]);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, negative_indices_resolve_across_chunks) {
+    // Each face refers back to the first vertex, whatever chunk it lands in.
+    std::stringstream obj;
+    const int numFaces = 2000;
+    obj << "v 9 9 9\nvn 0 1 0\n";
+    for(int i = 0; i < numFaces; ++i) {
+        obj << "v " << i << " 0 0\nv " << i << " 1 0\n";
+        obj << "f " << -(2 * i + 3) << "//" << "-1 -2//-1 -1//-1\n";
+    }
+    const string contents = obj.str();
+
+    decodeString(contents, 1);
+    const vector<vec3> expectedPositions = positions;
+    ASSERT_EQ(3u * numFaces, expectedPositions.size());
+    EXPECT_EQ(vec3(9.0f), expectedPositions[3 * (numFaces - 1)]);
+    EXPECT_EQ(vec3(numFaces - 1, 1, 0), expectedPositions[3 * numFaces - 1]);
+
+    positions.clear();
+    normals.clear();
+    uvCoords.clear();
+    decodeString(contents, 5);
+    expectIdentical(expectedPositions, positions);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, negative_index_before_first_vertex_throws) {
+    EXPECT_THROW(decodeString("v 0 0 0\nf -1 -2 -1\n"), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, submeshes_split_by_group_and_material) {
+    const string contents =
+        "mtllib a.mtl b.mtl\n"
+        "v 0 0 0\nv 1 0 0\nv 0 1 0\n"
+        "f 1 2 3\n"
+        "o Body\nusemtl red\nf 1 2 3\n"
+        "usemtl blue\nf 1 2 3\nf 1 2 3\n"
+        "g Wheel \nf 1 2 3 1\n"
+        "o Body\nusemtl red\nf 3 2 1\n";
+
+    ObjModel model;
+    ObjFileLoader::decodeModelBuffer(contents.data(), contents.size(),
+            MeshIndexing::Unindexed, model);
+
+    ASSERT_EQ(2u, model.materialLibraries.size());
+    EXPECT_EQ("a.mtl", model.materialLibraries[0]);
+    EXPECT_EQ("b.mtl", model.materialLibraries[1]);
+
+    ASSERT_EQ(4u, model.submeshes.size());
+    const char * names[] = {"", "Body", "Body", "Wheel"};
+    const char * materialNames[] = {"", "red", "blue", "blue"};
+    const uint32 startIndices[] = {0, 3, 9, 15};
+    const uint32 numIndices[] = {3, 6, 6, 6};
+    for(size_t i = 0; i < model.submeshes.size(); ++i) {
+        SCOPED_TRACE(i);
+        EXPECT_EQ(names[i], model.submeshes[i].name);
+        EXPECT_EQ(materialNames[i], model.submeshes[i].materialName);
+        EXPECT_EQ(-1, model.submeshes[i].materialIndex);
+        EXPECT_EQ(startIndices[i], model.submeshes[i].startIndex);
+        EXPECT_EQ(numIndices[i], model.submeshes[i].numIndices);
+    }
+
+    // The last face joins the earlier Body/red faces.
+    ASSERT_EQ(21u, model.positions.size());
+    EXPECT_EQ(vec3(0, 1, 0), model.positions[6]);
+    EXPECT_EQ(vec3(0, 0, 0), model.positions[8]);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, submeshes_are_independent_of_thread_count) {
+    std::stringstream obj;
+    obj << "v 0 0 0\nv 1 0 0\nv 0 1 0\n";
+    for(int i = 0; i < 3000; ++i) {
+        obj << "usemtl m" << (i % 7) << "\n";
+        obj << "v " << i << " 0 0\n";
+        obj << "f 1 2 -1\n";
+    }
+    const string contents = obj.str();
+
+    const MeshIndexing indexings[] = {MeshIndexing::Unindexed, MeshIndexing::Indexed};
+    for(MeshIndexing indexing : indexings) {
+        ObjModel expected;
+        ObjFileLoader::decodeModelBuffer(contents.data(), contents.size(), indexing,
+                expected, 1);
+        ASSERT_EQ(7u, expected.submeshes.size());
+
+        const uint32 threadCounts[] = {2, 3, 8};
+        for(uint32 numThreads : threadCounts) {
+            SCOPED_TRACE(numThreads);
+            ObjModel model;
+            ObjFileLoader::decodeModelBuffer(contents.data(), contents.size(), indexing,
+                    model, numThreads);
+
+            expectIdentical(expected.positions, model.positions);
+            EXPECT_EQ(expected.indices, model.indices);
+            ASSERT_EQ(expected.submeshes.size(), model.submeshes.size());
+            for(size_t i = 0; i < model.submeshes.size(); ++i) {
+                EXPECT_EQ(expected.submeshes[i].materialName, model.submeshes[i].materialName);
+                EXPECT_EQ(expected.submeshes[i].startIndex, model.submeshes[i].startIndex);
+                EXPECT_EQ(expected.submeshes[i].numIndices, model.submeshes[i].numIndices);
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, indexed_submeshes_are_ranges_of_indices) {
+    const string contents = "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\n"
+                            "usemtl a\nf 1 2 3\nusemtl b\nf 2 4 3\nusemtl a\nf 1 2 4\n";
+    ObjModel model;
+    ObjFileLoader::decodeModelBuffer(contents.data(), contents.size(),
+            MeshIndexing::Indexed, model);
+
+    ASSERT_EQ(9u, model.indices.size());
+    EXPECT_EQ(4u, model.positions.size());
+    ASSERT_EQ(2u, model.submeshes.size());
+    EXPECT_EQ(0u, model.submeshes[0].startIndex);
+    EXPECT_EQ(6u, model.submeshes[0].numIndices);
+    EXPECT_EQ(6u, model.submeshes[1].startIndex);
+    EXPECT_EQ(3u, model.submeshes[1].numIndices);
+
+    const uint32 expectedIndices[] = {0, 1, 2, 0, 1, 3, 1, 3, 2};
+    for(size_t i = 0; i < 9; ++i) {
+        EXPECT_EQ(expectedIndices[i], model.indices[i]) << "at index " << i;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, decodes_materials) {
+    const string contents =
+        "# comment\nNs 5\n"
+        "newmtl shiny\r\nKa 0.1 0.2 0.3\r\nKd 0.5\r\nKs 0.3 0.6 0.9\r\n"
+        "Ke 1 0 0\r\nNs 96.5\r\nmap_Kd -s 2 2 1 textures/shiny.png\r\n"
+        "newmtl plain";
+    vector<Material> materials;
+    ObjFileLoader::decodeMaterialsBuffer(contents.data(), contents.size(), materials);
+
+    ASSERT_EQ(2u, materials.size());
+    const Material & shiny = materials[0];
+    EXPECT_EQ("shiny", shiny.name);
+    EXPECT_EQ(vec3(0.1f, 0.2f, 0.3f), shiny.properties.Ka);
+    EXPECT_EQ(vec3(0.5f), shiny.properties.Kd);
+    EXPECT_FLOAT_EQ(0.6f, shiny.properties.Ks);
+    EXPECT_EQ(vec3(1.0f, 0.0f, 0.0f), shiny.properties.emission);
+    EXPECT_EQ(96.5f, shiny.properties.shininessFactor);
+    EXPECT_EQ("textures/shiny.png", shiny.diffuseTexture);
+
+    const Material & plain = materials[1];
+    EXPECT_EQ("plain", plain.name);
+    EXPECT_EQ(vec3(1.0f), plain.properties.Kd);
+    EXPECT_EQ(1.0f, plain.properties.Ks);
+    EXPECT_EQ(vec3(0.0f), plain.properties.emission);
+    EXPECT_TRUE(plain.diffuseTexture.empty());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, decode_model_loads_referenced_materials) {
+    ObjModel model;
+    ObjFileLoader::decodeModel("../../data/meshes/textured_cube.obj",
+            MeshIndexing::Indexed, model);
+
+    ASSERT_EQ(1u, model.materials.size());
+    EXPECT_EQ("Material_concrete_texture.jpg", model.materials[0].name);
+    EXPECT_EQ(vec3(0.64f), model.materials[0].properties.Kd);
+    EXPECT_FLOAT_EQ(0.5f, model.materials[0].properties.Ks);
+
+    ASSERT_EQ(1u, model.submeshes.size());
+    EXPECT_EQ("Cube", model.submeshes[0].name);
+    EXPECT_EQ(0, model.submeshes[0].materialIndex);
+    EXPECT_EQ(model.indices.size(), model.submeshes[0].numIndices);
+
+    // This .mtl file is missing, which leaves the material unresolved.
+    ObjFileLoader::decodeModel("../data/meshes/cube_textured.obj",
+            MeshIndexing::Unindexed, model);
+    EXPECT_TRUE(model.materials.empty());
+    ASSERT_EQ(1u, model.submeshes.size());
+    EXPECT_EQ(-1, model.submeshes[0].materialIndex);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, material_library_paths_are_relative_to_obj_file) {
+    EXPECT_EQ("meshes/a.mtl", ObjFileLoader::getMaterialLibraryPath("meshes/a.obj", "a.mtl"));
+    EXPECT_EQ("a.mtl", ObjFileLoader::getMaterialLibraryPath("a.obj", "a.mtl"));
+    EXPECT_EQ("/b/a.mtl", ObjFileLoader::getMaterialLibraryPath("meshes/a.obj", "/b/a.mtl"));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, out_of_range_index_throws) {
+    EXPECT_THROW(decodeString("v 0 0 0\nvn 0 0 1\nf 1//1 2//1 1//1\n"),
+            Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, indices_too_large_for_int_throw) {
+    // Both would wrap around to valid indices in 32 bits.
+    EXPECT_THROW(decodeString("v 0 0 0\nv 1 0 0\nf 1 4294967298 1\n"), Rigid3DException);
+    EXPECT_THROW(decodeString("v 0 0 0\nv 1 0 0\nf 1 -4294967294 1\n"), Rigid3DException);
+    EXPECT_THROW(decodeString("v 0 0 0\nf 1 99999999999999999999 1\n"), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, out_of_range_index_in_worker_chunk_throws) {
+    std::stringstream obj;
+    for(int i = 0; i < 1000; ++i) {
+        obj << "v 0 0 0\n";
+    }
+    obj << "f 1 2 1001\n";
+
+    EXPECT_THROW(decodeString(obj.str(), 4), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ObjFileLoader_Test, missing_file_throws) {
+    EXPECT_THROW(ObjFileLoader::decode("does_not_exist.obj", positions, normals,
+            uvCoords), Rigid3DException);
+}
@@ -0,0 +1,204 @@
+// OcclusionBuffer_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/OcclusionBuffer.hpp>
+#include <Rigid3D/Graphics/Camera.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Math/SimdLevel.hpp>
+using namespace Rigid3D;
+
+#include <glm/gtc/matrix_transform.hpp>
+using glm::translate;
+using glm::scale;
+
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class OcclusionBuffer_Test : public ::testing::Test {
+    protected:
+        Camera camera;
+        mat4 viewProjection;
+
+        // A wall at z = -5 covering the left half of the view.
+        vector<vec3> wall;
+
+        // Ran before each test.
+        virtual void SetUp() {
+            camera = Camera(45.0f, 2.0f, 1.0f, 100.0f);
+            viewProjection = camera.getProjectionMatrix() * camera.getViewMatrix();
+
+            const vec3 corners[4] = {
+                vec3(-100.0f, -100.0f, -5.0f), vec3(0.0f, -100.0f, -5.0f),
+                vec3(0.0f, 100.0f, -5.0f), vec3(-100.0f, 100.0f, -5.0f)
+            };
+            const uint32 indices[6] = {0, 1, 2, 0, 2, 3};
+            for(uint32 index : indices) {
+                wall.push_back(corners[index]);
+            }
+        }
+
+        // Ran after each test.
+        virtual void TearDown() {
+            setSimdLevel(detectSimdLevel());
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(OcclusionBuffer_Test, objects_behind_the_wall_are_occluded) {
+    OcclusionBuffer occlusion;
+    EXPECT_EQ(256u, occlusion.getWidth());
+    EXPECT_EQ(128u, occlusion.getHeight());
+
+    occlusion.clear(viewProjection);
+    occlusion.addOccluder(wall.data(), wall.size(), mat4());
+    occlusion.buildHiZ();
+    EXPECT_EQ(2u, occlusion.getNumRasterizedTriangles());
+
+    // Left half of the view holds the wall, and the right half is empty.
+    EXPECT_LT(occlusion.getDepth(10, 64), 1.0f);
+    EXPECT_EQ(1.0f, occlusion.getDepth(200, 64));
+
+    EXPECT_TRUE(occlusion.isOccluded(
+            AABB::fromCenter(vec3(-3.0f, 0.0f, -20.0f), vec3(0.5f))));
+    EXPECT_FALSE(occlusion.isOccluded(
+            AABB::fromCenter(vec3(3.0f, 0.0f, -20.0f), vec3(0.5f))));
+    EXPECT_FALSE(occlusion.isOccluded(
+            AABB::fromCenter(vec3(-2.0f, 0.0f, -3.0f), vec3(0.5f))));
+
+    // Straddling the wall's edge, or the near plane.
+    EXPECT_FALSE(occlusion.isOccluded(
+            AABB::fromCenter(vec3(0.0f, 0.0f, -20.0f), vec3(0.5f))));
+    EXPECT_FALSE(occlusion.isOccluded(
+            AABB::fromCenter(vec3(-1.0f, 0.0f, -1.0f), vec3(0.5f))));
+
+    // Reaching from behind the wall far past the right edge of the view.
+    AABB wide;
+    wide.minBounds = vec3(-3.0f, -0.5f, -20.5f);
+    wide.maxBounds = vec3(1e20f, 0.5f, -19.5f);
+    EXPECT_FALSE(occlusion.isOccluded(wide));
+
+    // Clearing removes the occluders.
+    occlusion.clear(viewProjection);
+    occlusion.buildHiZ();
+    EXPECT_FALSE(occlusion.isOccluded(
+            AABB::fromCenter(vec3(-3.0f, 0.0f, -20.0f), vec3(0.5f))));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(OcclusionBuffer_Test, occluders_are_clipped_at_the_near_plane) {
+    // A floor from behind the camera out to z = -50, seen from above.
+    camera.setPosition(0.0f, 2.0f, 0.0f);
+    viewProjection = camera.getProjectionMatrix() * camera.getViewMatrix();
+
+    const vec3 floor[6] = {
+        vec3(-50.0f, 0.0f, 10.0f), vec3(50.0f, 0.0f, 10.0f), vec3(50.0f, 0.0f, -50.0f),
+        vec3(-50.0f, 0.0f, 10.0f), vec3(50.0f, 0.0f, -50.0f), vec3(-50.0f, 0.0f, -50.0f)
+    };
+
+    OcclusionBuffer occlusion;
+    occlusion.clear(viewProjection);
+    occlusion.addOccluder(floor, 6, mat4());
+    occlusion.buildHiZ();
+
+    // The bottom rows see the floor, and the top rows see past it.
+    EXPECT_LT(occlusion.getDepth(128, 2), 1.0f);
+    EXPECT_EQ(1.0f, occlusion.getDepth(128, 120));
+
+    EXPECT_TRUE(occlusion.isOccluded(
+            AABB::fromCenter(vec3(0.0f, -3.0f, -10.0f), vec3(0.5f))));
+    EXPECT_FALSE(occlusion.isOccluded(
+            AABB::fromCenter(vec3(0.0f, 1.0f, -10.0f), vec3(0.5f))));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(OcclusionBuffer_Test, simd_and_scalar_rasterize_the_same_depths) {
+    OcclusionBuffer scalar(100, 60);
+    OcclusionBuffer simd(100, 60);
+
+    // A fan of sloped triangles, which partly overlap each other.
+    vector<vec3> triangles;
+    for(int i = 0; i < 12; ++i) {
+        const float x = -6.0f + float(i) * 1.1f;
+        triangles.push_back(vec3(x, -3.3f, -6.0f - 0.3f * float(i)));
+        triangles.push_back(vec3(x + 2.7f, -1.1f, -9.0f));
+        triangles.push_back(vec3(x + 0.4f, 2.9f, -4.0f));
+    }
+
+    setSimdLevel(SimdLevel::Scalar);
+    scalar.clear(viewProjection);
+    scalar.addOccluder(triangles.data(), triangles.size(), mat4());
+    scalar.buildHiZ();
+
+    setSimdLevel(detectSimdLevel());
+    simd.clear(viewProjection);
+    simd.addOccluder(triangles.data(), triangles.size(), mat4());
+    simd.buildHiZ();
+
+    ASSERT_EQ(scalar.getNumHiZLevels(), simd.getNumHiZLevels());
+    for(uint32 y = 0; y < 60; ++y) {
+        for(uint32 x = 0; x < 100; ++x) {
+            EXPECT_FLOAT_EQ(scalar.getDepth(x, y), simd.getDepth(x, y))
+                    << "at pixel " << x << ", " << y;
+        }
+    }
+    for(uint32 k = 0; k < simd.getNumHiZLevels(); ++k) {
+        EXPECT_EQ(scalar.getHiZDepth(k, 0, 0), simd.getHiZDepth(k, 0, 0));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(OcclusionBuffer_Test, hiz_levels_hold_maximum_depths) {
+    OcclusionBuffer occlusion(36, 20);
+    occlusion.clear(viewProjection);
+    occlusion.addOccluder(wall.data(), wall.size(), translate(mat4(), vec3(1.3f, 0.0f, 0.0f)));
+    occlusion.buildHiZ();
+
+    // 36x20, 18x10, 9x5, 5x3, 3x2, 2x1, 1x1
+    ASSERT_EQ(7u, occlusion.getNumHiZLevels());
+    for(uint32 y = 0; y < 10; ++y) {
+        for(uint32 x = 0; x < 18; ++x) {
+            float expected = std::max(
+                    std::max(occlusion.getDepth(2 * x, 2 * y), occlusion.getDepth(2 * x + 1, 2 * y)),
+                    std::max(occlusion.getDepth(2 * x, 2 * y + 1),
+                             occlusion.getDepth(2 * x + 1, 2 * y + 1)));
+            EXPECT_EQ(expected, occlusion.getHiZDepth(1, x, y));
+        }
+    }
+    EXPECT_EQ(1.0f, occlusion.getHiZDepth(6, 0, 0));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(OcclusionBuffer_Test, mesh_occluders) {
+    Mesh cube("../data/meshes/cube.obj");
+
+    OcclusionBuffer occlusion;
+    occlusion.clear(viewProjection);
+    occlusion.addOccluder(cube, scale(translate(mat4(),
+            vec3(0.0f, 0.0f, -10.0f)), vec3(4.0f)));
+    occlusion.buildHiZ();
+
+    EXPECT_EQ(cube.getNumVertexPositions() / 3, occlusion.getNumRasterizedTriangles());
+    EXPECT_TRUE(occlusion.isOccluded(
+            AABB::fromCenter(vec3(0.0f, 0.0f, -30.0f), vec3(0.5f))));
+    EXPECT_FALSE(occlusion.isOccluded(
+            AABB::fromCenter(vec3(0.0f, 0.0f, -5.0f), vec3(0.5f))));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(OcclusionBuffer_Test, misuse_throws) {
+    EXPECT_THROW(OcclusionBuffer(30, 20), Rigid3DException);
+    EXPECT_THROW(OcclusionBuffer(32, 0), Rigid3DException);
+
+    OcclusionBuffer occlusion;
+    occlusion.clear(viewProjection);
+    occlusion.addOccluder(wall.data(), wall.size(), mat4());
+    EXPECT_THROW(occlusion.isOccluded(AABB::fromCenter(vec3(0.0f), vec3(1.0f))),
+            Rigid3DException);
+}
@@ -0,0 +1,390 @@
+// RenderQueue_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/RenderQueue.hpp>
+#include <Rigid3D/Graphics/MeshConsolidator.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class RenderQueue_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+        static shared_ptr<ShaderProgram> programs[2];
+        static shared_ptr<ShaderProgram> instancedProgram;
+
+        GLuint vaos[2];
+        BatchInfo triangle;
+        RenderContext context;
+
+        RenderQueue_Test()
+            : triangle(0, 3) {
+            glGenVertexArrays(2, vaos);
+            context.viewMatrix = mat4();
+            context.projectionMatrix = mat4();
+        }
+
+        ~RenderQueue_Test() {
+            glDeleteVertexArrays(2, vaos);
+        }
+
+        static void SetUpTestCase() {
+            // Multi-draws need OpenGL 4.3.
+            glContext = std::make_shared<OpenGLContext>(4, 3);
+            glContext->init();
+
+            for(shared_ptr<ShaderProgram> & program : programs) {
+                program = std::make_shared<ShaderProgram>();
+                program->generateProgramObject();
+                program->attachVertexShader("../data/shaders/Renderable.vert");
+                program->attachFragmentShader("../data/shaders/Renderable.frag");
+                program->link();
+            }
+
+            instancedProgram = std::make_shared<ShaderProgram>();
+            instancedProgram->generateProgramObject();
+            instancedProgram->attachVertexShader("../data/shaders/RenderableInstanced.vert");
+            instancedProgram->attachFragmentShader("../data/shaders/Renderable.frag");
+            instancedProgram->link();
+        }
+
+        static void TearDownTestCase() {
+            programs[0].reset();
+            programs[1].reset();
+            instancedProgram.reset();
+            glContext.reset();
+        }
+
+        // A Renderable drawing 'triangle' at depth 'z' in front of the camera.
+        Renderable makeRenderable(uint32 program, uint32 vao, float z,
+                float diffuse = 1.0f) {
+            Renderable renderable(&vaos[vao], programs[program].get(), &triangle);
+            renderable.setPosition(vec3(0.0f, 0.0f, -z));
+            renderable.setDiffuseLevels(vec3(diffuse));
+            return renderable;
+        }
+
+        static void copyFile(const string & from, const string & to) {
+            std::ifstream in(from.c_str(), std::ios::binary);
+            std::ofstream out(to.c_str(), std::ios::binary);
+            out << in.rdbuf();
+        }
+    };
+
+    shared_ptr<OpenGLContext> RenderQueue_Test::glContext;
+    shared_ptr<ShaderProgram> RenderQueue_Test::programs[2];
+    shared_ptr<ShaderProgram> RenderQueue_Test::instancedProgram;
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(RenderQueue_Test, sorts_by_pass_then_state_then_depth) {
+    vector<Renderable> renderables = {
+        makeRenderable(1, 0, 5.0f),
+        makeRenderable(0, 1, 2.0f),
+        makeRenderable(0, 0, 9.0f),
+        makeRenderable(0, 0, 3.0f),
+        makeRenderable(1, 0, 1.0f),
+        makeRenderable(0, 1, 2.0f, 0.5f)
+    };
+    vector<Renderable> blended = {
+        makeRenderable(0, 0, 4.0f),
+        makeRenderable(1, 1, 8.0f),
+        makeRenderable(0, 0, 6.0f)
+    };
+
+    RenderQueue queue;
+    queue.setDepthOrder(1, DepthOrder::BackToFront);
+    for(Renderable & renderable : blended) {
+        queue.submit(renderable, 1);
+    }
+    for(Renderable & renderable : renderables) {
+        queue.submit(renderable);
+    }
+    Renderable incomplete;
+    queue.submit(incomplete);
+
+    queue.sort(context.viewMatrix);
+    const vector<RenderQueue::Item> & items = queue.getItems();
+    ASSERT_EQ(9u, items.size());
+
+    // Opaque pass first, grouped by program, VAO and material, then front to back.
+    const Renderable * expected[] = {
+        &renderables[3], &renderables[2],
+        &renderables[1], &renderables[5],
+        &renderables[4], &renderables[0],
+        &blended[1], &blended[2], &blended[0]
+    };
+    for(size_t i = 0; i < items.size(); ++i) {
+        EXPECT_EQ(expected[i], items[i].renderable) << "at item " << i;
+        if (i > 0) {
+            EXPECT_LT(items[i - 1].sortKey, items[i].sortKey);
+        }
+    }
+
+    EXPECT_THROW(queue.submit(renderables[0], RenderQueue::numPasses), Rigid3DException);
+    queue.clear();
+    EXPECT_TRUE(queue.getItems().empty());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(RenderQueue_Test, execute_only_changes_state_between_groups) {
+    vector<Renderable> renderables;
+    for(uint32 i = 0; i < 64; ++i) {
+        // Interleave programs, VAOs and two materials in submission order.
+        renderables.push_back(makeRenderable(i % 2, (i / 2) % 2, 1.0f + i,
+                (i % 8 < 4) ? 1.0f : 0.5f));
+    }
+
+    RenderQueue queue;
+    for(Renderable & renderable : renderables) {
+        queue.submit(renderable);
+    }
+    queue.execute(context);
+
+    const RenderStats & stats = queue.getStats();
+    EXPECT_EQ(64u, stats.numDrawCalls);
+    EXPECT_EQ(2u, stats.numProgramChanges);
+    EXPECT_EQ(4u, stats.numVertexArrayChanges);
+    EXPECT_EQ(8u, stats.numMaterialChanges);
+    EXPECT_EQ(14u, stats.getNumStateChanges());
+    EXPECT_EQ(GLenum(GL_NO_ERROR), glGetError());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(RenderQueue_Test, identical_renderables_are_drawn_instanced) {
+    BatchInfo otherMesh(3, 3);
+    vector<Renderable> renderables(10000);
+    for(size_t i = 0; i < renderables.size(); ++i) {
+        const bool other = i % 100 == 0;
+        renderables[i] = Renderable(&vaos[0], instancedProgram.get(),
+                other ? &otherMesh : &triangle);
+        renderables[i].setPosition(vec3(float(i % 100), float(i / 100), -1.0f));
+        renderables[i].setDiffuseLevels(vec3((i % 2 == 0) ? 1.0f : 0.5f));
+    }
+
+    RenderQueue queue;
+    for(Renderable & renderable : renderables) {
+        queue.submit(renderable);
+    }
+    // A lone Renderable has nothing to share a draw call with.
+    Renderable single = makeRenderable(0, 0, 1.0f);
+    queue.submit(single);
+    queue.execute(context);
+
+    // One draw per mesh and material, of which the 'otherMesh' ones all share
+    // the first material.
+    const RenderStats & stats = queue.getStats();
+    EXPECT_EQ(4u, stats.numDrawCalls);
+    EXPECT_EQ(3u, stats.numInstancedDrawCalls);
+    EXPECT_EQ(2u, stats.numProgramChanges);
+    EXPECT_EQ(GLenum(GL_NO_ERROR), glGetError());
+
+    // Renderables whose program has no instanced attributes are drawn one by one.
+    queue.clear();
+    vector<Renderable> plain(10, makeRenderable(1, 1, 2.0f));
+    for(Renderable & renderable : plain) {
+        queue.submit(renderable);
+    }
+    queue.execute(context);
+    EXPECT_EQ(10u, queue.getStats().numDrawCalls);
+    EXPECT_EQ(0u, queue.getStats().numInstancedDrawCalls);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(RenderQueue_Test, multi_draw_issues_one_call_per_state_bucket) {
+    // Distinct meshes of one consolidated buffer, as from a MeshConsolidator.
+    vector<BatchInfo> meshes;
+    for(uint32 i = 0; i < 100; ++i) {
+        meshes.push_back(BatchInfo(3 * i, 3));
+    }
+
+    vector<Renderable> renderables;
+    for(uint32 i = 0; i < 1000; ++i) {
+        Renderable renderable(&vaos[0], instancedProgram.get(), &meshes[i % 100]);
+        renderable.setPosition(vec3(float(i % 10), float(i / 10), -1.0f));
+        renderable.setDiffuseLevels(vec3((i % 200 < 100) ? 1.0f : 0.5f));
+        renderables.push_back(renderable);
+    }
+
+    RenderQueue queue;
+    EXPECT_FALSE(queue.isMultiDrawEnabled());
+    queue.setMultiDraw(true);
+    ASSERT_TRUE(queue.isMultiDrawEnabled());
+    for(Renderable & renderable : renderables) {
+        queue.submit(renderable);
+    }
+    queue.execute(context);
+
+    // One command per mesh and material, drawn with one call per material.
+    const RenderStats & stats = queue.getStats();
+    EXPECT_EQ(2u, stats.numDrawCalls);
+    EXPECT_EQ(2u, stats.numMultiDrawCalls);
+    EXPECT_EQ(200u, stats.numDrawCommands);
+    EXPECT_EQ(2u, stats.numMaterialChanges);
+    EXPECT_EQ(GLenum(GL_NO_ERROR), glGetError());
+
+    // A single Renderable still becomes a command, and programs without
+    // instanced attributes are drawn one by one.
+    queue.clear();
+    Renderable single(&vaos[1], instancedProgram.get(), &meshes[0]);
+    Renderable plain = makeRenderable(0, 0, 1.0f);
+    queue.submit(single);
+    queue.submit(plain);
+    queue.execute(context);
+    EXPECT_EQ(2u, queue.getStats().numDrawCalls);
+    EXPECT_EQ(1u, queue.getStats().numMultiDrawCalls);
+    EXPECT_EQ(1u, queue.getStats().numDrawCommands);
+    EXPECT_EQ(GLenum(GL_NO_ERROR), glGetError());
+
+    // Without multi-draws, as on contexts before OpenGL 4.3, the same queue is
+    // drawn instanced one run at a time.
+    queue.setMultiDraw(false);
+    queue.clear();
+    for(Renderable & renderable : renderables) {
+        queue.submit(renderable);
+    }
+    queue.execute(context);
+    EXPECT_EQ(200u, queue.getStats().numDrawCalls);
+    EXPECT_EQ(200u, queue.getStats().numInstancedDrawCalls);
+    EXPECT_EQ(0u, queue.getStats().numMultiDrawCalls);
+    EXPECT_EQ(GLenum(GL_NO_ERROR), glGetError());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(RenderQueue_Test, ids_are_reassigned_each_frame) {
+    Renderable animated = makeRenderable(0, 0, 1.0f);
+    Renderable still = makeRenderable(1, 1, 2.0f);
+
+    RenderQueue queue;
+    for(uint32 frame = 0; frame < 5000; ++frame) {
+        queue.clear();
+        animated.setEmissionLevels(vec3(float(frame)));
+        queue.submit(animated);
+        queue.submit(still);
+    }
+
+    // A new emission every frame would otherwise have used up the material IDs.
+    const vector<RenderQueue::Item> & items = queue.getItems();
+    ASSERT_EQ(2u, items.size());
+    EXPECT_EQ(0u, items[0].materialId);
+    EXPECT_EQ(1u, items[1].materialId);
+    EXPECT_EQ(1u, items[1].programId);
+    EXPECT_EQ(1u, items[1].vertexArrayId);
+    EXPECT_EQ(0u, items[1].batchId);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(RenderQueue_Test, relinked_programs_get_uniforms_at_their_new_locations) {
+    const char * tempDirectory = std::getenv("TMPDIR");
+    const string shaderPath = string(tempDirectory ? tempDirectory : "/tmp") +
+            "/RenderQueue_Test_relinked.vert";
+    copyFile("../data/shaders/Renderable.vert", shaderPath);
+
+    ShaderProgram program;
+    program.generateProgramObject();
+    program.attachVertexShader(shaderPath.c_str());
+    program.attachFragmentShader("../data/shaders/Renderable.frag");
+    program.link();
+    const uint32 firstGeneration = program.getLinkGeneration();
+
+    Renderable renderable(&vaos[0], &program, &triangle);
+    RenderQueue queue;
+    queue.submit(renderable);
+    queue.execute(context);
+
+    // Reloading a shader without ModelViewMatrix and NormalMatrix moves the
+    // uniforms that are left.
+    copyFile("../data/shaders/RenderableInstanced.vert", shaderPath);
+    program.recompileShaders();
+    program.link();
+    std::remove(shaderPath.c_str());
+    EXPECT_NE(firstGeneration, program.getLinkGeneration());
+    EXPECT_NE(programs[0]->getLinkGeneration(), program.getLinkGeneration());
+
+    context.projectionMatrix = mat4(2.0f);
+    renderable.setDiffuseLevels(vec3(0.25f));
+    queue.execute(context);
+
+    float projection[16];
+    glGetUniformfv(program.getProgramObject(),
+            program.getUniformLocation("ProjectionMatrix"), projection);
+    EXPECT_FLOAT_EQ(2.0f, projection[0]);
+    EXPECT_FLOAT_EQ(2.0f, projection[15]);
+
+    float diffuse[3];
+    glGetUniformfv(program.getProgramObject(),
+            program.getUniformLocation("material.Kd"), diffuse);
+    EXPECT_FLOAT_EQ(0.25f, diffuse[0]);
+    EXPECT_EQ(GLenum(GL_NO_ERROR), glGetError());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(RenderQueue_Test, instance_buffer_is_reattached_to_reset_vertex_arrays) {
+    vector<Renderable> renderables(2, Renderable(&vaos[0], instancedProgram.get(),
+            &triangle));
+    RenderQueue queue;
+    for(Renderable & renderable : renderables) {
+        queue.submit(renderable);
+    }
+
+    const GLuint location = RenderQueue::instanceAttribLocation;
+    for(int frame = 0; frame < 2; ++frame) {
+        queue.execute(context);
+        EXPECT_EQ(1u, queue.getStats().numInstancedDrawCalls);
+
+        GLint enabled = GL_FALSE;
+        GLint buffer = 0;
+        glGetVertexAttribiv(location, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &enabled);
+        glGetVertexAttribiv(location, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &buffer);
+        EXPECT_EQ(GL_TRUE, enabled) << "in frame " << frame;
+        EXPECT_NE(0, buffer) << "in frame " << frame;
+
+        // Looks to the queue like a VAO deleted and recreated under the same name.
+        glDisableVertexAttribArray(location);
+    }
+    glBindVertexArray(0);
+    EXPECT_EQ(GLenum(GL_NO_ERROR), glGetError());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(RenderQueue_Test, instanced_runs_read_their_own_instances) {
+    // Two runs, split by material.  The first run's triangles are off screen,
+    // and the second run's cover the screen, so the screen is only drawn on
+    // if the second run reads its own instances.
+    vector<Renderable> renderables;
+    for(uint32 i = 0; i < 4; ++i) {
+        Renderable renderable(&vaos[0], instancedProgram.get(), &triangle);
+        renderable.setPosition(vec3((i < 2) ? 10.0f : 0.0f, 0.0f, -0.5f));
+        renderable.setDiffuseLevels(vec3((i < 2) ? 1.0f : 0.5f));
+        renderables.push_back(renderable);
+    }
+
+    RenderQueue queue;
+    for(Renderable & renderable : renderables) {
+        queue.submit(renderable);
+    }
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    queue.execute(context);
+    EXPECT_EQ(2u, queue.getStats().numInstancedDrawCalls);
+
+    GLubyte pixel[4];
+    glReadPixels(0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+    EXPECT_EQ(255, pixel[3]);
+    glBindVertexArray(0);
+    EXPECT_EQ(GLenum(GL_NO_ERROR), glGetError());
+}
@@ -110,6 +110,48 @@ namespace {  // limit class visibility to this file.
         EXPECT_NE(-1, goodProgram->getAttribLocation("position"));
     }
 
+    //----------------------------------------------------------------------------------------
+    /**
+     * @brief Locations are read at link time, so unknown names throw without a
+     * driver round trip.
+     */
+    TEST_F(ShaderProgram_Test, test_unknown_names_throw){
+        EXPECT_THROW(goodProgram->getUniformLocation("missingUniform"), ShaderException);
+        EXPECT_THROW(goodProgram->getAttribLocation("missingAttribute"), ShaderException);
+        EXPECT_THROW(goodProgram->setUniform("missingUniform", 1.0f), ShaderException);
+    }
+
+    //----------------------------------------------------------------------------------------
+    TEST_F(ShaderProgram_Test, test_setUniform_by_location) {
+        GLint uniformLocation = goodProgram->getUniformLocation("vec3Uniform");
+        EXPECT_EQ(glGetUniformLocation(goodProgram->getProgramObject(), "vec3Uniform"),
+                uniformLocation);
+
+        vec3 expected = vec3(4.0f, 5.0f, 6.0f);
+        goodProgram->setUniform(uniformLocation, expected);
+        float values[3];
+        glGetUniformfv(goodProgram->getProgramObject(), uniformLocation, values);
+
+        EXPECT_FLOAT_EQ(expected.x, values[0]);
+        EXPECT_FLOAT_EQ(expected.y, values[1]);
+        EXPECT_FLOAT_EQ(expected.z, values[2]);
+    }
+
+    //----------------------------------------------------------------------------------------
+    TEST_F(ShaderProgram_Test, test_setUniform_does_not_change_program_in_use) {
+        shaderProgram->disable();
+        goodProgram->setUniform("floatUniform", 3.0f);
+
+        GLint currentProgram;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+        EXPECT_EQ(0, currentProgram);
+
+        goodProgram->enable();
+        glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+        EXPECT_EQ(GLint(goodProgram->getProgramObject()), currentProgram);
+        goodProgram->disable();
+    }
+
     //----------------------------------------------------------------------------------------
     TEST_F(ShaderProgram_Test, test_setUniform_bool) {
         goodProgram->setUniform("boolUniform", true);
@@ -0,0 +1,129 @@
+// UniformRingBuffer_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/UniformRingBuffer.hpp>
+#include <Rigid3D/Graphics/UniformBlocks.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <cstring>
+#include <memory>
+#include <vector>
+using std::shared_ptr;
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class UniformRingBuffer_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+
+        // Persistent mapping needs OpenGL 4.4, which Mesa's llvmpipe provides.
+        static void SetUpTestCase() {
+            glContext = std::make_shared<OpenGLContext>(4, 4);
+            glContext->init();
+        }
+
+        static void TearDownTestCase() {
+            glContext.reset();
+        }
+
+        // Reads back 'numBytes' of the buffer starting at 'offset'.
+        static vector<uint8> readBack(const UniformRingBuffer & ring, uint32 offset,
+                uint32 numBytes) {
+            vector<uint8> data(numBytes);
+            glFinish();
+            glBindBuffer(GL_UNIFORM_BUFFER, ring.getBufferObject());
+            glGetBufferSubData(GL_UNIFORM_BUFFER, offset, numBytes, data.data());
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            return data;
+        }
+    };
+
+    shared_ptr<OpenGLContext> UniformRingBuffer_Test::glContext;
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(UniformRingBuffer_Test, writes_are_aligned_and_visible_to_gl) {
+    UniformRingBuffer ring(1000);
+    EXPECT_TRUE(ring.isPersistentlyMapped());
+    const uint32 alignment = ring.getOffsetAlignment();
+    EXPECT_EQ(0u, ring.getRegionSize() % alignment);
+    EXPECT_GE(ring.getRegionSize(), 1000u);
+
+    ring.beginFrame();
+    const uint8 first[3] = {1, 2, 3};
+    const uint8 second[5] = {4, 5, 6, 7, 8};
+    const uint32 a = ring.write(first, 3);
+    const uint32 b = ring.write(second, 5);
+    EXPECT_EQ(0u, a);
+    EXPECT_EQ(alignment, b);
+    EXPECT_EQ(alignment + 5, ring.getNumBytesUsed());
+    ring.endFrame();
+
+    EXPECT_EQ(vector<uint8>(first, first + 3), readBack(ring, a, 3));
+    EXPECT_EQ(vector<uint8>(second, second + 5), readBack(ring, b, 5));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(UniformRingBuffer_Test, frames_cycle_through_regions) {
+    UniformRingBuffer ring(sizeof(ObjectUniforms) * 4);
+    const uint32 regionSize = ring.getRegionSize();
+
+    ObjectUniforms uniforms;
+    for(uint32 frame = 0; frame < 2 * UniformRingBuffer::numRegions; ++frame) {
+        ring.beginFrame();
+        const uint32 offset = ring.bindBlock(1, uniforms);
+        EXPECT_EQ((frame % UniformRingBuffer::numRegions) * regionSize, offset);
+
+        GLint boundBuffer;
+        glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, 1, &boundBuffer);
+        EXPECT_EQ(GLint(ring.getBufferObject()), boundBuffer);
+        ring.endFrame();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(UniformRingBuffer_Test, without_persistent_mapping_writes_map_the_buffer) {
+    UniformRingBuffer ring(sizeof(ObjectUniforms) * 4, false);
+    EXPECT_FALSE(ring.isPersistentlyMapped());
+    const uint32 regionSize = ring.getRegionSize();
+
+    for(uint32 frame = 0; frame < 2 * UniformRingBuffer::numRegions; ++frame) {
+        ring.beginFrame();
+        const uint8 bytes[4] = {uint8(frame), 1, 2, 3};
+        const uint32 offset = ring.write(bytes, 4);
+        EXPECT_EQ((frame % UniformRingBuffer::numRegions) * regionSize, offset);
+
+        ObjectUniforms uniforms;
+        uniforms.Ks = float(frame);
+        const uint32 blockOffset = ring.bindBlock(1, uniforms);
+        ring.endFrame();
+
+        EXPECT_EQ(vector<uint8>(bytes, bytes + 4), readBack(ring, offset, 4));
+        ObjectUniforms readUniforms;
+        const vector<uint8> block = readBack(ring, blockOffset, sizeof(ObjectUniforms));
+        memcpy(&readUniforms, block.data(), sizeof(ObjectUniforms));
+        EXPECT_EQ(float(frame), readUniforms.Ks);
+    }
+    EXPECT_EQ(GLenum(GL_NO_ERROR), glGetError());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(UniformRingBuffer_Test, throws_on_overflow_and_misuse) {
+    UniformRingBuffer ring(256);
+    vector<uint8> data(ring.getRegionSize() + 1);
+
+    EXPECT_THROW(ring.write(data.data(), 4), Rigid3DException);
+    EXPECT_THROW(ring.endFrame(), Rigid3DException);
+
+    ring.beginFrame();
+    EXPECT_THROW(ring.beginFrame(), Rigid3DException);
+    EXPECT_THROW(ring.write(data.data(), uint32(data.size())), Rigid3DException);
+    ring.write(data.data(), ring.getRegionSize());
+    EXPECT_THROW(ring.write(data.data(), 1), Rigid3DException);
+    ring.endFrame();
+}
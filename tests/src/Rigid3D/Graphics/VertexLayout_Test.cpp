@@ -0,0 +1,251 @@
+// VertexLayout_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/VertexLayout.hpp>
+using namespace Rigid3D;
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class VertexLayout_Test : public ::testing::Test {
+    protected:
+        static void expectFormat(const VertexAttributeFormat & format,
+                uint32 numComponents, uint32 offset, uint32 stride) {
+            EXPECT_EQ(numComponents, format.numComponents);
+            EXPECT_EQ(offset, format.offset);
+            EXPECT_EQ(stride, format.stride);
+        }
+
+        // Unlike acos of the dot product, accurate for nearly parallel vectors.
+        static float angleBetween(const vec3 & a, const vec3 & b) {
+            return std::atan2(glm::length(glm::cross(a, b)), glm::dot(a, b));
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VertexLayout_Test, separate_layout_has_one_block_per_attribute) {
+    VertexLayout layout(VertexLayoutType::Separate, 10, true, true);
+
+    expectFormat(layout.getPositionFormat(), 3, 0, 12);
+    expectFormat(layout.getNormalFormat(), 3, 120, 12);
+    expectFormat(layout.getUvCoordFormat(), 2, 240, 8);
+    EXPECT_EQ(320u, layout.getNumBytes());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VertexLayout_Test, interleaved_layout_shares_one_stride) {
+    VertexLayout layout(VertexLayoutType::Interleaved, 10, true, true);
+    expectFormat(layout.getPositionFormat(), 3, 0, 32);
+    expectFormat(layout.getNormalFormat(), 3, 12, 32);
+    expectFormat(layout.getUvCoordFormat(), 2, 24, 32);
+    EXPECT_EQ(320u, layout.getNumBytes());
+
+    // Missing attributes take no space.
+    VertexLayout noUvCoords(VertexLayoutType::Interleaved, 10, true, false);
+    EXPECT_FALSE(noUvCoords.getUvCoordFormat().isEnabled());
+    expectFormat(noUvCoords.getNormalFormat(), 3, 12, 24);
+    EXPECT_EQ(240u, noUvCoords.getNumBytes());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VertexLayout_Test, packed_layout_is_20_bytes_per_vertex) {
+    VertexLayout layout(VertexLayoutType::Packed, 10, true, true);
+    expectFormat(layout.getPositionFormat(), 3, 0, 20);
+    expectFormat(layout.getNormalFormat(), 4, 12, 20);
+    expectFormat(layout.getUvCoordFormat(), 2, 16, 20);
+    EXPECT_EQ(VertexComponentType::Int2_10_10_10, layout.getNormalFormat().componentType);
+    EXPECT_TRUE(layout.getNormalFormat().normalized);
+    EXPECT_EQ(VertexComponentType::Float16, layout.getUvCoordFormat().componentType);
+    EXPECT_EQ(200u, layout.getNumBytes());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VertexLayout_Test, writes_vertices_at_offset) {
+    const vec3 positions[] = {vec3(1, 2, 3), vec3(4, 5, 6)};
+    const vec3 normals[] = {vec3(0, 0, 1), vec3(0, 1, 0)};
+
+    VertexLayout layout(VertexLayoutType::Interleaved, 3, true, true);
+    vector<ubyte> data(layout.getNumBytes(), 0xFF);
+    layout.writeVertices(data.data(), 1, 2, positions, normals, nullptr);
+
+    vec3 position;
+    std::memcpy(&position, &data[2 * 32], sizeof(position));
+    EXPECT_EQ(positions[1], position);
+
+    vec3 normal;
+    std::memcpy(&normal, &data[32 + 12], sizeof(normal));
+    EXPECT_EQ(normals[0], normal);
+
+    // No texture coordinates given, so zeros are written.
+    vec2 uvCoord;
+    std::memcpy(&uvCoord, &data[32 + 24], sizeof(uvCoord));
+    EXPECT_EQ(vec2(0.0f), uvCoord);
+
+    // The first vertex is untouched.
+    EXPECT_EQ(0xFF, data[0]);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VertexLayout_Test, half_floats_round_trip) {
+    const float exact[] = {0.0f, 1.0f, -2.0f, 0.5f, 65504.0f, 6.103515625e-05f,
+                           5.9604644775390625e-08f};
+    for(float value : exact) {
+        EXPECT_EQ(value, VertexLayout::unpackHalfFloat(VertexLayout::packHalfFloat(value)))
+                << value;
+    }
+
+    EXPECT_EQ(0x3C00, VertexLayout::packHalfFloat(1.0f));
+    EXPECT_EQ(0x7C00, VertexLayout::packHalfFloat(1e6f));
+    EXPECT_EQ(0xFC00, VertexLayout::packHalfFloat(-std::numeric_limits<float>::infinity()));
+    EXPECT_TRUE(std::isnan(VertexLayout::unpackHalfFloat(VertexLayout::packHalfFloat(
+            std::numeric_limits<float>::quiet_NaN()))));
+
+    // Ties round to even: 1 + 2^-11 lies halfway between 1 and 1 + 2^-10.
+    EXPECT_EQ(0x3C00, VertexLayout::packHalfFloat(1.0f + 1.0f / 2048.0f));
+    EXPECT_EQ(0x3C02, VertexLayout::packHalfFloat(1.0f + 3.0f / 2048.0f));
+
+    // Texture coordinates in [0, 1] keep 11 significant bits.
+    for(int i = 0; i <= 1000; ++i) {
+        float value = i / 1000.0f;
+        EXPECT_NEAR(value, VertexLayout::unpackHalfFloat(VertexLayout::packHalfFloat(value)),
+                value / 2048.0f + 1e-7f);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VertexLayout_Test, normals_pack_to_10_bits) {
+    EXPECT_EQ(0u, VertexLayout::packNormal(vec3(0.0f)));
+    EXPECT_EQ(vec3(1.0f, -1.0f, 0.0f),
+            VertexLayout::unpackNormal(VertexLayout::packNormal(vec3(1.0f, -1.0f, 0.0f))));
+
+    const vec3 normal = glm::normalize(vec3(0.3f, -0.5f, 0.8f));
+    const vec3 unpacked = VertexLayout::unpackNormal(VertexLayout::packNormal(normal));
+    for(int i = 0; i < 3; ++i) {
+        EXPECT_NEAR(normal[i], unpacked[i], 0.5f / 511.0f);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VertexLayout_Test, quantized_layout_is_16_bytes_per_vertex) {
+    VertexBounds bounds;
+    AABB aabb;
+    aabb.minBounds = vec3(-1.0f, 0.0f, 2.0f);
+    aabb.maxBounds = vec3(3.0f, 1.0f, 2.0f);
+    const vec2 uvCoords[] = {vec2(0.0f, -1.0f), vec2(2.0f, 1.0f)};
+    bounds.extend(aabb, uvCoords, 2);
+
+    VertexLayout layout(VertexLayoutType::Quantized, 10, true, true, bounds);
+    expectFormat(layout.getPositionFormat(), 3, 0, 16);
+    expectFormat(layout.getNormalFormat(), 2, 8, 16);
+    expectFormat(layout.getUvCoordFormat(), 2, 12, 16);
+    EXPECT_EQ(VertexComponentType::UInt16, layout.getPositionFormat().componentType);
+    EXPECT_EQ(VertexComponentType::Int16, layout.getNormalFormat().componentType);
+    EXPECT_TRUE(layout.getUvCoordFormat().normalized);
+    EXPECT_EQ(160u, layout.getNumBytes());
+
+    const VertexQuantization & quantization = layout.getQuantization();
+    EXPECT_EQ(vec3(-1.0f, 0.0f, 2.0f), quantization.positionOffset);
+    EXPECT_EQ(vec3(4.0f, 1.0f, 0.0f), quantization.positionScale);
+    EXPECT_EQ(vec2(0.0f, -1.0f), quantization.uvCoordOffset);
+    EXPECT_EQ(vec2(2.0f, 2.0f), quantization.uvCoordScale);
+
+    const VertexDecodeError & error = layout.getDecodeError();
+    EXPECT_FLOAT_EQ(2.0f / 65535.0f, error.position.x);
+    EXPECT_EQ(0.0f, error.position.z);
+    EXPECT_FLOAT_EQ(1.0f / 65535.0f, error.uvCoord.s);
+    EXPECT_LT(error.normalAngle, 1e-4f);
+
+    // Unquantized floats decode exactly.
+    const VertexDecodeError & floatError =
+            VertexLayout(VertexLayoutType::Interleaved, 10, true, true, bounds).getDecodeError();
+    EXPECT_EQ(vec3(0.0f), floatError.position);
+    EXPECT_EQ(0.0f, floatError.normalAngle);
+    EXPECT_EQ(vec2(0.0f), floatError.uvCoord);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VertexLayout_Test, quantized_vertices_decode_within_reported_error) {
+    const size_t numVertices = 1000;
+    vector<vec3> positions(numVertices);
+    vector<vec3> normals(numVertices);
+    vector<vec2> uvCoords(numVertices);
+    AABB aabb;
+    aabb.minBounds = vec3(-5.0f, -0.5f, 10.0f);
+    aabb.maxBounds = vec3(7.0f, 0.5f, 10.25f);
+    for(size_t i = 0; i < numVertices; ++i) {
+        const float t = float(i) / (numVertices - 1);
+        positions[i] = glm::mix(aabb.minBounds, aabb.maxBounds,
+                vec3(t, std::sin(37.0f * t) * 0.5f + 0.5f, t * t));
+        normals[i] = glm::normalize(vec3(std::sin(91.0f * t), std::cos(53.0f * t),
+                std::sin(17.0f * t) - 0.2f));
+        uvCoords[i] = vec2(3.0f * t, 1.0f - t);
+    }
+    VertexBounds bounds;
+    bounds.extend(aabb, uvCoords.data(), numVertices);
+
+    VertexLayout layout(VertexLayoutType::Quantized, numVertices, true, true, bounds);
+    vector<ubyte> data(layout.getNumBytes());
+    layout.writeVertices(data.data(), 0, numVertices, positions.data(), normals.data(),
+            uvCoords.data());
+
+    const VertexQuantization & quantization = layout.getQuantization();
+    const VertexDecodeError & error = layout.getDecodeError();
+    for(size_t i = 0; i < numVertices; ++i) {
+        const ubyte * vertex = &data[i * 16];
+
+        // Decode as OpenGL and the quantized shaders do.
+        uint16 position[3];
+        std::memcpy(position, vertex, sizeof(position));
+        for(int axis = 0; axis < 3; ++axis) {
+            const float decoded = quantization.positionOffset[axis] +
+                    quantization.positionScale[axis] * (position[axis] / 65535.0f);
+            ASSERT_NEAR(positions[i][axis], decoded, error.position[axis] + 1e-5f);
+        }
+
+        uint32 packedNormal;
+        std::memcpy(&packedNormal, vertex + 8, sizeof(packedNormal));
+        const vec3 normal = VertexLayout::unpackOctahedralNormal(packedNormal);
+        ASSERT_LE(angleBetween(normals[i], normal), error.normalAngle + 1e-6f);
+
+        uint16 uvCoord[2];
+        std::memcpy(uvCoord, vertex + 12, sizeof(uvCoord));
+        for(int axis = 0; axis < 2; ++axis) {
+            const float decoded = quantization.uvCoordOffset[axis] +
+                    quantization.uvCoordScale[axis] * (uvCoord[axis] / 65535.0f);
+            ASSERT_NEAR(uvCoords[i][axis], decoded, error.uvCoord[axis] + 1e-6f);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VertexLayout_Test, octahedral_normals_round_trip) {
+    const vec3 axes[] = {vec3(1, 0, 0), vec3(-1, 0, 0), vec3(0, 1, 0), vec3(0, -1, 0),
+                         vec3(0, 0, 1), vec3(0, 0, -1)};
+    for(const vec3 & axis : axes) {
+        EXPECT_EQ(axis, VertexLayout::unpackOctahedralNormal(
+                VertexLayout::packOctahedralNormal(axis)));
+    }
+
+    const float maxAngle = VertexLayout(VertexLayoutType::Quantized, 1, true, false)
+            .getDecodeError().normalAngle;
+    for(int i = 0; i < 64; ++i) {
+        for(int j = 0; j < 64; ++j) {
+            const float theta = 3.14159265f * (i + 0.5f) / 64.0f;
+            const float phi = 6.28318531f * j / 64.0f;
+            const vec3 normal(std::sin(theta) * std::cos(phi),
+                              std::sin(theta) * std::sin(phi), std::cos(theta));
+            const vec3 unpacked = VertexLayout::unpackOctahedralNormal(
+                    VertexLayout::packOctahedralNormal(normal));
+            ASSERT_LE(angleBetween(normal, unpacked), maxAngle + 1e-6f);
+        }
+    }
+}
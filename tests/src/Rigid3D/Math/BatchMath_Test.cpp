@@ -0,0 +1,252 @@
+// BatchMath_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Math/BatchMath.hpp>
+#include <Rigid3D/Math/WideTypes.hpp>
+using namespace Rigid3D;
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+using glm::angleAxis;
+using glm::normalize;
+
+#include <cmath>
+
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class BatchMath_Test : public ::testing::Test {
+    protected:
+        // Not a multiple of 4 or 8, so every kernel exercises its partial batch.
+        static const size_t numElements = 37;
+        static const float tolerance;
+
+        vector<SimdLevel> levels;
+        vector<quat> orientations;
+        vector<vec3> vectors;
+        vector<mat3> inertias;
+
+        // Ran before each test.
+        virtual void SetUp() {
+            SimdLevel supported = detectSimdLevel();
+            for(int level = 0; level <= int(supported); ++level) {
+                levels.push_back(SimdLevel(level));
+            }
+
+            for(size_t i = 0; i < numElements; ++i) {
+                float t = float(i);
+                vec3 axis = normalize(vec3(std::sin(t) + 1.5f, std::cos(t), 0.5f * t));
+                orientations.push_back(angleAxis(0.37f * t, axis));
+                vectors.push_back(vec3(t - 3.0f, 0.5f * t, 2.0f - t * 0.25f));
+
+                mat3 inertia(0.0f);
+                inertia[0][0] = 1.0f + t;
+                inertia[1][1] = 2.0f + 0.5f * t;
+                inertia[2][2] = 3.0f;
+                inertia[1][0] = inertia[0][1] = 0.1f * t;
+                inertias.push_back(inertia);
+            }
+        }
+
+        // Ran after each test.
+        virtual void TearDown() {
+            setSimdLevel(detectSimdLevel());
+        }
+
+        static void expectNear(const vec3 & expected, const vec3 & actual) {
+            EXPECT_NEAR(expected.x, actual.x, tolerance);
+            EXPECT_NEAR(expected.y, actual.y, tolerance);
+            EXPECT_NEAR(expected.z, actual.z, tolerance);
+        }
+
+        static void expectNear(const quat & expected, const quat & actual) {
+            EXPECT_NEAR(expected.x, actual.x, tolerance);
+            EXPECT_NEAR(expected.y, actual.y, tolerance);
+            EXPECT_NEAR(expected.z, actual.z, tolerance);
+            EXPECT_NEAR(expected.w, actual.w, tolerance);
+        }
+    };
+
+    const float BatchMath_Test::tolerance = 1.0e-4f;
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(BatchMath_Test, set_simd_level_is_clamped_to_supported_level) {
+    setSimdLevel(SimdLevel::AVX2);
+    EXPECT_LE(int(getSimdLevel()), int(detectSimdLevel()));
+
+    setSimdLevel(SimdLevel::Scalar);
+    EXPECT_EQ(SimdLevel::Scalar, getSimdLevel());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(BatchMath_Test, wide_types_round_trip_glm_types) {
+    vec3x8 wideVectors;
+    loadWide(wideVectors, vectors.data());
+    vector<vec3> vectorsOut(8);
+    storeWide(wideVectors, vectorsOut.data());
+
+    quatx4 wideQuats;
+    loadWide(wideQuats, orientations.data());
+    vector<quat> quatsOut(4);
+    storeWide(wideQuats, quatsOut.data());
+
+    mat3x4 wideMatrices;
+    loadWide(wideMatrices, inertias.data());
+    vector<mat3> matricesOut(4);
+    storeWide(wideMatrices, matricesOut.data());
+
+    for(int i = 0; i < 8; ++i) {
+        EXPECT_EQ(vectors[i], vectorsOut[i]);
+        EXPECT_EQ(vectors[i], getLane(wideVectors, i));
+    }
+    for(int i = 0; i < 4; ++i) {
+        EXPECT_EQ(orientations[i], quatsOut[i]);
+        EXPECT_EQ(inertias[i][1][0], matricesOut[i][1][0]);
+        EXPECT_EQ(inertias[i][2][2], matricesOut[i][2][2]);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(BatchMath_Test, rotate_matches_glm) {
+    for(SimdLevel level : levels) {
+        setSimdLevel(level);
+        SCOPED_TRACE(getSimdLevelName(level));
+
+        vector<vec3> result(numElements);
+        batch::rotate(orientations.data(), vectors.data(), result.data(), numElements);
+
+        for(size_t i = 0; i < numElements; ++i) {
+            expectNear(orientations[i] * vectors[i], result[i]);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(BatchMath_Test, multiply_matches_glm) {
+    for(SimdLevel level : levels) {
+        setSimdLevel(level);
+        SCOPED_TRACE(getSimdLevelName(level));
+
+        vector<quat> reversed(orientations.rbegin(), orientations.rend());
+        vector<quat> result(numElements);
+        batch::multiply(orientations.data(), reversed.data(), result.data(), numElements);
+
+        for(size_t i = 0; i < numElements; ++i) {
+            expectNear(orientations[i] * reversed[i], result[i]);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(BatchMath_Test, integrate_linear_matches_glm) {
+    const float dt = 1.0f / 60.0f;
+    for(SimdLevel level : levels) {
+        setSimdLevel(level);
+        SCOPED_TRACE(getSimdLevelName(level));
+
+        vector<vec3> positions(vectors);
+        batch::integrateLinear(positions.data(), vectors.data(), dt, numElements);
+
+        for(size_t i = 0; i < numElements; ++i) {
+            expectNear(vectors[i] + vectors[i] * dt, positions[i]);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(BatchMath_Test, integrate_angular_matches_glm) {
+    const float dt = 1.0f / 60.0f;
+    for(SimdLevel level : levels) {
+        setSimdLevel(level);
+        SCOPED_TRACE(getSimdLevelName(level));
+
+        vector<quat> result(orientations);
+        batch::integrateAngular(result.data(), vectors.data(), dt, numElements);
+
+        for(size_t i = 0; i < numElements; ++i) {
+            const vec3 & w = vectors[i];
+            quat q = orientations[i];
+            quat dq = quat(0.0f, w.x, w.y, w.z) * q;
+            q.w += 0.5f * dt * dq.w;
+            q.x += 0.5f * dt * dq.x;
+            q.y += 0.5f * dt * dq.y;
+            q.z += 0.5f * dt * dq.z;
+            expectNear(normalize(q), result[i]);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(BatchMath_Test, rotate_inertia_matches_glm) {
+    for(SimdLevel level : levels) {
+        setSimdLevel(level);
+        SCOPED_TRACE(getSimdLevelName(level));
+
+        vector<mat3> result(numElements);
+        batch::rotateInertia(orientations.data(), inertias.data(), result.data(),
+                numElements);
+
+        for(size_t i = 0; i < numElements; ++i) {
+            mat3 R = glm::mat3_cast(orientations[i]);
+            mat3 expected = R * inertias[i] * glm::transpose(R);
+            for(int col = 0; col < 3; ++col) {
+                expectNear(expected[col], result[i][col]);
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(BatchMath_Test, cull_boxes_matches_plane_tests) {
+    // An axis aligned box [-4, 4]^3 given as six inward facing planes.
+    const vec4 planes[6] = {
+        vec4(1.0f, 0.0f, 0.0f, 4.0f), vec4(-1.0f, 0.0f, 0.0f, 4.0f),
+        vec4(0.0f, 1.0f, 0.0f, 4.0f), vec4(0.0f, -1.0f, 0.0f, 4.0f),
+        vec4(0.0f, 0.0f, 1.0f, 4.0f), vec4(0.0f, 0.0f, -1.0f, 4.0f)
+    };
+
+    // Three full visibility words and one partial word.
+    const size_t numBoxes = numElements + 64;
+    vector<float> arrays[6];
+    for(size_t i = 0; i < numBoxes; ++i) {
+        const float t = float(i);
+        arrays[0].push_back(std::sin(t) * 6.0f);
+        arrays[1].push_back(std::cos(1.3f * t) * 6.0f);
+        arrays[2].push_back(t * 0.1f - 5.0f);
+        arrays[3].push_back(0.25f + 0.01f * t);
+        arrays[4].push_back(0.5f);
+        arrays[5].push_back(1.0f);
+    }
+    const float * boxes[6];
+    for(int k = 0; k < 6; ++k) {
+        boxes[k] = arrays[k].data();
+    }
+
+    for(SimdLevel level : levels) {
+        setSimdLevel(level);
+        SCOPED_TRACE(getSimdLevelName(level));
+
+        vector<uint32> visibility(4, 0xFFFFFFFFu);
+        size_t numVisible = batch::cullBoxes(planes, boxes, visibility.data(), numBoxes);
+
+        size_t expectedVisible = 0;
+        for(size_t i = 0; i < numBoxes; ++i) {
+            bool expected = true;
+            for(int k = 0; k < 3; ++k) {
+                expected = expected && std::fabs(arrays[k][i]) - arrays[3 + k][i] <= 4.0f;
+            }
+            expectedVisible += expected ? 1 : 0;
+            EXPECT_EQ(expected, bool((visibility[i / 32] >> (i % 32)) & 1u)) << "at box " << i;
+        }
+        EXPECT_EQ(expectedVisible, numVisible);
+        EXPECT_LT(0u, numVisible);
+        EXPECT_GT(numBoxes, numVisible);
+
+        // Bits past the last box are cleared.
+        EXPECT_EQ(0u, visibility[3] >> (numBoxes % 32));
+    }
+}
@@ -0,0 +1,180 @@
+// Transform_Test.cpp
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Math/Transform.hpp>
+#include <Rigid3D/Math/BatchMath.hpp>
+#include <Rigid3D/Graphics/ModelTransform.hpp>
+using namespace Rigid3D;
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+using glm::angleAxis;
+using glm::normalize;
+
+#include <cmath>
+
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    const float tolerance = 1.0e-5f;
+
+    void expectNear(const vec3 & expected, const vec3 & actual) {
+        EXPECT_NEAR(expected.x, actual.x, tolerance);
+        EXPECT_NEAR(expected.y, actual.y, tolerance);
+        EXPECT_NEAR(expected.z, actual.z, tolerance);
+    }
+
+    void expectNear(const mat4 & expected, const mat4 & actual) {
+        for(int col = 0; col < 4; ++col) {
+            for(int row = 0; row < 4; ++row) {
+                EXPECT_NEAR(expected[col][row], actual[col][row], tolerance);
+            }
+        }
+    }
+
+    // Compares orientations, treating q and -q as equal.
+    void expectSameRotation(const quat & expected, const quat & actual) {
+        EXPECT_NEAR(1.0f, std::fabs(glm::dot(expected, actual)), tolerance);
+    }
+
+    class Transform_Test : public ::testing::Test {
+    protected:
+        Transform a;
+        Transform b;
+        vec3 point;
+
+        // Ran before each test.
+        virtual void SetUp() {
+            a = Transform(vec3(1.0f, 2.0f, 3.0f),
+                    angleAxis(0.7f, normalize(vec3(1.0f, 1.0f, 0.0f))));
+            b = Transform(vec3(-4.0f, 0.5f, 2.0f),
+                    angleAxis(-1.3f, normalize(vec3(0.0f, 1.0f, 2.0f))));
+            point = vec3(0.3f, -2.0f, 5.0f);
+        }
+    };
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(Transform_Test, default_constructor_is_identity) {
+    Transform t;
+    expectNear(point, t.applyToPoint(point));
+    expectNear(mat4(), t.getMatrix());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(Transform_Test, setIdentity) {
+    a.setIdentity();
+    expectNear(point, a.applyToPoint(point));
+    expectNear(point, a.applyToVector(point));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(Transform_Test, composition_applies_right_operand_first) {
+    Transform ab = a * b;
+    expectNear(a.applyToPoint(b.applyToPoint(point)), ab.applyToPoint(point));
+    expectNear(a.applyToVector(b.applyToVector(point)), ab.applyToVector(point));
+
+    Transform c = a;
+    c *= b;
+    expectNear(ab.position, c.position);
+    expectSameRotation(ab.pose, c.pose);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(Transform_Test, inverse_undoes_transform) {
+    Transform identity = a.inverse() * a;
+    expectNear(vec3(0.0f), identity.position);
+    expectSameRotation(quat(), identity.pose);
+
+    expectNear(point, a.inverse().applyToPoint(a.applyToPoint(point)));
+    expectNear(point, a.applyInverseToPoint(a.applyToPoint(point)));
+    expectNear(point, a.applyInverseToVector(a.applyToVector(point)));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(Transform_Test, applyToVector_ignores_translation) {
+    Transform translation(vec3(5.0f, 6.0f, 7.0f), quat());
+    expectNear(point, translation.applyToVector(point));
+    expectNear(point + vec3(5.0f, 6.0f, 7.0f), translation.applyToPoint(point));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(Transform_Test, interpolate_end_points_and_midpoint) {
+    Transform start = Transform::interpolate(a, b, 0.0f);
+    expectNear(a.position, start.position);
+    expectSameRotation(a.pose, start.pose);
+
+    Transform end = Transform::interpolate(a, b, 1.0f);
+    expectNear(b.position, end.position);
+    expectSameRotation(b.pose, end.pose);
+
+    // Rotating halfway about a single axis.
+    Transform r0(vec3(0.0f), quat());
+    Transform r1(vec3(2.0f, 0.0f, 0.0f), angleAxis(1.0f, vec3(0.0f, 0.0f, 1.0f)));
+    Transform mid = Transform::interpolate(r0, r1, 0.5f);
+    expectNear(vec3(1.0f, 0.0f, 0.0f), mid.position);
+    expectSameRotation(angleAxis(0.5f, vec3(0.0f, 0.0f, 1.0f)), mid.pose);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(Transform_Test, interpolate_takes_shortest_arc) {
+    Transform flipped(b.position, -b.pose);
+    Transform mid = Transform::interpolate(a, b, 0.5f);
+    Transform midFlipped = Transform::interpolate(a, flipped, 0.5f);
+    expectSameRotation(mid.pose, midFlipped.pose);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(Transform_Test, getMatrix_matches_applyToPoint) {
+    vec3 scale(2.0f, 3.0f, 0.5f);
+    mat4 matrix = a.getMatrix(scale);
+    vec4 result = matrix * vec4(point, 1.0f);
+    expectNear(a.applyToPoint(point * scale), vec3(result.x, result.y, result.z));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(Transform_Test, getMatrix_matches_ModelTransform) {
+    vec3 scale(2.0f, 3.0f, 0.5f);
+    ModelTransform modelTransform;
+    modelTransform.setPosition(a.position);
+    modelTransform.setPose(a.pose);
+    modelTransform.setScale(scale);
+
+    expectNear(modelTransform.getModelMatrix(), a.getMatrix(scale));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(Transform_Test, batch_computeWorldMatrices_matches_getMatrix) {
+    // Not a multiple of 4 or 8, so every kernel exercises its partial batch.
+    const size_t numTransforms = 21;
+    vector<Transform> transforms;
+    vector<vec3> scales;
+    for(size_t i = 0; i < numTransforms; ++i) {
+        float t = float(i);
+        transforms.push_back(Transform(vec3(t, -t, 0.5f * t),
+                angleAxis(0.3f * t, normalize(vec3(1.0f, std::cos(t), 2.0f)))));
+        scales.push_back(vec3(1.0f + t, 0.5f, 2.0f));
+    }
+
+    SimdLevel supported = detectSimdLevel();
+    for(int level = 0; level <= int(supported); ++level) {
+        setSimdLevel(SimdLevel(level));
+        SCOPED_TRACE(getSimdLevelName(SimdLevel(level)));
+
+        vector<mat4> scaled(numTransforms);
+        vector<mat4> unscaled(numTransforms);
+        batch::computeWorldMatrices(transforms.data(), scales.data(), scaled.data(),
+                numTransforms);
+        batch::computeWorldMatrices(transforms.data(), nullptr, unscaled.data(),
+                numTransforms);
+
+        for(size_t i = 0; i < numTransforms; ++i) {
+            expectNear(transforms[i].getMatrix(scales[i]), scaled[i]);
+            expectNear(transforms[i].getMatrix(), unscaled[i]);
+        }
+    }
+    setSimdLevel(supported);
+}
@@ -0,0 +1,66 @@
+/**
+ * @brief MeshCacheEnvironment
+ *
+ * Points MeshCache at a temporary directory while tests run, so that loading
+ * meshes leaves no cache files next to the .obj files under test.  Registers
+ * itself when linked in, so it applies to RunAllTests and to any single test
+ * target that lists this file.
+ *
+ * @author Dustin Biser
+ */
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/MeshCache.hpp>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+    class MeshCacheEnvironment : public ::testing::Environment {
+    public:
+        virtual void SetUp() {
+            const char * tempDirectory = std::getenv("TMPDIR");
+            directory = std::string(tempDirectory ? tempDirectory : "/tmp") +
+                    "/Rigid3D_Tests_XXXXXX";
+            if (mkdtemp(&directory[0]) == nullptr) {
+                // Nowhere to put cache files, so do without them.
+                directory.clear();
+                Rigid3D::MeshCache::setEnabled(false);
+                return;
+            }
+            Rigid3D::MeshCache::setCacheDirectory(directory);
+        }
+
+        virtual void TearDown() {
+            Rigid3D::MeshCache::setCacheDirectory("");
+            Rigid3D::MeshCache::setEnabled(true);
+            if (directory.empty()) {
+                return;
+            }
+
+            if (DIR * dir = opendir(directory.c_str())) {
+                while (dirent * entry = readdir(dir)) {
+                    const std::string name(entry->d_name);
+                    if (name != "." && name != "..") {
+                        std::remove((directory + "/" + name).c_str());
+                    }
+                }
+                closedir(dir);
+            }
+            rmdir(directory.c_str());
+        }
+
+    private:
+        std::string directory;
+    };
+
+    // Registered during static initialization, before main() runs the tests.
+    ::testing::Environment * const meshCacheEnvironment =
+            ::testing::AddGlobalTestEnvironment(new MeshCacheEnvironment);
+
+}
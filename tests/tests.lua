@@ -37,10 +37,36 @@ end
 
 -- Create Unit Tests
 SetupTest("RunAllTests", "src/**")
-SetupTest("Mesh_Test", "src/Rigid3D/Graphics/Mesh_Test.cpp")
-SetupTest("MeshConsolidator_Test", "src/Rigid3D/Graphics/MeshConsolidator_Test.cpp")
+    excludes {"src/Benchmarks/**"}
+SetupTest("Mesh_Test", "src/Rigid3D/Graphics/Mesh_Test.cpp", "src/Utils/MeshCacheEnvironment.cpp")
+SetupTest("MeshConsolidator_Test", "src/Rigid3D/Graphics/MeshConsolidator_Test.cpp", "src/Utils/MeshCacheEnvironment.cpp")
+SetupTest("ObjFileLoader_Test", "src/Rigid3D/Graphics/ObjFileLoader_Test.cpp")
+SetupTest("MeshBvh_Test", "src/Rigid3D/Graphics/MeshBvh_Test.cpp")
+SetupTest("MeshCache_Test", "src/Rigid3D/Graphics/MeshCache_Test.cpp", "src/Utils/MeshCacheEnvironment.cpp")
+SetupTest("AssetLoader_Test", "src/Rigid3D/Graphics/AssetLoader_Test.cpp", "src/Utils/MeshCacheEnvironment.cpp")
+SetupTest("VertexLayout_Test", "src/Rigid3D/Graphics/VertexLayout_Test.cpp")
+SetupTest("MeshOptimizer_Test", "src/Rigid3D/Graphics/MeshOptimizer_Test.cpp")
+SetupTest("MeshSimplifier_Test", "src/Rigid3D/Graphics/MeshSimplifier_Test.cpp")
 SetupTest("ShaderProgram_Test", "src/Rigid3D/Graphics/ShaderProgram_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("UniformRingBuffer_Test", "src/Rigid3D/Graphics/UniformRingBuffer_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("RenderQueue_Test", "src/Rigid3D/Graphics/RenderQueue_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("MultiDrawBuilder_Test", "src/Rigid3D/Graphics/MultiDrawBuilder_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("CascadedShadowMap_Test", "src/Rigid3D/Graphics/CascadedShadowMap_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
 SetupTest("GlmOutStream_Test", "src/Rigid3D/Graphics/GlmOutStream_Test.cpp")
 SetupTest("Camera_Test", "src/Rigid3D/Graphics/Camera_Test.cpp")
+SetupTest("FrustumCuller_Test", "src/Rigid3D/Graphics/FrustumCuller_Test.cpp")
+SetupTest("OcclusionBuffer_Test", "src/Rigid3D/Graphics/OcclusionBuffer_Test.cpp", "src/Utils/MeshCacheEnvironment.cpp")
 SetupTest("TestUtils_Predicates_Test", "src/Utils/TestUtils_Predicates_Test.cpp")
 SetupTest("AABB_Test", "src/Rigid3D/Collision/AABB_Test.cpp")
+SetupTest("ContactEventStream_Test", "src/Rigid3D/Collision/ContactEventStream_Test.cpp")
+SetupTest("DynamicAABBTree_Test", "src/Rigid3D/Collision/DynamicAABBTree_Test.cpp")
+SetupTest("VolumeContainment_Test", "src/Rigid3D/Collision/VolumeContainment_Test.cpp")
+SetupTest("BatchOverlapQuery_Test", "src/Rigid3D/Collision/BatchOverlapQuery_Test.cpp")
+SetupTest("JointSolver_Test", "src/Rigid3D/Dynamics/JointSolver_Test.cpp")
+SetupTest("BatchMath_Test", "src/Rigid3D/Math/BatchMath_Test.cpp")
+SetupTest("Transform_Test", "src/Rigid3D/Math/Transform_Test.cpp")
+SetupTest("RangeAllocator_Test", "src/Rigid3D/Common/RangeAllocator_Test.cpp")
+SetupTest("ThreadPool_Test", "src/Rigid3D/Common/ThreadPool_Test.cpp")
+
+-- Benchmarks
+SetupTest("ObjFileLoader_Benchmark", "src/Benchmarks/ObjFileLoader_Benchmark.cpp")